@@ -1,22 +1,55 @@
 #ifndef DBAL_CLIENT_HPP
 #define DBAL_CLIENT_HPP
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <map>
 #include <optional>
 #include <string>
+#include <vector>
 #include "types.hpp"
 #include "errors.hpp"
 #include "adapters/adapter.hpp"
 
 namespace dbal {
 
+struct InMemoryStore;
+class WriteAheadLog;
+class CredentialHasher;
+class SessionReaper;
+
+struct PasswordHashingConfig {
+    // Threads running the async credential calls; 0 for one per hardware thread
+    size_t workers = 0;
+    // Async calls that may wait for a thread before more fail with 503
+    size_t max_queued = 256;
+    // scrypt cost of new hashes: 128 * block_size * 2^cost_log2 bytes each
+    unsigned cost_log2 = 15;
+    unsigned block_size = 8;
+    unsigned parallelism = 1;
+};
+
+struct SessionConfig {
+    // How often a background thread removes expired sessions; 0 starts no
+    // thread and leaves it to reapExpiredSessions(). The daemon sets this
+    // for its one long-lived client; short-lived clients need not.
+    int reap_interval_ms = 0;
+    // Sessions removed per store lock, so other callers get in between batches
+    size_t reap_batch = 256;
+    // touchSession leaves expiresAt alone when it would move by less than this
+    int touch_granularity_ms = 1000;
+};
+
 struct ClientConfig {
     std::string mode;
     std::string adapter;
     std::string endpoint;
     std::string database_url;
     bool sandbox_enabled = true;
+    PersistenceConfig persistence;
+    PasswordHashingConfig password_hashing;
+    SessionConfig sessions;
 };
 
 class Client {
@@ -26,8 +59,8 @@ public:
 
     Client(const Client&) = delete;
     Client& operator=(const Client&) = delete;
-    Client(Client&&) = default;
-    Client& operator=(Client&&) = default;
+    Client(Client&&) noexcept;
+    Client& operator=(Client&&) noexcept;
 
     Result<User> createUser(const CreateUserInput& input);
     Result<User> getUser(const std::string& id);
@@ -50,6 +83,17 @@ public:
     Result<bool> getCredentialFirstLoginFlag(const std::string& username);
     Result<bool> deleteCredential(const std::string& username);
 
+    /**
+     * setCredential and verifyCredential hashing on the client's hashing
+     * threads, so an event loop never spends the hash itself. done runs
+     * once, on a hashing thread; or at once, with a ServiceUnavailable
+     * error, when too many calls are already waiting.
+     */
+    void setCredentialAsync(const CreateCredentialInput& input, std::function<void(Result<bool>)> done);
+    void verifyCredentialAsync(const std::string& username,
+                               const std::string& password,
+                               std::function<void(Result<bool>)> done);
+
     Result<PageConfig> createPage(const CreatePageInput& input);
     Result<PageConfig> getPage(const std::string& id);
     Result<PageConfig> getPageByPath(const std::string& path);
@@ -63,7 +107,7 @@ public:
     Result<ComponentNode> updateComponent(const std::string& id, const UpdateComponentNodeInput& input);
     Result<bool> deleteComponent(const std::string& id);
     Result<std::vector<ComponentNode>> listComponents(const ListOptions& options);
-    Result<std::vector<ComponentNode>> getComponentTree(const std::string& pageId);
+    Result<ComponentTreeSnapshot> getComponentTree(const std::string& pageId);
     Result<bool> reorderComponents(const std::vector<ComponentOrderUpdate>& updates);
     Result<ComponentNode> moveComponent(const MoveComponentInput& input);
     Result<std::vector<ComponentNode>> searchComponents(const std::string& query,
@@ -85,6 +129,20 @@ public:
     Result<bool> deleteSession(const std::string& id);
     Result<std::vector<Session>> listSessions(const ListOptions& options);
 
+    /**
+     * Sliding expiry: push a live session's expiry out to now + ttl.
+     * Writes only when that moves it by at least touch_granularity_ms,
+     * so most calls only take the sessions partition shared.
+     */
+    Result<Session> touchSession(const std::string& id, std::chrono::seconds ttl);
+
+    /**
+     * Remove the sessions that have expired now, in reap_batch batches;
+     * the background reaper, when reap_interval_ms enables it, does the
+     * same every reap_interval_ms
+     */
+    Result<int> reapExpiredSessions();
+
     Result<InstalledPackage> createPackage(const CreatePackageInput& input);
     Result<InstalledPackage> getPackage(const std::string& id);
     Result<InstalledPackage> updatePackage(const std::string& id, const UpdatePackageInput& input);
@@ -94,11 +152,32 @@ public:
     Result<int> batchUpdatePackages(const std::vector<UpdatePackageBatchItem>& updates);
     Result<int> batchDeletePackages(const std::vector<std::string>& ids);
 
+    /**
+     * Run body with the store locks for access taken once. Client calls
+     * made inside body take no locks of their own; a call that touches a
+     * partition access did not declare throws std::logic_error. When
+     * atomic is set and body returns an error or throws, every write body
+     * made is rolled back first.
+     */
+    Result<bool> batch(const std::vector<BatchAccess>& access,
+                       bool atomic,
+                       const std::function<Result<bool>()>& body);
+
+    /**
+     * Write a snapshot of the store and drop the log it covers. Fails
+     * when persistence is not configured; must not be called in a batch.
+     */
+    Result<bool> checkpoint();
+
     void close();
 
 private:
     std::unique_ptr<adapters::Adapter> adapter_;
+    std::unique_ptr<InMemoryStore> store_;
+    std::unique_ptr<WriteAheadLog> wal_;  // Declared after store_, which it writes to
     ClientConfig config_;
+    std::unique_ptr<CredentialHasher> hasher_;  // Its queued calls write to store_
+    std::unique_ptr<SessionReaper> reaper_;     // Writes to store_ from its own thread
 };
 
 }
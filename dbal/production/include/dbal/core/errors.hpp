@@ -33,6 +33,7 @@ enum class ErrorCode {
     InternalError = 500,             ///< Internal server error
     Timeout = 504,                   ///< Operation timed out
     DatabaseError = 503,             ///< Database unavailable
+    ServiceUnavailable = 503,        ///< Overloaded; retry later
     CapabilityNotSupported = 501,    ///< Feature not supported
     SandboxViolation = 403,          ///< Sandbox security violation
     MaliciousCodeDetected = 403      ///< Malicious code detected
@@ -119,6 +120,13 @@ public:
      */
     static Error internal(const std::string& message = "Internal server error");
 
+    /**
+     * @brief Factory for ServiceUnavailable errors (503)
+     * @param message Optional custom message
+     * @return Error instance
+     */
+    static Error unavailable(const std::string& message = "Service unavailable");
+
     /**
      * @brief Factory for SandboxViolation errors
      * @param message Violation details
@@ -237,6 +245,50 @@ private:
     bool has_value_;   ///< true if Ok, false if Err
 };
 
+/**
+ * @class Result<void>
+ * @brief Result of an operation that succeeds without a value
+ */
+template<>
+class Result<void> {
+public:
+    /**
+     * @brief Construct successful result
+     */
+    Result() : has_value_(true) {}
+
+    /**
+     * @brief Construct error result
+     * @param error Error instance
+     */
+    Result(Error error) : error_(std::move(error)), has_value_(false) {}
+
+    bool isOk() const { return has_value_; }
+    bool isError() const { return !has_value_; }
+
+    /**
+     * @brief Check for success
+     * @throws Error if result is Err
+     */
+    void value() const {
+        if (!has_value_) throw error_;
+    }
+
+    Error& error() {
+        if (has_value_) throw std::logic_error("No error present");
+        return error_;
+    }
+
+    const Error& error() const {
+        if (has_value_) throw std::logic_error("No error present");
+        return error_;
+    }
+
+private:
+    Error error_{ErrorCode::InternalError, ""};  ///< Error (if has_value_ == false)
+    bool has_value_;   ///< true if Ok, false if Err
+};
+
 }
 
 #endif
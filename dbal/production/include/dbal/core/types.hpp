@@ -3,6 +3,7 @@
 
 #include "types.generated.hpp"
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -180,11 +181,46 @@ struct UpdatePackageBatchItem {
     UpdatePackageInput data;
 };
 
+/**
+ * A page's component tree flattened in pre-order, siblings by order.
+ * Node i's descendants are nodes[i + 1, subtreeEnd[i]); its children are
+ * reached by starting at i + 1 and jumping to each child's subtreeEnd.
+ * Roots have depth 0. Trees are shared, immutable snapshots; one stays
+ * valid after the page's components change.
+ */
+struct ComponentTree {
+    std::vector<ComponentNode> nodes;
+    std::vector<int> depth;
+    std::vector<size_t> subtreeEnd;
+};
+
+using ComponentTreeSnapshot = std::shared_ptr<const ComponentTree>;
+
+/**
+ * Entity family a Client::batch reads or writes
+ */
+enum class BatchEntity {
+    User,
+    Page,
+    Component,
+    Workflow,
+    Session,
+    Package,
+};
+
+struct BatchAccess {
+    BatchEntity entity;
+    bool write = false;
+};
+
 struct ListOptions {
     std::map<std::string, std::string> filter;
     std::map<std::string, std::string> sort;
     int page = 1;
     int limit = 20;
+    // Opaque keyset cursor returned with a previous page; when set, page is
+    // ignored and the listing resumes after the row the cursor names
+    std::string cursor;
 };
 
 template<typename T>
@@ -194,6 +230,21 @@ struct ListResult {
     int page;
     int limit;
     bool hasMore;
+    std::string nextCursor;
+};
+
+/**
+ * Durability of the in-memory store. With no directory nothing is
+ * persisted; otherwise writes are logged there and replayed on startup.
+ */
+struct PersistenceConfig {
+    std::string directory;
+    // A commit is on disk at most this long after it returns...
+    int group_commit_ms = 5;
+    // ...or as soon as this many commits are waiting
+    int group_commit_records = 1024;
+    // Log size that triggers a snapshot
+    long long snapshot_bytes = 64LL * 1024 * 1024;
 };
 
 }  // namespace dbal
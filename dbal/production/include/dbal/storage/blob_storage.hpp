@@ -22,6 +22,9 @@ struct BlobMetadata {
 
 struct BlobListResult {
     std::vector<BlobMetadata> items;
+    // With a delimiter: each distinct "directory" under the prefix, once,
+    // ending in the delimiter; its keys are not listed in items
+    std::vector<std::string> common_prefixes;
     std::optional<std::string> next_token;
     bool is_truncated;
 };
@@ -39,13 +42,18 @@ struct DownloadOptions {
 
 struct ListOptions {
     std::optional<std::string> prefix;
-    std::optional<std::string> continuation_token;
-    size_t max_keys = 1000;
+    std::optional<std::string> delimiter;
+    std::optional<std::string> continuation_token;  // next_token of the previous page
+    size_t max_keys = 1000;  // Items and common prefixes together
 };
 
-// Callback for streaming uploads/downloads
+// Callback for streaming downloads: receives each piece of the blob in order
 using StreamCallback = std::function<void(const char* data, size_t size)>;
 
+// Callback for streaming uploads: fills up to capacity bytes of buffer and
+// returns how many it wrote, 0 at the end of the stream
+using StreamReader = std::function<size_t(char* buffer, size_t capacity)>;
+
 /**
  * Abstract interface for blob storage backends
  * Supports S3, filesystem, and in-memory implementations
@@ -68,7 +76,7 @@ public:
      */
     virtual Result<BlobMetadata> uploadStream(
         const std::string& key,
-        StreamCallback read_callback,
+        StreamReader read_callback,
         size_t size,
         const UploadOptions& options = {}
     ) = 0;
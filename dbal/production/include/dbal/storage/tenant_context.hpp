@@ -27,6 +27,7 @@ struct TenantQuota {
   
   // Current usage
   size_t currentBlobStorageBytes;
+  size_t currentBlobPhysicalBytes; // currentBlobStorageBytes after deduplication
   size_t currentBlobCount;
   size_t currentRecords;
   size_t currentDataSizeBytes;
@@ -0,0 +1,297 @@
+/**
+ * @file native_prisma_bridge.hpp
+ * @brief Coalescing client for the /api/native-prisma bridge
+ *
+ * Batching is off unless the bridge route is known to accept batches;
+ * without it every statement is its own request in the original
+ * {"sql", "type", "params"} format. With batching on, statements issued
+ * concurrently are merged into one request: while max_in_flight requests
+ * are outstanding, new statements queue up, and whichever caller next
+ * finds a free slot sends everything queued (up to max_batch) in a single
+ * round trip. A lone statement still goes out in the single-statement
+ * format.
+ *
+ * Wire format for batches:
+ *   request:  {"batch": [{"sql", "type", "params"}, ...], "transaction": bool}
+ *   response: {"results": [{"rows": [...]} | {"affected": n} | {"error", "code"}, ...]}
+ *
+ * A route that accepts batches always answers with a results array, one
+ * entry per statement, even when a transaction rolls back. A response
+ * without one means the route rejected the batch format before running
+ * anything, so batching is switched off for good and the statements are
+ * sent again one at a time.
+ */
+#ifndef DBAL_NATIVE_PRISMA_BRIDGE_HPP
+#define DBAL_NATIVE_PRISMA_BRIDGE_HPP
+
+#include <json/json.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dbal {
+namespace adapters {
+namespace sql {
+
+struct BridgeStatement {
+    std::string sql;
+    std::vector<::Json::Value> params;
+    bool query = true;
+};
+
+struct BridgeResult {
+    ::Json::Value rows{::Json::arrayValue};
+    int affected = 0;
+    std::string error;
+    std::string errorCode;  // bridge classification, e.g. "unique", "foreign_key"
+
+    bool ok() const {
+        return error.empty();
+    }
+};
+
+class NativePrismaBridge {
+public:
+    /**
+     * Sends one JSON payload and returns the decoded response body.
+     * Throws on transport failure.
+     */
+    using Transport = std::function<::Json::Value(const ::Json::Value&)>;
+
+    explicit NativePrismaBridge(Transport transport,
+                                bool batching = false,
+                                size_t max_batch = 64,
+                                size_t max_in_flight = 4)
+        : transport_(std::move(transport)),
+          batching_(batching),
+          max_batch_(std::max<size_t>(max_batch, 1)),
+          max_in_flight_(std::max<size_t>(max_in_flight, 1)) {}
+
+    NativePrismaBridge(const NativePrismaBridge&) = delete;
+    NativePrismaBridge& operator=(const NativePrismaBridge&) = delete;
+
+    /**
+     * Run one statement, sharing a round trip with any concurrent callers
+     */
+    BridgeResult execute(const BridgeStatement& statement) {
+        Pending pending(&statement);
+        if (!batching()) {
+            return sendOne(pending);
+        }
+        std::unique_lock<std::mutex> lock(mu_);
+        queue_.push_back(&pending);
+
+        while (!pending.done) {
+            if (in_flight_ < max_in_flight_ && !queue_.empty()) {
+                // Become the sender for everything queued so far, which may
+                // or may not include our own statement
+                std::vector<Pending*> batch;
+                while (!queue_.empty() && batch.size() < max_batch_) {
+                    batch.push_back(queue_.front());
+                    queue_.pop_front();
+                }
+                ++in_flight_;
+                lock.unlock();
+                auto results = send(batch, false);
+                lock.lock();
+                --in_flight_;
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    batch[i]->result = std::move(results[i]);
+                    batch[i]->done = true;
+                }
+                cv_.notify_all();
+                continue;
+            }
+            cv_.wait(lock);
+        }
+        return std::move(pending.result);
+    }
+
+    /**
+     * Run statements in one round trip; with transactional set the bridge
+     * applies all of them or none. Without batching they go one request
+     * each, in order, and a transactional run stops at the first failure
+     * rather than rolling back.
+     */
+    std::vector<BridgeResult> executeBatch(const std::vector<BridgeStatement>& statements, bool transactional) {
+        if (statements.empty()) {
+            return {};
+        }
+        std::vector<Pending> pending;
+        pending.reserve(statements.size());
+        for (const auto& statement : statements) {
+            pending.emplace_back(&statement);
+        }
+        std::vector<Pending*> batch;
+        for (auto& entry : pending) {
+            batch.push_back(&entry);
+        }
+        if (!batching()) {
+            return sendEach(batch, transactional);
+        }
+        return send(batch, transactional);
+    }
+
+    /**
+     * False when batching was never enabled or the bridge rejected it
+     */
+    bool batching() const {
+        return batching_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t roundTrips() const {
+        return round_trips_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t statementsSent() const {
+        return statements_sent_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Pending {
+        explicit Pending(const BridgeStatement* statement_) : statement(statement_) {}
+
+        const BridgeStatement* statement;
+        BridgeResult result;
+        bool done = false;
+    };
+
+    static ::Json::Value encode(const BridgeStatement& statement) {
+        ::Json::Value payload(::Json::objectValue);
+        payload["sql"] = statement.sql;
+        payload["type"] = statement.query ? "query" : "nonquery";
+        ::Json::Value params(::Json::arrayValue);
+        for (const auto& param : statement.params) {
+            params.append(param);
+        }
+        payload["params"] = std::move(params);
+        return payload;
+    }
+
+    static BridgeResult decode(::Json::Value& entry) {
+        BridgeResult result;
+        if (!entry.isObject()) {
+            result.error = "Malformed Native Prisma bridge response";
+            return result;
+        }
+        if (entry.isMember("error")) {
+            result.error = entry["error"].isString() ? entry["error"].asString() : "Native Prisma bridge error";
+            result.errorCode = entry.get("code", "").asString();
+            return result;
+        }
+        if (entry["rows"].isArray()) {
+            result.rows.swap(entry["rows"]);
+        }
+        if (entry["affected"].isNumeric()) {
+            result.affected = entry["affected"].asInt();
+        }
+        return result;
+    }
+
+    static std::vector<BridgeResult> failAll(size_t count, const std::string& message) {
+        std::vector<BridgeResult> results(count);
+        for (auto& result : results) {
+            result.error = message;
+            result.errorCode = "transport";
+        }
+        return results;
+    }
+
+    std::vector<BridgeResult> send(const std::vector<Pending*>& batch, bool transactional) {
+        ::Json::Value payload;
+        if (batch.size() == 1 && !transactional) {
+            payload = encode(*batch.front()->statement);
+        } else {
+            payload = ::Json::Value(::Json::objectValue);
+            ::Json::Value entries(::Json::arrayValue);
+            for (const auto* pending : batch) {
+                entries.append(encode(*pending->statement));
+            }
+            payload["batch"] = std::move(entries);
+            payload["transaction"] = transactional;
+        }
+
+        round_trips_.fetch_add(1, std::memory_order_relaxed);
+        statements_sent_.fetch_add(batch.size(), std::memory_order_relaxed);
+
+        ::Json::Value response;
+        try {
+            response = transport_(payload);
+        } catch (const std::exception& e) {
+            return failAll(batch.size(), e.what());
+        }
+
+        if (!payload.isMember("batch")) {
+            std::vector<BridgeResult> results;
+            results.push_back(decode(response));
+            return results;
+        }
+
+        auto& entries = response["results"];
+        if (!entries.isArray()) {
+            // The route does not speak the batch format and ran nothing
+            batching_.store(false, std::memory_order_relaxed);
+            return sendEach(batch, transactional);
+        }
+        if (entries.size() != batch.size()) {
+            return failAll(batch.size(), "Native Prisma bridge returned a mismatched batch");
+        }
+        std::vector<BridgeResult> results;
+        results.reserve(batch.size());
+        for (::Json::ArrayIndex i = 0; i < entries.size(); ++i) {
+            results.push_back(decode(entries[i]));
+        }
+        return results;
+    }
+
+    BridgeResult sendOne(Pending& pending) {
+        return std::move(send({&pending}, false).front());
+    }
+
+    /**
+     * One request per statement; a transactional run stops at the first
+     * failure and marks the rest as not run
+     */
+    std::vector<BridgeResult> sendEach(const std::vector<Pending*>& batch, bool transactional) {
+        std::vector<BridgeResult> results(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            results[i] = sendOne(*batch[i]);
+            if (transactional && !results[i].ok()) {
+                for (size_t rest = i + 1; rest < batch.size(); ++rest) {
+                    results[rest].error = "Not run after an earlier statement failed";
+                    results[rest].errorCode = "skipped";
+                }
+                break;
+            }
+        }
+        return results;
+    }
+
+    Transport transport_;
+    std::atomic<bool> batching_;
+    size_t max_batch_;
+    size_t max_in_flight_;
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<Pending*> queue_;
+    size_t in_flight_ = 0;
+
+    std::atomic<uint64_t> round_trips_{0};
+    std::atomic<uint64_t> statements_sent_{0};
+};
+
+}
+}
+}
+
+#endif
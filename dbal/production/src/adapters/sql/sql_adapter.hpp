@@ -2,11 +2,12 @@
 #define DBAL_SQL_ADAPTER_HPP
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
 #include <map>
-#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -15,21 +16,27 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "sql_connection.hpp"
+#include "sql_templates.hpp"
+#include "native_prisma_bridge.hpp"
+#include "../../query/cursor/list_cursor.hpp"
 #include "../../runtime/requests_client.hpp"
 
 namespace dbal {
 namespace adapters {
 namespace sql {
 
-struct SqlParam {
-    std::string name;
-    std::string value;
-};
-
 struct SqlRow {
     std::map<std::string, std::string> columns;
 };
 
+/**
+ * Statement for batch execution; sql points at cached template text
+ */
+struct SqlStatement {
+    const std::string* sql;
+    SqlParams params;
+};
+
 struct SqlError {
     enum class Code {
         UniqueViolation,
@@ -46,149 +53,141 @@ struct SqlError {
 
 class SqlAdapter : public Adapter {
 public:
-    explicit SqlAdapter(const SqlConnectionConfig& config, Dialect dialect)
-        : pool_(config), dialect_(dialect) {}
+    explicit SqlAdapter(const SqlConnectionConfig& config, Dialect dialect,
+                        const SqlPoolConfig& pool_config = SqlPoolConfig())
+        : pool_(config, pool_config), dialect_(dialect) {}
 
     ~SqlAdapter() override = default;
 
     Result<User> createUser(const CreateUserInput& input) override {
-        auto conn = pool_.acquire();
+        SqlPool::AcquireStatus status;
+        auto conn = pool_.acquire(status);
         if (!conn) {
-            return Error::internal("Unable to acquire SQL connection");
+            return acquireError(status);
         }
         ConnectionGuard guard(pool_, conn);
 
-        const std::string sql = "INSERT INTO users (tenantId, username, email, role, profilePicture, bio, isInstanceOwner, passwordChangeTimestamp, firstLogin) "
-                                "VALUES (" + placeholder(1) + ", " + placeholder(2) + ", " + placeholder(3) +
-                                ", " + placeholder(4) + ", " + placeholder(5) + ", " + placeholder(6) +
-                                ", " + placeholder(7) + ", " + placeholder(8) + ", " + placeholder(9) + ") "
-                                "RETURNING " + userFields();
-        const std::vector<SqlParam> params = {
-            {"tenantId", input.tenantId.value_or("")},
-            {"username", input.username},
-            {"email", input.email},
-            {"role", input.role},
-            {"profilePicture", input.profilePicture.value_or("")},
-            {"bio", input.bio.value_or("")},
-            {"isInstanceOwner", input.isInstanceOwner.value_or(false) ? "1" : "0"},
-            {"passwordChangeTimestamp", input.passwordChangeTimestamp.has_value() ? timestampToString(input.passwordChangeTimestamp.value()) : ""},
-            {"firstLogin", input.firstLogin.value_or(false) ? "1" : "0"},
-        };
+        const auto statement = userInsertStatement(input, true);
 
         try {
-            const auto rows = executeQuery(conn, sql, params);
-            if (rows.empty()) {
+            const auto users = queryUsers(conn, *statement.sql, statement.params);
+            if (users.empty()) {
                 return Error::internal("SQL insert returned no rows");
             }
-            return mapRowToUser(rows.front());
+            return users.front();
         } catch (const SqlError& err) {
             return mapSqlError(err);
         }
     }
 
     Result<User> getUser(const std::string& id) override {
-        auto conn = pool_.acquire();
+        SqlPool::AcquireStatus status;
+        auto conn = pool_.acquire(status);
         if (!conn) {
-            return Error::internal("Unable to acquire SQL connection");
+            return acquireError(status);
         }
         ConnectionGuard guard(pool_, conn);
 
-        const std::string sql = "SELECT " + userFields() +
-                                " FROM users WHERE id = " + placeholder(1);
-        const std::vector<SqlParam> params = {{"id", id}};
+        const std::string& sql = templates_.get(SqlOperation::SelectUserById, 0, [this](uint32_t) {
+            return "SELECT " + userFields() + " FROM users WHERE id = " + placeholder(1);
+        });
 
         try {
-            const auto rows = executeQuery(conn, sql, params);
-            if (rows.empty()) {
+            const auto users = queryUsers(conn, sql, {id});
+            if (users.empty()) {
                 return Error::notFound("User not found");
             }
-            return mapRowToUser(rows.front());
+            return users.front();
         } catch (const SqlError& err) {
             return mapSqlError(err);
         }
     }
 
     Result<User> updateUser(const std::string& id, const UpdateUserInput& input) override {
-        auto conn = pool_.acquire();
+        SqlPool::AcquireStatus status;
+        auto conn = pool_.acquire(status);
         if (!conn) {
-            return Error::internal("Unable to acquire SQL connection");
+            return acquireError(status);
         }
         ConnectionGuard guard(pool_, conn);
 
-        std::vector<std::string> setFragments;
-        std::vector<SqlParam> params;
-        params.reserve(4);
-        params.push_back({"id", id});
-
-        int paramIndex = 2;
+        // Bit i of the mask marks kUserUpdateColumns[i] as present; values
+        // are bound in column order with the id last
+        uint32_t mask = 0;
+        SqlParams params;
+        const auto set = [&mask, &params](size_t column, const SqlValue& value) {
+            mask |= 1u << column;
+            params.push_back(value);
+        };
         if (input.username) {
-            setFragments.push_back("username = " + placeholder(paramIndex++));
-            params.push_back({"username", *input.username});
+            set(0, *input.username);
         }
         if (input.email) {
-            setFragments.push_back("email = " + placeholder(paramIndex++));
-            params.push_back({"email", *input.email});
+            set(1, *input.email);
         }
         if (input.role) {
-            setFragments.push_back("role = " + placeholder(paramIndex++));
-            params.push_back({"role", *input.role});
+            set(2, *input.role);
         }
         if (input.profilePicture) {
-            setFragments.push_back("profilePicture = " + placeholder(paramIndex++));
-            params.push_back({"profilePicture", *input.profilePicture});
+            set(3, *input.profilePicture);
         }
         if (input.bio) {
-            setFragments.push_back("bio = " + placeholder(paramIndex++));
-            params.push_back({"bio", *input.bio});
+            set(4, *input.bio);
         }
         if (input.tenantId) {
-            setFragments.push_back("tenantId = " + placeholder(paramIndex++));
-            params.push_back({"tenantId", *input.tenantId});
+            set(5, *input.tenantId);
         }
         if (input.isInstanceOwner) {
-            setFragments.push_back("isInstanceOwner = " + placeholder(paramIndex++));
-            params.push_back({"isInstanceOwner", *input.isInstanceOwner ? "1" : "0"});
+            set(6, *input.isInstanceOwner);
         }
         if (input.passwordChangeTimestamp) {
-            setFragments.push_back("passwordChangeTimestamp = " + placeholder(paramIndex++));
-            params.push_back({"passwordChangeTimestamp", timestampToString(*input.passwordChangeTimestamp)});
+            set(7, toEpochSeconds(*input.passwordChangeTimestamp));
         }
         if (input.firstLogin) {
-            setFragments.push_back("firstLogin = " + placeholder(paramIndex++));
-            params.push_back({"firstLogin", *input.firstLogin ? "1" : "0"});
+            set(8, *input.firstLogin);
         }
 
-        if (setFragments.empty()) {
+        if (mask == 0) {
             return Error::validationError("No update fields supplied");
         }
+        params.push_back(id);
 
-        const std::string sql = "UPDATE users SET " + joinFragments(setFragments, ", ") +
-                                " WHERE id = " + placeholder(1) +
-                                " RETURNING " + userFields();
+        const std::string& sql = templates_.get(SqlOperation::UpdateUser, mask, [this](uint32_t fields) {
+            std::string text = "UPDATE users SET ";
+            size_t index = 1;
+            for (size_t column = 0; column < kUserUpdateColumns.size(); ++column) {
+                if (fields & (1u << column)) {
+                    if (index > 1) {
+                        text += ", ";
+                    }
+                    text += kUserUpdateColumns[column];
+                    text += " = " + placeholder(index++);
+                }
+            }
+            return text + " WHERE id = " + placeholder(index) + " RETURNING " + userFields();
+        });
 
         try {
-            const auto rows = executeQuery(conn, sql, params);
-            if (rows.empty()) {
+            const auto users = queryUsers(conn, sql, params);
+            if (users.empty()) {
                 return Error::notFound("User not found");
             }
-            return mapRowToUser(rows.front());
+            return users.front();
         } catch (const SqlError& err) {
             return mapSqlError(err);
         }
     }
 
     Result<bool> deleteUser(const std::string& id) override {
-        auto conn = pool_.acquire();
+        SqlPool::AcquireStatus status;
+        auto conn = pool_.acquire(status);
         if (!conn) {
-            return Error::internal("Unable to acquire SQL connection");
+            return acquireError(status);
         }
         ConnectionGuard guard(pool_, conn);
 
-        const std::string sql = "DELETE FROM users WHERE id = " + placeholder(1);
-        const std::vector<SqlParam> params = {{"id", id}};
-
         try {
-            const int affected = executeNonQuery(conn, sql, params);
+            const int affected = executeNonQuery(conn, deleteUserSql(), {id});
             if (affected == 0) {
                 return Error::notFound("User not found");
             }
@@ -199,43 +198,126 @@ public:
     }
 
     Result<std::vector<User>> listUsers(const ListOptions& options) override {
-        auto conn = pool_.acquire();
+        const std::string field = query::sortField<User>(options);
+        auto cursor = query::resolveCursor<User>(options, field);
+        if (cursor.isError()) {
+            return cursor.error();
+        }
+        const auto& after = cursor.value();
+
+        SqlPool::AcquireStatus status;
+        auto conn = pool_.acquire(status);
         if (!conn) {
-            return Error::internal("Unable to acquire SQL connection");
+            return acquireError(status);
         }
         ConnectionGuard guard(pool_, conn);
 
         const int limit = options.limit > 0 ? options.limit : 50;
-        const int offset = options.page > 1 ? (options.page - 1) * limit : 0;
+        const int offset = !after.has_value() && options.page > 1 ? (options.page - 1) * limit : 0;
 
-        std::string where_clause;
-        std::vector<SqlParam> params;
-        params.reserve(3);
-        int param_index = 1;
-        auto tenant_filter = options.filter.find("tenantId");
-        if (tenant_filter == options.filter.end()) {
-            tenant_filter = options.filter.find("tenantId");
-        }
+        // Mask bits: 1 tenant filter, 2 ordered by username, 4 resuming after a cursor
+        uint32_t mask = 0;
+        SqlParams params;
+        const auto tenant_filter = options.filter.find("tenantId");
         if (tenant_filter != options.filter.end()) {
-            where_clause = " WHERE tenantId = " + placeholder(param_index++);
-            params.push_back({"tenantId", tenant_filter->second});
+            mask |= 1;
+            params.push_back(tenant_filter->second);
         }
+        if (field == "username") {
+            mask |= 2;
+        }
+        if (after.has_value()) {
+            mask |= 4;
+            if (mask & 2) {
+                params.push_back(after->key);
+            }
+            params.push_back(after->id);
+        }
+        params.push_back(limit);
+        params.push_back(offset);
+
+        const std::string& sql = templates_.get(SqlOperation::ListUsers, mask, [this](uint32_t shape) {
+            size_t index = 1;
+            std::string text = "SELECT " + userFields() + " FROM users";
+            const char* joiner = " WHERE ";
+            if (shape & 1) {
+                text += joiner + std::string("tenantId = ") + placeholder(index++);
+                joiner = " AND ";
+            }
+            if (shape & 4) {
+                text += joiner;
+                if (shape & 2) {
+                    text += "(username, id) > (" + placeholder(index++);
+                    text += ", " + placeholder(index++) + ")";
+                } else {
+                    text += "id > " + placeholder(index++);
+                }
+            }
+            text += (shape & 2) ? " ORDER BY username, id" : " ORDER BY id";
+            text += " LIMIT " + placeholder(index);
+            text += " OFFSET " + placeholder(index + 1);
+            return text;
+        });
 
-        const std::string sql = "SELECT " + userFields() +
-                                " FROM users" + where_clause +
-                                " ORDER BY createdAt DESC LIMIT " + placeholder(param_index++) +
-                                " OFFSET " + placeholder(param_index++);
-        params.push_back({"limit", std::to_string(limit)});
-        params.push_back({"offset", std::to_string(offset)});
+        try {
+            return Result<std::vector<User>>(queryUsers(conn, sql, params));
+        } catch (const SqlError& err) {
+            return mapSqlError(err);
+        }
+    }
+
+    /**
+     * Insert users as one batch; see runBatch for atomicity and round trips
+     */
+    Result<int> batchCreateUsers(const std::vector<CreateUserInput>& inputs) {
+        if (inputs.empty()) {
+            return Result<int>(0);
+        }
+        SqlPool::AcquireStatus status;
+        auto conn = pool_.acquire(status);
+        if (!conn) {
+            return acquireError(status);
+        }
+        ConnectionGuard guard(pool_, conn);
+
+        std::vector<SqlStatement> statements;
+        statements.reserve(inputs.size());
+        for (const auto& input : inputs) {
+            statements.push_back(userInsertStatement(input, false));
+        }
 
         try {
-            const auto rows = executeQuery(conn, sql, params);
-            std::vector<User> users;
-            users.reserve(rows.size());
-            for (const auto& row : rows) {
-                users.push_back(mapRowToUser(row));
+            runBatch(conn, statements);
+            return Result<int>(static_cast<int>(inputs.size()));
+        } catch (const SqlError& err) {
+            return mapSqlError(err);
+        }
+    }
+
+    Result<int> batchDeleteUsers(const std::vector<std::string>& ids) {
+        if (ids.empty()) {
+            return Result<int>(0);
+        }
+        SqlPool::AcquireStatus status;
+        auto conn = pool_.acquire(status);
+        if (!conn) {
+            return acquireError(status);
+        }
+        ConnectionGuard guard(pool_, conn);
+
+        std::vector<SqlStatement> statements;
+        statements.reserve(ids.size());
+        for (const auto& id : ids) {
+            statements.push_back({&deleteUserSql(), {id}});
+        }
+
+        try {
+            const auto affected = runBatch(conn, statements);
+            int deleted = 0;
+            for (int count : affected) {
+                deleted += count;
             }
-            return Result<std::vector<User>>(users);
+            return Result<int>(deleted);
         } catch (const SqlError& err) {
             return mapSqlError(err);
         }
@@ -349,6 +431,10 @@ public:
         // Connections will tear down automatically via RAII in the pool.
     }
 
+    SqlPoolMetrics poolMetrics() const {
+        return pool_.metrics();
+    }
+
 protected:
     struct ConnectionGuard {
         SqlPool& pool;
@@ -364,28 +450,102 @@ protected:
 
     std::vector<SqlRow> executeQuery(SqlConnection* connection,
                                      const std::string& sql,
-                                     const std::vector<SqlParam>& params) {
+                                     const SqlParams& params) {
         return runQuery(connection, sql, params);
     }
 
     int executeNonQuery(SqlConnection* connection,
                         const std::string& sql,
-                        const std::vector<SqlParam>& params) {
+                        const SqlParams& params) {
         return runNonQuery(connection, sql, params);
     }
 
     virtual std::vector<SqlRow> runQuery(SqlConnection*,
                                          const std::string&,
-                                         const std::vector<SqlParam>&) {
+                                         const SqlParams&) {
         throw SqlError{SqlError::Code::Unknown, "SQL execution not implemented"};
     }
 
     virtual int runNonQuery(SqlConnection*,
                             const std::string&,
-                            const std::vector<SqlParam>&) {
+                            const SqlParams&) {
         throw SqlError{SqlError::Code::Unknown, "SQL execution not implemented"};
     }
 
+    /**
+     * Run a query returning user rows. Transports that can decode rows
+     * straight into User override this to skip the SqlRow round trip.
+     */
+    virtual std::vector<User> queryUsers(SqlConnection* connection,
+                                         const std::string& sql,
+                                         const SqlParams& params) {
+        const auto rows = executeQuery(connection, sql, params);
+        std::vector<User> users;
+        users.reserve(rows.size());
+        for (const auto& row : rows) {
+            users.push_back(mapRowToUser(row));
+        }
+        return users;
+    }
+
+    /**
+     * Run several non-query statements and return their affected counts.
+     * The default issues them one by one; transports that can ship a batch
+     * in one round trip (and apply it atomically) override this.
+     */
+    virtual std::vector<int> runBatch(SqlConnection* connection, const std::vector<SqlStatement>& statements) {
+        std::vector<int> affected;
+        affected.reserve(statements.size());
+        for (const auto& statement : statements) {
+            affected.push_back(executeNonQuery(connection, *statement.sql, statement.params));
+        }
+        return affected;
+    }
+
+    SqlStatement userInsertStatement(const CreateUserInput& input, bool returning) {
+        const auto operation = returning ? SqlOperation::InsertUserReturning : SqlOperation::InsertUser;
+        const std::string& sql = templates_.get(operation, 0, [this, returning](uint32_t) {
+            std::string text = "INSERT INTO users (tenantId, username, email, role, profilePicture, bio, "
+                               "isInstanceOwner, passwordChangeTimestamp, firstLogin) VALUES (";
+            for (size_t index = 1; index <= 9; ++index) {
+                text += (index > 1 ? ", " : "") + placeholder(index);
+            }
+            text += ")";
+            return returning ? text + " RETURNING " + userFields() : text;
+        });
+
+        SqlStatement statement{&sql, {}};
+        statement.params.push_back(SqlValue::fromOptional(input.tenantId));
+        statement.params.push_back(input.username);
+        statement.params.push_back(input.email);
+        statement.params.push_back(input.role);
+        statement.params.push_back(SqlValue::fromOptional(input.profilePicture));
+        statement.params.push_back(SqlValue::fromOptional(input.bio));
+        statement.params.push_back(input.isInstanceOwner.value_or(false));
+        statement.params.push_back(input.passwordChangeTimestamp.has_value()
+                                       ? SqlValue(toEpochSeconds(input.passwordChangeTimestamp.value()))
+                                       : SqlValue());
+        statement.params.push_back(input.firstLogin.value_or(false));
+        return statement;
+    }
+
+    const std::string& deleteUserSql() {
+        return templates_.get(SqlOperation::DeleteUserById, 0, [this](uint32_t) {
+            return "DELETE FROM users WHERE id = " + placeholder(1);
+        });
+    }
+
+    static Error acquireError(SqlPool::AcquireStatus status) {
+        switch (status) {
+            case SqlPool::AcquireStatus::Timeout:
+                return Error(ErrorCode::Timeout, "Timed out waiting for a SQL connection");
+            case SqlPool::AcquireStatus::QueueFull:
+                return Error(ErrorCode::DatabaseError, "SQL connection pool exhausted");
+            default:
+                return Error(ErrorCode::DatabaseError, "Unable to open SQL connection");
+        }
+    }
+
     static Error mapSqlError(const SqlError& error) {
         switch (error.code) {
             case SqlError::Code::UniqueViolation:
@@ -442,9 +602,8 @@ protected:
         return parseTimestamp(value);
     }
 
-    static std::string timestampToString(const Timestamp& value) {
-        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(value.time_since_epoch()).count();
-        return std::to_string(seconds);
+    static int64_t toEpochSeconds(const Timestamp& value) {
+        return std::chrono::duration_cast<std::chrono::seconds>(value.time_since_epoch()).count();
     }
 
     static std::optional<std::string> emptyToNull(const std::string& value) {
@@ -454,20 +613,17 @@ protected:
         return value;
     }
 
-    static std::string joinFragments(const std::vector<std::string>& fragments, const std::string& separator) {
-        std::ostringstream out;
-        for (size_t i = 0; i < fragments.size(); ++i) {
-            if (i > 0) {
-                out << separator;
-            }
-            out << fragments[i];
-        }
-        return out.str();
+    static const std::string& userFields() {
+        static const std::string fields =
+            "id, tenantId, username, email, role, profilePicture, bio, createdAt, isInstanceOwner, passwordChangeTimestamp, firstLogin";
+        return fields;
     }
 
-    static std::string userFields() {
-        return "id, tenantId, username, email, role, profilePicture, bio, createdAt, isInstanceOwner, passwordChangeTimestamp, firstLogin";
-    }
+    // Columns settable by updateUser, in mask bit order
+    static constexpr std::array<const char*, 9> kUserUpdateColumns = {
+        "username", "email", "role", "profilePicture", "bio",
+        "tenantId", "isInstanceOwner", "passwordChangeTimestamp", "firstLogin",
+    };
 
     std::string placeholder(size_t index) const {
         if (dialect_ == Dialect::Postgres || dialect_ == Dialect::Prisma) {
@@ -478,6 +634,7 @@ protected:
 
     SqlPool pool_;
     Dialect dialect_;
+    SqlTemplateCache templates_;
 };
 
 class PostgresAdapter : public SqlAdapter {
@@ -500,65 +657,190 @@ class NativePrismaAdapter : public SqlAdapter {
 public:
     explicit NativePrismaAdapter(const SqlConnectionConfig& config)
         : SqlAdapter(config, Dialect::Prisma),
-          requestsClient_(resolveBridgeUrl(config), buildBridgeHeaders(resolveBridgeToken(config))) {}
+          requestsClient_(resolveBridgeUrl(config), buildBridgeHeaders(resolveBridgeToken(config))),
+          bridge_([this](const ::Json::Value& payload) { return post(payload); }, resolveBridgeBatching(config)) {}
 
+    /**
+     * Bridge client; exposes round-trip counters
+     */
+    const NativePrismaBridge& bridge() const {
+        return bridge_;
+    }
+
+protected:
     std::vector<SqlRow> runQuery(SqlConnection* connection,
                                  const std::string& sql,
-                                 const std::vector<SqlParam>& params) override {
+                                 const SqlParams& params) override {
         (void)connection;
-        const auto payload = buildPayload(sql, params, "query");
-        ::Json::StreamWriterBuilder writer;
-        writer["indentation"] = "";
-        const auto response = requestsClient_.post(
-            "/api/native-prisma",
-            ::Json::writeString(writer, payload));
-        if (response.statusCode != 200) {
-            throw SqlError{SqlError::Code::Unknown, "Native Prisma bridge request failed"};
-        }
+        auto result = executeChecked(sql, params, true);
         std::vector<SqlRow> rows;
-        const auto& rowsJson = response.json["rows"];
-        if (!rowsJson.isNull() && rowsJson.isArray()) {
-            for (const auto& entry : rowsJson) {
-                SqlRow row;
-                if (entry.isObject()) {
-                    const auto keys = entry.getMemberNames();
-                    for (const auto& key : keys) {
-                        const auto& value = entry[key];
-                        if (value.isString()) {
-                            row.columns[key] = value.asString();
-                        } else {
-                            ::Json::StreamWriterBuilder writer;
-                            writer["indentation"] = "";
-                            row.columns[key] = ::Json::writeString(writer, value);
-                        }
-                    }
+        rows.reserve(result.rows.size());
+        for (const auto& entry : result.rows) {
+            SqlRow row;
+            if (entry.isObject()) {
+                for (auto itr = entry.begin(); itr != entry.end(); ++itr) {
+                    row.columns[itr.name()] = itr->isString() ? itr->asString() : ::Json::writeString(writer(), *itr);
                 }
-                rows.push_back(std::move(row));
             }
+            rows.push_back(std::move(row));
         }
         return rows;
     }
 
     int runNonQuery(SqlConnection* connection,
                     const std::string& sql,
-                    const std::vector<SqlParam>& params) override {
+                    const SqlParams& params) override {
+        (void)connection;
+        return executeChecked(sql, params, false).affected;
+    }
+
+    std::vector<User> queryUsers(SqlConnection* connection,
+                                 const std::string& sql,
+                                 const SqlParams& params) override {
         (void)connection;
-        const auto payload = buildPayload(sql, params, "nonquery");
-        ::Json::StreamWriterBuilder writer;
-        writer["indentation"] = "";
-        const auto response = requestsClient_.post(
-            "/api/native-prisma",
-            ::Json::writeString(writer, payload));
-        if (response.statusCode != 200) {
-            throw SqlError{SqlError::Code::Unknown, "Native Prisma bridge request failed"};
+        auto result = executeChecked(sql, params, true);
+        std::vector<User> users;
+        users.reserve(result.rows.size());
+        for (const auto& entry : result.rows) {
+            users.push_back(decodeUser(entry));
         }
-        if (response.json.isMember("affected")) {
-            return response.json["affected"].asInt();
+        return users;
+    }
+
+    std::vector<int> runBatch(SqlConnection* connection, const std::vector<SqlStatement>& statements) override {
+        (void)connection;
+        std::vector<BridgeStatement> batch;
+        batch.reserve(statements.size());
+        for (const auto& statement : statements) {
+            batch.push_back(toBridgeStatement(*statement.sql, statement.params, false));
+        }
+        const auto results = bridge_.executeBatch(batch, true);
+        std::vector<int> affected;
+        affected.reserve(results.size());
+        for (const auto& result : results) {
+            throwIfFailed(result);
+            affected.push_back(result.affected);
         }
-        return 0;
+        return affected;
     }
 
 private:
+    static const ::Json::StreamWriterBuilder& writer() {
+        static const ::Json::StreamWriterBuilder builder = [] {
+            ::Json::StreamWriterBuilder configured;
+            configured["indentation"] = "";
+            return configured;
+        }();
+        return builder;
+    }
+
+    static BridgeStatement toBridgeStatement(const std::string& sql,
+                                             const SqlParams& params,
+                                             bool query) {
+        BridgeStatement statement;
+        statement.sql = sql;
+        statement.query = query;
+        statement.params.reserve(params.size());
+        for (const auto& param : params) {
+            statement.params.push_back(toJson(param));
+        }
+        return statement;
+    }
+
+    static ::Json::Value toJson(const SqlValue& value) {
+        switch (value.kind()) {
+            case SqlValue::Kind::Text:
+                return ::Json::Value(std::string(value.text()));
+            case SqlValue::Kind::Integer:
+                return ::Json::Value(static_cast<::Json::Int64>(value.integer()));
+            case SqlValue::Kind::Boolean:
+                return ::Json::Value(value.boolean());
+            default:
+                return ::Json::Value();
+        }
+    }
+
+    static void throwIfFailed(const BridgeResult& result) {
+        if (result.ok()) {
+            return;
+        }
+        SqlError::Code code = SqlError::Code::Unknown;
+        if (result.errorCode == "unique") {
+            code = SqlError::Code::UniqueViolation;
+        } else if (result.errorCode == "foreign_key") {
+            code = SqlError::Code::ForeignKeyViolation;
+        } else if (result.errorCode == "timeout") {
+            code = SqlError::Code::Timeout;
+        } else if (result.errorCode == "transport") {
+            code = SqlError::Code::ConnectionLost;
+        }
+        throw SqlError{code, result.error};
+    }
+
+    BridgeResult executeChecked(const std::string& sql, const SqlParams& params, bool query) {
+        auto result = bridge_.execute(toBridgeStatement(sql, params, query));
+        throwIfFailed(result);
+        return result;
+    }
+
+    ::Json::Value post(const ::Json::Value& payload) {
+        const auto response = requestsClient_.post("/api/native-prisma", ::Json::writeString(writer(), payload));
+        if (response.statusCode != 200 && !response.json.isMember("error")) {
+            throw std::runtime_error("Native Prisma bridge request failed with status " +
+                                     std::to_string(response.statusCode));
+        }
+        return response.json;
+    }
+
+    static std::string jsonText(const ::Json::Value& value) {
+        if (value.isNull()) {
+            return "";
+        }
+        if (value.isString()) {
+            return value.asString();
+        }
+        if (value.isBool()) {
+            return value.asBool() ? "1" : "0";
+        }
+        return ::Json::writeString(writer(), value);
+    }
+
+    static bool jsonFlag(const ::Json::Value& value) {
+        if (value.isBool()) {
+            return value.asBool();
+        }
+        if (value.isNumeric()) {
+            return value.asInt64() != 0;
+        }
+        return value.isString() && (value.asString() == "1" || value.asString() == "true");
+    }
+
+    static std::optional<Timestamp> jsonTimestamp(const ::Json::Value& value) {
+        if (value.isNull()) {
+            return std::nullopt;
+        }
+        if (value.isNumeric()) {
+            return Timestamp(std::chrono::seconds(value.asInt64()));
+        }
+        return parseOptionalTimestamp(value.asString());
+    }
+
+    static User decodeUser(const ::Json::Value& row) {
+        User user;
+        user.id = jsonText(row["id"]);
+        user.tenantId = emptyToNull(jsonText(row["tenantId"]));
+        user.username = jsonText(row["username"]);
+        user.email = jsonText(row["email"]);
+        user.role = jsonText(row["role"]);
+        user.profilePicture = emptyToNull(jsonText(row["profilePicture"]));
+        user.bio = emptyToNull(jsonText(row["bio"]));
+        user.createdAt = jsonTimestamp(row["createdAt"]).value_or(std::chrono::system_clock::now());
+        user.isInstanceOwner = jsonFlag(row["isInstanceOwner"]);
+        user.passwordChangeTimestamp = jsonTimestamp(row["passwordChangeTimestamp"]);
+        user.firstLogin = jsonFlag(row["firstLogin"]);
+        return user;
+    }
+
     static std::string resolveBridgeUrl(const SqlConnectionConfig& config) {
         if (!config.prisma_bridge_url.empty()) {
             return config.prisma_bridge_url;
@@ -579,6 +861,14 @@ private:
         return "";
     }
 
+    static bool resolveBridgeBatching(const SqlConnectionConfig& config) {
+        if (config.prisma_bridge_batching) {
+            return true;
+        }
+        const char* env_batch = std::getenv("DBAL_NATIVE_PRISMA_BATCH");
+        return env_batch && (std::string(env_batch) == "1" || std::string(env_batch) == "true");
+    }
+
     static std::unordered_map<std::string, std::string> buildBridgeHeaders(const std::string& token) {
         std::unordered_map<std::string, std::string> headers;
         headers["Content-Type"] = "application/json";
@@ -589,18 +879,7 @@ private:
     }
 
     runtime::RequestsClient requestsClient_;
-    ::Json::Value buildPayload(const std::string& sql,
-                               const std::vector<SqlParam>& params,
-                               const std::string& type) const {
-        ::Json::Value payload;
-        payload["sql"] = sql;
-        payload["type"] = type;
-        payload["params"] = ::Json::Value(::Json::arrayValue);
-        for (const auto& param : params) {
-            payload["params"].append(param.value);
-        }
-        return payload;
-    }
+    NativePrismaBridge bridge_;
 };
 
 }
@@ -7,6 +7,10 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 
 namespace dbal {
 namespace adapters {
@@ -27,6 +31,8 @@ struct SqlConnectionConfig {
     std::string options;
     std::string prisma_bridge_url;
     std::string prisma_bridge_token;
+    // Only for a bridge route that accepts {"batch": [...]} payloads
+    bool prisma_bridge_batching = false;
 };
 
 class SqlConnection {
@@ -63,6 +69,15 @@ public:
         return connected_;
     }
 
+    /**
+     * Liveness probe used by the pool before reusing a long-idle connection
+     */
+    bool ping() {
+        std::lock_guard<std::mutex> lock(mu_);
+        // TODO: Issue a round trip (SELECT 1) once a native driver is wired in.
+        return connected_;
+    }
+
     void touch() {
         lastActivity_ = std::chrono::steady_clock::now();
     }
@@ -78,24 +93,156 @@ private:
     std::chrono::steady_clock::time_point lastActivity_;
 };
 
+struct SqlPoolConfig {
+    size_t min_size = 1;
+    size_t max_size = 5;
+    size_t max_waiters = 64;
+    std::chrono::milliseconds acquire_timeout{5000};
+    std::chrono::milliseconds idle_timeout{60000};
+    // Idle connections older than this are pinged before being handed out
+    std::chrono::milliseconds health_check_interval{30000};
+};
+
+struct SqlPoolMetrics {
+    size_t open = 0;
+    size_t idle = 0;
+    size_t in_use = 0;
+    size_t waiting = 0;
+    uint64_t acquired = 0;
+    uint64_t waits = 0;
+    uint64_t timeouts = 0;
+    uint64_t rejected = 0;
+    uint64_t created = 0;
+    uint64_t evicted = 0;
+    uint64_t health_check_failures = 0;
+    std::chrono::microseconds total_checkout_latency{0};
+    std::chrono::microseconds max_checkout_latency{0};
+};
+
+/**
+ * Exclusive-checkout connection pool.
+ *
+ * A connection belongs to exactly one caller between acquire() and
+ * release(). When every connection is busy and the pool is at max_size,
+ * callers queue FIFO (up to max_waiters) and release() hands the
+ * connection straight to the oldest waiter, so nobody is starved by
+ * late arrivals and no thundering herd wakes up.
+ */
 class SqlPool {
 public:
+    enum class AcquireStatus {
+        Ok,
+        Timeout,
+        QueueFull,
+        ConnectFailed,
+    };
+
     SqlPool(const SqlConnectionConfig& config, size_t size = 5)
-        : config_(config), size_(size) {
-        for (size_t i = 0; i < size_; ++i) {
+        : SqlPool(config, sizedConfig(size)) {}
+
+    SqlPool(const SqlConnectionConfig& config, const SqlPoolConfig& pool_config)
+        : config_(config), pool_config_(pool_config) {
+        pool_config_.max_size = std::max<size_t>(pool_config_.max_size, 1);
+        pool_config_.min_size = std::min(pool_config_.min_size, pool_config_.max_size);
+        connections_.reserve(pool_config_.max_size);
+        idle_.reserve(pool_config_.max_size);
+        in_use_.reserve(pool_config_.max_size);
+
+        std::lock_guard<std::mutex> lock(mu_);
+        for (size_t i = 0; i < pool_config_.min_size; ++i) {
             auto conn = std::make_unique<SqlConnection>(config_);
-            pool_.push_back(std::move(conn));
+            if (!conn->connect()) {
+                break;
+            }
+            idle_.push_back(conn.get());
+            connections_.push_back(std::move(conn));
+            ++created_;
         }
     }
 
+    SqlPool(const SqlPool&) = delete;
+    SqlPool& operator=(const SqlPool&) = delete;
+
     SqlConnection* acquire() {
-        std::lock_guard<std::mutex> lock(mu_);
-        for (auto& conn : pool_) {
-            if (conn && conn->connect()) {
-                return conn.get();
+        AcquireStatus status;
+        return acquire(status);
+    }
+
+    /**
+     * Check out a connection, waiting up to acquire_timeout for one to be
+     * released. Returns nullptr and sets status on failure.
+     */
+    SqlConnection* acquire(AcquireStatus& status) {
+        const auto start = Clock::now();
+        const auto deadline = start + pool_config_.acquire_timeout;
+        std::unique_lock<std::mutex> lock(mu_);
+        bool counted_wait = false;
+
+        while (true) {
+            if (!idle_.empty()) {
+                SqlConnection* conn = idle_.back();
+                idle_.pop_back();
+                in_use_.push_back(conn);
+                if (Clock::now() - conn->lastActivity() >= pool_config_.health_check_interval) {
+                    lock.unlock();
+                    const bool healthy = conn->ping();
+                    lock.lock();
+                    if (!healthy) {
+                        ++health_check_failures_;
+                        untrack(conn);
+                        destroy(conn);
+                        continue;
+                    }
+                }
+                return checkedOut(conn, start, status);
+            }
+
+            if (connections_.size() + opening_ < pool_config_.max_size) {
+                // Connect outside the lock; the slot is reserved via opening_
+                ++opening_;
+                lock.unlock();
+                auto conn = std::make_unique<SqlConnection>(config_);
+                const bool connected = conn->connect();
+                lock.lock();
+                --opening_;
+                if (!connected) {
+                    wakeNextWaiter();
+                    status = AcquireStatus::ConnectFailed;
+                    return nullptr;
+                }
+                SqlConnection* raw = conn.get();
+                connections_.push_back(std::move(conn));
+                in_use_.push_back(raw);
+                ++created_;
+                return checkedOut(raw, start, status);
+            }
+
+            if (waiters_.size() >= pool_config_.max_waiters) {
+                ++rejected_;
+                status = AcquireStatus::QueueFull;
+                return nullptr;
+            }
+            if (!counted_wait) {
+                ++waits_;
+                counted_wait = true;
+            }
+
+            Waiter waiter;
+            waiters_.push_back(&waiter);
+            const bool signalled = waiter.cv.wait_until(lock, deadline, [&waiter]() {
+                return waiter.connection != nullptr || waiter.retry;
+            });
+            if (!signalled) {
+                waiters_.erase(std::find(waiters_.begin(), waiters_.end(), &waiter));
+                ++timeouts_;
+                status = AcquireStatus::Timeout;
+                return nullptr;
+            }
+            if (waiter.connection) {
+                return checkedOut(waiter.connection, start, status);
             }
+            // A slot was freed by a dropped connection; try to open one
         }
-        return nullptr;
     }
 
     void release(SqlConnection* connection) {
@@ -103,18 +250,163 @@ public:
             return;
         }
         std::lock_guard<std::mutex> lock(mu_);
+        if (!untrack(connection)) {
+            return;
+        }
+
+        if (!connection->isConnected()) {
+            destroy(connection);
+            wakeNextWaiter();
+            return;
+        }
+
         connection->touch();
+        if (!waiters_.empty()) {
+            Waiter* waiter = waiters_.front();
+            waiters_.pop_front();
+            waiter->connection = connection;
+            in_use_.push_back(connection);
+            waiter->cv.notify_one();
+            return;
+        }
+
+        idle_.push_back(connection);
+        evictIdleLocked(Clock::now());
     }
 
+    /**
+     * Close connections idle for longer than idle_timeout, keeping at
+     * least min_size open. Also runs on every release.
+     */
+    size_t evictIdle() {
+        std::lock_guard<std::mutex> lock(mu_);
+        return evictIdleLocked(Clock::now());
+    }
+
+    SqlPoolMetrics metrics() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        SqlPoolMetrics metrics;
+        metrics.open = connections_.size();
+        metrics.idle = idle_.size();
+        metrics.in_use = in_use_.size();
+        metrics.waiting = waiters_.size();
+        metrics.acquired = acquired_;
+        metrics.waits = waits_;
+        metrics.timeouts = timeouts_;
+        metrics.rejected = rejected_;
+        metrics.created = created_;
+        metrics.evicted = evicted_;
+        metrics.health_check_failures = health_check_failures_;
+        metrics.total_checkout_latency = total_checkout_latency_;
+        metrics.max_checkout_latency = max_checkout_latency_;
+        return metrics;
+    }
+
+    /**
+     * Number of open connections
+     */
     size_t size() const {
-        return size_;
+        std::lock_guard<std::mutex> lock(mu_);
+        return connections_.size();
+    }
+
+    size_t capacity() const {
+        return pool_config_.max_size;
+    }
+
+    const SqlPoolConfig& config() const {
+        return pool_config_;
     }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Waiter {
+        std::condition_variable cv;
+        SqlConnection* connection = nullptr;
+        bool retry = false;
+    };
+
+    static SqlPoolConfig sizedConfig(size_t size) {
+        SqlPoolConfig config;
+        config.max_size = size;
+        return config;
+    }
+
+    SqlConnection* checkedOut(SqlConnection* connection, Clock::time_point start, AcquireStatus& status) {
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        ++acquired_;
+        total_checkout_latency_ += latency;
+        max_checkout_latency_ = std::max(max_checkout_latency_, latency);
+        status = AcquireStatus::Ok;
+        return connection;
+    }
+
+    void wakeNextWaiter() {
+        if (waiters_.empty()) {
+            return;
+        }
+        Waiter* waiter = waiters_.front();
+        waiters_.pop_front();
+        waiter->retry = true;
+        waiter->cv.notify_one();
+    }
+
+    size_t evictIdleLocked(Clock::time_point now) {
+        // idle_ is used as a stack, so the front holds the least recently used
+        size_t evicted = 0;
+        while (!idle_.empty() && connections_.size() > pool_config_.min_size &&
+               now - idle_.front()->lastActivity() >= pool_config_.idle_timeout) {
+            SqlConnection* conn = idle_.front();
+            idle_.erase(idle_.begin());
+            destroy(conn);
+            ++evicted;
+        }
+        evicted_ += evicted;
+        return evicted;
+    }
+
+    bool untrack(SqlConnection* connection) {
+        auto it = std::find(in_use_.begin(), in_use_.end(), connection);
+        if (it == in_use_.end()) {
+            return false;
+        }
+        *it = in_use_.back();
+        in_use_.pop_back();
+        return true;
+    }
+
+    void destroy(SqlConnection* connection) {
+        auto it = std::find_if(connections_.begin(), connections_.end(),
+                               [connection](const std::unique_ptr<SqlConnection>& owned) {
+                                   return owned.get() == connection;
+                               });
+        if (it != connections_.end()) {
+            connections_.erase(it);
+        }
+    }
+
     SqlConnectionConfig config_;
-    size_t size_;
-    std::vector<std::unique_ptr<SqlConnection>> pool_;
+    SqlPoolConfig pool_config_;
     mutable std::mutex mu_;
+
+    std::vector<std::unique_ptr<SqlConnection>> connections_;
+    // Both hold at most max_size entries and are reserved up front, so
+    // checkout and release never allocate
+    std::vector<SqlConnection*> idle_;
+    std::vector<SqlConnection*> in_use_;
+    std::deque<Waiter*> waiters_;
+    size_t opening_ = 0;
+
+    uint64_t acquired_ = 0;
+    uint64_t waits_ = 0;
+    uint64_t timeouts_ = 0;
+    uint64_t rejected_ = 0;
+    uint64_t created_ = 0;
+    uint64_t evicted_ = 0;
+    uint64_t health_check_failures_ = 0;
+    std::chrono::microseconds total_checkout_latency_{0};
+    std::chrono::microseconds max_checkout_latency_{0};
 };
 
 }
@@ -0,0 +1,194 @@
+/**
+ * @file sql_templates.hpp
+ * @brief Cached SQL statement text and positional, typed bind values
+ *
+ * SQL text for each (operation, field mask) pair is generated once per
+ * adapter, i.e. per dialect, and then reused by reference. Parameters are
+ * bound by position from typed values; string values are borrowed views,
+ * so building a parameter list for a point query does not allocate.
+ */
+#ifndef DBAL_SQL_TEMPLATES_HPP
+#define DBAL_SQL_TEMPLATES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dbal {
+namespace adapters {
+namespace sql {
+
+/**
+ * One positional bind value. Text values point at caller-owned strings
+ * that must outlive the statement execution.
+ */
+class SqlValue {
+public:
+    enum class Kind {
+        Null,
+        Text,
+        Integer,
+        Boolean,
+    };
+
+    SqlValue() = default;
+    SqlValue(std::nullptr_t) {}
+    SqlValue(std::string_view text) : kind_(Kind::Text), text_(text) {}
+    SqlValue(const std::string& text) : kind_(Kind::Text), text_(text) {}
+    SqlValue(const char* text) : kind_(Kind::Text), text_(text) {}
+    SqlValue(int64_t value) : kind_(Kind::Integer), integer_(value) {}
+    SqlValue(int value) : kind_(Kind::Integer), integer_(value) {}
+    SqlValue(bool value) : kind_(Kind::Boolean), integer_(value ? 1 : 0) {}
+
+    static SqlValue fromOptional(const std::optional<std::string>& value) {
+        return value.has_value() ? SqlValue(value.value()) : SqlValue();
+    }
+
+    Kind kind() const {
+        return kind_;
+    }
+
+    bool isNull() const {
+        return kind_ == Kind::Null;
+    }
+
+    std::string_view text() const {
+        return text_;
+    }
+
+    int64_t integer() const {
+        return integer_;
+    }
+
+    bool boolean() const {
+        return integer_ != 0;
+    }
+
+    /**
+     * Text rendering for transports that only speak strings
+     */
+    std::string toString() const {
+        switch (kind_) {
+            case Kind::Text:
+                return std::string(text_);
+            case Kind::Integer:
+                return std::to_string(integer_);
+            case Kind::Boolean:
+                return integer_ ? "1" : "0";
+            default:
+                return std::string();
+        }
+    }
+
+private:
+    Kind kind_ = Kind::Null;
+    std::string_view text_;
+    int64_t integer_ = 0;
+};
+
+/**
+ * Positional parameter list with inline storage for the common case
+ */
+class SqlParams {
+public:
+    static constexpr size_t kInlineCapacity = 12;
+
+    SqlParams() = default;
+
+    SqlParams(std::initializer_list<SqlValue> values) {
+        for (const auto& value : values) {
+            push_back(value);
+        }
+    }
+
+    void push_back(const SqlValue& value) {
+        if (size_ < kInlineCapacity && overflow_.empty()) {
+            inline_[size_++] = value;
+            return;
+        }
+        if (overflow_.empty()) {
+            overflow_.assign(inline_.begin(), inline_.begin() + size_);
+        }
+        overflow_.push_back(value);
+        ++size_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    const SqlValue* begin() const {
+        return overflow_.empty() ? inline_.data() : overflow_.data();
+    }
+
+    const SqlValue* end() const {
+        return begin() + size_;
+    }
+
+    const SqlValue& operator[](size_t index) const {
+        return begin()[index];
+    }
+
+private:
+    std::array<SqlValue, kInlineCapacity> inline_{};
+    std::vector<SqlValue> overflow_;
+    size_t size_ = 0;
+};
+
+enum class SqlOperation : uint32_t {
+    InsertUser,
+    InsertUserReturning,
+    SelectUserById,
+    UpdateUser,
+    DeleteUserById,
+    ListUsers,
+};
+
+/**
+ * SQL text per (operation, field mask), built on first use. Returned
+ * references stay valid for the cache's lifetime.
+ */
+class SqlTemplateCache {
+public:
+    template<typename Build>
+    const std::string& get(SqlOperation operation, uint32_t mask, Build&& build) {
+        const uint64_t key = (static_cast<uint64_t>(operation) << 32) | mask;
+        {
+            std::shared_lock<std::shared_mutex> lock(mu_);
+            auto it = templates_.find(key);
+            if (it != templates_.end()) {
+                return it->second;
+            }
+        }
+        std::string sql = build(mask);
+        std::unique_lock<std::shared_mutex> lock(mu_);
+        return templates_.emplace(key, std::move(sql)).first->second;
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mu_);
+        return templates_.size();
+    }
+
+private:
+    mutable std::shared_mutex mu_;
+    std::unordered_map<uint64_t, std::string> templates_;
+};
+
+}
+}
+}
+
+#endif
@@ -1,194 +1,1404 @@
-#include "dbal/adapters/adapter.hpp"
-#include <string>
-#include <vector>
+#include "sqlite_adapter.hpp"
+
+#include "../../query/cursor/list_cursor.hpp"
+#include "../../validation/entity/package_validation.hpp"
+#include "../../validation/entity/page_validation.hpp"
+#include "../../validation/entity/user_validation.hpp"
+#include "../../validation/entity/workflow_validation.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
 
 namespace dbal {
 namespace adapters {
 namespace sqlite {
 
-class SQLiteAdapter : public Adapter {
+namespace {
+
+const char* const kSchema = R"SQL(
+CREATE TABLE IF NOT EXISTS users (
+    id TEXT PRIMARY KEY,
+    tenantId TEXT,
+    username TEXT NOT NULL,
+    email TEXT NOT NULL,
+    role TEXT NOT NULL,
+    profilePicture TEXT,
+    bio TEXT,
+    createdAt INTEGER NOT NULL,
+    isInstanceOwner INTEGER NOT NULL DEFAULT 0,
+    passwordChangeTimestamp INTEGER,
+    firstLogin INTEGER NOT NULL DEFAULT 0
+);
+CREATE UNIQUE INDEX IF NOT EXISTS users_tenant_username ON users(IFNULL(tenantId, ''), username);
+CREATE UNIQUE INDEX IF NOT EXISTS users_tenant_email ON users(IFNULL(tenantId, ''), email);
+CREATE INDEX IF NOT EXISTS users_tenant ON users(tenantId, id);
+CREATE INDEX IF NOT EXISTS users_role ON users(role, id);
+CREATE INDEX IF NOT EXISTS users_username ON users(username, id);
+
+CREATE TABLE IF NOT EXISTS pages (
+    id TEXT PRIMARY KEY,
+    tenantId TEXT,
+    packageId TEXT,
+    path TEXT NOT NULL UNIQUE,
+    title TEXT NOT NULL,
+    description TEXT,
+    icon TEXT,
+    component TEXT,
+    componentTree TEXT NOT NULL,
+    level INTEGER NOT NULL,
+    requiresAuth INTEGER NOT NULL,
+    requiredRole TEXT,
+    parentPath TEXT,
+    sortOrder INTEGER NOT NULL DEFAULT 0,
+    isPublished INTEGER NOT NULL DEFAULT 1,
+    params TEXT,
+    meta TEXT,
+    createdAt INTEGER,
+    updatedAt INTEGER
+);
+CREATE INDEX IF NOT EXISTS pages_tenant ON pages(tenantId, id);
+CREATE INDEX IF NOT EXISTS pages_package ON pages(packageId, id);
+CREATE INDEX IF NOT EXISTS pages_level ON pages(level);
+CREATE INDEX IF NOT EXISTS pages_title ON pages(title, id);
+
+CREATE TABLE IF NOT EXISTS workflows (
+    id TEXT PRIMARY KEY,
+    tenantId TEXT,
+    name TEXT NOT NULL UNIQUE,
+    description TEXT,
+    nodes TEXT NOT NULL,
+    edges TEXT NOT NULL,
+    enabled INTEGER NOT NULL,
+    version INTEGER NOT NULL DEFAULT 1,
+    createdAt INTEGER,
+    updatedAt INTEGER,
+    createdBy TEXT
+);
+CREATE INDEX IF NOT EXISTS workflows_tenant ON workflows(tenantId, id);
+
+CREATE TABLE IF NOT EXISTS sessions (
+    id TEXT PRIMARY KEY,
+    userId TEXT NOT NULL REFERENCES users(id) ON DELETE CASCADE,
+    token TEXT NOT NULL UNIQUE,
+    expiresAt INTEGER NOT NULL,
+    createdAt INTEGER NOT NULL,
+    lastActivity INTEGER NOT NULL,
+    ipAddress TEXT,
+    userAgent TEXT
+);
+CREATE INDEX IF NOT EXISTS sessions_user ON sessions(userId);
+CREATE INDEX IF NOT EXISTS sessions_expires ON sessions(expiresAt);
+
+CREATE TABLE IF NOT EXISTS packages (
+    packageId TEXT PRIMARY KEY,
+    tenantId TEXT,
+    installedAt INTEGER NOT NULL,
+    version TEXT NOT NULL,
+    enabled INTEGER NOT NULL,
+    config TEXT
+);
+CREATE INDEX IF NOT EXISTS packages_tenant ON packages(tenantId, packageId);
+)SQL";
+
+const std::string kUserColumns =
+    "id, tenantId, username, email, role, profilePicture, bio, createdAt, isInstanceOwner, "
+    "passwordChangeTimestamp, firstLogin";
+const std::string kPageColumns =
+    "id, tenantId, packageId, path, title, description, icon, component, componentTree, level, "
+    "requiresAuth, requiredRole, parentPath, sortOrder, isPublished, params, meta, createdAt, updatedAt";
+const std::string kWorkflowColumns =
+    "id, tenantId, name, description, nodes, edges, enabled, version, createdAt, updatedAt, createdBy";
+const std::string kSessionColumns =
+    "id, userId, token, expiresAt, createdAt, lastActivity, ipAddress, userAgent";
+const std::string kPackageColumns = "packageId, tenantId, installedAt, version, enabled, config";
+
+int64_t toMillis(const Timestamp& value) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(value.time_since_epoch()).count();
+}
+
+std::optional<int64_t> toMillis(const std::optional<Timestamp>& value) {
+    if (!value.has_value()) {
+        return std::nullopt;
+    }
+    return toMillis(value.value());
+}
+
+Timestamp fromMillis(int64_t millis) {
+    return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::milliseconds(millis)));
+}
+
+std::optional<Timestamp> fromMillis(const std::optional<int64_t>& millis) {
+    if (!millis.has_value()) {
+        return std::nullopt;
+    }
+    return fromMillis(millis.value());
+}
+
+std::string generateId(const char* prefix) {
+    thread_local std::mt19937_64 rng(std::random_device{}() ^
+                                     std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%s_%016llx", prefix, static_cast<unsigned long long>(rng()));
+    return std::string(buffer);
+}
+
+Error mapError(const SQLiteError& error) {
+    switch (error.code) {
+        case SQLITE_CONSTRAINT_UNIQUE:
+        case SQLITE_CONSTRAINT_PRIMARYKEY:
+            return Error::conflict(error.message);
+        case SQLITE_CONSTRAINT_FOREIGNKEY:
+        case SQLITE_CONSTRAINT_NOTNULL:
+        case SQLITE_CONSTRAINT_CHECK:
+            return Error::validationError(error.message);
+        default:
+            break;
+    }
+    if ((error.code & 0xff) == SQLITE_BUSY || (error.code & 0xff) == SQLITE_LOCKED) {
+        return Error(ErrorCode::Timeout, error.message);
+    }
+    return Error(ErrorCode::DatabaseError, error.message);
+}
+
+/**
+ * BEGIN IMMEDIATE on construction, ROLLBACK unless committed
+ */
+class Transaction {
 public:
-    explicit SQLiteAdapter(const std::string& db_path) : db_path_(db_path) {}
-    
-    ~SQLiteAdapter() override {
-        close();
-    }
-    
-    Result<User> createUser(const CreateUserInput& input) override {
-        // Stub implementation
-        User user;
-        user.id = "user_" + input.username;
-        user.username = input.username;
-        user.email = input.email;
-        user.role = input.role;
-        user.profilePicture = input.profilePicture;
-        user.bio = input.bio;
-        user.createdAt = input.createdAt.value_or(std::chrono::system_clock::now());
-        user.tenantId = input.tenantId;
-        user.isInstanceOwner = input.isInstanceOwner.value_or(false);
-        user.passwordChangeTimestamp = input.passwordChangeTimestamp;
-        user.firstLogin = input.firstLogin.value_or(false);
-        
-        return Result<User>(user);
-    }
-    
-    Result<User> getUser(const std::string& id) override {
+    explicit Transaction(SQLiteConnection& conn) : conn_(conn) {
+        conn_.prepare("BEGIN IMMEDIATE")->step();
+    }
+
+    ~Transaction() {
+        if (!committed_) {
+            try {
+                conn_.prepare("ROLLBACK")->step();
+            } catch (const SQLiteError&) {
+                // Nothing useful to do; the connection stays usable
+            }
+        }
+    }
+
+    void commit() {
+        conn_.prepare("COMMIT")->step();
+        committed_ = true;
+    }
+
+private:
+    SQLiteConnection& conn_;
+    bool committed_ = false;
+};
+
+User readUser(const SQLiteStatement& row) {
+    User user;
+    user.id = row.text(0);
+    user.tenantId = row.optionalText(1);
+    user.username = row.text(2);
+    user.email = row.text(3);
+    user.role = row.text(4);
+    user.profilePicture = row.optionalText(5);
+    user.bio = row.optionalText(6);
+    user.createdAt = fromMillis(row.int64(7));
+    user.isInstanceOwner = row.int64(8) != 0;
+    user.passwordChangeTimestamp = fromMillis(row.optionalInt64(9));
+    user.firstLogin = row.int64(10) != 0;
+    return user;
+}
+
+PageConfig readPage(const SQLiteStatement& row) {
+    PageConfig page;
+    page.id = row.text(0);
+    page.tenantId = row.optionalText(1);
+    page.packageId = row.optionalText(2);
+    page.path = row.text(3);
+    page.title = row.text(4);
+    page.description = row.optionalText(5);
+    page.icon = row.optionalText(6);
+    page.component = row.optionalText(7);
+    page.componentTree = row.text(8);
+    page.level = static_cast<int>(row.int64(9));
+    page.requiresAuth = row.int64(10) != 0;
+    page.requiredRole = row.optionalText(11);
+    page.parentPath = row.optionalText(12);
+    page.sortOrder = static_cast<int>(row.int64(13));
+    page.isPublished = row.int64(14) != 0;
+    page.params = row.optionalText(15);
+    page.meta = row.optionalText(16);
+    page.createdAt = fromMillis(row.optionalInt64(17));
+    page.updatedAt = fromMillis(row.optionalInt64(18));
+    return page;
+}
+
+Workflow readWorkflow(const SQLiteStatement& row) {
+    Workflow workflow;
+    workflow.id = row.text(0);
+    workflow.tenantId = row.optionalText(1);
+    workflow.name = row.text(2);
+    workflow.description = row.optionalText(3);
+    workflow.nodes = row.text(4);
+    workflow.edges = row.text(5);
+    workflow.enabled = row.int64(6) != 0;
+    workflow.version = static_cast<int>(row.int64(7));
+    workflow.createdAt = fromMillis(row.optionalInt64(8));
+    workflow.updatedAt = fromMillis(row.optionalInt64(9));
+    workflow.createdBy = row.optionalText(10);
+    return workflow;
+}
+
+Session readSession(const SQLiteStatement& row) {
+    Session session;
+    session.id = row.text(0);
+    session.userId = row.text(1);
+    session.token = row.text(2);
+    session.expiresAt = fromMillis(row.int64(3));
+    session.createdAt = fromMillis(row.int64(4));
+    session.lastActivity = fromMillis(row.int64(5));
+    session.ipAddress = row.optionalText(6);
+    session.userAgent = row.optionalText(7);
+    return session;
+}
+
+InstalledPackage readPackage(const SQLiteStatement& row) {
+    InstalledPackage package;
+    package.packageId = row.text(0);
+    package.tenantId = row.optionalText(1);
+    package.installedAt = fromMillis(row.int64(2));
+    package.version = row.text(3);
+    package.enabled = row.int64(4) != 0;
+    package.config = row.optionalText(5);
+    return package;
+}
+
+/**
+ * Parameter values collected while building dynamic SQL
+ */
+using Binder = std::function<void(SQLiteStatement&, int)>;
+
+struct SqlBuilder {
+    std::string sql;
+    std::vector<Binder> binders;
+
+    template<typename T>
+    void add(const std::string& fragment, T value) {
+        sql += fragment;
+        binders.push_back([value](SQLiteStatement& statement, int index) { statement.bind(index, value); });
+    }
+
+    void bindAll(SQLiteStatement& statement) const {
+        for (size_t i = 0; i < binders.size(); ++i) {
+            binders[i](statement, static_cast<int>(i + 1));
+        }
+    }
+};
+
+/**
+ * "SET a = ?, b = ?" assembly for partial updates
+ */
+struct SetList {
+    SqlBuilder builder;
+
+    template<typename T>
+    void set(const char* column, const std::optional<T>& value) {
+        if (value.has_value()) {
+            builder.add(std::string(builder.sql.empty() ? "" : ", ") + column + " = ?", value.value());
+        }
+    }
+
+    void setTimestamp(const char* column, const std::optional<Timestamp>& value) {
+        if (value.has_value()) {
+            builder.add(std::string(builder.sql.empty() ? "" : ", ") + column + " = ?",
+                        toMillis(value.value()));
+        }
+    }
+
+    bool empty() const {
+        return builder.sql.empty();
+    }
+};
+
+void appendFilter(SqlBuilder& where, const std::string& condition) {
+    where.sql += where.sql.empty() ? " WHERE " : " AND ";
+    where.sql += condition;
+}
+
+template<typename T>
+void appendFilter(SqlBuilder& where, const std::string& condition, T value) {
+    appendFilter(where, condition);
+    where.binders.push_back([value](SQLiteStatement& statement, int index) { statement.bind(index, value); });
+}
+
+template<typename A, typename B>
+void appendFilter(SqlBuilder& where, const std::string& condition, A first, B second) {
+    appendFilter(where, condition, first);
+    where.binders.push_back([second](SQLiteStatement& statement, int index) { statement.bind(index, second); });
+}
+
+/**
+ * A ListOptions sort field and the column expression it orders by
+ */
+struct SortColumn {
+    const char* field;
+    const char* expression;
+    bool timestamp;
+};
+
+/**
+ * Keyset ordering for a list of T. Orders by the sort column chosen in
+ * options.sort and then by the unique tiebreak column; with a cursor, adds
+ * "(column, tiebreak) > (?, ?)" to where. Returns the ORDER BY clause.
+ */
+template<typename T>
+Result<std::string> applyKeyset(SqlBuilder& where,
+                                const ListOptions& options,
+                                std::initializer_list<SortColumn> columns,
+                                const std::string& tiebreak) {
+    const std::string field = query::sortField<T>(options);
+    auto cursor = query::resolveCursor<T>(options, field);
+    if (cursor.isError()) {
+        return cursor.error();
+    }
+    const SortColumn* column = nullptr;
+    for (const auto& candidate : columns) {
+        if (field == candidate.field) {
+            column = &candidate;
+        }
+    }
+
+    if (cursor.value().has_value()) {
+        const auto& after = cursor.value().value();
+        if (!column) {
+            appendFilter(where, tiebreak + " > ?", after.id);
+        } else if (column->timestamp) {
+            const auto millis = query::parseTimestampKey(after.key);
+            if (!millis.has_value()) {
+                return Error::validationError("Invalid list cursor");
+            }
+            appendFilter(where, "(" + std::string(column->expression) + ", " + tiebreak + ") > (?, ?)",
+                         millis.value(), after.id);
+        } else {
+            appendFilter(where, "(" + std::string(column->expression) + ", " + tiebreak + ") > (?, ?)", after.key,
+                         after.id);
+        }
+    }
+    if (!column) {
+        return Result<std::string>(" ORDER BY " + tiebreak);
+    }
+    return Result<std::string>(" ORDER BY " + std::string(column->expression) + ", " + tiebreak);
+}
+
+void appendPaging(SqlBuilder& query, const ListOptions& options) {
+    const int limit = options.limit > 0 ? options.limit : 20;
+    const int offset = options.cursor.empty() && options.page > 1 ? (options.page - 1) * limit : 0;
+    query.add(" LIMIT ?", static_cast<int64_t>(limit));
+    query.add(" OFFSET ?", static_cast<int64_t>(offset));
+}
+
+template<typename T, typename Reader>
+std::vector<T> readAll(SQLiteConnection& conn, const SqlBuilder& query, Reader read) {
+    auto statement = conn.prepare(query.sql);
+    query.bindAll(*statement);
+    std::vector<T> rows;
+    while (statement->step()) {
+        rows.push_back(read(*statement));
+    }
+    return rows;
+}
+
+template<typename T, typename Reader>
+std::optional<T> readOne(SQLiteConnection& conn, const std::string& sql, const std::string& key, Reader read) {
+    auto statement = conn.prepare(sql);
+    statement->bind(1, key);
+    if (!statement->step()) {
+        return std::nullopt;
+    }
+    return read(*statement);
+}
+
+int execute(SQLiteConnection& conn, const std::string& sql, const std::string& key) {
+    auto statement = conn.prepare(sql);
+    statement->bind(1, key);
+    statement->step();
+    return conn.changes();
+}
+
+} // namespace
+
+SQLiteAdapter::SQLiteAdapter(const std::string& db_path, size_t statement_cache_size)
+    : pool_(std::make_unique<SQLitePool>(db_path, statement_cache_size)) {
+    auto conn = pool_->acquireWriter();
+    conn->exec(kSchema);
+}
+
+SQLiteAdapter::~SQLiteAdapter() {
+    close();
+}
+
+void SQLiteAdapter::close() {
+    pool_.reset();
+}
+
+// ---------------------------------------------------------------------------
+// Users
+// ---------------------------------------------------------------------------
+
+Result<User> SQLiteAdapter::insertUser(SQLiteConnection& conn, const CreateUserInput& input) {
+    if (!validation::isValidUsername(input.username)) {
+        return Error::validationError("Invalid username format (alphanumeric, underscore, hyphen only)");
+    }
+    if (!validation::isValidEmail(input.email)) {
+        return Error::validationError("Invalid email format");
+    }
+
+    User user;
+    user.id = generateId("user");
+    user.tenantId = input.tenantId;
+    user.username = input.username;
+    user.email = input.email;
+    user.role = input.role;
+    user.profilePicture = input.profilePicture;
+    user.bio = input.bio;
+    user.createdAt = input.createdAt.value_or(std::chrono::system_clock::now());
+    user.isInstanceOwner = input.isInstanceOwner.value_or(false);
+    user.passwordChangeTimestamp = input.passwordChangeTimestamp;
+    user.firstLogin = input.firstLogin.value_or(false);
+
+    auto statement = conn.prepare("INSERT INTO users (" + kUserColumns +
+                                  ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    statement->bind(1, user.id);
+    statement->bind(2, user.tenantId);
+    statement->bind(3, user.username);
+    statement->bind(4, user.email);
+    statement->bind(5, user.role);
+    statement->bind(6, user.profilePicture);
+    statement->bind(7, user.bio);
+    statement->bind(8, toMillis(user.createdAt));
+    statement->bind(9, user.isInstanceOwner);
+    statement->bind(10, toMillis(user.passwordChangeTimestamp));
+    statement->bind(11, user.firstLogin);
+    statement->step();
+    return Result<User>(user);
+}
+
+Result<User> SQLiteAdapter::modifyUser(SQLiteConnection& conn, const std::string& id,
+                                       const UpdateUserInput& input) {
+    if (id.empty()) {
+        return Error::validationError("User ID cannot be empty");
+    }
+    if (input.username.has_value() && !validation::isValidUsername(input.username.value())) {
+        return Error::validationError("Invalid username format");
+    }
+    if (input.email.has_value() && !validation::isValidEmail(input.email.value())) {
+        return Error::validationError("Invalid email format");
+    }
+
+    SetList set;
+    set.set("username", input.username);
+    set.set("email", input.email);
+    set.set("role", input.role);
+    set.set("profilePicture", input.profilePicture);
+    set.set("bio", input.bio);
+    set.set("tenantId", input.tenantId);
+    set.set("isInstanceOwner", input.isInstanceOwner);
+    set.setTimestamp("passwordChangeTimestamp", input.passwordChangeTimestamp);
+    set.set("firstLogin", input.firstLogin);
+
+    if (set.empty()) {
+        auto existing = readOne<User>(conn, "SELECT " + kUserColumns + " FROM users WHERE id = ?", id, readUser);
+        if (!existing.has_value()) {
+            return Error::notFound("User not found: " + id);
+        }
+        return Result<User>(existing.value());
+    }
+
+    SqlBuilder query = set.builder;
+    query.sql = "UPDATE users SET " + query.sql;
+    query.add(" WHERE id = ?", id);
+    query.sql += " RETURNING " + kUserColumns;
+    auto rows = readAll<User>(conn, query, readUser);
+    if (rows.empty()) {
         return Error::notFound("User not found: " + id);
     }
-    
-    Result<User> updateUser(const std::string& id, const UpdateUserInput& input) override {
+    return Result<User>(rows.front());
+}
+
+Result<bool> SQLiteAdapter::removeUser(SQLiteConnection& conn, const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("User ID cannot be empty");
+    }
+    if (execute(conn, "DELETE FROM users WHERE id = ?", id) == 0) {
         return Error::notFound("User not found: " + id);
     }
-    
-    Result<bool> deleteUser(const std::string& id) override {
-        return Result<bool>(true);
+    return Result<bool>(true);
+}
+
+Result<User> SQLiteAdapter::createUser(const CreateUserInput& input) {
+    try {
+        auto conn = pool_->acquireWriter();
+        return insertUser(*conn, input);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<User> SQLiteAdapter::getUser(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("User ID cannot be empty");
+    }
+    try {
+        auto conn = pool_->acquireReader();
+        auto user = readOne<User>(*conn, "SELECT " + kUserColumns + " FROM users WHERE id = ?", id, readUser);
+        if (!user.has_value()) {
+            return Error::notFound("User not found: " + id);
+        }
+        return Result<User>(user.value());
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<User> SQLiteAdapter::updateUser(const std::string& id, const UpdateUserInput& input) {
+    try {
+        auto conn = pool_->acquireWriter();
+        return modifyUser(*conn, id, input);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<bool> SQLiteAdapter::deleteUser(const std::string& id) {
+    try {
+        auto conn = pool_->acquireWriter();
+        return removeUser(*conn, id);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<std::vector<User>> SQLiteAdapter::listUsers(const ListOptions& options) {
+    SqlBuilder query;
+    query.sql = "SELECT " + kUserColumns + " FROM users";
+    SqlBuilder where;
+    auto tenant = options.filter.find("tenantId");
+    if (tenant != options.filter.end()) {
+        appendFilter(where, "tenantId = ?", tenant->second);
+    }
+    auto role = options.filter.find("role");
+    if (role != options.filter.end()) {
+        appendFilter(where, "role = ?", role->second);
+    }
+    auto order = applyKeyset<User>(where, options, {{"username", "username", false}}, "id");
+    if (order.isError()) {
+        return order.error();
+    }
+    query.sql += where.sql;
+    query.binders = where.binders;
+    query.sql += order.value();
+    appendPaging(query, options);
+
+    try {
+        auto conn = pool_->acquireReader();
+        return Result<std::vector<User>>(readAll<User>(*conn, query, readUser));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<int> SQLiteAdapter::batchCreateUsers(const std::vector<CreateUserInput>& inputs) {
+    if (inputs.empty()) {
+        return Result<int>(0);
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        Transaction tx(*conn);
+        for (const auto& input : inputs) {
+            auto result = insertUser(*conn, input);
+            if (result.isError()) {
+                return result.error();
+            }
+        }
+        tx.commit();
+        return Result<int>(static_cast<int>(inputs.size()));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
-    
-    Result<std::vector<User>> listUsers(const ListOptions& options) override {
-        std::vector<User> users;
-        return Result<std::vector<User>>(users);
-    }
-    
-    Result<PageConfig> createPage(const CreatePageInput& input) override {
-        PageConfig page;
-        page.id = "page_" + input.path;
-        page.tenantId = input.tenantId;
-        page.packageId = input.packageId;
-        page.path = input.path;
-        page.title = input.title;
-        page.description = input.description;
-        page.icon = input.icon;
-        page.component = input.component;
-        page.componentTree = input.componentTree;
-        page.level = input.level;
-        page.requiresAuth = input.requiresAuth;
-        page.requiredRole = input.requiredRole;
-        page.parentPath = input.parentPath;
-        page.sortOrder = input.sortOrder;
-        page.isPublished = input.isPublished;
-        page.params = input.params;
-        page.meta = input.meta;
-        page.createdAt = std::chrono::system_clock::now();
-        
+}
+
+Result<int> SQLiteAdapter::batchUpdateUsers(const std::vector<UpdateUserBatchItem>& updates) {
+    if (updates.empty()) {
+        return Result<int>(0);
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        Transaction tx(*conn);
+        for (const auto& item : updates) {
+            auto result = modifyUser(*conn, item.id, item.data);
+            if (result.isError()) {
+                return result.error();
+            }
+        }
+        tx.commit();
+        return Result<int>(static_cast<int>(updates.size()));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<int> SQLiteAdapter::batchDeleteUsers(const std::vector<std::string>& ids) {
+    if (ids.empty()) {
+        return Result<int>(0);
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        Transaction tx(*conn);
+        for (const auto& id : ids) {
+            auto result = removeUser(*conn, id);
+            if (result.isError()) {
+                return result.error();
+            }
+        }
+        tx.commit();
+        return Result<int>(static_cast<int>(ids.size()));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Pages
+// ---------------------------------------------------------------------------
+
+Result<PageConfig> SQLiteAdapter::createPage(const CreatePageInput& input) {
+    if (!validation::isValidPath(input.path)) {
+        return Error::validationError("Invalid path format");
+    }
+    if (input.title.empty() || input.title.length() > 255) {
+        return Error::validationError("Title must be between 1 and 255 characters");
+    }
+    if (input.level < 1 || input.level > 6) {
+        return Error::validationError("Level must be between 1 and 6");
+    }
+
+    PageConfig page;
+    page.id = generateId("page");
+    page.tenantId = input.tenantId;
+    page.packageId = input.packageId;
+    page.path = input.path;
+    page.title = input.title;
+    page.description = input.description;
+    page.icon = input.icon;
+    page.component = input.component;
+    page.componentTree = input.componentTree;
+    page.level = input.level;
+    page.requiresAuth = input.requiresAuth;
+    page.requiredRole = input.requiredRole;
+    page.parentPath = input.parentPath;
+    page.sortOrder = input.sortOrder;
+    page.isPublished = input.isPublished;
+    page.params = input.params;
+    page.meta = input.meta;
+    page.createdAt = std::chrono::system_clock::now();
+
+    try {
+        auto conn = pool_->acquireWriter();
+        auto statement = conn->prepare("INSERT INTO pages (" + kPageColumns +
+                                       ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        statement->bind(1, page.id);
+        statement->bind(2, page.tenantId);
+        statement->bind(3, page.packageId);
+        statement->bind(4, page.path);
+        statement->bind(5, page.title);
+        statement->bind(6, page.description);
+        statement->bind(7, page.icon);
+        statement->bind(8, page.component);
+        statement->bind(9, page.componentTree);
+        statement->bind(10, page.level);
+        statement->bind(11, page.requiresAuth);
+        statement->bind(12, page.requiredRole);
+        statement->bind(13, page.parentPath);
+        statement->bind(14, page.sortOrder);
+        statement->bind(15, page.isPublished);
+        statement->bind(16, page.params);
+        statement->bind(17, page.meta);
+        statement->bind(18, toMillis(page.createdAt));
+        statement->bind(19, toMillis(page.updatedAt));
+        statement->step();
         return Result<PageConfig>(page);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
-    
-    Result<PageConfig> getPage(const std::string& id) override {
-        return Error::notFound("Page not found: " + id);
+}
+
+Result<PageConfig> SQLiteAdapter::getPage(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Page ID cannot be empty");
+    }
+    try {
+        auto conn = pool_->acquireReader();
+        auto page = readOne<PageConfig>(*conn, "SELECT " + kPageColumns + " FROM pages WHERE id = ?", id, readPage);
+        if (!page.has_value()) {
+            return Error::notFound("Page not found: " + id);
+        }
+        return Result<PageConfig>(page.value());
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<PageConfig> SQLiteAdapter::updatePage(const std::string& id, const UpdatePageInput& input) {
+    if (id.empty()) {
+        return Error::validationError("Page ID cannot be empty");
+    }
+    if (input.path.has_value() && !validation::isValidPath(input.path.value())) {
+        return Error::validationError("Invalid path format");
+    }
+    if (input.title.has_value() && (input.title.value().empty() || input.title.value().length() > 255)) {
+        return Error::validationError("Title must be between 1 and 255 characters");
+    }
+    if (input.level.has_value() && (input.level.value() < 1 || input.level.value() > 6)) {
+        return Error::validationError("Level must be between 1 and 6");
     }
-    
-    Result<PageConfig> updatePage(const std::string& id, const UpdatePageInput& input) override {
-        return Error::notFound("Page not found: " + id);
+
+    SetList set;
+    set.set("tenantId", input.tenantId);
+    set.set("packageId", input.packageId);
+    set.set("path", input.path);
+    set.set("title", input.title);
+    set.set("description", input.description);
+    set.set("icon", input.icon);
+    set.set("component", input.component);
+    set.set("componentTree", input.componentTree);
+    set.set("level", input.level);
+    set.set("requiresAuth", input.requiresAuth);
+    set.set("requiredRole", input.requiredRole);
+    set.set("parentPath", input.parentPath);
+    set.set("sortOrder", input.sortOrder);
+    set.set("isPublished", input.isPublished);
+    set.set("params", input.params);
+    set.set("meta", input.meta);
+    set.setTimestamp("updatedAt", std::optional<Timestamp>(std::chrono::system_clock::now()));
+
+    SqlBuilder query = set.builder;
+    query.sql = "UPDATE pages SET " + query.sql;
+    query.add(" WHERE id = ?", id);
+    query.sql += " RETURNING " + kPageColumns;
+
+    try {
+        auto conn = pool_->acquireWriter();
+        auto rows = readAll<PageConfig>(*conn, query, readPage);
+        if (rows.empty()) {
+            return Error::notFound("Page not found: " + id);
+        }
+        return Result<PageConfig>(rows.front());
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<bool> SQLiteAdapter::deletePage(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Page ID cannot be empty");
     }
-    
-    Result<bool> deletePage(const std::string& id) override {
+    try {
+        auto conn = pool_->acquireWriter();
+        if (execute(*conn, "DELETE FROM pages WHERE id = ?", id) == 0) {
+            return Error::notFound("Page not found: " + id);
+        }
         return Result<bool>(true);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<std::vector<PageConfig>> SQLiteAdapter::listPages(const ListOptions& options) {
+    SqlBuilder query;
+    query.sql = "SELECT " + kPageColumns + " FROM pages";
+    SqlBuilder where;
+    auto it = options.filter.find("isPublished");
+    if (it != options.filter.end()) {
+        appendFilter(where, "isPublished = ?", it->second == "true");
+    }
+    it = options.filter.find("level");
+    if (it != options.filter.end()) {
+        try {
+            appendFilter(where, "level = ?", static_cast<int64_t>(std::stoi(it->second)));
+        } catch (const std::exception&) {
+            return Error::validationError("level filter must be an integer");
+        }
+    }
+    it = options.filter.find("tenantId");
+    if (it != options.filter.end()) {
+        appendFilter(where, "tenantId = ?", it->second);
+    }
+    it = options.filter.find("packageId");
+    if (it != options.filter.end()) {
+        appendFilter(where, "packageId = ?", it->second);
+    }
+    auto order = applyKeyset<PageConfig>(
+        where, options, {{"title", "title", false}, {"createdAt", "IFNULL(createdAt, 0)", true}}, "id");
+    if (order.isError()) {
+        return order.error();
     }
-    
-    Result<std::vector<PageConfig>> listPages(const ListOptions& options) override {
-        std::vector<PageConfig> pages;
-        return Result<std::vector<PageConfig>>(pages);
-    }
-
-    Result<Workflow> createWorkflow(const CreateWorkflowInput& input) override {
-        Workflow workflow;
-        workflow.id = "workflow_" + input.name;
-        workflow.tenantId = input.tenantId;
-        workflow.name = input.name;
-        workflow.description = input.description;
-        workflow.nodes = input.nodes;
-        workflow.edges = input.edges;
-        workflow.enabled = input.enabled;
-        workflow.version = input.version;
-        workflow.createdBy = input.createdBy;
-        workflow.createdAt = input.createdAt.value_or(std::chrono::system_clock::now());
-        workflow.updatedAt = input.updatedAt;
+    query.sql += where.sql;
+    query.binders = where.binders;
+    query.sql += order.value();
+    appendPaging(query, options);
+
+    try {
+        auto conn = pool_->acquireReader();
+        return Result<std::vector<PageConfig>>(readAll<PageConfig>(*conn, query, readPage));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Workflows
+// ---------------------------------------------------------------------------
 
+Result<Workflow> SQLiteAdapter::createWorkflow(const CreateWorkflowInput& input) {
+    if (!validation::isValidWorkflowName(input.name)) {
+        return Error::validationError("Workflow name must be 1-255 characters");
+    }
+
+    Workflow workflow;
+    workflow.id = generateId("workflow");
+    workflow.tenantId = input.tenantId;
+    workflow.name = input.name;
+    workflow.description = input.description;
+    workflow.nodes = input.nodes;
+    workflow.edges = input.edges;
+    workflow.enabled = input.enabled;
+    workflow.version = input.version;
+    workflow.createdAt = input.createdAt.value_or(std::chrono::system_clock::now());
+    workflow.updatedAt = input.updatedAt;
+    workflow.createdBy = input.createdBy;
+
+    try {
+        auto conn = pool_->acquireWriter();
+        auto statement = conn->prepare("INSERT INTO workflows (" + kWorkflowColumns +
+                                       ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        statement->bind(1, workflow.id);
+        statement->bind(2, workflow.tenantId);
+        statement->bind(3, workflow.name);
+        statement->bind(4, workflow.description);
+        statement->bind(5, workflow.nodes);
+        statement->bind(6, workflow.edges);
+        statement->bind(7, workflow.enabled);
+        statement->bind(8, workflow.version);
+        statement->bind(9, toMillis(workflow.createdAt));
+        statement->bind(10, toMillis(workflow.updatedAt));
+        statement->bind(11, workflow.createdBy);
+        statement->step();
         return Result<Workflow>(workflow);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
+}
 
-    Result<Workflow> getWorkflow(const std::string& id) override {
-        return Error::notFound("Workflow not found: " + id);
+Result<Workflow> SQLiteAdapter::getWorkflow(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Workflow ID cannot be empty");
     }
+    try {
+        auto conn = pool_->acquireReader();
+        auto workflow = readOne<Workflow>(*conn, "SELECT " + kWorkflowColumns + " FROM workflows WHERE id = ?",
+                                          id, readWorkflow);
+        if (!workflow.has_value()) {
+            return Error::notFound("Workflow not found: " + id);
+        }
+        return Result<Workflow>(workflow.value());
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
 
-    Result<Workflow> updateWorkflow(const std::string& id, const UpdateWorkflowInput& input) override {
-        return Error::notFound("Workflow not found: " + id);
+Result<Workflow> SQLiteAdapter::updateWorkflow(const std::string& id, const UpdateWorkflowInput& input) {
+    if (id.empty()) {
+        return Error::validationError("Workflow ID cannot be empty");
     }
+    if (input.name.has_value() && !validation::isValidWorkflowName(input.name.value())) {
+        return Error::validationError("Workflow name must be 1-255 characters");
+    }
+
+    SetList set;
+    set.set("tenantId", input.tenantId);
+    set.set("name", input.name);
+    set.set("description", input.description);
+    set.set("nodes", input.nodes);
+    set.set("edges", input.edges);
+    set.set("enabled", input.enabled);
+    set.set("version", input.version);
+    set.setTimestamp("createdAt", input.createdAt);
+    set.setTimestamp("updatedAt", input.updatedAt);
+    set.set("createdBy", input.createdBy);
 
-    Result<bool> deleteWorkflow(const std::string& id) override {
+    try {
+        auto conn = pool_->acquireWriter();
+        if (set.empty()) {
+            auto existing = readOne<Workflow>(*conn, "SELECT " + kWorkflowColumns + " FROM workflows WHERE id = ?",
+                                              id, readWorkflow);
+            if (!existing.has_value()) {
+                return Error::notFound("Workflow not found: " + id);
+            }
+            return Result<Workflow>(existing.value());
+        }
+
+        SqlBuilder query = set.builder;
+        query.sql = "UPDATE workflows SET " + query.sql;
+        query.add(" WHERE id = ?", id);
+        query.sql += " RETURNING " + kWorkflowColumns;
+        auto rows = readAll<Workflow>(*conn, query, readWorkflow);
+        if (rows.empty()) {
+            return Error::notFound("Workflow not found: " + id);
+        }
+        return Result<Workflow>(rows.front());
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<bool> SQLiteAdapter::deleteWorkflow(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Workflow ID cannot be empty");
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        if (execute(*conn, "DELETE FROM workflows WHERE id = ?", id) == 0) {
+            return Error::notFound("Workflow not found: " + id);
+        }
         return Result<bool>(true);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<std::vector<Workflow>> SQLiteAdapter::listWorkflows(const ListOptions& options) {
+    SqlBuilder query;
+    query.sql = "SELECT " + kWorkflowColumns + " FROM workflows";
+    SqlBuilder where;
+    auto it = options.filter.find("enabled");
+    if (it != options.filter.end()) {
+        appendFilter(where, "enabled = ?", it->second == "true");
     }
+    it = options.filter.find("tenantId");
+    if (it != options.filter.end()) {
+        appendFilter(where, "tenantId = ?", it->second);
+    }
+    it = options.filter.find("createdBy");
+    if (it != options.filter.end()) {
+        appendFilter(where, "createdBy = ?", it->second);
+    }
+    auto order = applyKeyset<Workflow>(
+        where, options, {{"name", "name", false}, {"createdAt", "IFNULL(createdAt, 0)", true}}, "id");
+    if (order.isError()) {
+        return order.error();
+    }
+    query.sql += where.sql;
+    query.binders = where.binders;
+    query.sql += order.value();
+    appendPaging(query, options);
+
+    try {
+        auto conn = pool_->acquireReader();
+        return Result<std::vector<Workflow>>(readAll<Workflow>(*conn, query, readWorkflow));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
 
-    Result<std::vector<Workflow>> listWorkflows(const ListOptions& options) override {
-        std::vector<Workflow> workflows;
-        return Result<std::vector<Workflow>>(workflows);
+// ---------------------------------------------------------------------------
+// Sessions
+// ---------------------------------------------------------------------------
+
+Result<Session> SQLiteAdapter::createSession(const CreateSessionInput& input) {
+    if (input.userId.empty()) {
+        return Error::validationError("userId is required");
+    }
+    if (input.token.empty()) {
+        return Error::validationError("token is required");
     }
 
-    Result<Session> createSession(const CreateSessionInput& input) override {
-        Session session;
-        session.id = "session_" + input.userId;
-        session.userId = input.userId;
-        session.token = input.token;
-        session.expiresAt = input.expiresAt;
-        session.createdAt = input.createdAt.value_or(std::chrono::system_clock::now());
-        session.lastActivity = input.lastActivity.value_or(session.createdAt);
-        session.ipAddress = input.ipAddress;
-        session.userAgent = input.userAgent;
+    Session session;
+    session.id = generateId("session");
+    session.userId = input.userId;
+    session.token = input.token;
+    session.expiresAt = input.expiresAt;
+    session.createdAt = input.createdAt.value_or(std::chrono::system_clock::now());
+    session.lastActivity = input.lastActivity.value_or(session.createdAt);
+    session.ipAddress = input.ipAddress;
+    session.userAgent = input.userAgent;
+
+    try {
+        auto conn = pool_->acquireWriter();
+        auto statement = conn->prepare("INSERT INTO sessions (" + kSessionColumns +
+                                       ") VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+        statement->bind(1, session.id);
+        statement->bind(2, session.userId);
+        statement->bind(3, session.token);
+        statement->bind(4, toMillis(session.expiresAt));
+        statement->bind(5, toMillis(session.createdAt));
+        statement->bind(6, toMillis(session.lastActivity));
+        statement->bind(7, session.ipAddress);
+        statement->bind(8, session.userAgent);
+        statement->step();
         return Result<Session>(session);
+    } catch (const SQLiteError& err) {
+        if (err.code == SQLITE_CONSTRAINT_FOREIGNKEY) {
+            return Error::validationError("User not found: " + input.userId);
+        }
+        return mapError(err);
     }
+}
 
-    Result<Session> getSession(const std::string& id) override {
-        return Error::notFound("Session not found: " + id);
+Result<Session> SQLiteAdapter::getSession(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Session ID cannot be empty");
+    }
+    try {
+        std::optional<Session> session;
+        {
+            auto conn = pool_->acquireReader();
+            session = readOne<Session>(*conn, "SELECT " + kSessionColumns + " FROM sessions WHERE id = ?",
+                                       id, readSession);
+        }
+        if (!session.has_value()) {
+            return Error::notFound("Session not found: " + id);
+        }
+        const auto now = std::chrono::system_clock::now();
+        if (session->expiresAt <= now) {
+            // Only while still expired: a touch since the read may have renewed it
+            auto conn = pool_->acquireWriter();
+            auto statement = conn->prepare("DELETE FROM sessions WHERE id = ? AND expiresAt <= ?");
+            statement->bind(1, id);
+            statement->bind(2, toMillis(now));
+            statement->step();
+            return Error::notFound("Session expired: " + id);
+        }
+        return Result<Session>(session.value());
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
+}
 
-    Result<Session> updateSession(const std::string& id, const UpdateSessionInput& input) override {
-        return Error::notFound("Session not found: " + id);
+Result<Session> SQLiteAdapter::updateSession(const std::string& id, const UpdateSessionInput& input) {
+    if (id.empty()) {
+        return Error::validationError("Session ID cannot be empty");
+    }
+    if (input.userId.has_value() && input.userId.value().empty()) {
+        return Error::validationError("userId is required");
     }
+    if (input.token.has_value() && input.token.value().empty()) {
+        return Error::validationError("token is required");
+    }
+
+    SetList set;
+    set.set("userId", input.userId);
+    set.set("token", input.token);
+    set.setTimestamp("expiresAt", input.expiresAt);
+    set.setTimestamp("lastActivity", input.lastActivity);
+    set.set("ipAddress", input.ipAddress);
+    set.set("userAgent", input.userAgent);
 
-    Result<bool> deleteSession(const std::string& id) override {
+    try {
+        auto conn = pool_->acquireWriter();
+        if (set.empty()) {
+            auto existing = readOne<Session>(*conn, "SELECT " + kSessionColumns + " FROM sessions WHERE id = ?",
+                                             id, readSession);
+            if (!existing.has_value()) {
+                return Error::notFound("Session not found: " + id);
+            }
+            return Result<Session>(existing.value());
+        }
+
+        SqlBuilder query = set.builder;
+        query.sql = "UPDATE sessions SET " + query.sql;
+        query.add(" WHERE id = ?", id);
+        query.sql += " RETURNING " + kSessionColumns;
+        auto rows = readAll<Session>(*conn, query, readSession);
+        if (rows.empty()) {
+            return Error::notFound("Session not found: " + id);
+        }
+        return Result<Session>(rows.front());
+    } catch (const SQLiteError& err) {
+        if (err.code == SQLITE_CONSTRAINT_FOREIGNKEY) {
+            return Error::validationError("User not found: " + input.userId.value_or(""));
+        }
+        return mapError(err);
+    }
+}
+
+Result<bool> SQLiteAdapter::deleteSession(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Session ID cannot be empty");
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        if (execute(*conn, "DELETE FROM sessions WHERE id = ?", id) == 0) {
+            return Error::notFound("Session not found: " + id);
+        }
         return Result<bool>(true);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
+}
 
-    Result<std::vector<Session>> listSessions(const ListOptions& options) override {
-        std::vector<Session> sessions;
-        return Result<std::vector<Session>>(sessions);
+Result<std::vector<Session>> SQLiteAdapter::listSessions(const ListOptions& options) {
+    SqlBuilder query;
+    query.sql = "SELECT " + kSessionColumns + " FROM sessions";
+    SqlBuilder where;
+    appendFilter(where, "expiresAt > ?", toMillis(std::chrono::system_clock::now()));
+    auto it = options.filter.find("userId");
+    if (it != options.filter.end()) {
+        appendFilter(where, "userId = ?", it->second);
     }
+    it = options.filter.find("token");
+    if (it != options.filter.end()) {
+        appendFilter(where, "token = ?", it->second);
+    }
+    auto order = applyKeyset<Session>(
+        where, options, {{"createdAt", "createdAt", true}, {"expiresAt", "expiresAt", true}}, "id");
+    if (order.isError()) {
+        return order.error();
+    }
+    query.sql += where.sql;
+    query.binders = where.binders;
+    query.sql += order.value();
+    appendPaging(query, options);
 
-    Result<InstalledPackage> createPackage(const CreatePackageInput& input) override {
-        InstalledPackage package;
-        package.packageId = input.packageId;
-        package.tenantId = input.tenantId;
-        package.installedAt = input.installedAt.value_or(std::chrono::system_clock::now());
-        package.version = input.version;
-        package.enabled = input.enabled;
-        package.config = input.config;
-        return Result<InstalledPackage>(package);
+    try {
+        auto conn = pool_->acquireReader();
+        return Result<std::vector<Session>>(readAll<Session>(*conn, query, readSession));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
+}
+
+// ---------------------------------------------------------------------------
+// Packages
+// ---------------------------------------------------------------------------
 
-    Result<InstalledPackage> getPackage(const std::string& id) override {
+Result<InstalledPackage> SQLiteAdapter::insertPackage(SQLiteConnection& conn, const CreatePackageInput& input) {
+    if (!validation::isValidPackageId(input.packageId)) {
+        return Error::validationError("Package ID must be 1-255 characters");
+    }
+    if (!validation::isValidSemver(input.version)) {
+        return Error::validationError("Version must be valid semver");
+    }
+
+    InstalledPackage package;
+    package.packageId = input.packageId;
+    package.tenantId = input.tenantId;
+    package.installedAt = input.installedAt.value_or(std::chrono::system_clock::now());
+    package.version = input.version;
+    package.enabled = input.enabled;
+    package.config = input.config;
+
+    auto statement = conn.prepare("INSERT INTO packages (" + kPackageColumns + ") VALUES (?, ?, ?, ?, ?, ?)");
+    statement->bind(1, package.packageId);
+    statement->bind(2, package.tenantId);
+    statement->bind(3, toMillis(package.installedAt));
+    statement->bind(4, package.version);
+    statement->bind(5, package.enabled);
+    statement->bind(6, package.config);
+    try {
+        statement->step();
+    } catch (const SQLiteError& err) {
+        if (err.code == SQLITE_CONSTRAINT_PRIMARYKEY) {
+            return Error::conflict("Package ID already exists: " + validation::packageKey(input.packageId));
+        }
+        throw;
+    }
+    return Result<InstalledPackage>(package);
+}
+
+Result<InstalledPackage> SQLiteAdapter::modifyPackage(SQLiteConnection& conn, const std::string& id,
+                                                      const UpdatePackageInput& input) {
+    if (id.empty()) {
+        return Error::validationError("Package ID cannot be empty");
+    }
+    if (input.version.has_value() && !validation::isValidSemver(input.version.value())) {
+        return Error::validationError("Version must be valid semver");
+    }
+
+    SetList set;
+    set.set("tenantId", input.tenantId);
+    set.setTimestamp("installedAt", input.installedAt);
+    set.set("version", input.version);
+    set.set("enabled", input.enabled);
+    set.set("config", input.config);
+
+    if (set.empty()) {
+        auto existing = readOne<InstalledPackage>(
+            conn, "SELECT " + kPackageColumns + " FROM packages WHERE packageId = ?", id, readPackage);
+        if (!existing.has_value()) {
+            return Error::notFound("Package not found: " + id);
+        }
+        return Result<InstalledPackage>(existing.value());
+    }
+
+    SqlBuilder query = set.builder;
+    query.sql = "UPDATE packages SET " + query.sql;
+    query.add(" WHERE packageId = ?", id);
+    query.sql += " RETURNING " + kPackageColumns;
+    auto rows = readAll<InstalledPackage>(conn, query, readPackage);
+    if (rows.empty()) {
         return Error::notFound("Package not found: " + id);
     }
+    return Result<InstalledPackage>(rows.front());
+}
 
-    Result<InstalledPackage> updatePackage(const std::string& id, const UpdatePackageInput& input) override {
+Result<bool> SQLiteAdapter::removePackage(SQLiteConnection& conn, const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Package ID cannot be empty");
+    }
+    if (execute(conn, "DELETE FROM packages WHERE packageId = ?", id) == 0) {
         return Error::notFound("Package not found: " + id);
     }
+    return Result<bool>(true);
+}
 
-    Result<bool> deletePackage(const std::string& id) override {
-        return Result<bool>(true);
+Result<InstalledPackage> SQLiteAdapter::createPackage(const CreatePackageInput& input) {
+    try {
+        auto conn = pool_->acquireWriter();
+        return insertPackage(*conn, input);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
+}
 
-    Result<std::vector<InstalledPackage>> listPackages(const ListOptions& options) override {
-        std::vector<InstalledPackage> packages;
-        return Result<std::vector<InstalledPackage>>(packages);
+Result<InstalledPackage> SQLiteAdapter::getPackage(const std::string& id) {
+    if (id.empty()) {
+        return Error::validationError("Package ID cannot be empty");
     }
-    
-    void close() override {
-        // Cleanup
+    try {
+        auto conn = pool_->acquireReader();
+        auto package = readOne<InstalledPackage>(
+            *conn, "SELECT " + kPackageColumns + " FROM packages WHERE packageId = ?", id, readPackage);
+        if (!package.has_value()) {
+            return Error::notFound("Package not found: " + id);
+        }
+        return Result<InstalledPackage>(package.value());
+    } catch (const SQLiteError& err) {
+        return mapError(err);
     }
-    
-private:
-    std::string db_path_;
-};
+}
+
+Result<InstalledPackage> SQLiteAdapter::updatePackage(const std::string& id, const UpdatePackageInput& input) {
+    try {
+        auto conn = pool_->acquireWriter();
+        return modifyPackage(*conn, id, input);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<bool> SQLiteAdapter::deletePackage(const std::string& id) {
+    try {
+        auto conn = pool_->acquireWriter();
+        return removePackage(*conn, id);
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<std::vector<InstalledPackage>> SQLiteAdapter::listPackages(const ListOptions& options) {
+    SqlBuilder query;
+    query.sql = "SELECT " + kPackageColumns + " FROM packages";
+    SqlBuilder where;
+    auto it = options.filter.find("packageId");
+    if (it != options.filter.end()) {
+        appendFilter(where, "packageId = ?", it->second);
+    }
+    it = options.filter.find("version");
+    if (it != options.filter.end()) {
+        appendFilter(where, "version = ?", it->second);
+    }
+    it = options.filter.find("tenantId");
+    if (it != options.filter.end()) {
+        appendFilter(where, "tenantId = ?", it->second);
+    }
+    it = options.filter.find("enabled");
+    if (it != options.filter.end()) {
+        appendFilter(where, "enabled = ?", it->second == "true");
+    }
+    auto order = applyKeyset<InstalledPackage>(where, options, {{"installedAt", "installedAt", true}}, "packageId");
+    if (order.isError()) {
+        return order.error();
+    }
+    query.sql += where.sql;
+    query.binders = where.binders;
+    query.sql += order.value();
+    appendPaging(query, options);
+
+    try {
+        auto conn = pool_->acquireReader();
+        return Result<std::vector<InstalledPackage>>(readAll<InstalledPackage>(*conn, query, readPackage));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<int> SQLiteAdapter::batchCreatePackages(const std::vector<CreatePackageInput>& inputs) {
+    if (inputs.empty()) {
+        return Result<int>(0);
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        Transaction tx(*conn);
+        for (const auto& input : inputs) {
+            auto result = insertPackage(*conn, input);
+            if (result.isError()) {
+                return result.error();
+            }
+        }
+        tx.commit();
+        return Result<int>(static_cast<int>(inputs.size()));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<int> SQLiteAdapter::batchUpdatePackages(const std::vector<UpdatePackageBatchItem>& updates) {
+    if (updates.empty()) {
+        return Result<int>(0);
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        Transaction tx(*conn);
+        for (const auto& item : updates) {
+            auto result = modifyPackage(*conn, item.id, item.data);
+            if (result.isError()) {
+                return result.error();
+            }
+        }
+        tx.commit();
+        return Result<int>(static_cast<int>(updates.size()));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
+
+Result<int> SQLiteAdapter::batchDeletePackages(const std::vector<std::string>& ids) {
+    if (ids.empty()) {
+        return Result<int>(0);
+    }
+    try {
+        auto conn = pool_->acquireWriter();
+        Transaction tx(*conn);
+        for (const auto& id : ids) {
+            auto result = removePackage(*conn, id);
+            if (result.isError()) {
+                return result.error();
+            }
+        }
+        tx.commit();
+        return Result<int>(static_cast<int>(ids.size()));
+    } catch (const SQLiteError& err) {
+        return mapError(err);
+    }
+}
 
 }
 }
@@ -0,0 +1,88 @@
+/**
+ * @file sqlite_adapter.hpp
+ * @brief Embedded SQLite adapter (WAL, cached statements, batched writes)
+ */
+#ifndef DBAL_SQLITE_ADAPTER_HPP
+#define DBAL_SQLITE_ADAPTER_HPP
+
+#include "dbal/adapters/adapter.hpp"
+#include "sqlite_pool.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dbal {
+namespace adapters {
+namespace sqlite {
+
+class SQLiteAdapter : public Adapter {
+public:
+    /**
+     * Open (or create) the database at db_path and apply the schema.
+     * ":memory:" gives a private in-memory database.
+     *
+     * @throws SQLiteError if the database cannot be opened
+     */
+    explicit SQLiteAdapter(const std::string& db_path, size_t statement_cache_size = 64);
+    ~SQLiteAdapter() override;
+
+    Result<User> createUser(const CreateUserInput& input) override;
+    Result<User> getUser(const std::string& id) override;
+    Result<User> updateUser(const std::string& id, const UpdateUserInput& input) override;
+    Result<bool> deleteUser(const std::string& id) override;
+    Result<std::vector<User>> listUsers(const ListOptions& options) override;
+
+    Result<PageConfig> createPage(const CreatePageInput& input) override;
+    Result<PageConfig> getPage(const std::string& id) override;
+    Result<PageConfig> updatePage(const std::string& id, const UpdatePageInput& input) override;
+    Result<bool> deletePage(const std::string& id) override;
+    Result<std::vector<PageConfig>> listPages(const ListOptions& options) override;
+
+    Result<Workflow> createWorkflow(const CreateWorkflowInput& input) override;
+    Result<Workflow> getWorkflow(const std::string& id) override;
+    Result<Workflow> updateWorkflow(const std::string& id, const UpdateWorkflowInput& input) override;
+    Result<bool> deleteWorkflow(const std::string& id) override;
+    Result<std::vector<Workflow>> listWorkflows(const ListOptions& options) override;
+
+    Result<Session> createSession(const CreateSessionInput& input) override;
+    Result<Session> getSession(const std::string& id) override;
+    Result<Session> updateSession(const std::string& id, const UpdateSessionInput& input) override;
+    Result<bool> deleteSession(const std::string& id) override;
+    Result<std::vector<Session>> listSessions(const ListOptions& options) override;
+
+    Result<InstalledPackage> createPackage(const CreatePackageInput& input) override;
+    Result<InstalledPackage> getPackage(const std::string& id) override;
+    Result<InstalledPackage> updatePackage(const std::string& id, const UpdatePackageInput& input) override;
+    Result<bool> deletePackage(const std::string& id) override;
+    Result<std::vector<InstalledPackage>> listPackages(const ListOptions& options) override;
+
+    // Batch operations run in a single write transaction; any failure
+    // rolls back the whole batch.
+    Result<int> batchCreateUsers(const std::vector<CreateUserInput>& inputs);
+    Result<int> batchUpdateUsers(const std::vector<UpdateUserBatchItem>& updates);
+    Result<int> batchDeleteUsers(const std::vector<std::string>& ids);
+    Result<int> batchCreatePackages(const std::vector<CreatePackageInput>& inputs);
+    Result<int> batchUpdatePackages(const std::vector<UpdatePackageBatchItem>& updates);
+    Result<int> batchDeletePackages(const std::vector<std::string>& ids);
+
+    void close() override;
+
+private:
+    // Single-row operations on a connection the caller already holds
+    Result<User> insertUser(SQLiteConnection& conn, const CreateUserInput& input);
+    Result<User> modifyUser(SQLiteConnection& conn, const std::string& id, const UpdateUserInput& input);
+    Result<bool> removeUser(SQLiteConnection& conn, const std::string& id);
+    Result<InstalledPackage> insertPackage(SQLiteConnection& conn, const CreatePackageInput& input);
+    Result<InstalledPackage> modifyPackage(SQLiteConnection& conn, const std::string& id,
+                                           const UpdatePackageInput& input);
+    Result<bool> removePackage(SQLiteConnection& conn, const std::string& id);
+
+    std::unique_ptr<SQLitePool> pool_;
+};
+
+}
+}
+}
+
+#endif
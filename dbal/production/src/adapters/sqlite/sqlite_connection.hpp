@@ -0,0 +1,261 @@
+/**
+ * @file sqlite_connection.hpp
+ * @brief Thin RAII wrappers over a sqlite3 handle and prepared statements
+ *
+ * Each connection owns an LRU cache of prepared statements keyed by SQL
+ * text, so hot queries are compiled once per connection. A connection is
+ * used by one thread at a time (see SQLitePool), so handles are opened
+ * with SQLITE_OPEN_NOMUTEX.
+ */
+#ifndef DBAL_SQLITE_CONNECTION_HPP
+#define DBAL_SQLITE_CONNECTION_HPP
+
+#include <sqlite3.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace dbal {
+namespace adapters {
+namespace sqlite {
+
+struct SQLiteError {
+    int code;  // extended result code
+    std::string message;
+};
+
+class SQLiteStatement {
+public:
+    SQLiteStatement(sqlite3* db, const std::string& sql) : db_(db) {
+        const int rc = sqlite3_prepare_v3(db, sql.c_str(), static_cast<int>(sql.size()),
+                                          SQLITE_PREPARE_PERSISTENT, &stmt_, nullptr);
+        if (rc != SQLITE_OK) {
+            throw SQLiteError{sqlite3_extended_errcode(db), sqlite3_errmsg(db)};
+        }
+    }
+
+    ~SQLiteStatement() {
+        sqlite3_finalize(stmt_);
+    }
+
+    SQLiteStatement(const SQLiteStatement&) = delete;
+    SQLiteStatement& operator=(const SQLiteStatement&) = delete;
+
+    void bind(int index, const std::string& value) {
+        check(sqlite3_bind_text(stmt_, index, value.data(), static_cast<int>(value.size()),
+                                SQLITE_TRANSIENT));
+    }
+
+    void bind(int index, const std::optional<std::string>& value) {
+        if (value.has_value()) {
+            bind(index, value.value());
+        } else {
+            bindNull(index);
+        }
+    }
+
+    void bind(int index, int64_t value) {
+        check(sqlite3_bind_int64(stmt_, index, value));
+    }
+
+    void bind(int index, int value) {
+        bind(index, static_cast<int64_t>(value));
+    }
+
+    void bind(int index, bool value) {
+        bind(index, static_cast<int64_t>(value ? 1 : 0));
+    }
+
+    void bind(int index, const std::optional<int64_t>& value) {
+        if (value.has_value()) {
+            bind(index, value.value());
+        } else {
+            bindNull(index);
+        }
+    }
+
+    void bindNull(int index) {
+        check(sqlite3_bind_null(stmt_, index));
+    }
+
+    /**
+     * Advance to the next row; false once the statement is done
+     */
+    bool step() {
+        const int rc = sqlite3_step(stmt_);
+        if (rc == SQLITE_ROW) {
+            return true;
+        }
+        if (rc == SQLITE_DONE) {
+            return false;
+        }
+        throw SQLiteError{sqlite3_extended_errcode(db_), sqlite3_errmsg(db_)};
+    }
+
+    bool isNull(int column) const {
+        return sqlite3_column_type(stmt_, column) == SQLITE_NULL;
+    }
+
+    std::string text(int column) const {
+        const auto* data = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, column));
+        if (!data) {
+            return std::string();
+        }
+        return std::string(data, static_cast<size_t>(sqlite3_column_bytes(stmt_, column)));
+    }
+
+    std::optional<std::string> optionalText(int column) const {
+        if (isNull(column)) {
+            return std::nullopt;
+        }
+        return text(column);
+    }
+
+    int64_t int64(int column) const {
+        return sqlite3_column_int64(stmt_, column);
+    }
+
+    std::optional<int64_t> optionalInt64(int column) const {
+        if (isNull(column)) {
+            return std::nullopt;
+        }
+        return int64(column);
+    }
+
+    void reset() {
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+    }
+
+private:
+    void check(int rc) {
+        if (rc != SQLITE_OK) {
+            throw SQLiteError{sqlite3_extended_errcode(db_), sqlite3_errmsg(db_)};
+        }
+    }
+
+    sqlite3* db_;
+    sqlite3_stmt* stmt_ = nullptr;
+};
+
+/**
+ * Borrowed cached statement; resets it on scope exit so a half-read
+ * SELECT never pins a read transaction open
+ */
+class StatementHandle {
+public:
+    explicit StatementHandle(SQLiteStatement& statement) : statement_(&statement) {}
+    ~StatementHandle() {
+        if (statement_) {
+            statement_->reset();
+        }
+    }
+
+    StatementHandle(StatementHandle&& other) noexcept : statement_(other.statement_) {
+        other.statement_ = nullptr;
+    }
+    StatementHandle(const StatementHandle&) = delete;
+    StatementHandle& operator=(const StatementHandle&) = delete;
+    StatementHandle& operator=(StatementHandle&&) = delete;
+
+    SQLiteStatement* operator->() const {
+        return statement_;
+    }
+
+    SQLiteStatement& operator*() const {
+        return *statement_;
+    }
+
+private:
+    SQLiteStatement* statement_;
+};
+
+class SQLiteConnection {
+public:
+    SQLiteConnection(const std::string& path, bool read_only, size_t statement_cache_capacity = 64)
+        : cache_capacity_(statement_cache_capacity) {
+        int flags = SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_URI;
+        flags |= read_only ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+        const int rc = sqlite3_open_v2(path.c_str(), &db_, flags, nullptr);
+        if (rc != SQLITE_OK) {
+            const std::string message = db_ ? sqlite3_errmsg(db_) : "unable to open database";
+            sqlite3_close(db_);
+            db_ = nullptr;
+            throw SQLiteError{rc, message};
+        }
+        sqlite3_extended_result_codes(db_, 1);
+        sqlite3_busy_timeout(db_, 5000);
+    }
+
+    ~SQLiteConnection() {
+        // Statements must be finalized before the handle can close
+        lru_.clear();
+        cache_.clear();
+        sqlite3_close(db_);
+    }
+
+    SQLiteConnection(const SQLiteConnection&) = delete;
+    SQLiteConnection& operator=(const SQLiteConnection&) = delete;
+
+    /**
+     * Run one or more statements that take no parameters
+     */
+    void exec(const std::string& sql) {
+        char* error = nullptr;
+        if (sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+            SQLiteError err{sqlite3_extended_errcode(db_), error ? error : "exec failed"};
+            sqlite3_free(error);
+            throw err;
+        }
+    }
+
+    /**
+     * Cached prepared statement for sql, compiled on first use
+     */
+    StatementHandle prepare(const std::string& sql) {
+        auto it = cache_.find(sql);
+        if (it != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return StatementHandle(*it->second->second);
+        }
+
+        if (cache_capacity_ > 0 && cache_.size() >= cache_capacity_) {
+            cache_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+        lru_.emplace_front(sql, std::make_unique<SQLiteStatement>(db_, sql));
+        cache_[sql] = lru_.begin();
+        return StatementHandle(*lru_.front().second);
+    }
+
+    int changes() const {
+        return sqlite3_changes(db_);
+    }
+
+    size_t cachedStatements() const {
+        return cache_.size();
+    }
+
+    sqlite3* handle() const {
+        return db_;
+    }
+
+private:
+    using Entry = std::pair<std::string, std::unique_ptr<SQLiteStatement>>;
+
+    sqlite3* db_ = nullptr;
+    size_t cache_capacity_;
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> cache_;
+};
+
+}
+}
+}
+
+#endif
@@ -1,47 +1,73 @@
-#include <memory>
-#include <string>
-#include <map>
-#include <mutex>
+#include "sqlite_pool.hpp"
+
+#include <atomic>
 
 namespace dbal {
 namespace adapters {
 namespace sqlite {
 
-// Simple connection pool for SQLite
-class SQLitePool {
-public:
-    SQLitePool(const std::string& db_path, int pool_size = 5)
-        : db_path_(db_path), pool_size_(pool_size) {}
-    
-    ~SQLitePool() {
-        // Close all connections
-    }
-    
-    void* acquire() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        // In a real implementation, this would return a SQLite connection
-        return nullptr;
+namespace {
+
+std::atomic<uint64_t> next_pool_id{1};
+
+// Per-thread shortcut from pool id to that thread's reader. Pool ids are
+// never reused, so entries left behind by a destroyed pool are never hit.
+thread_local std::unordered_map<uint64_t, SQLiteConnection*> thread_readers;
+
+}
+
+SQLitePool::SQLitePool(const std::string& db_path, size_t statement_cache_size)
+    : db_path_(db_path.empty() ? ":memory:" : db_path),
+      statement_cache_size_(statement_cache_size),
+      in_memory_(db_path_ == ":memory:" || db_path_.find("mode=memory") != std::string::npos),
+      pool_id_(next_pool_id.fetch_add(1)) {
+    writer_ = std::make_unique<SQLiteConnection>(db_path_, false, statement_cache_size_);
+    if (!in_memory_) {
+        writer_->exec("PRAGMA journal_mode=WAL");
+        // WAL makes NORMAL durable across application crashes; only an OS
+        // crash can lose the last commits
+        writer_->exec("PRAGMA synchronous=NORMAL");
     }
-    
-    void release(void* conn) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        // In a real implementation, this would return the connection to the pool
+    writer_->exec("PRAGMA foreign_keys=ON");
+    writer_->exec("PRAGMA temp_store=MEMORY");
+}
+
+SQLitePool::~SQLitePool() {
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    readers_.clear();
+}
+
+SQLitePool::Lease SQLitePool::acquireWriter() {
+    return Lease(*writer_, std::unique_lock<std::mutex>(writer_mutex_));
+}
+
+SQLitePool::Lease SQLitePool::acquireReader() {
+    if (in_memory_) {
+        return acquireWriter();
     }
-    
-    size_t size() const {
-        return pool_size_;
+    return Lease(threadReader(), std::unique_lock<std::mutex>());
+}
+
+size_t SQLitePool::readerCount() const {
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    return readers_.size();
+}
+
+SQLiteConnection& SQLitePool::threadReader() {
+    auto cached = thread_readers.find(pool_id_);
+    if (cached != thread_readers.end()) {
+        return *cached->second;
     }
-    
-    size_t available() const {
-        // In a real implementation, return the number of available connections
-        return pool_size_;
+
+    std::lock_guard<std::mutex> lock(readers_mutex_);
+    auto& slot = readers_[std::this_thread::get_id()];
+    if (!slot) {
+        slot = std::make_unique<SQLiteConnection>(db_path_, true, statement_cache_size_);
+        slot->exec("PRAGMA query_only=ON");
     }
-    
-private:
-    std::string db_path_;
-    int pool_size_;
-    std::mutex mutex_;
-};
+    thread_readers[pool_id_] = slot.get();
+    return *slot;
+}
 
 }
 }
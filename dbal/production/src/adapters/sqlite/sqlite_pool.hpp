@@ -0,0 +1,98 @@
+/**
+ * @file sqlite_pool.hpp
+ * @brief SQLite connection pool: one serialized writer, one reader per thread
+ *
+ * The database runs in WAL mode, so readers never block the writer and
+ * see a consistent snapshot per statement. Writes go through a single
+ * connection guarded by a mutex, which is SQLite's concurrency model
+ * anyway and avoids SQLITE_BUSY retries between our own connections.
+ *
+ * In-memory databases cannot be shared across connections, so for
+ * ":memory:" every lease is the writer connection.
+ */
+#ifndef DBAL_SQLITE_POOL_HPP
+#define DBAL_SQLITE_POOL_HPP
+
+#include "sqlite_connection.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace dbal {
+namespace adapters {
+namespace sqlite {
+
+class SQLitePool {
+public:
+    /**
+     * Connection borrowed from the pool; holds the writer lock when it
+     * wraps the writer connection
+     */
+    class Lease {
+    public:
+        Lease(SQLiteConnection& connection, std::unique_lock<std::mutex> lock)
+            : connection_(&connection), lock_(std::move(lock)) {}
+
+        SQLiteConnection* operator->() const {
+            return connection_;
+        }
+
+        SQLiteConnection& operator*() const {
+            return *connection_;
+        }
+
+    private:
+        SQLiteConnection* connection_;
+        std::unique_lock<std::mutex> lock_;
+    };
+
+    explicit SQLitePool(const std::string& db_path, size_t statement_cache_size = 64);
+    ~SQLitePool();
+
+    SQLitePool(const SQLitePool&) = delete;
+    SQLitePool& operator=(const SQLitePool&) = delete;
+
+    /**
+     * Exclusive access to the writer connection
+     */
+    Lease acquireWriter();
+
+    /**
+     * The calling thread's reader connection, opened on first use
+     */
+    Lease acquireReader();
+
+    const std::string& path() const {
+        return db_path_;
+    }
+
+    bool inMemory() const {
+        return in_memory_;
+    }
+
+    size_t readerCount() const;
+
+private:
+    SQLiteConnection& threadReader();
+
+    std::string db_path_;
+    size_t statement_cache_size_;
+    bool in_memory_;
+    uint64_t pool_id_;
+
+    std::unique_ptr<SQLiteConnection> writer_;
+    std::mutex writer_mutex_;
+
+    std::unordered_map<std::thread::id, std::unique_ptr<SQLiteConnection>> readers_;
+    mutable std::mutex readers_mutex_;
+};
+
+}
+}
+}
+
+#endif
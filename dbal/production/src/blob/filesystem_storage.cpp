@@ -0,0 +1,738 @@
+#include "filesystem_storage.hpp"
+#include "sorted_listing.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace dbal {
+namespace blob {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::string kSidecarMagic = "DBALBMD1";
+
+class Sha256 {
+public:
+    Sha256() : context_(EVP_MD_CTX_new()) {
+        EVP_DigestInit_ex(context_, EVP_sha256(), nullptr);
+    }
+
+    ~Sha256() {
+        EVP_MD_CTX_free(context_);
+    }
+
+    Sha256(const Sha256&) = delete;
+    Sha256& operator=(const Sha256&) = delete;
+
+    void update(const char* data, size_t size) {
+        EVP_DigestUpdate(context_, data, size);
+    }
+
+    std::string hex() {
+        static const char digits[] = "0123456789abcdef";
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_DigestFinal_ex(context_, digest, &length);
+        std::string out;
+        out.reserve(length * 2);
+        for (unsigned int i = 0; i < length; ++i) {
+            out.push_back(digits[digest[i] >> 4]);
+            out.push_back(digits[digest[i] & 0x0F]);
+        }
+        return out;
+    }
+
+private:
+    EVP_MD_CTX* context_;
+};
+
+std::string sha256Hex(std::string_view data) {
+    Sha256 sha;
+    sha.update(data.data(), data.size());
+    return sha.hex();
+}
+
+// objects/ab/cd/abcd... and meta/ab/cd/abcd...: 65536 directories keep
+// each one small however many blobs there are
+fs::path shardedPath(const fs::path& base, const std::string& digest) {
+    return base / digest.substr(0, 2) / digest.substr(2, 2) / digest;
+}
+
+std::string systemError(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+// Make a rename or a new file in directory durable
+void syncDirectory(const fs::path& directory) {
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+/**
+ * Create directory and any missing parents; when any were created, sync
+ * the two shard levels above so the new entries survive a crash
+ */
+bool makeShardDirectory(const fs::path& directory, std::error_code& error) {
+    const bool created = fs::create_directories(directory, error);
+    if (created) {
+        syncDirectory(directory.parent_path());
+        syncDirectory(directory.parent_path().parent_path());
+    }
+    return !error;
+}
+
+class FileHandle {
+public:
+    FileHandle() = default;
+    explicit FileHandle(int fd) : fd_(fd) {}
+
+    FileHandle(FileHandle&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+
+    FileHandle& operator=(FileHandle&& other) noexcept {
+        std::swap(fd_, other.fd_);
+        return *this;
+    }
+
+    ~FileHandle() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    int get() const {
+        return fd_;
+    }
+
+    int release() {
+        return std::exchange(fd_, -1);
+    }
+
+private:
+    int fd_ = -1;
+};
+
+/**
+ * A file being written in tmp/, hashed as it goes. It is unlinked on
+ * destruction unless it has been renamed into place by then.
+ */
+class StagedFile {
+public:
+    explicit StagedFile(fs::path path)
+        : path_(std::move(path)),
+          file_(::open(path_.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644)) {}
+
+    ~StagedFile() {
+        ::unlink(path_.c_str());
+    }
+
+    StagedFile(const StagedFile&) = delete;
+    StagedFile& operator=(const StagedFile&) = delete;
+
+    const fs::path& path() const {
+        return path_;
+    }
+
+    bool write(const char* data, size_t size) {
+        if (file_.get() < 0) {
+            return false;
+        }
+        sha_.update(data, size);
+        while (size > 0) {
+            const ssize_t written = ::write(file_.get(), data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    /**
+     * Sync and close the file; digest() is its content's SHA-256 after
+     */
+    bool finish() {
+        if (file_.get() < 0 || ::fdatasync(file_.get()) != 0) {
+            return false;
+        }
+        digest_ = sha_.hex();
+        file_ = FileHandle();
+        return true;
+    }
+
+    const std::string& digest() const {
+        return digest_;
+    }
+
+private:
+    fs::path path_;
+    FileHandle file_;
+    Sha256 sha_;
+    std::string digest_;
+};
+
+// ---------------------------------------------------------------------------
+// Sidecars: magic, then key, digest, u64 size, content type, i64 last
+// modified in nanoseconds since the epoch and u32 count of custom metadata
+// pairs; strings are u32 length-prefixed, integers little-endian
+
+void putU32(std::string& out, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>(value >> shift));
+    }
+}
+
+void putU64(std::string& out, std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<char>(value >> shift));
+    }
+}
+
+void putString(std::string& out, const std::string& value) {
+    putU32(out, static_cast<std::uint32_t>(value.size()));
+    out.append(value);
+}
+
+class SidecarReader {
+public:
+    explicit SidecarReader(std::string_view in) : in_(in) {}
+
+    bool failed() const {
+        return failed_;
+    }
+
+    std::uint64_t integer(int bytes) {
+        if (in_.size() < static_cast<size_t>(bytes)) {
+            failed_ = true;
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in_[i])) << (8 * i);
+        }
+        in_.remove_prefix(bytes);
+        return value;
+    }
+
+    std::string string() {
+        const auto size = integer(4);
+        if (failed_ || size > in_.size()) {
+            failed_ = true;
+            return std::string();
+        }
+        std::string value(in_.substr(0, size));
+        in_.remove_prefix(size);
+        return value;
+    }
+
+private:
+    std::string_view in_;
+    bool failed_ = false;
+};
+
+std::string encodeSidecar(const std::string& digest, const BlobMetadata& metadata) {
+    std::string out = kSidecarMagic;
+    putString(out, metadata.key);
+    putString(out, digest);
+    putU64(out, metadata.size);
+    putString(out, metadata.content_type);
+    const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(metadata.last_modified.time_since_epoch());
+    putU64(out, static_cast<std::uint64_t>(nanos.count()));
+    putU32(out, static_cast<std::uint32_t>(metadata.custom_metadata.size()));
+    for (const auto& [name, value] : metadata.custom_metadata) {
+        putString(out, name);
+        putString(out, value);
+    }
+    return out;
+}
+
+std::string etagOf(const std::string& digest) {
+    return "\"" + digest + "\"";
+}
+
+bool decodeSidecar(std::string_view in, std::string& digest, BlobMetadata& metadata) {
+    if (in.substr(0, kSidecarMagic.size()) != kSidecarMagic) {
+        return false;
+    }
+    SidecarReader reader(in.substr(kSidecarMagic.size()));
+    metadata.key = reader.string();
+    digest = reader.string();
+    metadata.size = static_cast<size_t>(reader.integer(8));
+    metadata.content_type = reader.string();
+    const auto nanos = static_cast<std::int64_t>(reader.integer(8));
+    metadata.last_modified = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos)));
+    for (auto pairs = reader.integer(4); pairs > 0 && !reader.failed(); --pairs) {
+        auto name = reader.string();
+        metadata.custom_metadata[std::move(name)] = reader.string();
+    }
+    metadata.etag = etagOf(digest);
+    return !reader.failed() && digest.size() == 64;
+}
+
+/**
+ * [offset, offset + length) that options asks for, clipped to size
+ */
+Result<std::pair<size_t, size_t>> clampRange(size_t size, const DownloadOptions& options) {
+    if (!options.offset.has_value() && !options.length.has_value()) {
+        return std::make_pair(size_t{0}, size);
+    }
+    const size_t offset = options.offset.value_or(0);
+    if (offset >= size) {
+        return Error::validationError("Offset exceeds blob size");
+    }
+    return std::make_pair(offset, std::min(options.length.value_or(size - offset), size - offset));
+}
+
+} // namespace
+
+struct FilesystemStorage::OpenBlob {
+    FileHandle file;
+    size_t offset = 0;
+    size_t length = 0;
+    BlobMetadata metadata;
+};
+
+FilesystemStorage::FilesystemStorage(const std::string& directory) : root_(directory) {
+    for (const char* sub : {"objects", "meta", "tmp"}) {
+        std::error_code error;
+        fs::create_directories(root_ / sub, error);
+        if (error) {
+            throw std::runtime_error("Cannot create blob directory " + (root_ / sub).string() + ": " +
+                                     error.message());
+        }
+    }
+    load();
+}
+
+fs::path FilesystemStorage::objectPath(const std::string& digest) const {
+    return shardedPath(root_ / "objects", digest);
+}
+
+fs::path FilesystemStorage::sidecarPath(const std::string& key) const {
+    return shardedPath(root_ / "meta", sha256Hex(key));
+}
+
+fs::path FilesystemStorage::tempPath() {
+    return root_ / "tmp" / (std::to_string(next_temp_.fetch_add(1)) + ".tmp");
+}
+
+void FilesystemStorage::load() {
+    // Uploads a crash interrupted; nothing names them
+    std::error_code error;
+    for (const auto& stray : fs::directory_iterator(root_ / "tmp", error)) {
+        fs::remove_all(stray.path(), error);
+    }
+
+    for (const auto& file : fs::recursive_directory_iterator(root_ / "meta")) {
+        if (!file.is_regular_file()) {
+            continue;
+        }
+        std::ifstream in(file.path(), std::ios::binary);
+        const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        Entry entry;
+        if (!in.good() && !in.eof()) {
+            throw std::runtime_error("Cannot read blob metadata " + file.path().string());
+        }
+        if (!decodeSidecar(bytes, entry.digest, entry.metadata) || sidecarPath(entry.metadata.key) != file.path()) {
+            throw std::runtime_error("Corrupt blob metadata " + file.path().string());
+        }
+        const auto stored = fs::file_size(objectPath(entry.digest), error);
+        if (error || stored != entry.metadata.size) {
+            throw std::runtime_error("Blob object missing or truncated for " + entry.metadata.key);
+        }
+        ++references_[entry.digest];
+        total_bytes_ += entry.metadata.size;
+        std::string key = entry.metadata.key;
+        entries_.emplace(std::move(key), std::move(entry));
+    }
+
+    // Objects whose last key was dropped by a crash between unlinks
+    for (const auto& file : fs::recursive_directory_iterator(root_ / "objects")) {
+        if (file.is_regular_file() && references_.count(file.path().filename().string()) == 0) {
+            fs::remove(file.path(), error);
+        }
+    }
+}
+
+void FilesystemStorage::retain(const std::string& digest) {
+    ++references_[digest];
+}
+
+void FilesystemStorage::release(const std::string& digest) {
+    auto it = references_.find(digest);
+    if (it == references_.end() || --it->second > 0) {
+        return;
+    }
+    references_.erase(it);
+    std::error_code error;
+    fs::remove(objectPath(digest), error);
+}
+
+Result<bool> FilesystemStorage::checkOverwrite(const std::string& key, const UploadOptions& options) {
+    if (!options.overwrite) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (entries_.find(key) != entries_.end()) {
+            return Error::conflict("Blob already exists: " + key);
+        }
+    }
+    return Result<bool>(true);
+}
+
+Result<BlobMetadata> FilesystemStorage::upload(
+    const std::string& key,
+    const std::vector<char>& data,
+    const UploadOptions& options
+) {
+    auto allowed = checkOverwrite(key, options);
+    if (allowed.isError()) {
+        return allowed.error();
+    }
+
+    StagedFile staged(tempPath());
+    if (!staged.write(data.data(), data.size()) || !staged.finish()) {
+        return Error::internal(systemError("Cannot write blob " + key));
+    }
+    return commit(key, staged.path(), staged.digest(), data.size(), options);
+}
+
+Result<BlobMetadata> FilesystemStorage::uploadStream(
+    const std::string& key,
+    StreamReader read_callback,
+    size_t /*size*/,
+    const UploadOptions& options
+) {
+    auto allowed = checkOverwrite(key, options);
+    if (allowed.isError()) {
+        return allowed.error();
+    }
+
+    StagedFile staged(tempPath());
+    std::unique_ptr<char[]> buffer(new char[kStreamPieceBytes]);
+    size_t total = 0;
+    for (;;) {
+        const size_t read = read_callback(buffer.get(), kStreamPieceBytes);
+        if (read == 0) {
+            break;
+        }
+        if (!staged.write(buffer.get(), read)) {
+            return Error::internal(systemError("Cannot write blob " + key));
+        }
+        total += read;
+    }
+    if (!staged.finish()) {
+        return Error::internal(systemError("Cannot write blob " + key));
+    }
+    return commit(key, staged.path(), staged.digest(), total, options);
+}
+
+Result<BlobMetadata> FilesystemStorage::commit(
+    const std::string& key,
+    const fs::path& staged,
+    const std::string& digest,
+    size_t size,
+    const UploadOptions& options
+) {
+    Entry entry;
+    entry.digest = digest;
+    entry.metadata.key = key;
+    entry.metadata.size = size;
+    entry.metadata.content_type = options.content_type.value_or("application/octet-stream");
+    entry.metadata.etag = etagOf(digest);
+    entry.metadata.last_modified = std::chrono::system_clock::now();
+    entry.metadata.custom_metadata = options.metadata;
+
+    // The reference taken here pins the object until publish() hands it
+    // to the key or drops it; identical bytes already stored are reused
+    const fs::path object = objectPath(digest);
+    bool placed = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        placed = references_.count(digest) == 0;
+        retain(digest);
+        if (placed) {
+            std::error_code error;
+            if (makeShardDirectory(object.parent_path(), error)) {
+                fs::rename(staged, object, error);
+            }
+            if (error) {
+                release(digest);
+                return Error::internal("Cannot store blob " + key + ": " + error.message());
+            }
+        }
+    }
+    if (placed) {
+        syncDirectory(object.parent_path());
+    }
+    return publish(std::move(entry), options.overwrite);
+}
+
+Result<BlobMetadata> FilesystemStorage::publish(Entry entry, bool overwrite) {
+    const std::string& key = entry.metadata.key;
+    const fs::path sidecar = sidecarPath(key);
+    auto drop = [this, &entry] {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        release(entry.digest);
+    };
+
+    StagedFile staged(tempPath());
+    const std::string bytes = encodeSidecar(entry.digest, entry.metadata);
+    std::error_code error;
+    if (!staged.write(bytes.data(), bytes.size()) || !staged.finish()) {
+        const std::string message = systemError("Cannot write metadata for blob " + key);
+        drop();
+        return Error::internal(message);
+    }
+    if (!makeShardDirectory(sidecar.parent_path(), error)) {
+        drop();
+        return Error::internal("Cannot write metadata for blob " + key + ": " + error.message());
+    }
+
+    BlobMetadata metadata = entry.metadata;
+    std::string replaced;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (!overwrite && it != entries_.end()) {
+            release(entry.digest);
+            return Error::conflict("Blob already exists: " + key);
+        }
+        fs::rename(staged.path(), sidecar, error);
+        if (error) {
+            release(entry.digest);
+            return Error::internal("Cannot write metadata for blob " + key + ": " + error.message());
+        }
+        total_bytes_ += metadata.size;
+        if (it != entries_.end()) {
+            total_bytes_ -= it->second.metadata.size;
+            replaced = std::move(it->second.digest);
+            it->second = std::move(entry);
+            release(replaced);
+        } else {
+            entries_.emplace(key, std::move(entry));
+        }
+    }
+    syncDirectory(sidecar.parent_path());
+    return metadata;
+}
+
+Result<FilesystemStorage::OpenBlob> FilesystemStorage::openBlob(
+    const std::string& key,
+    const DownloadOptions& options
+) {
+    // Opened under the lock so the object cannot be unlinked first; once
+    // open it stays readable whatever happens to the key
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return Error::notFound("Blob not found: " + key);
+    }
+    auto range = clampRange(it->second.metadata.size, options);
+    if (range.isError()) {
+        return range.error();
+    }
+    OpenBlob blob;
+    blob.file = FileHandle(::open(objectPath(it->second.digest).c_str(), O_RDONLY | O_CLOEXEC));
+    if (blob.file.get() < 0) {
+        return Error::internal(systemError("Cannot open blob " + key));
+    }
+    std::tie(blob.offset, blob.length) = range.value();
+    blob.metadata = it->second.metadata;
+    return blob;
+}
+
+Result<BlobLocation> FilesystemStorage::locate(const std::string& key, const DownloadOptions& options) {
+    auto opened = openBlob(key, options);
+    if (opened.isError()) {
+        return opened.error();
+    }
+    OpenBlob& blob = opened.value();
+    BlobLocation location;
+    location.file = std::shared_ptr<const int>(new int(blob.file.release()), [](const int* fd) {
+        ::close(*fd);
+        delete fd;
+    });
+    location.offset = blob.offset;
+    location.length = blob.length;
+    location.metadata = std::move(blob.metadata);
+    return location;
+}
+
+size_t FilesystemStorage::readLocated(const BlobLocation& location, size_t done, char* out, size_t size) {
+    if (done >= location.length) {
+        return 0;
+    }
+    const size_t wanted = std::min(size, location.length - done);
+    while (true) {
+        const ssize_t read = ::pread(*location.file, out, wanted, static_cast<off_t>(location.offset + done));
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        return read < 0 ? 0 : static_cast<size_t>(read);
+    }
+}
+
+Result<std::vector<char>> FilesystemStorage::download(const std::string& key, const DownloadOptions& options) {
+    auto opened = openBlob(key, options);
+    if (opened.isError()) {
+        return opened.error();
+    }
+    const OpenBlob& blob = opened.value();
+
+    std::vector<char> data(blob.length);
+    size_t done = 0;
+    while (done < blob.length) {
+        const ssize_t read = ::pread(blob.file.get(), data.data() + done, blob.length - done,
+                                     static_cast<off_t>(blob.offset + done));
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read <= 0) {
+            return Error::internal(systemError("Cannot read blob " + key));
+        }
+        done += static_cast<size_t>(read);
+    }
+    return Result<std::vector<char>>(std::move(data));
+}
+
+Result<bool> FilesystemStorage::downloadStream(
+    const std::string& key,
+    StreamCallback write_callback,
+    const DownloadOptions& options
+) {
+    auto opened = openBlob(key, options);
+    if (opened.isError()) {
+        return opened.error();
+    }
+    const OpenBlob& blob = opened.value();
+    if (blob.length == 0) {
+        return Result<bool>(true);
+    }
+
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t skip = blob.offset % page;
+    const size_t mapped = skip + blob.length;
+    void* address = ::mmap(nullptr, mapped, PROT_READ, MAP_SHARED, blob.file.get(),
+                           static_cast<off_t>(blob.offset - skip));
+    if (address == MAP_FAILED) {
+        return Error::internal(systemError("Cannot map blob " + key));
+    }
+    std::unique_ptr<void, std::function<void(void*)>> mapping(address, [mapped](void* region) {
+        ::munmap(region, mapped);
+    });
+    ::madvise(address, mapped, MADV_SEQUENTIAL);
+
+    const char* bytes = static_cast<const char*>(address) + skip;
+    for (size_t done = 0; done < blob.length;) {
+        const size_t piece = std::min(kStreamPieceBytes, blob.length - done);
+        write_callback(bytes + done, piece);
+        done += piece;
+    }
+    return Result<bool>(true);
+}
+
+Result<bool> FilesystemStorage::deleteBlob(const std::string& key) {
+    const fs::path sidecar = sidecarPath(key);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            return Error::notFound("Blob not found: " + key);
+        }
+        if (::unlink(sidecar.c_str()) != 0 && errno != ENOENT) {
+            return Error::internal(systemError("Cannot delete blob " + key));
+        }
+        total_bytes_ -= it->second.metadata.size;
+        const std::string digest = std::move(it->second.digest);
+        entries_.erase(it);
+        release(digest);
+    }
+    syncDirectory(sidecar.parent_path());
+    return Result<bool>(true);
+}
+
+Result<bool> FilesystemStorage::exists(const std::string& key) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return Result<bool>(entries_.find(key) != entries_.end());
+}
+
+Result<BlobMetadata> FilesystemStorage::getMetadata(const std::string& key) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return Error::notFound("Blob not found: " + key);
+    }
+    return it->second.metadata;
+}
+
+Result<BlobListResult> FilesystemStorage::list(const ListOptions& options) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return list_sorted(entries_, options, [](const std::string&, const Entry& entry) {
+        return entry.metadata;
+    });
+}
+
+Result<std::string> FilesystemStorage::generatePresignedUrl(
+    const std::string& /*key*/,
+    std::chrono::seconds /*expiration*/
+) {
+    return Result<std::string>("");
+}
+
+Result<BlobMetadata> FilesystemStorage::copy(const std::string& source_key, const std::string& dest_key) {
+    Entry entry;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(source_key);
+        if (it == entries_.end()) {
+            return Error::notFound("Source blob not found: " + source_key);
+        }
+        entry = it->second;
+        retain(entry.digest);
+    }
+    entry.metadata.key = dest_key;
+    entry.metadata.last_modified = std::chrono::system_clock::now();
+    return publish(std::move(entry), true);
+}
+
+Result<size_t> FilesystemStorage::getTotalSize() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return Result<size_t>(total_bytes_);
+}
+
+Result<size_t> FilesystemStorage::getObjectCount() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return Result<size_t>(entries_.size());
+}
+
+size_t FilesystemStorage::storedObjectCount() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return references_.size();
+}
+
+} // namespace blob
+} // namespace dbal
@@ -0,0 +1,179 @@
+/**
+ * @file filesystem_storage.hpp
+ * @brief BlobStorage kept in a directory, content-addressed
+ *
+ * Layout under the root directory:
+ *
+ *   objects/ab/cd/<sha256>   blob bytes, named by their SHA-256; never
+ *                            rewritten once in place, shared by every
+ *                            key whose bytes hash the same
+ *   meta/ab/cd/<sha256>      sidecar per key, named by the key's SHA-256:
+ *                            key, content hash, size, type, timestamps
+ *                            and custom metadata
+ *   tmp/                     uploads and sidecars being written
+ *
+ * Uploads are written and hashed in tmp/, synced, then renamed into
+ * objects/; the sidecar follows the same way, only after the object's
+ * directory is synced, so a sidecar on disk always names an object that
+ * is. Renames are the commit point: a crash leaves either the old blob or
+ * the new one, plus at worst stray files that the next open removes.
+ *
+ * Every sidecar is read once at open into an in-memory index, which
+ * metadata, listing and lookups answer from without touching the disk;
+ * objects are reference counted there and unlinked when the last key
+ * naming them goes. Downloads open the object under the index lock and
+ * read it after releasing it; streamed downloads map it. POSIX only.
+ */
+#ifndef DBAL_FILESYSTEM_STORAGE_HPP
+#define DBAL_FILESYSTEM_STORAGE_HPP
+
+#include "dbal/blob_storage.hpp"
+#include "dbal/errors.hpp"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace dbal {
+namespace blob {
+
+/**
+ * @struct BlobLocation
+ * @brief A blob's content file, held open, and the range of it to send
+ *
+ * The descriptor keeps the file readable after the key is deleted or
+ * overwritten, until the last copy of the location goes.
+ */
+struct BlobLocation {
+    std::shared_ptr<const int> file;  // Read-only descriptor on the immutable content file
+    size_t offset = 0;
+    size_t length = 0;
+    BlobMetadata metadata;
+};
+
+class FilesystemStorage : public BlobStorage {
+public:
+    /**
+     * Open the store rooted at directory, creating it if needed
+     * @throws std::runtime_error when the directory cannot be created or
+     *         holds a sidecar that is corrupt or names a missing object
+     */
+    explicit FilesystemStorage(const std::string& directory);
+
+    FilesystemStorage(const FilesystemStorage&) = delete;
+    FilesystemStorage& operator=(const FilesystemStorage&) = delete;
+
+    Result<BlobMetadata> upload(
+        const std::string& key,
+        const std::vector<char>& data,
+        const UploadOptions& options
+    ) override;
+
+    Result<BlobMetadata> uploadStream(
+        const std::string& key,
+        StreamReader read_callback,
+        size_t size,
+        const UploadOptions& options
+    ) override;
+
+    Result<std::vector<char>> download(
+        const std::string& key,
+        const DownloadOptions& options
+    ) override;
+
+    /**
+     * Maps the range and hands it to write_callback straight from the
+     * page cache, in pieces of at most kStreamPieceBytes
+     */
+    Result<bool> downloadStream(
+        const std::string& key,
+        StreamCallback write_callback,
+        const DownloadOptions& options
+    ) override;
+
+    /**
+     * Open file and byte range holding key's blob, or the range options
+     * asks for, so a server can send it after returning. The file is
+     * opened under the index lock, as for downloads, so a concurrent
+     * delete or overwrite cannot unlink it first.
+     */
+    Result<BlobLocation> locate(
+        const std::string& key,
+        const DownloadOptions& options = {}
+    );
+
+    /**
+     * Read up to size bytes of location's range, starting done bytes in
+     * @returns Bytes read; 0 at the end of the range or on a read error
+     */
+    static size_t readLocated(const BlobLocation& location, size_t done, char* out, size_t size);
+
+    Result<bool> deleteBlob(const std::string& key) override;
+    Result<bool> exists(const std::string& key) override;
+    Result<BlobMetadata> getMetadata(const std::string& key) override;
+    Result<BlobListResult> list(const ListOptions& options) override;
+
+    Result<std::string> generatePresignedUrl(
+        const std::string& key,
+        std::chrono::seconds expiration
+    ) override;
+
+    /**
+     * Writes a sidecar for dest_key naming the source's object; no blob
+     * bytes are copied
+     */
+    Result<BlobMetadata> copy(
+        const std::string& source_key,
+        const std::string& dest_key
+    ) override;
+
+    Result<size_t> getTotalSize() override;
+    Result<size_t> getObjectCount() override;
+
+    /**
+     * Content files on disk, counting each shared one once
+     */
+    size_t storedObjectCount();
+
+    static constexpr size_t kStreamPieceBytes = 1024 * 1024;
+
+private:
+    struct Entry {
+        std::string digest;  // Hex SHA-256 of the content; names its object
+        BlobMetadata metadata;
+    };
+
+    struct OpenBlob;
+
+    std::filesystem::path objectPath(const std::string& digest) const;
+    std::filesystem::path sidecarPath(const std::string& key) const;
+    std::filesystem::path tempPath();
+
+    void load();
+    Result<bool> checkOverwrite(const std::string& key, const UploadOptions& options);
+    Result<OpenBlob> openBlob(const std::string& key, const DownloadOptions& options);
+    Result<BlobMetadata> commit(const std::string& key, const std::filesystem::path& staged,
+                                const std::string& digest, size_t size, const UploadOptions& options);
+    Result<BlobMetadata> publish(Entry entry, bool overwrite);
+
+    /** Takes a reference to digest's object; caller holds mutex_ exclusively */
+    void retain(const std::string& digest);
+    /** Drops one, unlinking the object with the last; caller holds mutex_ exclusively */
+    void release(const std::string& digest);
+
+    std::filesystem::path root_;
+    std::map<std::string, Entry> entries_;
+    std::unordered_map<std::string, size_t> references_;
+    size_t total_bytes_ = 0;
+    std::shared_mutex mutex_;  // Guards the three above and renames into objects/ and meta/
+    std::atomic<std::uint64_t> next_temp_{0};
+};
+
+} // namespace blob
+} // namespace dbal
+
+#endif // DBAL_FILESYSTEM_STORAGE_HPP
@@ -0,0 +1,97 @@
+/**
+ * @file blob_chunk.hpp
+ * @brief Immutable, shared chunks that blob contents are made of
+ *
+ * A blob's bytes are split into chunks that never change once built; see
+ * chunk_builder.hpp for where the cuts fall and chunk_store.hpp for how
+ * chunks with the same bytes are shared. Blobs, copies of them and
+ * readers in the middle of a download all hold the same chunks by
+ * shared_ptr, so a reader keeps what it is reading alive after the blob
+ * is overwritten or deleted, and nothing is copied to hand bytes out.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace dbal {
+namespace blob {
+
+// Chunks are cut where the content says (chunk_builder.hpp), no shorter
+// than the minimum unless they end the blob and never longer than the maximum
+constexpr size_t kBlobChunkMinBytes = 16 * 1024;
+constexpr size_t kBlobChunkAverageBytes = 64 * 1024;
+constexpr size_t kBlobChunkBytes = 256 * 1024;
+
+struct BlobChunk {
+    std::unique_ptr<char[]> bytes;
+    size_t size = 0;
+    size_t hash = 0;  // Of bytes; feeds the blob's ETag and the chunk store
+};
+
+using ChunkRef = std::shared_ptr<const BlobChunk>;
+
+/**
+ * @struct BlobSlice
+ * @brief Bytes [offset, offset + length) of one chunk, which it keeps alive
+ */
+struct BlobSlice {
+    ChunkRef chunk;
+    size_t offset = 0;
+    size_t length = 0;
+
+    const char* data() const {
+        return chunk->bytes.get() + offset;
+    }
+
+    std::string_view view() const {
+        return std::string_view(data(), length);
+    }
+};
+
+/**
+ * @struct BlobView
+ * @brief A blob's bytes, or a range of them, as slices in order
+ */
+struct BlobView {
+    std::vector<BlobSlice> slices;
+    size_t size = 0;
+};
+
+/**
+ * @struct BlobContent
+ * @brief The chunks of one blob, in order; immutable once built
+ */
+struct BlobContent {
+    std::vector<ChunkRef> chunks;
+    std::vector<size_t> ends;  // Offset just past each chunk
+    size_t size = 0;
+
+    /**
+     * Slices covering [offset, offset + length), clipped to the blob
+     */
+    BlobView view(size_t offset, size_t length) const {
+        BlobView result;
+        if (offset >= size) {
+            return result;
+        }
+        length = std::min(length, size - offset);
+        auto index = static_cast<size_t>(std::upper_bound(ends.begin(), ends.end(), offset) - ends.begin());
+        size_t remaining = length;
+        size_t start = offset - (index == 0 ? 0 : ends[index - 1]);
+        for (; remaining > 0; ++index, start = 0) {
+            const size_t take = std::min(chunks[index]->size - start, remaining);
+            result.slices.push_back(BlobSlice{chunks[index], start, take});
+            remaining -= take;
+        }
+        result.size = length;
+        return result;
+    }
+};
+
+} // namespace blob
+} // namespace dbal
@@ -6,9 +6,10 @@
 #pragma once
 
 #include <string>
-#include <vector>
 #include <map>
+#include <memory>
 #include <chrono>
+#include "blob_chunk.hpp"
 
 namespace dbal {
 namespace blob {
@@ -16,9 +17,11 @@ namespace blob {
 /**
  * @struct BlobData
  * @brief Internal blob storage structure
+ *
+ * Copying a BlobData shares its content rather than its bytes.
  */
 struct BlobData {
-    std::vector<char> data;
+    std::shared_ptr<const BlobContent> content;
     std::string content_type;
     std::string etag;
     std::chrono::system_clock::time_point last_modified;
@@ -0,0 +1,147 @@
+/**
+ * @file chunk_builder.hpp
+ * @brief Splits blob bytes into content-defined chunks
+ *
+ * Cut points come from a gear rolling hash over the bytes themselves
+ * (FastCDC): a chunk ends where the hash's top bits are all zero, past
+ * kBlobChunkMinBytes, and at kBlobChunkBytes at the latest. The mask is
+ * stricter before kBlobChunkAverageBytes and looser after, which keeps
+ * sizes close to the average. Because cuts follow content rather than
+ * offsets, an insert or delete only changes the chunks around it, and
+ * the rest of an edited blob still matches the chunks of the original.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include "blob_chunk.hpp"
+#include "chunk_store.hpp"
+
+namespace dbal {
+namespace blob {
+
+namespace detail {
+
+constexpr std::array<uint64_t, 256> makeGearTable() {
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (auto& entry : table) {
+        // splitmix64
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        entry = z ^ (z >> 31);
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 256> kGearTable = makeGearTable();
+
+// Top bits of the hash, which depend on the last 64 bytes; 2 bits more
+// and less than log2 of the average size
+constexpr uint64_t kStrictCutMask = ~0ULL << (64 - 18);
+constexpr uint64_t kLooseCutMask = ~0ULL << (64 - 14);
+
+} // namespace detail
+
+/**
+ * @class ChunkBuilder
+ * @brief Fills a buffer in place and seals it into stored chunks
+ *
+ * Callers write into the buffer returned by space() and then commit()
+ * how much they wrote, so stream readers fill it directly. Cuts do not
+ * depend on how the bytes were split across commits, so a streamed and
+ * a buffered upload of the same bytes produce the same chunks.
+ */
+class ChunkBuilder {
+public:
+    explicit ChunkBuilder(ChunkStore& store, size_t expected_size = 0)
+        : store_(store), buffer_(new char[kBlobChunkBytes]) {
+        content_ = std::make_shared<BlobContent>();
+        const size_t expected_chunks = expected_size / kBlobChunkAverageBytes + 1;
+        content_->chunks.reserve(expected_chunks);
+        content_->ends.reserve(expected_chunks);
+    }
+
+    /**
+     * Free space in the buffer; never empty
+     */
+    std::pair<char*, size_t> space() {
+        return {buffer_.get() + filled_, kBlobChunkBytes - filled_};
+    }
+
+    void commit(size_t written) {
+        filled_ += written;
+        scan();
+    }
+
+    void append(const char* data, size_t size) {
+        while (size > 0) {
+            auto [buffer, room] = space();
+            const size_t take = std::min(room, size);
+            std::memcpy(buffer, data, take);
+            commit(take);
+            data += take;
+            size -= take;
+        }
+    }
+
+    std::shared_ptr<const BlobContent> finish() {
+        if (filled_ > 0) {
+            cut(filled_);
+        }
+        return std::move(content_);
+    }
+
+private:
+    void scan() {
+        while (scanned_ < filled_) {
+            if (scanned_ < kBlobChunkMinBytes) {
+                // No cut can fall this early, so these bytes are not hashed
+                scanned_ = std::min(filled_, kBlobChunkMinBytes);
+                continue;
+            }
+            const auto* bytes = reinterpret_cast<const unsigned char*>(buffer_.get());
+            bool found = false;
+            for (; scanned_ < filled_ && !found; ++scanned_) {
+                hash_ = (hash_ << 1) + detail::kGearTable[bytes[scanned_]];
+                const uint64_t mask =
+                    scanned_ < kBlobChunkAverageBytes ? detail::kStrictCutMask : detail::kLooseCutMask;
+                found = (hash_ & mask) == 0;
+            }
+            if (found || scanned_ == kBlobChunkBytes) {
+                cut(scanned_);
+            }
+        }
+    }
+
+    /**
+     * Seal the first length bytes as a chunk and move what follows them
+     * to the front of the buffer, unscanned
+     */
+    void cut(size_t length) {
+        ChunkRef chunk = store_.intern(buffer_.get(), length);
+        content_->size += length;
+        content_->chunks.push_back(std::move(chunk));
+        content_->ends.push_back(content_->size);
+        std::memmove(buffer_.get(), buffer_.get() + length, filled_ - length);
+        filled_ -= length;
+        scanned_ = 0;
+        hash_ = 0;
+    }
+
+    ChunkStore& store_;
+    std::unique_ptr<char[]> buffer_;  // kBlobChunkBytes; holds the chunk being cut
+    size_t filled_ = 0;
+    size_t scanned_ = 0;
+    uint64_t hash_ = 0;
+    std::shared_ptr<BlobContent> content_;
+};
+
+} // namespace blob
+} // namespace dbal
@@ -0,0 +1,123 @@
+/**
+ * @file chunk_store.hpp
+ * @brief Chunks indexed by content, so equal bytes are stored once
+ *
+ * intern() hands back the chunk already holding the same bytes when
+ * there is one, and only copies them into a new chunk otherwise. Chunks
+ * are reference counted by their shared_ptr: the last blob or view to
+ * let go of a chunk frees it and drops it from the index. The index is
+ * sharded by hash; a hash match is confirmed byte for byte, so chunks
+ * are never shared by mistake.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include "blob_chunk.hpp"
+
+namespace dbal {
+namespace blob {
+
+class ChunkStore {
+public:
+    ChunkStore() : state_(std::make_shared<State>()) {}
+
+    ChunkStore(const ChunkStore&) = delete;
+    ChunkStore& operator=(const ChunkStore&) = delete;
+
+    /**
+     * The stored chunk holding bytes [data, data + size), added if new
+     */
+    ChunkRef intern(const char* data, size_t size) {
+        const size_t hash = std::hash<std::string_view>{}(std::string_view(data, size));
+        Shard& shard = state_->shards[hash % kShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // Compare through the raw address: a chunk is only deleted after
+        // its deleter has dropped it from the shard under this mutex, so it
+        // is still readable here. Locking every candidate instead could
+        // leave this thread holding the last reference to one, and its
+        // deleter would then relock the mutex from inside this loop.
+        auto [first, last] = shard.chunks.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+            const BlobChunk* candidate = it->second.address;
+            if (candidate->size != size || std::memcmp(candidate->bytes.get(), data, size) != 0) {
+                continue;
+            }
+            if (ChunkRef existing = it->second.chunk.lock()) {
+                return existing;
+            }
+        }
+
+        auto* chunk = new BlobChunk();
+        chunk->bytes.reset(new char[size]);
+        std::memcpy(chunk->bytes.get(), data, size);
+        chunk->size = size;
+        chunk->hash = hash;
+        ChunkRef stored(chunk, [state = state_](const BlobChunk* released) {
+            state->forget(released);
+            delete released;
+        });
+        shard.chunks.emplace(hash, Entry{stored, chunk});
+        state_->bytes.fetch_add(size, std::memory_order_relaxed);
+        state_->count.fetch_add(1, std::memory_order_relaxed);
+        return stored;
+    }
+
+    /**
+     * Bytes held by distinct live chunks
+     */
+    size_t storedBytes() const {
+        return state_->bytes.load(std::memory_order_relaxed);
+    }
+
+    size_t chunkCount() const {
+        return state_->count.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t kShards = 16;
+
+    struct Entry {
+        std::weak_ptr<const BlobChunk> chunk;
+        const BlobChunk* address;  // Tells entries apart once chunk has expired
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_multimap<size_t, Entry> chunks;
+    };
+
+    // Shared with every chunk's deleter, so chunks may outlive the store
+    struct State {
+        std::array<Shard, kShards> shards;
+        std::atomic<size_t> bytes{0};
+        std::atomic<size_t> count{0};
+
+        void forget(const BlobChunk* chunk) {
+            Shard& shard = shards[chunk->hash % kShards];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto [first, last] = shard.chunks.equal_range(chunk->hash);
+            for (auto it = first; it != last; ++it) {
+                if (it->second.address == chunk) {
+                    shard.chunks.erase(it);
+                    break;
+                }
+            }
+            bytes.fetch_sub(chunk->size, std::memory_order_relaxed);
+            count.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace blob
+} // namespace dbal
@@ -6,20 +6,22 @@
 #pragma once
 
 #include <string>
-#include <vector>
 #include <cstdio>
-#include <functional>
+#include "../blob_chunk.hpp"
 
 namespace dbal {
 namespace blob {
 
 /**
- * @brief Generate ETag for blob data
- * @param data The blob data
+ * @brief Generate ETag for blob data from its chunks' hashes
+ * @param content The blob content
  * @return ETag string
  */
-inline std::string generate_etag(const std::vector<char>& data) {
-    size_t hash = std::hash<std::string>{}(std::string(data.begin(), data.end()));
+inline std::string generate_etag(const BlobContent& content) {
+    size_t hash = content.size;
+    for (const auto& chunk : content.chunks) {
+        hash = (hash ^ chunk->hash) * 0x100000001b3ULL;
+    }
     char buffer[32];
     snprintf(buffer, sizeof(buffer), "\"%016zx\"", hash);
     return std::string(buffer);
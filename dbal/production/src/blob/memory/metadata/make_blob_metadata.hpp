@@ -7,7 +7,7 @@
 
 #include "dbal/blob_storage.hpp"
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
+#include "../blob_data.hpp"
 
 namespace dbal {
 namespace blob {
@@ -21,7 +21,7 @@ namespace blob {
 inline Result<BlobMetadata> make_blob_metadata(const std::string& key, const BlobData& blob) {
     BlobMetadata meta;
     meta.key = key;
-    meta.size = blob.data.size();
+    meta.size = blob.content->size;
     meta.content_type = blob.content_type;
     meta.etag = blob.etag;
     meta.last_modified = blob.last_modified;
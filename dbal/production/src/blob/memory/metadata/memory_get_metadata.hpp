@@ -6,10 +6,10 @@
 #pragma once
 
 #include <map>
-#include <mutex>
+#include <shared_mutex>
 #include "dbal/blob_storage.hpp"
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
+#include "../blob_data.hpp"
 #include "make_blob_metadata.hpp"
 
 namespace dbal {
@@ -20,10 +20,10 @@ namespace blob {
  */
 inline Result<BlobMetadata> memory_get_metadata(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex,
+    std::shared_mutex& mutex,
     const std::string& key
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_lock<std::shared_mutex> lock(mutex);
 
     auto it = store.find(key);
     if (it == store.end()) {
@@ -7,8 +7,9 @@
 
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
+#include "../blob_data.hpp"
 
 namespace dbal {
 namespace blob {
@@ -18,17 +19,20 @@ namespace blob {
  */
 inline Result<bool> memory_delete(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex,
+    std::shared_mutex& mutex,
     const std::string& key
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_lock<std::shared_mutex> lock(mutex);
 
     auto it = store.find(key);
     if (it == store.end()) {
         return Error::notFound("Blob not found: " + key);
     }
 
+    // Chunks no other blob or reader holds are freed after the lock
+    BlobData removed = std::move(it->second);
     store.erase(it);
+    lock.unlock();
     return Result<bool>(true);
 }
 
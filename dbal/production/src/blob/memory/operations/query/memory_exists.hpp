@@ -6,9 +6,9 @@
 #pragma once
 
 #include <map>
-#include <mutex>
+#include <shared_mutex>
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
+#include "../../blob_data.hpp"
 
 namespace dbal {
 namespace blob {
@@ -18,10 +18,10 @@ namespace blob {
  */
 inline Result<bool> memory_exists(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex,
+    std::shared_mutex& mutex,
     const std::string& key
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_lock<std::shared_mutex> lock(mutex);
     return Result<bool>(store.find(key) != store.end());
 }
 
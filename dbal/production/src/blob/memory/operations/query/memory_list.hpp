@@ -6,43 +6,31 @@
 #pragma once
 
 #include <map>
-#include <mutex>
+#include <shared_mutex>
 #include "dbal/blob_storage.hpp"
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
-#include "make_blob_metadata.hpp"
+#include "../../blob_data.hpp"
+#include "../../metadata/make_blob_metadata.hpp"
+#include "../../../sorted_listing.hpp"
 
 namespace dbal {
 namespace blob {
 
 /**
- * @brief List blobs from memory store
+ * @brief List a page of blobs from memory store
+ *
+ * Seeks to the prefix or continuation token rather than scanning from the
+ * first key; see list_sorted.
  */
 inline Result<BlobListResult> memory_list(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex,
+    std::shared_mutex& mutex,
     const ListOptions& options
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
-
-    BlobListResult result;
-    result.is_truncated = false;
-    result.next_token = std::nullopt;
-
-    std::string prefix = options.prefix.value_or("");
-    
-    for (const auto& [key, blob] : store) {
-        if (prefix.empty() || key.find(prefix) == 0) {
-            if (result.items.size() >= options.max_keys) {
-                result.is_truncated = true;
-                result.next_token = key;
-                break;
-            }
-            result.items.push_back(make_blob_metadata(key, blob).value());
-        }
-    }
-
-    return Result<BlobListResult>(result);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return list_sorted(store, options, [](const std::string& key, const BlobData& blob) {
+        return make_blob_metadata(key, blob).value();
+    });
 }
 
 } // namespace blob
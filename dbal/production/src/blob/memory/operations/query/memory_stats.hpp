@@ -6,9 +6,10 @@
 #pragma once
 
 #include <map>
-#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
+#include "../../blob_data.hpp"
 
 namespace dbal {
 namespace blob {
@@ -18,13 +19,13 @@ namespace blob {
  */
 inline Result<size_t> memory_total_size(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex
+    std::shared_mutex& mutex
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_lock<std::shared_mutex> lock(mutex);
 
     size_t total = 0;
     for (const auto& [key, blob] : store) {
-        total += blob.data.size();
+        total += blob.content->size;
     }
 
     return Result<size_t>(total);
@@ -35,11 +36,51 @@ inline Result<size_t> memory_total_size(
  */
 inline Result<size_t> memory_object_count(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex
+    std::shared_mutex& mutex
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_lock<std::shared_mutex> lock(mutex);
     return Result<size_t>(store.size());
 }
 
+/**
+ * @struct BlobUsage
+ * @brief Storage used by the blobs under one key prefix
+ */
+struct BlobUsage {
+    size_t blobs = 0;
+    size_t logical_bytes = 0;   // Sum of blob sizes
+    size_t physical_bytes = 0;  // Distinct chunks those blobs hold, each counted once
+};
+
+/**
+ * @brief Logical and physical usage of the blobs whose keys start with prefix
+ *
+ * A chunk shared with blobs outside the prefix still counts in full, so
+ * the physical figure is what the prefix alone would need.
+ */
+inline BlobUsage memory_usage(
+    std::map<std::string, BlobData>& store,
+    std::shared_mutex& mutex,
+    const std::string& prefix
+) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    BlobUsage usage;
+    std::unordered_set<const BlobChunk*> seen;
+    for (auto it = store.lower_bound(prefix); it != store.end(); ++it) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) {
+            break;
+        }
+        ++usage.blobs;
+        usage.logical_bytes += it->second.content->size;
+        for (const auto& chunk : it->second.content->chunks) {
+            if (seen.insert(chunk.get()).second) {
+                usage.physical_bytes += chunk->size;
+            }
+        }
+    }
+    return usage;
+}
+
 } // namespace blob
 } // namespace dbal
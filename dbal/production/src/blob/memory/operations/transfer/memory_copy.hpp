@@ -7,34 +7,37 @@
 
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 #include "dbal/blob_storage.hpp"
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
-#include "make_blob_metadata.hpp"
+#include "../../blob_data.hpp"
+#include "../../metadata/make_blob_metadata.hpp"
 
 namespace dbal {
 namespace blob {
 
 /**
- * @brief Copy blob in memory store
+ * @brief Copy blob in memory store; the copy shares the source's chunks
  */
 inline Result<BlobMetadata> memory_copy(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex,
+    std::shared_mutex& mutex,
     const std::string& source_key,
     const std::string& dest_key
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_lock<std::shared_mutex> lock(mutex);
 
     auto it = store.find(source_key);
     if (it == store.end()) {
         return Error::notFound("Source blob not found: " + source_key);
     }
 
-    store[dest_key] = it->second;
-    store[dest_key].last_modified = std::chrono::system_clock::now();
+    BlobData copy = it->second;
+    copy.last_modified = std::chrono::system_clock::now();
+    auto& stored = store[dest_key];
+    stored = std::move(copy);
 
-    return make_blob_metadata(dest_key, store[dest_key]);
+    return make_blob_metadata(dest_key, stored);
 }
 
 } // namespace blob
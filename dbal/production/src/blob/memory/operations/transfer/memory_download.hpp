@@ -6,48 +6,94 @@
 #pragma once
 
 #include <map>
-#include <mutex>
+#include <memory>
+#include <shared_mutex>
 #include <algorithm>
 #include "dbal/blob_storage.hpp"
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
+#include "../../blob_chunk.hpp"
+#include "../../blob_data.hpp"
 
 namespace dbal {
 namespace blob {
 
 /**
- * @brief Download blob from memory store
+ * @brief Slices of a blob, or of the range options asks for
+ *
+ * Only the lookup holds the lock; the slices share the blob's chunks, so
+ * they stay valid if the blob is then overwritten or deleted.
  */
-inline Result<std::vector<char>> memory_download(
+inline Result<BlobView> memory_view(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex,
+    std::shared_mutex& mutex,
     const std::string& key,
     const DownloadOptions& options
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
-
-    auto it = store.find(key);
-    if (it == store.end()) {
-        return Error::notFound("Blob not found: " + key);
+    std::shared_ptr<const BlobContent> content;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = store.find(key);
+        if (it == store.end()) {
+            return Error::notFound("Blob not found: " + key);
+        }
+        content = it->second.content;
     }
 
-    const auto& data = it->second.data;
-
     if (options.offset.has_value() || options.length.has_value()) {
         size_t offset = options.offset.value_or(0);
-        size_t length = options.length.value_or(data.size() - offset);
-
-        if (offset >= data.size()) {
+        if (offset >= content->size) {
             return Error::validationError("Offset exceeds blob size");
         }
+        return content->view(offset, options.length.value_or(content->size - offset));
+    }
 
-        length = std::min(length, data.size() - offset);
-        return Result<std::vector<char>>(
-            std::vector<char>(data.begin() + offset, data.begin() + offset + length)
-        );
+    return content->view(0, content->size);
+}
+
+/**
+ * @brief Download blob from memory store
+ */
+inline Result<std::vector<char>> memory_download(
+    std::map<std::string, BlobData>& store,
+    std::shared_mutex& mutex,
+    const std::string& key,
+    const DownloadOptions& options
+) {
+    auto view = memory_view(store, mutex, key, options);
+    if (view.isError()) {
+        return view.error();
+    }
+
+    std::vector<char> data;
+    data.reserve(view.value().size);
+    for (const auto& slice : view.value().slices) {
+        data.insert(data.end(), slice.data(), slice.data() + slice.length);
+    }
+    return Result<std::vector<char>>(std::move(data));
+}
+
+/**
+ * @brief Download blob from memory store to a callback, one slice at a time
+ *
+ * Each slice is handed over in place and the next is not produced until
+ * the callback returns.
+ */
+inline Result<bool> memory_download_stream(
+    std::map<std::string, BlobData>& store,
+    std::shared_mutex& mutex,
+    const std::string& key,
+    const StreamCallback& write_callback,
+    const DownloadOptions& options
+) {
+    auto view = memory_view(store, mutex, key, options);
+    if (view.isError()) {
+        return view.error();
     }
 
-    return Result<std::vector<char>>(data);
+    for (const auto& slice : view.value().slices) {
+        write_callback(slice.data(), slice.length);
+    }
+    return Result<bool>(true);
 }
 
 } // namespace blob
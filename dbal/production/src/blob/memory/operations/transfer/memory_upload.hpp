@@ -6,42 +6,122 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include "dbal/blob_storage.hpp"
 #include "dbal/errors.hpp"
-#include "blob_data.hpp"
-#include "generate_etag.hpp"
-#include "make_blob_metadata.hpp"
+#include "../../blob_data.hpp"
+#include "../../chunk_builder.hpp"
+#include "../../chunk_store.hpp"
+#include "../../metadata/generate_etag.hpp"
+#include "../../metadata/make_blob_metadata.hpp"
 
 namespace dbal {
 namespace blob {
 
 /**
- * @brief Upload blob to memory store
+ * @brief Store content built outside the lock under key
  */
-inline Result<BlobMetadata> memory_upload(
+inline Result<BlobMetadata> memory_store_content(
     std::map<std::string, BlobData>& store,
-    std::mutex& mutex,
+    std::shared_mutex& mutex,
     const std::string& key,
-    const std::vector<char>& data,
+    std::shared_ptr<const BlobContent> content,
     const UploadOptions& options
 ) {
-    std::lock_guard<std::mutex> lock(mutex);
+    BlobData blob;
+    blob.etag = generate_etag(*content);
+    blob.content = std::move(content);
+    blob.content_type = options.content_type.value_or("application/octet-stream");
+    blob.metadata = options.metadata;
+    blob.last_modified = std::chrono::system_clock::now();
+    auto metadata = make_blob_metadata(key, blob);
 
+    std::unique_lock<std::shared_mutex> lock(mutex);
     if (!options.overwrite && store.find(key) != store.end()) {
         return Error::conflict("Blob already exists: " + key);
     }
+    // The blob replaced, if any, is released after the lock
+    std::swap(store[key], blob);
+    lock.unlock();
 
-    BlobData blob;
-    blob.data = data;
-    blob.content_type = options.content_type.value_or("application/octet-stream");
-    blob.metadata = options.metadata;
-    blob.last_modified = std::chrono::system_clock::now();
-    blob.etag = generate_etag(data);
+    return metadata;
+}
+
+/**
+ * @brief Refuse early when key exists and may not be overwritten
+ */
+inline Result<bool> memory_check_overwrite(
+    std::map<std::string, BlobData>& store,
+    std::shared_mutex& mutex,
+    const std::string& key,
+    const UploadOptions& options
+) {
+    if (!options.overwrite) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (store.find(key) != store.end()) {
+            return Error::conflict("Blob already exists: " + key);
+        }
+    }
+    return Result<bool>(true);
+}
 
-    store[key] = blob;
+/**
+ * @brief Upload blob to memory store
+ *
+ * Chunks whose bytes are already stored, by this blob or any other, are
+ * shared rather than kept again.
+ */
+inline Result<BlobMetadata> memory_upload(
+    std::map<std::string, BlobData>& store,
+    std::shared_mutex& mutex,
+    ChunkStore& chunks,
+    const std::string& key,
+    const std::vector<char>& data,
+    const UploadOptions& options
+) {
+    auto allowed = memory_check_overwrite(store, mutex, key, options);
+    if (allowed.isError()) {
+        return allowed.error();
+    }
 
-    return make_blob_metadata(key, blob);
+    ChunkBuilder builder(chunks, data.size());
+    builder.append(data.data(), data.size());
+    return memory_store_content(store, mutex, key, builder.finish(), options);
+}
+
+/**
+ * @brief Upload blob to memory store from a reader
+ *
+ * The reader fills the chunking buffer directly, at most the capacity it
+ * is given per call, until it returns 0; size only sizes the chunk table
+ * up front. Nothing is read ahead of what has been chunked.
+ */
+inline Result<BlobMetadata> memory_upload_stream(
+    std::map<std::string, BlobData>& store,
+    std::shared_mutex& mutex,
+    ChunkStore& chunks,
+    const std::string& key,
+    const StreamReader& read_callback,
+    size_t size,
+    const UploadOptions& options
+) {
+    auto allowed = memory_check_overwrite(store, mutex, key, options);
+    if (allowed.isError()) {
+        return allowed.error();
+    }
+
+    ChunkBuilder builder(chunks, size);
+    for (;;) {
+        auto [buffer, room] = builder.space();
+        const size_t read = read_callback(buffer, room);
+        if (read == 0) {
+            break;
+        }
+        builder.commit(read);
+    }
+    return memory_store_content(store, mutex, key, builder.finish(), options);
 }
 
 } // namespace blob
@@ -7,20 +7,23 @@
 
 #include "dbal/blob_storage.hpp"
 #include "dbal/errors.hpp"
+#include "dbal/storage/tenant_context.hpp"
 #include <map>
-#include <mutex>
+#include <shared_mutex>
 
+#include "memory/blob_chunk.hpp"
 #include "memory/blob_data.hpp"
-#include "memory/generate_etag.hpp"
-#include "memory/make_blob_metadata.hpp"
-#include "memory/memory_upload.hpp"
-#include "memory/memory_download.hpp"
-#include "memory/memory_delete.hpp"
-#include "memory/memory_exists.hpp"
-#include "memory/memory_get_metadata.hpp"
-#include "memory/memory_list.hpp"
-#include "memory/memory_copy.hpp"
-#include "memory/memory_stats.hpp"
+#include "memory/chunk_store.hpp"
+#include "memory/metadata/generate_etag.hpp"
+#include "memory/metadata/make_blob_metadata.hpp"
+#include "memory/metadata/memory_get_metadata.hpp"
+#include "memory/operations/memory_delete.hpp"
+#include "memory/operations/query/memory_exists.hpp"
+#include "memory/operations/query/memory_list.hpp"
+#include "memory/operations/query/memory_stats.hpp"
+#include "memory/operations/transfer/memory_copy.hpp"
+#include "memory/operations/transfer/memory_download.hpp"
+#include "memory/operations/transfer/memory_upload.hpp"
 
 namespace dbal {
 namespace blob {
@@ -28,6 +31,12 @@ namespace blob {
 /**
  * @class MemoryStorage
  * @brief In-memory blob storage implementation
+ *
+ * Blobs are kept as immutable, shared chunks (memory/blob_chunk.hpp),
+ * cut by content and stored once however many blobs hold the same bytes
+ * (memory/chunk_store.hpp). Uploads build their chunks before taking the
+ * lock and downloads only hold it to find the blob, so readers never
+ * wait on each other or on a large upload, and copies only add metadata.
  */
 class MemoryStorage : public BlobStorage {
 public:
@@ -38,18 +47,16 @@ public:
         const std::vector<char>& data,
         const UploadOptions& options
     ) override {
-        return memory_upload(store_, mutex_, key, data, options);
+        return memory_upload(store_, mutex_, chunks_, key, data, options);
     }
 
     Result<BlobMetadata> uploadStream(
         const std::string& key,
-        StreamCallback read_callback,
+        StreamReader read_callback,
         size_t size,
         const UploadOptions& options
     ) override {
-        std::vector<char> data;
-        data.reserve(size);
-        return upload(key, data, options);
+        return memory_upload_stream(store_, mutex_, chunks_, key, read_callback, size, options);
     }
 
     Result<std::vector<char>> download(
@@ -64,15 +71,17 @@ public:
         StreamCallback write_callback,
         const DownloadOptions& options
     ) override {
-        auto data_result = download(key, options);
-        if (data_result.isError()) {
-            return Result<bool>(data_result.error());
-        }
-        const auto& data = data_result.value();
-        if (!data.empty()) {
-            write_callback(data.data(), data.size());
-        }
-        return Result<bool>(true);
+        return memory_download_stream(store_, mutex_, key, write_callback, options);
+    }
+
+    /**
+     * Blob bytes, or the range options asks for, without copying them
+     */
+    Result<BlobView> view(
+        const std::string& key,
+        const DownloadOptions& options = {}
+    ) {
+        return memory_view(store_, mutex_, key, options);
     }
 
     Result<bool> deleteBlob(const std::string& key) override {
@@ -113,9 +122,36 @@ public:
         return memory_object_count(store_, mutex_);
     }
 
+    /**
+     * Logical and physical usage of the blobs whose keys start with prefix
+     */
+    BlobUsage usage(const std::string& prefix = "") {
+        return memory_usage(store_, mutex_, prefix);
+    }
+
+    /**
+     * Set the current blob count and logical and physical bytes of
+     * context's quota from the blobs in its namespace
+     */
+    void reportUsage(tenant::TenantContext& context) {
+        const BlobUsage current = usage(context.namespace_());
+        tenant::TenantQuota& quota = context.quota();
+        quota.currentBlobCount = current.blobs;
+        quota.currentBlobStorageBytes = current.logical_bytes;
+        quota.currentBlobPhysicalBytes = current.physical_bytes;
+    }
+
+    /**
+     * Bytes held by distinct chunks, including any only a view still holds
+     */
+    size_t storedBytes() const {
+        return chunks_.storedBytes();
+    }
+
 private:
+    ChunkStore chunks_;
     std::map<std::string, BlobData> store_;
-    std::mutex mutex_;
+    std::shared_mutex mutex_;  // Guards store_ only, never blob bytes
 };
 
 } // namespace blob
@@ -0,0 +1,76 @@
+/**
+ * @file sorted_listing.hpp
+ * @brief One page of a blob listing, read from a key-ordered map
+ *
+ * Shared by the backends that keep their keys in a std::map. A page seeks
+ * to the later of the prefix and the continuation token, stops at the
+ * first key past the prefix, and seeks past every key of a common prefix
+ * once it has been rolled up, so it costs O(log n + page) however far
+ * into the listing it is.
+ */
+
+#pragma once
+
+#include <string>
+#include "dbal/blob_storage.hpp"
+
+namespace dbal {
+namespace blob {
+
+/**
+ * The first string greater than every string starting with prefix; empty
+ * when there is none (prefix is all 0xFF bytes)
+ */
+inline std::string prefix_successor(std::string prefix) {
+    while (!prefix.empty()) {
+        if (static_cast<unsigned char>(prefix.back()) != 0xFF) {
+            prefix.back() = static_cast<char>(static_cast<unsigned char>(prefix.back()) + 1);
+            return prefix;
+        }
+        prefix.pop_back();
+    }
+    return prefix;
+}
+
+/**
+ * @brief List a page of entries, a std::map keyed by blob key
+ * @param describe Called as describe(key, value) for each listed item; returns its BlobMetadata
+ *
+ * next_token is the key the next page starts at.
+ */
+template<typename Map, typename Describe>
+BlobListResult list_sorted(const Map& entries, const ListOptions& options, Describe describe) {
+    const std::string prefix = options.prefix.value_or("");
+    const std::string delimiter = options.delimiter.value_or("");
+
+    BlobListResult result;
+    result.is_truncated = false;
+
+    auto it = entries.lower_bound(
+        options.continuation_token.has_value() && *options.continuation_token > prefix
+            ? *options.continuation_token
+            : prefix);
+    while (it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        if (result.items.size() + result.common_prefixes.size() >= options.max_keys) {
+            result.is_truncated = true;
+            result.next_token = it->first;
+            break;
+        }
+
+        const std::string& key = it->first;
+        const size_t split = delimiter.empty() ? std::string::npos : key.find(delimiter, prefix.size());
+        if (split == std::string::npos) {
+            result.items.push_back(describe(key, it->second));
+            ++it;
+            continue;
+        }
+
+        result.common_prefixes.push_back(key.substr(0, split + delimiter.size()));
+        const std::string after = prefix_successor(result.common_prefixes.back());
+        it = after.empty() ? entries.end() : entries.lower_bound(after);
+    }
+    return result;
+}
+
+} // namespace blob
+} // namespace dbal
@@ -1,238 +1,513 @@
 #include "dbal/client.hpp"
 #include "entities/index.hpp"
+#include "entities/credential/credential_hasher.hpp"
+#include "entities/session/session_reaper.hpp"
 #include "store/in_memory_store.hpp"
+#include "store/store_lock.hpp"
+#include "store/write_ahead_log.hpp"
+#include <optional>
 #include <stdexcept>
 
 namespace dbal {
 
-Client::Client(const ClientConfig& config) : config_(config) {
+using P = StorePartition;
+
+namespace {
+
+/**
+ * Answer a read by id from the store's loader while the record's partition
+ * is still waiting to load, so it does not pay for loading all of it
+ * @returns nothing when the partition has to be loaded after all
+ */
+template<typename Record>
+std::optional<Result<Record>> peekPending(InMemoryStore& store, const std::string& id, const char* not_found) {
+    StoreLoader* loader = store.loader;
+    std::optional<Record> found;
+    if (!loader || id.empty() || !loader->pending(partitionOf<Record>()) || !loader->peek(id, found)) {
+        return std::nullopt;
+    }
+    if (!found) {
+        return Result<Record>(Error::notFound(not_found + id));
+    }
+    return Result<Record>(std::move(*found));
+}
+
+} // namespace
+
+Client::Client(const ClientConfig& config)
+    : store_(std::make_unique<InMemoryStore>()),
+      config_(config),
+      hasher_(std::make_unique<CredentialHasher>(config.password_hashing)) {
     if (config.adapter.empty()) {
         throw std::invalid_argument("Adapter type must be specified");
     }
     if (config.database_url.empty()) {
         throw std::invalid_argument("Database URL must be specified");
     }
+    if (!config.persistence.directory.empty()) {
+        wal_ = std::make_unique<WriteAheadLog>(*store_, config.persistence);
+    }
+    // Started once the log is attached, so its removals are logged
+    reaper_ = std::make_unique<SessionReaper>(*store_, std::chrono::milliseconds(config.sessions.reap_interval_ms),
+                                              config.sessions.reap_batch);
 }
 
 Client::~Client() {
+    // Finish the queued credential calls and stop reaping while the log still records them
+    reaper_.reset();
+    hasher_.reset();
     close();
 }
 
+Client::Client(Client&&) noexcept = default;
+
+Client& Client::operator=(Client&& other) noexcept {
+    if (this != &other) {
+        // The reaper, queued credential calls and the log refer to the store, so they go first
+        reaper_.reset();
+        hasher_.reset();
+        wal_.reset();
+        adapter_ = std::move(other.adapter_);
+        store_ = std::move(other.store_);
+        wal_ = std::move(other.wal_);
+        config_ = std::move(other.config_);
+        hasher_ = std::move(other.hasher_);
+        reaper_ = std::move(other.reaper_);
+    }
+    return *this;
+}
+
 Result<User> Client::createUser(const CreateUserInput& input) {
-    return entities::user::create(getStore(), input);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::create(*store_, input);
 }
 
 Result<User> Client::getUser(const std::string& id) {
-    return entities::user::get(getStore(), id);
+    if (auto peeked = peekPending<User>(*store_, id, "User not found: ")) {
+        return std::move(*peeked);
+    }
+    StoreLock lock(*store_, {readLock(P::Users, id)});
+    return entities::user::get(*store_, id);
 }
 
 Result<User> Client::updateUser(const std::string& id, const UpdateUserInput& input) {
-    return entities::user::update(getStore(), id, input);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::update(*store_, id, input);
 }
 
 Result<bool> Client::deleteUser(const std::string& id) {
-    return entities::user::remove(getStore(), id);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::remove(*store_, id);
 }
 
 Result<std::vector<User>> Client::listUsers(const ListOptions& options) {
-    return entities::user::list(getStore(), options);
+    StoreLock lock(*store_, {readLock(P::Users)});
+    return entities::user::list(*store_, options);
 }
 
 Result<int> Client::batchCreateUsers(const std::vector<CreateUserInput>& inputs) {
-    return entities::user::batchCreate(getStore(), inputs);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::batchCreate(*store_, inputs);
 }
 
 Result<int> Client::batchUpdateUsers(const std::vector<UpdateUserBatchItem>& updates) {
-    return entities::user::batchUpdate(getStore(), updates);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::batchUpdate(*store_, updates);
 }
 
 Result<int> Client::batchDeleteUsers(const std::vector<std::string>& ids) {
-    return entities::user::batchDelete(getStore(), ids);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::batchDelete(*store_, ids);
 }
 
 Result<std::vector<User>> Client::searchUsers(const std::string& query, int limit) {
-    return entities::user::search(getStore(), query, limit);
+    StoreLock lock(*store_, {readLock(P::Users)});
+    return entities::user::search(*store_, query, limit);
 }
 
 Result<int> Client::countUsers(const std::optional<std::string>& role) {
-    return entities::user::count(getStore(), role);
+    StoreLock lock(*store_, {readLock(P::Users)});
+    return entities::user::count(*store_, role);
 }
 
 Result<int> Client::updateManyUsers(const std::map<std::string, std::string>& filter,
                                    const UpdateUserInput& updates) {
-    return entities::user::updateMany(getStore(), filter, updates);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::updateMany(*store_, filter, updates);
 }
 
 Result<int> Client::deleteManyUsers(const std::map<std::string, std::string>& filter) {
-    return entities::user::deleteMany(getStore(), filter);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::user::deleteMany(*store_, filter);
 }
 
+namespace {
+
+// The hash runs before the store is locked, and the check after it is released
+
+Result<bool> setCredentialIn(InMemoryStore& store,
+                             const CreateCredentialInput& input,
+                             const security::PasswordHashCost& cost) {
+    auto valid = entities::credential::validateInput(input);
+    if (valid.isError()) {
+        return valid.error();
+    }
+    const Credential hashed = entities::credential::hashCredential(input, cost);
+    StoreLock lock(store, {readLock(P::Users, input.username), writeLock(P::Credentials)});
+    return entities::credential::storeHashed(store, hashed);
+}
+
+Result<bool> verifyCredentialIn(InMemoryStore& store,
+                                const std::string& username,
+                                const std::string& password,
+                                const security::PasswordHashCost& cost) {
+    if (username.empty() || password.empty()) {
+        return Error::validationError("username and password are required");
+    }
+    std::optional<Credential> credential;
+    {
+        StoreLock lock(store, {readLock(P::Users, username), readLock(P::Credentials, username)});
+        credential = entities::credential::lookup(store, username);
+    }
+    return entities::credential::matches(credential, password, cost);
+}
+
+} // namespace
+
 Result<bool> Client::setCredential(const CreateCredentialInput& input) {
-    return entities::credential::set(getStore(), input);
+    return setCredentialIn(*store_, input, hasher_->cost());
 }
 
 Result<bool> Client::verifyCredential(const std::string& username, const std::string& password) {
-    return entities::credential::verify(getStore(), username, password);
+    return verifyCredentialIn(*store_, username, password, hasher_->cost());
+}
+
+void Client::setCredentialAsync(const CreateCredentialInput& input, std::function<void(Result<bool>)> done) {
+    auto job = [store = store_.get(), cost = hasher_->cost(), input, done] {
+        Result<bool> result = Error::internal();
+        try {
+            result = setCredentialIn(*store, input, cost);
+        } catch (const std::exception& e) {
+            result = Error::internal(e.what());
+        }
+        done(std::move(result));
+    };
+    if (!hasher_->submit(std::move(job))) {
+        done(Error::unavailable("Too many credential requests; retry later"));
+    }
+}
+
+void Client::verifyCredentialAsync(const std::string& username,
+                                   const std::string& password,
+                                   std::function<void(Result<bool>)> done) {
+    auto job = [store = store_.get(), cost = hasher_->cost(), username, password, done] {
+        Result<bool> result = Error::internal();
+        try {
+            result = verifyCredentialIn(*store, username, password, cost);
+        } catch (const std::exception& e) {
+            result = Error::internal(e.what());
+        }
+        done(std::move(result));
+    };
+    if (!hasher_->submit(std::move(job))) {
+        done(Error::unavailable("Too many credential requests; retry later"));
+    }
 }
 
 Result<bool> Client::setCredentialFirstLoginFlag(const std::string& username, bool flag) {
-    return entities::credential::setFirstLogin(getStore(), username, flag);
+    StoreLock lock(*store_, {writeLock(P::Users)});
+    return entities::credential::setFirstLogin(*store_, username, flag);
 }
 
 Result<bool> Client::getCredentialFirstLoginFlag(const std::string& username) {
-    return entities::credential::getFirstLogin(getStore(), username);
+    StoreLock lock(*store_, {readLock(P::Users)});
+    return entities::credential::getFirstLogin(*store_, username);
 }
 
 Result<bool> Client::deleteCredential(const std::string& username) {
-    return entities::credential::remove(getStore(), username);
+    StoreLock lock(*store_, {writeLock(P::Credentials)});
+    return entities::credential::remove(*store_, username);
 }
 
 Result<PageConfig> Client::createPage(const CreatePageInput& input) {
-    return entities::page::create(getStore(), input);
+    StoreLock lock(*store_, {writeLock(P::Pages)});
+    return entities::page::create(*store_, input);
 }
 
 Result<PageConfig> Client::getPage(const std::string& id) {
-    return entities::page::get(getStore(), id);
+    if (auto peeked = peekPending<PageConfig>(*store_, id, "Page not found: ")) {
+        return std::move(*peeked);
+    }
+    StoreLock lock(*store_, {readLock(P::Pages, id)});
+    return entities::page::get(*store_, id);
 }
 
 Result<PageConfig> Client::getPageByPath(const std::string& path) {
-    return entities::page::getByPath(getStore(), path);
+    StoreLock lock(*store_, {readLock(P::Pages, path)});
+    return entities::page::getByPath(*store_, path);
 }
 
 Result<PageConfig> Client::updatePage(const std::string& id, const UpdatePageInput& input) {
-    return entities::page::update(getStore(), id, input);
+    StoreLock lock(*store_, {writeLock(P::Pages)});
+    return entities::page::update(*store_, id, input);
 }
 
 Result<bool> Client::deletePage(const std::string& id) {
-    return entities::page::remove(getStore(), id);
+    StoreLock lock(*store_, {writeLock(P::Pages)});
+    return entities::page::remove(*store_, id);
 }
 
 Result<std::vector<PageConfig>> Client::listPages(const ListOptions& options) {
-    return entities::page::list(getStore(), options);
+    StoreLock lock(*store_, {readLock(P::Pages)});
+    return entities::page::list(*store_, options);
 }
 
 Result<std::vector<PageConfig>> Client::searchPages(const std::string& query, int limit) {
-    return entities::page::search(getStore(), query, limit);
+    StoreLock lock(*store_, {readLock(P::Pages)});
+    return entities::page::search(*store_, query, limit);
 }
 
 Result<ComponentNode> Client::createComponent(const CreateComponentNodeInput& input) {
-    return entities::component::create(getStore(), input);
+    StoreLock lock(*store_, {readLock(P::Pages), writeLock(P::Components)});
+    return entities::component::create(*store_, input);
 }
 
 Result<ComponentNode> Client::getComponent(const std::string& id) {
-    return entities::component::get(getStore(), id);
+    StoreLock lock(*store_, {readLock(P::Components, id)});
+    return entities::component::get(*store_, id);
 }
 
 Result<ComponentNode> Client::updateComponent(const std::string& id, const UpdateComponentNodeInput& input) {
-    return entities::component::update(getStore(), id, input);
+    StoreLock lock(*store_, {writeLock(P::Components)});
+    return entities::component::update(*store_, id, input);
 }
 
 Result<bool> Client::deleteComponent(const std::string& id) {
-    return entities::component::remove(getStore(), id);
+    StoreLock lock(*store_, {writeLock(P::Components)});
+    return entities::component::remove(*store_, id);
 }
 
 Result<std::vector<ComponentNode>> Client::listComponents(const ListOptions& options) {
-    return entities::component::list(getStore(), options);
+    StoreLock lock(*store_, {readLock(P::Components)});
+    return entities::component::list(*store_, options);
 }
 
-Result<std::vector<ComponentNode>> Client::getComponentTree(const std::string& pageId) {
-    return entities::component::getTree(getStore(), pageId);
+Result<ComponentTreeSnapshot> Client::getComponentTree(const std::string& pageId) {
+    StoreLock lock(*store_, {readLock(P::Pages, pageId), readLock(P::Components, pageId)});
+    return entities::component::getTree(*store_, pageId);
 }
 
 Result<bool> Client::reorderComponents(const std::vector<ComponentOrderUpdate>& updates) {
-    return entities::component::reorder(getStore(), updates);
+    StoreLock lock(*store_, {writeLock(P::Components)});
+    return entities::component::reorder(*store_, updates);
 }
 
 Result<ComponentNode> Client::moveComponent(const MoveComponentInput& input) {
-    return entities::component::move(getStore(), input);
+    StoreLock lock(*store_, {writeLock(P::Components)});
+    return entities::component::move(*store_, input);
 }
 
 Result<std::vector<ComponentNode>> Client::searchComponents(const std::string& query,
                                                             const std::optional<std::string>& pageId,
                                                             int limit) {
-    return entities::component::search(getStore(), query, pageId, limit);
+    StoreLock lock(*store_, {readLock(P::Components)});
+    return entities::component::search(*store_, query, pageId, limit);
 }
 
 Result<std::vector<ComponentNode>> Client::getComponentChildren(const std::string& parentId,
                                                                 const std::optional<std::string>& componentType,
                                                                 int limit) {
-    return entities::component::getChildren(getStore(), parentId, componentType, limit);
+    StoreLock lock(*store_, {readLock(P::Components, parentId)});
+    return entities::component::getChildren(*store_, parentId, componentType, limit);
 }
 
 Result<Workflow> Client::createWorkflow(const CreateWorkflowInput& input) {
-    return entities::workflow::create(getStore(), input);
+    StoreLock lock(*store_, {writeLock(P::Workflows)});
+    return entities::workflow::create(*store_, input);
 }
 
 Result<Workflow> Client::getWorkflow(const std::string& id) {
-    return entities::workflow::get(getStore(), id);
+    StoreLock lock(*store_, {readLock(P::Workflows, id)});
+    return entities::workflow::get(*store_, id);
 }
 
 Result<Workflow> Client::updateWorkflow(const std::string& id, const UpdateWorkflowInput& input) {
-    return entities::workflow::update(getStore(), id, input);
+    StoreLock lock(*store_, {writeLock(P::Workflows)});
+    return entities::workflow::update(*store_, id, input);
 }
 
 Result<bool> Client::deleteWorkflow(const std::string& id) {
-    return entities::workflow::remove(getStore(), id);
+    StoreLock lock(*store_, {writeLock(P::Workflows)});
+    return entities::workflow::remove(*store_, id);
 }
 
 Result<std::vector<Workflow>> Client::listWorkflows(const ListOptions& options) {
-    return entities::workflow::list(getStore(), options);
+    StoreLock lock(*store_, {readLock(P::Workflows)});
+    return entities::workflow::list(*store_, options);
 }
 
 Result<Session> Client::createSession(const CreateSessionInput& input) {
-    return entities::session::create(getStore(), input);
+    StoreLock lock(*store_, {readLock(P::Users), writeLock(P::Sessions)});
+    return entities::session::create(*store_, input);
 }
 
 Result<Session> Client::getSession(const std::string& id) {
-    return entities::session::get(getStore(), id);
+    StoreLock lock(*store_, {readLock(P::Sessions, id)});
+    return entities::session::get(*store_, id);
 }
 
 Result<Session> Client::updateSession(const std::string& id, const UpdateSessionInput& input) {
-    return entities::session::update(getStore(), id, input);
+    StoreLock lock(*store_, {readLock(P::Users), writeLock(P::Sessions)});
+    return entities::session::update(*store_, id, input);
 }
 
 Result<bool> Client::deleteSession(const std::string& id) {
-    return entities::session::remove(getStore(), id);
+    StoreLock lock(*store_, {writeLock(P::Sessions)});
+    return entities::session::remove(*store_, id);
 }
 
 Result<std::vector<Session>> Client::listSessions(const ListOptions& options) {
-    return entities::session::list(getStore(), options);
+    StoreLock lock(*store_, {readLock(P::Sessions)});
+    return entities::session::list(*store_, options);
+}
+
+Result<Session> Client::touchSession(const std::string& id, std::chrono::seconds ttl) {
+    const auto now = std::chrono::system_clock::now();
+    const auto granularity = std::chrono::milliseconds(config_.sessions.touch_granularity_ms);
+    {
+        // Most touches move the expiry too little to write anything
+        StoreLock lock(*store_, {readLock(P::Sessions, id)});
+        auto current = entities::session::get(*store_, id);
+        if (current.isError() || now + ttl - current.value().expiresAt < granularity) {
+            return current;
+        }
+    }
+    StoreLock lock(*store_, {writeLock(P::Sessions)});
+    return entities::session::touch(*store_, id, now, ttl, granularity);
+}
+
+Result<int> Client::reapExpiredSessions() {
+    return Result<int>(reaper_->reap());
 }
 
 Result<InstalledPackage> Client::createPackage(const CreatePackageInput& input) {
-    return entities::package::create(getStore(), input);
+    StoreLock lock(*store_, {writeLock(P::Packages)});
+    return entities::package::create(*store_, input);
 }
 
 Result<InstalledPackage> Client::getPackage(const std::string& id) {
-    return entities::package::get(getStore(), id);
+    StoreLock lock(*store_, {readLock(P::Packages, id)});
+    return entities::package::get(*store_, id);
 }
 
 Result<InstalledPackage> Client::updatePackage(const std::string& id, const UpdatePackageInput& input) {
-    return entities::package::update(getStore(), id, input);
+    StoreLock lock(*store_, {writeLock(P::Packages)});
+    return entities::package::update(*store_, id, input);
 }
 
 Result<bool> Client::deletePackage(const std::string& id) {
-    return entities::package::remove(getStore(), id);
+    StoreLock lock(*store_, {writeLock(P::Packages)});
+    return entities::package::remove(*store_, id);
 }
 
 Result<std::vector<InstalledPackage>> Client::listPackages(const ListOptions& options) {
-    return entities::package::list(getStore(), options);
+    StoreLock lock(*store_, {readLock(P::Packages)});
+    return entities::package::list(*store_, options);
 }
 
 Result<int> Client::batchCreatePackages(const std::vector<CreatePackageInput>& inputs) {
-    return entities::package::batchCreate(getStore(), inputs);
+    StoreLock lock(*store_, {writeLock(P::Packages)});
+    return entities::package::batchCreate(*store_, inputs);
 }
 
 Result<int> Client::batchUpdatePackages(const std::vector<UpdatePackageBatchItem>& updates) {
-    return entities::package::batchUpdate(getStore(), updates);
+    StoreLock lock(*store_, {writeLock(P::Packages)});
+    return entities::package::batchUpdate(*store_, updates);
 }
 
 Result<int> Client::batchDeletePackages(const std::vector<std::string>& ids) {
-    return entities::package::batchDelete(getStore(), ids);
+    StoreLock lock(*store_, {writeLock(P::Packages)});
+    return entities::package::batchDelete(*store_, ids);
+}
+
+namespace {
+
+void addBatchAccess(std::vector<PartitionAccess>& partitions, const BatchAccess& access) {
+    const auto mode = [&access](StorePartition partition) {
+        return access.write ? writeLock(partition) : readLock(partition);
+    };
+    switch (access.entity) {
+        case BatchEntity::User:
+            partitions.push_back(mode(P::Users));
+            break;
+        case BatchEntity::Page:
+            partitions.push_back(mode(P::Pages));
+            break;
+        case BatchEntity::Component:
+            partitions.push_back(readLock(P::Pages));
+            partitions.push_back(mode(P::Components));
+            break;
+        case BatchEntity::Workflow:
+            partitions.push_back(mode(P::Workflows));
+            break;
+        case BatchEntity::Session:
+            partitions.push_back(readLock(P::Users));
+            partitions.push_back(mode(P::Sessions));
+            break;
+        case BatchEntity::Package:
+            partitions.push_back(mode(P::Packages));
+            break;
+    }
+}
+
+} // namespace
+
+Result<bool> Client::batch(const std::vector<BatchAccess>& access,
+                           bool atomic,
+                           const std::function<Result<bool>()>& body) {
+    std::vector<PartitionAccess> partitions;
+    for (const auto& entry : access) {
+        addBatchAccess(partitions, entry);
+    }
+    BatchLock lock(*store_, partitions.begin(), partitions.end());
+    if (!atomic) {
+        return body();
+    }
+
+    if (store_->undo_log) {
+        throw std::logic_error("Atomic batches cannot be nested");
+    }
+    StoreUndoLog undo;
+    store_->undo_log = &undo;
+    try {
+        auto result = body();
+        store_->undo_log = nullptr;
+        if (result.isError()) {
+            entities::rollback(*store_, undo);
+        }
+        return result;
+    } catch (...) {
+        store_->undo_log = nullptr;
+        entities::rollback(*store_, undo);
+        throw;
+    }
+}
+
+Result<bool> Client::checkpoint() {
+    if (!wal_) {
+        return Error::validationError("Persistence is not configured");
+    }
+    if (!wal_->checkpoint()) {
+        return Error::internal("Snapshot could not be written");
+    }
+    return Result<bool>(true);
 }
 
 void Client::close() {
-    // For in-memory implementation, optionally clear store.
+    // Drains the group-commit buffer; the store itself stays readable
+    if (wal_) {
+        wal_->close();
+    }
 }
 
 } // namespace dbal
@@ -0,0 +1,229 @@
+#include "blob_routes.hpp"
+#include "server_helpers/response.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <json/json.h>
+#include <optional>
+#include <string_view>
+
+// Kept apart from the other routes: the blob API's ListOptions would
+// clash with dbal::ListOptions from the client headers they include
+#include "blob/filesystem_storage.hpp"
+
+namespace dbal {
+namespace daemon {
+
+namespace {
+
+using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+struct ByteRange {
+    size_t offset = 0;
+    size_t length = 0;
+    bool satisfiable = true;
+};
+
+/**
+ * The range a Range header asks of a blob of size bytes. No header, or
+ * one this does not serve (other units, several ranges, malformed), gives
+ * nullopt and the whole blob is sent, as RFC 9110 allows.
+ */
+std::optional<ByteRange> parse_range(const std::string& header, size_t size) {
+    constexpr std::string_view kUnit = "bytes=";
+    std::string_view spec(header);
+    if (spec.substr(0, kUnit.size()) != kUnit || spec.find(',') != std::string_view::npos) {
+        return std::nullopt;
+    }
+    spec.remove_prefix(kUnit.size());
+    const auto dash = spec.find('-');
+    if (dash == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    auto number = [](std::string_view digits, size_t& out) {
+        if (digits.empty() || digits.size() > 19 ||
+            !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return false;
+        }
+        out = std::stoull(std::string(digits));
+        return true;
+    };
+
+    ByteRange range;
+    size_t first = 0;
+    size_t last = 0;
+    if (dash == 0) {
+        // bytes=-n: the last n bytes
+        if (!number(spec.substr(1), last)) {
+            return std::nullopt;
+        }
+        range.satisfiable = last > 0 && size > 0;
+        range.length = std::min(last, size);
+        range.offset = size - range.length;
+        return range;
+    }
+    if (!number(spec.substr(0, dash), first)) {
+        return std::nullopt;
+    }
+    last = size == 0 ? 0 : size - 1;
+    if (dash + 1 < spec.size()) {
+        size_t requested = 0;
+        if (!number(spec.substr(dash + 1), requested) || requested < first) {
+            return std::nullopt;
+        }
+        last = std::min(last, requested);
+    }
+    range.satisfiable = first < size;
+    range.offset = first;
+    range.length = range.satisfiable ? last - first + 1 : 0;
+    return range;
+}
+
+void send_error(const Callback& callback, const std::string& message, int status) {
+    ::Json::Value body;
+    body["success"] = false;
+    body["error"] = message;
+    auto response = drogon::HttpResponse::newHttpJsonResponse(body);
+    response->setStatusCode(static_cast<drogon::HttpStatusCode>(status));
+    callback(response);
+}
+
+void send_failure(const Callback& callback, const Error& error) {
+    send_error(callback, error.what(), static_cast<int>(error.code()));
+}
+
+::Json::Value metadata_json(const BlobMetadata& metadata) {
+    ::Json::Value data;
+    data["key"] = metadata.key;
+    data["size"] = static_cast<::Json::UInt64>(metadata.size);
+    data["contentType"] = metadata.content_type;
+    data["etag"] = metadata.etag;
+    return data;
+}
+
+void serve_blob(blob::FilesystemStorage& storage, const drogon::HttpRequestPtr& request,
+                const Callback& callback, const std::string& key) {
+    auto location = storage.locate(key);
+    if (location.isError()) {
+        send_failure(callback, location.error());
+        return;
+    }
+    const auto& found = location.value();
+    const auto range = parse_range(request->getHeader("Range"), found.length);
+    if (range.has_value() && !range->satisfiable) {
+        auto response = drogon::HttpResponse::newHttpResponse();
+        response->setStatusCode(drogon::k416RequestedRangeNotSatisfiable);
+        response->addHeader("Content-Range", "bytes */" + std::to_string(found.length));
+        callback(response);
+        return;
+    }
+
+    // Sent from the descriptor locate() opened, which the reader holds
+    // until the response is done, so a DELETE or PUT landing meanwhile
+    // cannot unlink the object out from under it; a partial range
+    // answers 206
+    blob::BlobLocation sent = found;
+    if (range.has_value()) {
+        sent.offset = found.offset + range->offset;
+        sent.length = range->length;
+    }
+    auto response = drogon::HttpResponse::newStreamResponse(
+        [sent, done = size_t(0)](char* buffer, std::size_t size) mutable {
+            const size_t read = blob::FilesystemStorage::readLocated(sent, done, buffer, size);
+            done += read;
+            return read;
+        },
+        "", drogon::CT_CUSTOM, found.metadata.content_type);
+    if (range.has_value()) {
+        response->setStatusCode(drogon::k206PartialContent);
+        response->addHeader("Content-Range", "bytes " + std::to_string(range->offset) + "-" +
+                                                 std::to_string(range->offset + range->length - 1) + "/" +
+                                                 std::to_string(found.length));
+    }
+    response->addHeader("Server", "DBAL/1.0.0");
+    response->addHeader("ETag", found.metadata.etag);
+    response->addHeader("Accept-Ranges", "bytes");
+    callback(response);
+}
+
+void store_blob(blob::FilesystemStorage& storage, const drogon::HttpRequestPtr& request,
+                const Callback& callback, const std::string& key) {
+    UploadOptions options;
+    const std::string& content_type = request->getHeader("Content-Type");
+    if (!content_type.empty()) {
+        options.content_type = content_type;
+    }
+    options.overwrite = request->getHeader("If-None-Match") != "*";
+
+    std::string_view body = request->getBody();
+    auto stored = storage.uploadStream(
+        key,
+        [&body](char* buffer, size_t capacity) {
+            const size_t take = std::min(capacity, body.size());
+            std::memcpy(buffer, body.data(), take);
+            body.remove_prefix(take);
+            return take;
+        },
+        body.size(), options);
+    if (stored.isError()) {
+        const Error& error = stored.error();
+        // A refused conditional PUT is a failed precondition, not a conflict
+        send_error(callback, error.what(),
+                   error.code() == ErrorCode::Conflict ? 412 : static_cast<int>(error.code()));
+        return;
+    }
+    ::Json::Value body_json;
+    body_json["success"] = true;
+    body_json["data"] = metadata_json(stored.value());
+    callback(build_json_response(body_json));
+}
+
+void delete_blob(blob::FilesystemStorage& storage, const Callback& callback, const std::string& key) {
+    auto deleted = storage.deleteBlob(key);
+    if (deleted.isError()) {
+        send_failure(callback, deleted.error());
+        return;
+    }
+    ::Json::Value body;
+    body["success"] = true;
+    callback(build_json_response(body));
+}
+
+} // namespace
+
+std::shared_ptr<blob::FilesystemStorage> open_blob_storage(const std::string& directory) {
+    return std::make_shared<blob::FilesystemStorage>(directory);
+}
+
+void register_blob_routes(std::shared_ptr<blob::FilesystemStorage> storage) {
+    auto blob_handler = [storage](const drogon::HttpRequestPtr& request, Callback&& callback,
+                                  const std::string& key) {
+        switch (request->method()) {
+            case drogon::HttpMethod::Get:
+            case drogon::HttpMethod::Head:
+                serve_blob(*storage, request, callback, key);
+                break;
+            case drogon::HttpMethod::Put:
+                store_blob(*storage, request, callback, key);
+                break;
+            case drogon::HttpMethod::Delete:
+                delete_blob(*storage, callback, key);
+                break;
+            default:
+                send_error(callback, "Method not allowed", 405);
+                break;
+        }
+    };
+
+    drogon::app().registerHandlerViaRegex(
+        "/api/blobs/(.+)",
+        blob_handler,
+        {drogon::HttpMethod::Get, drogon::HttpMethod::Head,
+         drogon::HttpMethod::Put, drogon::HttpMethod::Delete}
+    );
+}
+
+} // namespace daemon
+} // namespace dbal
@@ -0,0 +1,31 @@
+#ifndef DBAL_BLOB_ROUTES_HPP
+#define DBAL_BLOB_ROUTES_HPP
+
+#include <memory>
+#include <string>
+
+namespace dbal {
+namespace blob {
+class FilesystemStorage;
+} // namespace blob
+
+namespace daemon {
+
+/**
+ * Open the blob store kept under directory
+ * @throws std::runtime_error when it cannot be created or read
+ */
+std::shared_ptr<blob::FilesystemStorage> open_blob_storage(const std::string& directory);
+
+/**
+ * Serve storage under /api/blobs/{key}: GET and HEAD send the stored file
+ * with sendfile, honouring a single byte Range; PUT stores the request
+ * body (If-None-Match: * refuses to replace a blob); DELETE removes it.
+ * Register before the RESTful patterns, which would otherwise match too.
+ */
+void register_blob_routes(std::shared_ptr<blob::FilesystemStorage> storage);
+
+} // namespace daemon
+} // namespace dbal
+
+#endif // DBAL_BLOB_ROUTES_HPP
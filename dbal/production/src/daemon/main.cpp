@@ -44,8 +44,13 @@ int main(int argc, char* argv[]) {
     std::string config_file = "config.yaml";
     std::string bind_address = "127.0.0.1";
     int port = 8080;
+    int threads = 0;  // 0 = one event loop per hardware core
     bool development_mode = false;
     bool daemon_mode = false;  // Default to interactive mode
+    std::string data_dir;      // Empty = nothing persisted
+    int wal_sync_ms = 5;
+    int session_reap_ms = 1000;
+    std::string blob_dir;      // Empty = no /api/blobs/ routes
     
     // Check environment variables
     const char* env_bind = std::getenv("DBAL_BIND_ADDRESS");
@@ -54,6 +59,9 @@ int main(int argc, char* argv[]) {
     const char* env_port = std::getenv("DBAL_PORT");
     if (env_port) port = std::stoi(env_port);
     
+    const char* env_threads = std::getenv("DBAL_THREADS");
+    if (env_threads) threads = std::stoi(env_threads);
+    
     const char* env_mode = std::getenv("DBAL_MODE");
     if (env_mode) {
         std::string mode_str = env_mode;
@@ -69,6 +77,18 @@ int main(int argc, char* argv[]) {
         daemon_mode = (daemon_str == "true" || daemon_str == "1" || daemon_str == "yes");
     }
     
+    const char* env_data_dir = std::getenv("DBAL_DATA_DIR");
+    if (env_data_dir) data_dir = env_data_dir;
+    
+    const char* env_wal_sync = std::getenv("DBAL_WAL_SYNC_MS");
+    if (env_wal_sync) wal_sync_ms = std::stoi(env_wal_sync);
+    
+    const char* env_session_reap = std::getenv("DBAL_SESSION_REAP_MS");
+    if (env_session_reap) session_reap_ms = std::stoi(env_session_reap);
+    
+    const char* env_blob_dir = std::getenv("DBAL_BLOB_DIR");
+    if (env_blob_dir) blob_dir = env_blob_dir;
+    
     // Parse command line arguments (override environment variables)
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -79,9 +99,17 @@ int main(int argc, char* argv[]) {
             bind_address = argv[++i];
         } else if (arg == "--port" && i + 1 < argc) {
             port = std::stoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
         } else if (arg == "--mode" && i + 1 < argc) {
             std::string mode = argv[++i];
             development_mode = (mode == "development" || mode == "dev");
+        } else if (arg == "--data-dir" && i + 1 < argc) {
+            data_dir = argv[++i];
+        } else if (arg == "--wal-sync-ms" && i + 1 < argc) {
+            wal_sync_ms = std::stoi(argv[++i]);
+        } else if (arg == "--blob-dir" && i + 1 < argc) {
+            blob_dir = argv[++i];
         } else if (arg == "--daemon" || arg == "-d") {
             daemon_mode = true;
         } else if (arg == "--help" || arg == "-h") {
@@ -90,7 +118,11 @@ int main(int argc, char* argv[]) {
             std::cout << "  --config <file>    Configuration file (default: config.yaml)" << std::endl;
             std::cout << "  --bind <address>   Bind address (default: 127.0.0.1)" << std::endl;
             std::cout << "  --port <port>      Port number (default: 8080)" << std::endl;
+            std::cout << "  --threads <n>      HTTP worker threads (default: 0 = one per core)" << std::endl;
             std::cout << "  --mode <mode>      Run mode: production, development (default: production)" << std::endl;
+            std::cout << "  --data-dir <dir>   Persist the store here (default: none, in-memory only)" << std::endl;
+            std::cout << "  --wal-sync-ms <n>  Group-commit window for the write-ahead log (default: 5)" << std::endl;
+            std::cout << "  --blob-dir <dir>   Serve blobs stored here under /api/blobs/ (default: none)" << std::endl;
             std::cout << "  --daemon, -d       Run in daemon mode (default: interactive)" << std::endl;
             std::cout << "  --help, -h         Show this help message" << std::endl;
             std::cout << std::endl;
@@ -100,6 +132,12 @@ int main(int argc, char* argv[]) {
             std::cout << "  DBAL_MODE          Run mode (production/development)" << std::endl;
             std::cout << "  DBAL_CONFIG        Configuration file path" << std::endl;
             std::cout << "  DBAL_DAEMON        Run in daemon mode (true/false)" << std::endl;
+            std::cout << "  DBAL_DATA_DIR      Directory for the write-ahead log and snapshots" << std::endl;
+            std::cout << "  DBAL_WAL_SYNC_MS   Group-commit window in milliseconds" << std::endl;
+            std::cout << "  DBAL_SESSION_REAP_MS  How often expired sessions are removed (default: 1000, 0 = never)" << std::endl;
+            std::cout << "  DBAL_BLOB_DIR      Directory for blobs served under /api/blobs/" << std::endl;
+            std::cout << "  DBAL_PASSWORD_HASH_COST     log2 of the scrypt cost for new credentials (default: 15)" << std::endl;
+            std::cout << "  DBAL_PASSWORD_HASH_THREADS  Credential hashing threads (default: 0 = one per core)" << std::endl;
             std::cout << "  DBAL_LOG_LEVEL     Log level (trace/debug/info/warn/error/critical)" << std::endl;
             std::cout << std::endl;
             std::cout << "Interactive mode (default):" << std::endl;
@@ -122,6 +160,8 @@ int main(int argc, char* argv[]) {
     
     std::cout << "Configuration: " << config_file << std::endl;
     std::cout << "Mode: " << (development_mode ? "development" : "production") << std::endl;
+    std::cout << "Data directory: " << (data_dir.empty() ? "(none, in-memory only)" : data_dir) << std::endl;
+    std::cout << "Blob directory: " << (blob_dir.empty() ? "(none)" : blob_dir) << std::endl;
     std::cout << std::endl;
     
     dbal::ClientConfig client_config;
@@ -138,9 +178,21 @@ int main(int argc, char* argv[]) {
     if (endpoint_env) {
         client_config.endpoint = endpoint_env;
     }
+    client_config.persistence.directory = data_dir;
+    client_config.persistence.group_commit_ms = wal_sync_ms;
+    client_config.sessions.reap_interval_ms = session_reap_ms;
+    const char* hash_cost_env = std::getenv("DBAL_PASSWORD_HASH_COST");
+    if (hash_cost_env) {
+        client_config.password_hashing.cost_log2 = static_cast<unsigned>(std::stoi(hash_cost_env));
+    }
+    const char* hash_threads_env = std::getenv("DBAL_PASSWORD_HASH_THREADS");
+    if (hash_threads_env) {
+        client_config.password_hashing.workers = static_cast<size_t>(std::stoi(hash_threads_env));
+    }
 
     // Create and start HTTP server
-    server_instance = std::make_unique<dbal::daemon::Server>(bind_address, port, client_config);
+    server_instance = std::make_unique<dbal::daemon::Server>(bind_address, port, client_config,
+                                                             threads, blob_dir);
     
     if (!server_instance->start()) {
         std::cerr << "Failed to start server" << std::endl;
@@ -152,6 +204,9 @@ int main(int argc, char* argv[]) {
     std::cout << "  GET  /health      - Health check" << std::endl;
     std::cout << "  GET  /version     - Version information" << std::endl;
     std::cout << "  GET  /status      - Server status" << std::endl;
+    if (!blob_dir.empty()) {
+        std::cout << "  GET|PUT|DELETE /api/blobs/{key} - Blob storage" << std::endl;
+    }
     std::cout << std::endl;
     
     if (daemon_mode) {
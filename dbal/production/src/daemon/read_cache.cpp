@@ -0,0 +1,285 @@
+#include "read_cache.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <random>
+#include <utility>
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+namespace {
+
+constexpr char kSeparator = '\x1f';
+
+// Rough per-entry bookkeeping (list node, index slot, control block)
+constexpr std::size_t kEntryOverhead = 128;
+
+void append_hex(std::string& out, std::uint64_t value) {
+    char buffer[16];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, 16);
+    out.append(buffer, result.ptr);
+}
+
+std::string epoch_counter(const std::string& route) {
+    std::string key = route;
+    key += kSeparator;
+    key += '*';
+    return key;
+}
+
+std::string tenant_counter(const std::string& route, const std::string& tenantId) {
+    std::string key = route;
+    key += kSeparator;
+    key += 't';
+    key += kSeparator;
+    key += tenantId;
+    return key;
+}
+
+std::string record_counter(const std::string& route, const std::string& id) {
+    std::string key = route;
+    key += kSeparator;
+    key += 'i';
+    key += kSeparator;
+    key += id;
+    return key;
+}
+
+std::string floor_counter(const std::string& route) {
+    std::string key = route;
+    key += kSeparator;
+    key += 'f';
+    return key;
+}
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+} // namespace
+
+ReadCache::ReadCache(std::size_t max_bytes) : shard_budget_(max_bytes / kShards) {
+    std::random_device random;
+    const std::uint64_t boot = (static_cast<std::uint64_t>(random()) << 32) ^ random();
+    append_hex(boot_, boot);
+}
+
+ReadCache::Read ReadCache::beginRead(const EntityRoute& route,
+                                     const std::string& tenantId,
+                                     const std::string& package,
+                                     const std::string& id,
+                                     const std::map<std::string, std::string>& query) const {
+    Read read;
+    if (!route.cacheable) {
+        return read;
+    }
+
+    read.key = route.name;
+    read.key += kSeparator;
+    read.key += tenantId;
+    read.key += kSeparator;
+    read.key += package;
+    read.key += kSeparator;
+    read.key += id;
+    read.key += kSeparator;
+    for (const auto& [name, value] : query) {
+        read.key += name;
+        read.key += '=';
+        read.key += value;
+        read.key += '&';
+    }
+
+    read.counters.push_back(epoch_counter(route.name));
+    if (id.empty()) {
+        read.counters.push_back(tenant_counter(route.name, tenantId));
+    } else {
+        // The record before the floor: a version dropped after this reads
+        // it finds the floor it bumped first
+        read.counters.push_back(record_counter(route.name, id));
+        read.counters.push_back(floor_counter(route.name));
+    }
+    if (!route.cache_parent.empty()) {
+        read.counters.push_back(epoch_counter(route.cache_parent));
+        read.counters.push_back(tenant_counter(route.cache_parent, tenantId));
+    }
+    read.etag = currentTag(read.counters);
+    return read;
+}
+
+std::shared_ptr<const std::string> ReadCache::find(const Read& read) {
+    if (!read.cacheable()) {
+        return nullptr;
+    }
+    BodyShard& shard = bodyShard(read.key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto it = shard.index.find(read.key);
+    if (it == shard.index.end()) {
+        return nullptr;
+    }
+    if (it->second->etag != read.etag) {
+        erase(shard, it->second);
+        return nullptr;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->body;
+}
+
+bool ReadCache::store(const Read& read, const std::string& body) {
+    if (!read.cacheable() || currentTag(read.counters) != read.etag) {
+        return false;
+    }
+    const std::size_t bytes = read.key.size() + read.etag.size() + body.size() + kEntryOverhead;
+    if (bytes > shard_budget_) {
+        return true;
+    }
+    auto shared = std::make_shared<const std::string>(body);
+
+    BodyShard& shard = bodyShard(read.key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto existing = shard.index.find(read.key);
+    if (existing != shard.index.end()) {
+        erase(shard, existing->second);
+    }
+    shard.entries.push_front(Entry{read.key, read.etag, std::move(shared), bytes});
+    shard.index.emplace(shard.entries.front().key, shard.entries.begin());
+    shard.bytes += bytes;
+    while (shard.bytes > shard_budget_) {
+        erase(shard, std::prev(shard.entries.end()));
+    }
+    return true;
+}
+
+std::string ReadCache::currentTag(const std::vector<std::string>& counters) const {
+    std::string etag = "\"" + boot_;
+    for (const auto& key : counters) {
+        std::uint64_t version = 0;
+        {
+            CounterShard& shard = counterShard(key);
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            auto it = shard.counters.find(key);
+            if (it != shard.counters.end()) {
+                if (it->second.writers > 0) {
+                    return std::string();
+                }
+                version = it->second.version;
+            }
+        }
+        etag += etag.size() == boot_.size() + 1 ? '-' : '.';
+        append_hex(etag, version);
+    }
+    etag += '"';
+    return etag;
+}
+
+void ReadCache::beginWrite(const std::string& key) {
+    CounterShard& shard = counterShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    Counter& counter = shard.counters[key];
+    ++counter.writers;
+    ++counter.version;
+}
+
+void ReadCache::endWrite(const std::string& key, const std::string& floor) {
+    {
+        CounterShard& shard = counterShard(key);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        Counter& counter = shard.counters[key];
+        ++counter.version;
+        if (--counter.writers > 0 || floor.empty()) {
+            return;
+        }
+    }
+    bump(floor);
+    CounterShard& shard = counterShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto it = shard.counters.find(key);
+    if (it != shard.counters.end() && it->second.writers == 0) {
+        shard.counters.erase(it);
+    }
+}
+
+void ReadCache::bump(const std::string& key) {
+    CounterShard& shard = counterShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    ++shard.counters[key].version;
+}
+
+ReadCache::CounterShard& ReadCache::counterShard(const std::string& key) const {
+    return counters_[std::hash<std::string>{}(key) % kShards];
+}
+
+ReadCache::BodyShard& ReadCache::bodyShard(const std::string& key) {
+    return bodies_[std::hash<std::string>{}(key) % kShards];
+}
+
+void ReadCache::erase(BodyShard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->bytes;
+    shard.index.erase(it->key);
+    shard.entries.erase(it);
+}
+
+ReadCache::WriteScope::~WriteScope() {
+    for (const auto& key : keys_) {
+        cache_.endWrite(key.counter, key.floor);
+    }
+}
+
+void ReadCache::WriteScope::add(const EntityRoute& route,
+                                RpcAction action,
+                                const std::string& tenantId,
+                                const std::string& id) {
+    const bool single_record = action == RpcAction::Update || action == RpcAction::Delete;
+    if (tenantId.empty() || (!single_record && action != RpcAction::Create) || (single_record && id.empty())) {
+        begin(epoch_counter(route.name));
+    }
+    if (!tenantId.empty()) {
+        begin(tenant_counter(route.name, tenantId));
+    }
+    if (single_record && !id.empty()) {
+        begin(record_counter(route.name, id),
+              action == RpcAction::Delete ? floor_counter(route.name) : std::string());
+    }
+}
+
+void ReadCache::WriteScope::begin(std::string key, std::string floor) {
+    auto it = std::find_if(keys_.begin(), keys_.end(), [&](const Key& held) { return held.counter == key; });
+    if (it != keys_.end()) {
+        if (it->floor.empty()) {
+            it->floor = std::move(floor);
+        }
+        return;
+    }
+    cache_.beginWrite(key);
+    keys_.push_back(Key{std::move(key), std::move(floor)});
+}
+
+bool etag_matches(std::string_view if_none_match, const std::string& etag) {
+    while (!if_none_match.empty()) {
+        const std::size_t comma = if_none_match.find(',');
+        std::string_view candidate = trim(if_none_match.substr(0, comma));
+        if_none_match = comma == std::string_view::npos ? std::string_view() : if_none_match.substr(comma + 1);
+        if (candidate == "*") {
+            return true;
+        }
+        if (candidate.substr(0, 2) == "W/") {
+            candidate.remove_prefix(2);
+        }
+        if (!candidate.empty() && candidate == etag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
@@ -0,0 +1,182 @@
+#ifndef DBAL_READ_CACHE_HPP
+#define DBAL_READ_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "rpc_dispatch_table.hpp"
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+/**
+ * Validators and serialized bodies for RESTful GETs
+ *
+ * Every entity route has version counters: an epoch for the whole route,
+ * a generation per tenant collection and a version per record. Writes
+ * bump the counters they can affect (see WriteScope), so a GET's strong
+ * ETag is built from the counters its answer depends on:
+ *
+ *   list: route epoch + tenant generation
+ *   item: route epoch + record version + route floor
+ *
+ * plus, for a route with a cache_parent, the parent's epoch and tenant
+ * generation. A request whose ETag is still current can be answered
+ * with 304, or from the bounded LRU of serialized bodies, without
+ * touching the client. Cached bodies carry the ETag they were stored
+ * under, so a write leaves every body it affects unreachable at once;
+ * the stale entry is dropped on its next lookup or by eviction.
+ *
+ * While a write to a counter is in flight, reads that depend on it get
+ * no ETag and are neither cached nor answered from the cache.
+ *
+ * A deleted record's version is dropped once its last writer finishes,
+ * so deletes do not leave a counter behind forever. The route's floor is
+ * bumped first: a missing version reads as 0, and the floor keeps the
+ * ETags issued after the drop from repeating one issued before it.
+ */
+class ReadCache {
+public:
+    static constexpr std::size_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+    explicit ReadCache(std::size_t max_bytes = kDefaultMaxBytes);
+
+    ReadCache(const ReadCache&) = delete;
+    ReadCache& operator=(const ReadCache&) = delete;
+
+    /**
+     * A GET resolved to its cache key and the ETag current when it began
+     */
+    struct Read {
+        std::string key;
+        std::string etag;                   // Empty when the answer must not be cached
+        std::vector<std::string> counters;  // What etag was built from
+
+        bool cacheable() const {
+            return !etag.empty();
+        }
+    };
+
+    /**
+     * Call before reading from the client. id is empty for a list; package
+     * and query select among the answers for one collection.
+     */
+    Read beginRead(const EntityRoute& route,
+                   const std::string& tenantId,
+                   const std::string& package,
+                   const std::string& id,
+                   const std::map<std::string, std::string>& query) const;
+
+    /**
+     * Cached body for read, or null when there is none under its ETag
+     */
+    std::shared_ptr<const std::string> find(const Read& read);
+
+    /**
+     * Cache body for read if read's ETag is still current, that is, no
+     * write began since beginRead. False when it is not; the body may
+     * then be newer than the ETag and must be sent without it.
+     */
+    bool store(const Read& read, const std::string& body);
+
+    /**
+     * Marks the counters a set of writes can change as in flight for the
+     * scope's lifetime and bumps each of them on entry and on exit
+     */
+    class WriteScope {
+    public:
+        explicit WriteScope(ReadCache& cache) : cache_(cache) {}
+        ~WriteScope();
+
+        WriteScope(const WriteScope&) = delete;
+        WriteScope& operator=(const WriteScope&) = delete;
+
+        /**
+         * Register a write before it runs. Writes without a tenant, and
+         * moves or reorders that touch records other than id, bump the
+         * route's epoch; the rest bump the tenant generation and, for an
+         * update or delete, the record's version.
+         */
+        void add(const EntityRoute& route, RpcAction action, const std::string& tenantId, const std::string& id);
+
+    private:
+        struct Key {
+            std::string counter;
+            std::string floor;  // Set when the counter is dropped on release
+        };
+
+        void begin(std::string key, std::string floor = std::string());
+
+        ReadCache& cache_;
+        std::vector<Key> keys_;
+    };
+
+private:
+    struct Counter {
+        std::uint64_t version = 0;
+        std::uint32_t writers = 0;
+    };
+
+    struct Entry {
+        std::string key;
+        std::string etag;
+        std::shared_ptr<const std::string> body;
+        std::size_t bytes = 0;
+    };
+
+    static constexpr std::size_t kShards = 16;
+
+    struct alignas(64) CounterShard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Counter> counters;
+    };
+
+    struct alignas(64) BodyShard {
+        std::mutex mutex;
+        std::list<Entry> entries;  // Most recently used first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+        std::size_t bytes = 0;
+    };
+
+    /**
+     * ETag over the counters' versions; empty while a write to any of
+     * them is in flight
+     */
+    std::string currentTag(const std::vector<std::string>& counters) const;
+    void beginWrite(const std::string& key);
+    // Drops key once it has no writers left when floor is set, after
+    // bumping floor
+    void endWrite(const std::string& key, const std::string& floor);
+    void bump(const std::string& key);
+
+    CounterShard& counterShard(const std::string& key) const;
+    BodyShard& bodyShard(const std::string& key);
+    void erase(BodyShard& shard, std::list<Entry>::iterator it);
+
+    std::string boot_;  // Distinguishes ETags of different daemon runs
+    std::size_t shard_budget_;
+    mutable std::array<CounterShard, kShards> counters_;
+    std::array<BodyShard, kShards> bodies_;
+};
+
+/**
+ * True when an If-None-Match header value lists etag or is "*"
+ * (weak comparison, as RFC 9110 requires for If-None-Match)
+ */
+bool etag_matches(std::string_view if_none_match, const std::string& etag);
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
+
+#endif // DBAL_READ_CACHE_HPP
@@ -0,0 +1,218 @@
+#include "rpc_batch_actions.hpp"
+
+#include "dbal/core/errors.hpp"
+
+#include <exception>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+namespace {
+
+const ::Json::Value& empty_object() {
+    static const ::Json::Value value(::Json::objectValue);
+    return value;
+}
+
+/**
+ * View of a string member without copying it out of the document
+ */
+std::string_view string_member(const ::Json::Value& object, const char* key) {
+    const auto& value = object[key];
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    if (!value.isString() || !value.getString(&begin, &end)) {
+        return {};
+    }
+    return std::string_view(begin, static_cast<std::size_t>(end - begin));
+}
+
+const ::Json::Value& object_member(const ::Json::Value& object, const char* key) {
+    const auto& value = object[key];
+    return value.isNull() ? empty_object() : value;
+}
+
+struct OperationOutcome {
+    bool success = false;
+    ::Json::Value data;
+    std::string message;
+    int status = 500;
+};
+
+OperationOutcome run_operation(Client& client, const RpcOperation& operation) {
+    OperationOutcome outcome;
+    bool reported = false;
+    dispatch_rpc(client, operation,
+                 [&](const ::Json::Value& data) {
+                     outcome.success = true;
+                     outcome.data = data;
+                     reported = true;
+                 },
+                 [&](const std::string& message, int status) {
+                     outcome.message = message;
+                     outcome.status = status;
+                     reported = true;
+                 });
+    if (!reported) {
+        outcome.message = "Operation produced no response";
+    }
+    return outcome;
+}
+
+} // namespace
+
+bool parse_rpc_operation(const DispatchTable& table,
+                         const ::Json::Value& request,
+                         const std::string& fallbackTenant,
+                         RpcOperation& operation,
+                         std::string& error) {
+    if (!request.isObject()) {
+        error = "Each operation must be an object";
+        return false;
+    }
+    const auto entity = string_member(request, "entity");
+    auto action_name = string_member(request, "action");
+    if (action_name.empty()) {
+        action_name = string_member(request, "method");
+    }
+    if (entity.empty() || action_name.empty()) {
+        error = "Both entity and action are required";
+        return false;
+    }
+
+    operation.route = table.find(entity);
+    if (operation.route == nullptr) {
+        error = "Unsupported entity: " + std::string(entity);
+        return false;
+    }
+    const auto action = parse_rpc_action(action_name);
+    if (!action.has_value() || !operation.route->supports(action.value())) {
+        error = "Unsupported action: " + std::string(action_name);
+        return false;
+    }
+    operation.action = action.value();
+
+    operation.payload = &object_member(request, "payload");
+    operation.options = &object_member(request, "options");
+    if (request["tenantId"].isString()) {
+        operation.tenantId = request["tenantId"].asString();
+    } else if ((*operation.payload)["tenantId"].isString()) {
+        operation.tenantId = (*operation.payload)["tenantId"].asString();
+    } else {
+        operation.tenantId = fallbackTenant;
+    }
+    return true;
+}
+
+bool is_rpc_batch(const ::Json::Value& request) {
+    return request.isArray() || (request.isObject() && request["operations"].isArray());
+}
+
+void track_rpc_write(ReadCache::WriteScope& writes, const RpcOperation& operation) {
+    if (is_read_action(operation.action)) {
+        return;
+    }
+    writes.add(*operation.route, operation.action, operation.tenantId,
+               std::string(string_member(*operation.payload, "id")));
+}
+
+void dispatch_rpc(Client& client,
+                  const RpcOperation& operation,
+                  ResponseSender send_success,
+                  ErrorSender send_error) {
+    operation.route->handler(client, operation.action, operation.tenantId, *operation.payload,
+                             *operation.options, std::move(send_success), std::move(send_error));
+}
+
+void handle_rpc_batch(Client& client,
+                      const DispatchTable& table,
+                      ReadCache& cache,
+                      const ::Json::Value& request,
+                      ResponseSender send_success,
+                      ErrorSender send_error) {
+    const auto& operations_value = request.isArray() ? request : request["operations"];
+    const bool atomic = request.isObject() && request.get("atomic", false).asBool();
+    const std::string tenantId = request.isObject() ? request.get("tenantId", "").asString() : std::string();
+
+    if (operations_value.empty()) {
+        send_error("A batch needs at least one operation", 400);
+        return;
+    }
+    if (operations_value.size() > kMaxBatchOperations) {
+        send_error("A batch may hold at most " + std::to_string(kMaxBatchOperations) + " operations", 400);
+        return;
+    }
+
+    // Parse and classify everything up front so a malformed batch never
+    // takes a lock, and the lock set is known before the first operation
+    std::vector<RpcOperation> operations(operations_value.size());
+    std::map<BatchEntity, bool> writes;
+    for (::Json::ArrayIndex i = 0; i < operations_value.size(); ++i) {
+        std::string error;
+        if (!parse_rpc_operation(table, operations_value[i], tenantId, operations[i], error)) {
+            send_error("Operation " + std::to_string(i) + ": " + error, 400);
+            return;
+        }
+        writes[operations[i].route->locks] |= !is_read_action(operations[i].action);
+    }
+
+    std::vector<BatchAccess> access;
+    for (const auto& [entity, write] : writes) {
+        access.push_back({entity, write});
+    }
+
+    ReadCache::WriteScope cache_writes(cache);
+    for (const auto& operation : operations) {
+        track_rpc_write(cache_writes, operation);
+    }
+
+    ::Json::Value results(::Json::arrayValue);
+    int failed = 0;
+    std::optional<std::pair<size_t, OperationOutcome>> failure;
+    try {
+        client.batch(access, atomic, [&]() -> Result<bool> {
+            for (size_t i = 0; i < operations.size(); ++i) {
+                auto outcome = run_operation(client, operations[i]);
+                ::Json::Value entry;
+                entry["success"] = outcome.success;
+                if (outcome.success) {
+                    entry["data"] = outcome.data;
+                } else {
+                    ++failed;
+                    entry["message"] = outcome.message;
+                    entry["code"] = outcome.status;
+                    if (atomic) {
+                        failure.emplace(i, std::move(outcome));
+                        return Error::internal("Batch aborted");
+                    }
+                }
+                results.append(entry);
+            }
+            return true;
+        });
+    } catch (const std::exception& e) {
+        send_error(std::string("Batch failed: ") + e.what(), 500);
+        return;
+    }
+
+    if (failure.has_value()) {
+        const auto& [index, outcome] = failure.value();
+        send_error("Operation " + std::to_string(index) + " failed: " + outcome.message, outcome.status);
+        return;
+    }
+
+    ::Json::Value body;
+    body["results"] = results;
+    body["failed"] = failed;
+    send_success(body);
+}
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
@@ -0,0 +1,84 @@
+#ifndef DBAL_RPC_BATCH_ACTIONS_HPP
+#define DBAL_RPC_BATCH_ACTIONS_HPP
+
+#include <cstddef>
+#include <json/json.h>
+#include <string>
+
+#include "dbal/core/client.hpp"
+#include "read_cache.hpp"
+#include "rpc_dispatch_table.hpp"
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+/**
+ * One {entity, action, payload, options, tenantId} call on /api/dbal,
+ * resolved against the dispatch table. payload and options point into
+ * the parsed request, which must outlive the operation.
+ */
+struct RpcOperation {
+    const EntityRoute* route = nullptr;
+    RpcAction action = RpcAction::Get;
+    std::string tenantId;
+    const ::Json::Value* payload = nullptr;
+    const ::Json::Value* options = nullptr;
+};
+
+constexpr std::size_t kMaxBatchOperations = 1000;
+
+/**
+ * Parse one operation; fallbackTenant applies when neither the operation
+ * nor its payload names a tenant. Returns false with error set when
+ * entity or action is missing, unknown, or not served for that entity.
+ */
+bool parse_rpc_operation(const DispatchTable& table,
+                         const ::Json::Value& request,
+                         const std::string& fallbackTenant,
+                         RpcOperation& operation,
+                         std::string& error);
+
+/**
+ * True for a batch body: a top-level array of operations or an object
+ * carrying an "operations" array
+ */
+bool is_rpc_batch(const ::Json::Value& request);
+
+/**
+ * Register operation with writes when it is not a read, so cached GETs
+ * it can change are invalidated
+ */
+void track_rpc_write(ReadCache::WriteScope& writes, const RpcOperation& operation);
+
+/**
+ * Run a parsed operation through its entity's handler
+ */
+void dispatch_rpc(Client& client,
+                  const RpcOperation& operation,
+                  ResponseSender send_success,
+                  ErrorSender send_error);
+
+/**
+ * Run a batch of operations in order under one set of store locks.
+ *
+ * The locks cover every entity the batch names and are taken once, up
+ * front. With "atomic": true the batch stops at the first failing
+ * operation, every write made so far is rolled back and the failure is
+ * reported through send_error. Otherwise every operation runs and
+ * send_success receives {"results": [...], "failed": n}, one
+ * {success, data} or {success: false, message, code} entry per operation.
+ * The batch's writes invalidate cache for the whole time it runs.
+ */
+void handle_rpc_batch(Client& client,
+                      const DispatchTable& table,
+                      ReadCache& cache,
+                      const ::Json::Value& request,
+                      ResponseSender send_success,
+                      ErrorSender send_error);
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
+
+#endif // DBAL_RPC_BATCH_ACTIONS_HPP
@@ -0,0 +1,144 @@
+#include "rpc_dispatch_table.hpp"
+#include "rpc_entity_actions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <stdexcept>
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+namespace {
+
+char lower(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+std::string lowercase(std::string_view value) {
+    std::string result(value);
+    std::transform(result.begin(), result.end(), result.begin(), lower);
+    return result;
+}
+
+/**
+ * Three-way compare of a lowercase key against a name of any case
+ */
+int compare_folded(std::string_view key, std::string_view name) {
+    const std::size_t length = std::min(key.size(), name.size());
+    for (std::size_t i = 0; i < length; ++i) {
+        const char folded = lower(name[i]);
+        if (key[i] != folded) {
+            return key[i] < folded ? -1 : 1;
+        }
+    }
+    if (key.size() == name.size()) {
+        return 0;
+    }
+    return key.size() < name.size() ? -1 : 1;
+}
+
+struct ActionName {
+    std::string_view name;
+    RpcAction action;
+};
+
+constexpr std::array<ActionName, 11> kActionNames = {{
+    {"list", RpcAction::List},
+    {"get", RpcAction::Get},
+    {"read", RpcAction::Get},
+    {"create", RpcAction::Create},
+    {"update", RpcAction::Update},
+    {"delete", RpcAction::Delete},
+    {"remove", RpcAction::Delete},
+    {"tree", RpcAction::Tree},
+    {"move", RpcAction::Move},
+    {"reorder", RpcAction::Reorder},
+    {"children", RpcAction::Children},
+}};
+
+} // namespace
+
+void DispatchTable::add(EntityRoute route) {
+    const std::size_t index = routes_.size();
+    std::vector<std::string> names{lowercase(route.name)};
+    for (const auto& alias : route.aliases) {
+        names.push_back(lowercase(alias));
+    }
+    for (auto& name : names) {
+        auto it = std::lower_bound(names_.begin(), names_.end(), name,
+                                   [](const auto& entry, const std::string& key) { return entry.first < key; });
+        if (it != names_.end() && it->first == name) {
+            throw std::logic_error("Entity route registered twice: " + name);
+        }
+        names_.insert(it, {std::move(name), index});
+    }
+    routes_.push_back(std::move(route));
+}
+
+const EntityRoute* DispatchTable::find(std::string_view entity) const {
+    auto it = std::lower_bound(names_.begin(), names_.end(), entity,
+                               [](const auto& entry, std::string_view name) {
+                                   return compare_folded(entry.first, name) < 0;
+                               });
+    if (it == names_.end() || compare_folded(it->first, entity) != 0) {
+        return nullptr;
+    }
+    return &routes_[it->second];
+}
+
+RpcActionSet rpc_actions(std::initializer_list<RpcAction> actions) {
+    RpcActionSet set;
+    for (auto action : actions) {
+        set.set(static_cast<std::size_t>(action));
+    }
+    return set;
+}
+
+std::optional<RpcAction> parse_rpc_action(std::string_view name) {
+    for (const auto& entry : kActionNames) {
+        if (compare_folded(entry.name, name) == 0) {
+            return entry.action;
+        }
+    }
+    return std::nullopt;
+}
+
+const std::string& rpc_action_name(RpcAction action) {
+    static const std::array<std::string, kRpcActionCount> names = {
+        "list", "get", "create", "update", "delete", "tree", "move", "reorder", "children",
+    };
+    return names[static_cast<std::size_t>(action)];
+}
+
+bool is_read_action(RpcAction action) {
+    return action == RpcAction::List || action == RpcAction::Get ||
+           action == RpcAction::Tree || action == RpcAction::Children;
+}
+
+DispatchTable core_dispatch_table() {
+    const auto crud = rpc_actions({RpcAction::List, RpcAction::Get, RpcAction::Create,
+                                   RpcAction::Update, RpcAction::Delete});
+    auto component_actions = crud;
+    component_actions |= rpc_actions({RpcAction::Tree, RpcAction::Move, RpcAction::Reorder,
+                                      RpcAction::Children});
+
+    DispatchTable table;
+    table.add({"user", {"users"}, BatchEntity::User, crud, handle_user_action, handle_user_list_stream,
+               handle_user_direct});
+    table.add({"page", {"pages", "page_config"}, BatchEntity::Page, crud, handle_page_action});
+    // Component reads check the owning page's tenant
+    table.add({"component", {"components", "component_node"}, BatchEntity::Component, component_actions,
+               handle_component_action, nullptr, nullptr, true, "page"});
+    table.add({"workflow", {"workflows"}, BatchEntity::Workflow, crud, handle_workflow_action});
+    // Session reads skip expired rows, so their answers change without a write
+    table.add({"session", {"sessions"}, BatchEntity::Session, crud, handle_session_action, nullptr, nullptr,
+               false});
+    table.add({"package", {"packages", "installed_package"}, BatchEntity::Package, crud, handle_package_action});
+    return table;
+}
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
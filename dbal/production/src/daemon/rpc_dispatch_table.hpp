@@ -0,0 +1,137 @@
+#ifndef DBAL_RPC_DISPATCH_TABLE_HPP
+#define DBAL_RPC_DISPATCH_TABLE_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <json/json.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "dbal/core/client.hpp"
+#include "rpc_user_actions.hpp"
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+enum class RpcAction : std::uint8_t {
+    List,
+    Get,
+    Create,
+    Update,
+    Delete,
+    Tree,
+    Move,
+    Reorder,
+    Children,
+};
+
+constexpr std::size_t kRpcActionCount = 9;
+
+using RpcActionSet = std::bitset<kRpcActionCount>;
+
+enum class HttpVerb : std::uint8_t {
+    Get,
+    Post,
+    Put,
+    Patch,
+    Delete,
+    Other,
+};
+
+using EntityActionHandler = void (*)(Client& client,
+                                     RpcAction action,
+                                     const std::string& tenantId,
+                                     const ::Json::Value& payload,
+                                     const ::Json::Value& options,
+                                     ResponseSender send_success,
+                                     ErrorSender send_error);
+
+using EntityListStreamer = void (*)(Client& client,
+                                    const std::string& tenantId,
+                                    const ::Json::Value& options,
+                                    StreamSender send_stream,
+                                    ErrorSender send_error);
+
+using EntityDirectHandler = void (*)(Client& client,
+                                     RpcAction action,
+                                     const std::string& tenantId,
+                                     const std::string& id,
+                                     std::string_view body,
+                                     const ::Json::Value& options,
+                                     BodySender send_body,
+                                     ErrorSender send_error);
+
+/**
+ * One entity the daemon serves over /api/dbal and the RESTful routes
+ */
+struct EntityRoute {
+    std::string name;                  // Canonical RPC name, e.g. "page"
+    std::vector<std::string> aliases;  // Other accepted names, e.g. "pages"
+    BatchEntity locks;                 // Store partitions a batch takes for it
+    RpcActionSet actions;              // Actions the handler implements
+    EntityActionHandler handler = nullptr;
+    EntityListStreamer list_stream = nullptr;  // Optional NDJSON list
+    EntityDirectHandler direct = nullptr;      // Optional DOM-free REST path
+    bool cacheable = true;                     // GETs may use the read cache
+    std::string cache_parent;                  // Entity whose writes also change our reads
+
+    bool supports(RpcAction action) const {
+        return actions.test(static_cast<std::size_t>(action));
+    }
+};
+
+/**
+ * Entity routes resolved once, when the server registers its routes
+ *
+ * Lookups compare names case-insensitively in place, so resolving an
+ * entity or action for a request allocates nothing.
+ */
+class DispatchTable {
+public:
+    /**
+     * Register an entity; a name or alias already taken is a logic_error
+     */
+    void add(EntityRoute route);
+
+    const EntityRoute* find(std::string_view entity) const;
+
+    const std::vector<EntityRoute>& routes() const {
+        return routes_;
+    }
+
+private:
+    std::vector<EntityRoute> routes_;
+    std::vector<std::pair<std::string, std::size_t>> names_;  // Lowercase, sorted
+};
+
+RpcActionSet rpc_actions(std::initializer_list<RpcAction> actions);
+
+/**
+ * Action for a case-insensitive name; "read" and "remove" are accepted
+ * for get and delete
+ */
+std::optional<RpcAction> parse_rpc_action(std::string_view name);
+
+/**
+ * Canonical, interned name of an action
+ */
+const std::string& rpc_action_name(RpcAction action);
+
+bool is_read_action(RpcAction action);
+
+/**
+ * Every entity the daemon serves. A new entity is one registration here.
+ */
+DispatchTable core_dispatch_table();
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
+
+#endif // DBAL_RPC_DISPATCH_TABLE_HPP
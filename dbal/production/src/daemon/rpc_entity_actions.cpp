@@ -0,0 +1,671 @@
+#include "rpc_entity_actions.hpp"
+#include "server_helpers/serialization.hpp"
+
+#include "dbal/core/errors.hpp"
+
+#include <optional>
+#include <vector>
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+namespace {
+
+void send_failure(const Error& error, const ErrorSender& send_error) {
+    send_error(error.what(), static_cast<int>(error.code()));
+}
+
+template<typename T, typename ToJson>
+void send_result(const Result<T>& result, ToJson to_json, const ResponseSender& send_success,
+                 const ErrorSender& send_error) {
+    if (result.isError()) {
+        send_failure(result.error(), send_error);
+        return;
+    }
+    send_success(to_json(result.value()));
+}
+
+void send_deleted(const Result<bool>& result, const ResponseSender& send_success, const ErrorSender& send_error) {
+    send_result(result, [](bool deleted) {
+        ::Json::Value body;
+        body["deleted"] = deleted;
+        return body;
+    }, send_success, send_error);
+}
+
+template<typename Owner>
+bool owned_by(const Owner& owner, const std::string& tenantId) {
+    return owner == tenantId;
+}
+
+std::string member_string(const ::Json::Value& payload, const char* key) {
+    const auto& value = payload[key];
+    return value.isString() ? value.asString() : std::string();
+}
+
+std::optional<std::string> optional_string(const ::Json::Value& payload, const char* key) {
+    if (!payload.isMember(key) || !payload[key].isString()) {
+        return std::nullopt;
+    }
+    return payload[key].asString();
+}
+
+/**
+ * Text column that clients may send either as a string or as structured
+ * JSON; structured values are stored in compact form
+ */
+std::optional<std::string> optional_text(const ::Json::Value& payload, const char* key) {
+    if (!payload.isMember(key) || payload[key].isNull()) {
+        return std::nullopt;
+    }
+    const auto& value = payload[key];
+    if (value.isString()) {
+        return value.asString();
+    }
+    ::Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return ::Json::writeString(writer, value);
+}
+
+std::optional<int> optional_int(const ::Json::Value& payload, const char* key) {
+    if (!payload.isMember(key) || !payload[key].isInt()) {
+        return std::nullopt;
+    }
+    return payload[key].asInt();
+}
+
+std::optional<bool> optional_bool(const ::Json::Value& payload, const char* key) {
+    if (!payload.isMember(key) || !payload[key].isBool()) {
+        return std::nullopt;
+    }
+    return payload[key].asBool();
+}
+
+std::optional<Timestamp> optional_timestamp(const ::Json::Value& payload, const char* key) {
+    if (!payload.isMember(key)) {
+        return std::nullopt;
+    }
+    return timestamp_from_json(payload[key]);
+}
+
+ListOptions scoped_list_options(const ::Json::Value& options, const std::string& tenantId) {
+    auto list_options = list_options_from_json(options);
+    list_options.filter["tenantId"] = tenantId;
+    return list_options;
+}
+
+Result<PageConfig> owned_page(Client& client, const std::string& id, const std::string& tenantId) {
+    auto page = client.getPage(id);
+    if (page.isOk() && !owned_by(page.value().tenantId, tenantId)) {
+        return Error::notFound("Page not found: " + id);
+    }
+    return page;
+}
+
+Result<ComponentNode> owned_component(Client& client, const std::string& id, const std::string& tenantId) {
+    auto component = client.getComponent(id);
+    if (component.isError()) {
+        return component;
+    }
+    auto page = owned_page(client, component.value().pageId, tenantId);
+    if (page.isError()) {
+        return Error::notFound("Component not found: " + id);
+    }
+    return component;
+}
+
+Result<Workflow> owned_workflow(Client& client, const std::string& id, const std::string& tenantId) {
+    auto workflow = client.getWorkflow(id);
+    if (workflow.isOk() && !owned_by(workflow.value().tenantId, tenantId)) {
+        return Error::notFound("Workflow not found: " + id);
+    }
+    return workflow;
+}
+
+Result<User> owned_user(Client& client, const std::string& id, const std::string& tenantId) {
+    auto user = client.getUser(id);
+    if (user.isOk() && !owned_by(user.value().tenantId, tenantId)) {
+        return Error::notFound("User not found: " + id);
+    }
+    return user;
+}
+
+Result<Session> owned_session(Client& client, const std::string& id, const std::string& tenantId) {
+    auto session = client.getSession(id);
+    if (session.isError()) {
+        return session;
+    }
+    if (owned_user(client, session.value().userId, tenantId).isError()) {
+        return Error::notFound("Session not found: " + id);
+    }
+    return session;
+}
+
+Result<InstalledPackage> owned_package(Client& client, const std::string& id, const std::string& tenantId) {
+    auto package = client.getPackage(id);
+    if (package.isOk() && !owned_by(package.value().tenantId, tenantId)) {
+        return Error::notFound("Package not found: " + id);
+    }
+    return package;
+}
+
+/**
+ * Reports a missing id or unowned record; true when the handler may go on
+ */
+template<typename T>
+bool check_owned(const Result<T>& owned, const ErrorSender& send_error) {
+    if (owned.isError()) {
+        send_failure(owned.error(), send_error);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Every call is scoped to a tenant, as for users; true when one is given
+ */
+bool require_tenant(const std::string& tenantId, const ErrorSender& send_error) {
+    if (tenantId.empty()) {
+        send_error("Tenant ID is required", 400);
+        return false;
+    }
+    return true;
+}
+
+bool require_id(const std::string& id, const ErrorSender& send_error) {
+    if (id.empty()) {
+        send_error("ID is required", 400);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void handle_user_action(Client& client,
+                        RpcAction action,
+                        const std::string& tenantId,
+                        const ::Json::Value& payload,
+                        const ::Json::Value& options,
+                        ResponseSender send_success,
+                        ErrorSender send_error) {
+    if (action == RpcAction::List) {
+        handle_user_list(client, tenantId, options, send_success, send_error);
+        return;
+    }
+    if (action == RpcAction::Create) {
+        handle_user_create(client, tenantId, payload, send_success, send_error);
+        return;
+    }
+
+    const std::string id = member_string(payload, "id");
+    if (action == RpcAction::Get) {
+        if (id.empty()) {
+            send_error("ID is required for read operations", 400);
+            return;
+        }
+        handle_user_read(client, tenantId, id, send_success, send_error);
+        return;
+    }
+    if (action == RpcAction::Update) {
+        handle_user_update(client, tenantId, id, payload, send_success, send_error);
+        return;
+    }
+    if (action == RpcAction::Delete) {
+        handle_user_delete(client, tenantId, id, send_success, send_error);
+        return;
+    }
+
+    send_error("Unsupported action: " + rpc_action_name(action), 400);
+}
+
+void handle_page_action(Client& client,
+                        RpcAction action,
+                        const std::string& tenantId,
+                        const ::Json::Value& payload,
+                        const ::Json::Value& options,
+                        ResponseSender send_success,
+                        ErrorSender send_error) {
+    if (!require_tenant(tenantId, send_error)) {
+        return;
+    }
+    if (action == RpcAction::List) {
+        const auto list_options = scoped_list_options(options, tenantId);
+        auto result = client.listPages(list_options);
+        send_result(result, [&](const std::vector<PageConfig>& pages) {
+            return list_response_value(pages, list_options);
+        }, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Create) {
+        CreatePageInput input;
+        input.tenantId = tenantId;
+        input.packageId = optional_string(payload, "packageId");
+        input.path = member_string(payload, "path");
+        input.title = member_string(payload, "title");
+        input.description = optional_string(payload, "description");
+        input.icon = optional_string(payload, "icon");
+        input.component = optional_string(payload, "component");
+        input.componentTree = optional_text(payload, "componentTree").value_or("{}");
+        input.level = optional_int(payload, "level").value_or(1);
+        input.requiresAuth = optional_bool(payload, "requiresAuth").value_or(false);
+        input.requiredRole = optional_string(payload, "requiredRole");
+        input.parentPath = optional_string(payload, "parentPath");
+        input.sortOrder = optional_int(payload, "sortOrder").value_or(0);
+        input.isPublished = optional_bool(payload, "isPublished").value_or(true);
+        input.params = optional_text(payload, "params");
+        input.meta = optional_text(payload, "meta");
+        send_result(client.createPage(input), page_to_json, send_success, send_error);
+        return;
+    }
+
+    const std::string id = member_string(payload, "id");
+    if (action == RpcAction::Get && id.empty() && payload.isMember("path")) {
+        auto page = client.getPageByPath(member_string(payload, "path"));
+        if (page.isOk() && !owned_by(page.value().tenantId, tenantId)) {
+            send_error("Page not found", 404);
+            return;
+        }
+        send_result(page, page_to_json, send_success, send_error);
+        return;
+    }
+    if (!require_id(id, send_error)) {
+        return;
+    }
+    auto existing = owned_page(client, id, tenantId);
+
+    if (action == RpcAction::Get) {
+        send_result(existing, page_to_json, send_success, send_error);
+        return;
+    }
+    if (!check_owned(existing, send_error)) {
+        return;
+    }
+
+    if (action == RpcAction::Update) {
+        UpdatePageInput input;
+        input.packageId = optional_string(payload, "packageId");
+        input.path = optional_string(payload, "path");
+        input.title = optional_string(payload, "title");
+        input.description = optional_string(payload, "description");
+        input.icon = optional_string(payload, "icon");
+        input.component = optional_string(payload, "component");
+        input.componentTree = optional_text(payload, "componentTree");
+        input.level = optional_int(payload, "level");
+        input.requiresAuth = optional_bool(payload, "requiresAuth");
+        input.requiredRole = optional_string(payload, "requiredRole");
+        input.parentPath = optional_string(payload, "parentPath");
+        input.sortOrder = optional_int(payload, "sortOrder");
+        input.isPublished = optional_bool(payload, "isPublished");
+        input.params = optional_text(payload, "params");
+        input.meta = optional_text(payload, "meta");
+        send_result(client.updatePage(id, input), page_to_json, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Delete) {
+        send_deleted(client.deletePage(id), send_success, send_error);
+        return;
+    }
+
+    send_error("Unsupported action: " + rpc_action_name(action), 400);
+}
+
+void handle_component_action(Client& client,
+                             RpcAction action,
+                             const std::string& tenantId,
+                             const ::Json::Value& payload,
+                             const ::Json::Value& options,
+                             ResponseSender send_success,
+                             ErrorSender send_error) {
+    if (!require_tenant(tenantId, send_error)) {
+        return;
+    }
+    if (action == RpcAction::List) {
+        const auto list_options = list_options_from_json(options);
+        auto page_it = list_options.filter.find("pageId");
+        if (page_it == list_options.filter.end()) {
+            send_error("A pageId filter is required for tenant-scoped component lists", 400);
+            return;
+        }
+        if (!check_owned(owned_page(client, page_it->second, tenantId), send_error)) {
+            return;
+        }
+        auto result = client.listComponents(list_options);
+        send_result(result, [&](const std::vector<ComponentNode>& components) {
+            return list_response_value(components, list_options);
+        }, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Create || action == RpcAction::Tree) {
+        const std::string pageId = member_string(payload, "pageId");
+        if (pageId.empty()) {
+            send_error("pageId is required", 400);
+            return;
+        }
+        if (!check_owned(owned_page(client, pageId, tenantId), send_error)) {
+            return;
+        }
+        if (action == RpcAction::Tree) {
+            send_result(client.getComponentTree(pageId), [](const ComponentTreeSnapshot& tree) {
+                return component_tree_to_json(*tree);
+            }, send_success, send_error);
+            return;
+        }
+        CreateComponentNodeInput input;
+        input.pageId = pageId;
+        input.parentId = optional_string(payload, "parentId");
+        input.type = member_string(payload, "type");
+        input.childIds = optional_text(payload, "childIds").value_or("[]");
+        input.order = optional_int(payload, "order").value_or(0);
+        send_result(client.createComponent(input), component_to_json, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Reorder) {
+        const auto& updates_value = payload["updates"];
+        if (!updates_value.isArray()) {
+            send_error("updates must be an array of {id, order}", 400);
+            return;
+        }
+        std::vector<ComponentOrderUpdate> updates;
+        for (const auto& entry : updates_value) {
+            ComponentOrderUpdate update;
+            update.id = member_string(entry, "id");
+            update.order = optional_int(entry, "order").value_or(-1);
+            updates.push_back(update);
+        }
+        // Root components of every page share a parent, so each one is checked
+        for (const auto& update : updates) {
+            if (!check_owned(owned_component(client, update.id, tenantId), send_error)) {
+                return;
+            }
+        }
+        send_result(client.reorderComponents(updates), [](bool ok) {
+            ::Json::Value body;
+            body["reordered"] = ok;
+            return body;
+        }, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Children) {
+        const std::string parentId = member_string(payload, "parentId");
+        if (!require_id(parentId, send_error)) {
+            return;
+        }
+        if (!check_owned(owned_component(client, parentId, tenantId), send_error)) {
+            return;
+        }
+        auto result = client.getComponentChildren(parentId, optional_string(payload, "type"),
+                                                  optional_int(payload, "limit").value_or(0));
+        send_result(result, [](const std::vector<ComponentNode>& children) {
+            ::Json::Value array(::Json::arrayValue);
+            for (const auto& child : children) {
+                array.append(component_to_json(child));
+            }
+            return array;
+        }, send_success, send_error);
+        return;
+    }
+
+    const std::string id = member_string(payload, "id");
+    if (!require_id(id, send_error)) {
+        return;
+    }
+    auto existing = owned_component(client, id, tenantId);
+
+    if (action == RpcAction::Get) {
+        send_result(existing, component_to_json, send_success, send_error);
+        return;
+    }
+    if (!check_owned(existing, send_error)) {
+        return;
+    }
+
+    if (action == RpcAction::Update) {
+        UpdateComponentNodeInput input;
+        input.parentId = optional_string(payload, "parentId");
+        input.type = optional_string(payload, "type");
+        input.childIds = optional_text(payload, "childIds");
+        input.order = optional_int(payload, "order");
+        send_result(client.updateComponent(id, input), component_to_json, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Move) {
+        MoveComponentInput input;
+        input.id = id;
+        input.newParentId = member_string(payload, "newParentId");
+        input.order = optional_int(payload, "order").value_or(0);
+        send_result(client.moveComponent(input), component_to_json, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Delete) {
+        send_deleted(client.deleteComponent(id), send_success, send_error);
+        return;
+    }
+
+    send_error("Unsupported action: " + rpc_action_name(action), 400);
+}
+
+void handle_workflow_action(Client& client,
+                            RpcAction action,
+                            const std::string& tenantId,
+                            const ::Json::Value& payload,
+                            const ::Json::Value& options,
+                            ResponseSender send_success,
+                            ErrorSender send_error) {
+    if (!require_tenant(tenantId, send_error)) {
+        return;
+    }
+    if (action == RpcAction::List) {
+        const auto list_options = scoped_list_options(options, tenantId);
+        auto result = client.listWorkflows(list_options);
+        send_result(result, [&](const std::vector<Workflow>& workflows) {
+            return list_response_value(workflows, list_options);
+        }, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Create) {
+        CreateWorkflowInput input;
+        input.tenantId = tenantId;
+        input.name = member_string(payload, "name");
+        input.description = optional_string(payload, "description");
+        input.nodes = optional_text(payload, "nodes").value_or("[]");
+        input.edges = optional_text(payload, "edges").value_or("[]");
+        input.enabled = optional_bool(payload, "enabled").value_or(true);
+        input.version = optional_int(payload, "version").value_or(1);
+        input.createdBy = optional_string(payload, "createdBy");
+        send_result(client.createWorkflow(input), workflow_to_json, send_success, send_error);
+        return;
+    }
+
+    const std::string id = member_string(payload, "id");
+    if (!require_id(id, send_error)) {
+        return;
+    }
+    auto existing = owned_workflow(client, id, tenantId);
+
+    if (action == RpcAction::Get) {
+        send_result(existing, workflow_to_json, send_success, send_error);
+        return;
+    }
+    if (!check_owned(existing, send_error)) {
+        return;
+    }
+
+    if (action == RpcAction::Update) {
+        UpdateWorkflowInput input;
+        input.name = optional_string(payload, "name");
+        input.description = optional_string(payload, "description");
+        input.nodes = optional_text(payload, "nodes");
+        input.edges = optional_text(payload, "edges");
+        input.enabled = optional_bool(payload, "enabled");
+        input.version = optional_int(payload, "version");
+        input.updatedAt = optional_timestamp(payload, "updatedAt");
+        send_result(client.updateWorkflow(id, input), workflow_to_json, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Delete) {
+        send_deleted(client.deleteWorkflow(id), send_success, send_error);
+        return;
+    }
+
+    send_error("Unsupported action: " + rpc_action_name(action), 400);
+}
+
+void handle_session_action(Client& client,
+                           RpcAction action,
+                           const std::string& tenantId,
+                           const ::Json::Value& payload,
+                           const ::Json::Value& options,
+                           ResponseSender send_success,
+                           ErrorSender send_error) {
+    if (!require_tenant(tenantId, send_error)) {
+        return;
+    }
+    if (action == RpcAction::List) {
+        const auto list_options = list_options_from_json(options);
+        auto user_it = list_options.filter.find("userId");
+        if (user_it == list_options.filter.end()) {
+            send_error("A userId filter is required for tenant-scoped session lists", 400);
+            return;
+        }
+        if (!check_owned(owned_user(client, user_it->second, tenantId), send_error)) {
+            return;
+        }
+        auto result = client.listSessions(list_options);
+        send_result(result, [&](const std::vector<Session>& sessions) {
+            return list_response_value(sessions, list_options);
+        }, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Create) {
+        const auto expiresAt = optional_timestamp(payload, "expiresAt");
+        if (!expiresAt.has_value()) {
+            send_error("expiresAt (epoch milliseconds) is required", 400);
+            return;
+        }
+        CreateSessionInput input;
+        input.userId = member_string(payload, "userId");
+        if (!check_owned(owned_user(client, input.userId, tenantId), send_error)) {
+            return;
+        }
+        input.token = member_string(payload, "token");
+        input.expiresAt = expiresAt.value();
+        input.lastActivity = optional_timestamp(payload, "lastActivity");
+        input.ipAddress = optional_string(payload, "ipAddress");
+        input.userAgent = optional_string(payload, "userAgent");
+        send_result(client.createSession(input), session_to_json, send_success, send_error);
+        return;
+    }
+
+    const std::string id = member_string(payload, "id");
+    if (!require_id(id, send_error)) {
+        return;
+    }
+    auto existing = owned_session(client, id, tenantId);
+
+    if (action == RpcAction::Get) {
+        send_result(existing, session_to_json, send_success, send_error);
+        return;
+    }
+    if (!check_owned(existing, send_error)) {
+        return;
+    }
+
+    if (action == RpcAction::Update) {
+        UpdateSessionInput input;
+        input.token = optional_string(payload, "token");
+        input.expiresAt = optional_timestamp(payload, "expiresAt");
+        input.lastActivity = optional_timestamp(payload, "lastActivity");
+        input.ipAddress = optional_string(payload, "ipAddress");
+        input.userAgent = optional_string(payload, "userAgent");
+        send_result(client.updateSession(id, input), session_to_json, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Delete) {
+        send_deleted(client.deleteSession(id), send_success, send_error);
+        return;
+    }
+
+    send_error("Unsupported action: " + rpc_action_name(action), 400);
+}
+
+void handle_package_action(Client& client,
+                           RpcAction action,
+                           const std::string& tenantId,
+                           const ::Json::Value& payload,
+                           const ::Json::Value& options,
+                           ResponseSender send_success,
+                           ErrorSender send_error) {
+    if (!require_tenant(tenantId, send_error)) {
+        return;
+    }
+    if (action == RpcAction::List) {
+        const auto list_options = scoped_list_options(options, tenantId);
+        auto result = client.listPackages(list_options);
+        send_result(result, [&](const std::vector<InstalledPackage>& packages) {
+            return list_response_value(packages, list_options);
+        }, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Create) {
+        CreatePackageInput input;
+        input.packageId = member_string(payload, "packageId");
+        input.tenantId = tenantId;
+        input.installedAt = optional_timestamp(payload, "installedAt");
+        input.version = member_string(payload, "version");
+        input.enabled = optional_bool(payload, "enabled").value_or(true);
+        input.config = optional_text(payload, "config");
+        send_result(client.createPackage(input), package_to_json, send_success, send_error);
+        return;
+    }
+
+    std::string id = member_string(payload, "id");
+    if (id.empty()) {
+        id = member_string(payload, "packageId");
+    }
+    if (!require_id(id, send_error)) {
+        return;
+    }
+    auto existing = owned_package(client, id, tenantId);
+
+    if (action == RpcAction::Get) {
+        send_result(existing, package_to_json, send_success, send_error);
+        return;
+    }
+    if (!check_owned(existing, send_error)) {
+        return;
+    }
+
+    if (action == RpcAction::Update) {
+        UpdatePackageInput input;
+        input.version = optional_string(payload, "version");
+        input.enabled = optional_bool(payload, "enabled");
+        input.config = optional_text(payload, "config");
+        send_result(client.updatePackage(id, input), package_to_json, send_success, send_error);
+        return;
+    }
+
+    if (action == RpcAction::Delete) {
+        send_deleted(client.deletePackage(id), send_success, send_error);
+        return;
+    }
+
+    send_error("Unsupported action: " + rpc_action_name(action), 400);
+}
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
@@ -0,0 +1,77 @@
+#ifndef DBAL_RPC_ENTITY_ACTIONS_HPP
+#define DBAL_RPC_ENTITY_ACTIONS_HPP
+
+#include <json/json.h>
+#include <string>
+
+#include "dbal/core/client.hpp"
+#include "rpc_dispatch_table.hpp"
+
+namespace dbal {
+namespace daemon {
+namespace rpc {
+
+/**
+ * Entity handlers registered in the dispatch table. Each takes an action
+ * the table lists for its entity (list, get, create, update, delete, plus
+ * tree/move/reorder/children for components) and reports through exactly
+ * one of send_success and send_error. Record ids come from payload "id".
+ *
+ * A non-empty tenantId scopes the call: lists are filtered to the tenant
+ * and records owned by another tenant are reported as not found.
+ * Components are owned through their page and sessions through their user.
+ */
+
+void handle_user_action(Client& client,
+                        RpcAction action,
+                        const std::string& tenantId,
+                        const ::Json::Value& payload,
+                        const ::Json::Value& options,
+                        ResponseSender send_success,
+                        ErrorSender send_error);
+
+void handle_page_action(Client& client,
+                        RpcAction action,
+                        const std::string& tenantId,
+                        const ::Json::Value& payload,
+                        const ::Json::Value& options,
+                        ResponseSender send_success,
+                        ErrorSender send_error);
+
+void handle_component_action(Client& client,
+                             RpcAction action,
+                             const std::string& tenantId,
+                             const ::Json::Value& payload,
+                             const ::Json::Value& options,
+                             ResponseSender send_success,
+                             ErrorSender send_error);
+
+void handle_workflow_action(Client& client,
+                            RpcAction action,
+                            const std::string& tenantId,
+                            const ::Json::Value& payload,
+                            const ::Json::Value& options,
+                            ResponseSender send_success,
+                            ErrorSender send_error);
+
+void handle_session_action(Client& client,
+                           RpcAction action,
+                           const std::string& tenantId,
+                           const ::Json::Value& payload,
+                           const ::Json::Value& options,
+                           ResponseSender send_success,
+                           ErrorSender send_error);
+
+void handle_package_action(Client& client,
+                           RpcAction action,
+                           const std::string& tenantId,
+                           const ::Json::Value& payload,
+                           const ::Json::Value& options,
+                           ResponseSender send_success,
+                           ErrorSender send_error);
+
+} // namespace rpc
+} // namespace daemon
+} // namespace dbal
+
+#endif // DBAL_RPC_ENTITY_ACTIONS_HPP
@@ -1,10 +1,8 @@
 #include "rpc_restful_handler.hpp"
-#include "rpc_user_actions.hpp"
+#include "server_helpers/json_reader.hpp"
 
-#include <algorithm>
 #include <cctype>
 #include <exception>
-#include <sstream>
 
 namespace {
 bool parse_int(const std::string& value, int& out) {
@@ -26,178 +24,86 @@ namespace dbal {
 namespace daemon {
 namespace rpc {
 
-std::string toPascalCase(const std::string& snake_case) {
-    std::string result;
-    bool capitalize_next = true;
-    
-    for (char c : snake_case) {
-        if (c == '_') {
-            capitalize_next = true;
-        } else if (capitalize_next) {
-            result += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
-            capitalize_next = false;
-        } else {
-            result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+namespace {
+
+bool is_valid_name(const std::string& name) {
+    if (name.empty()) return false;
+    for (char c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+            return false;
         }
     }
-    
-    return result;
-}
-
-std::string toLower(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-    return result;
-}
-
-std::string RouteInfo::getPrefixedEntity() const {
-    if (package.empty() || entity.empty()) return "";
-    return "Pkg_" + toPascalCase(package) + "_" + toPascalCase(entity);
+    return true;
 }
 
-std::string RouteInfo::getTableName() const {
-    if (package.empty() || entity.empty()) return "";
-    return package + "_" + toLower(entity);
-}
+} // namespace
 
-RouteInfo parseRoute(const std::string& path) {
-    RouteInfo info;
-    
-    // Skip leading slash and split by /
-    std::string clean_path = path;
-    if (!clean_path.empty() && clean_path[0] == '/') {
-        clean_path = clean_path.substr(1);
-    }
-    
-    // Remove trailing slash
-    if (!clean_path.empty() && clean_path.back() == '/') {
-        clean_path.pop_back();
-    }
-    
-    // Split path segments
-    std::vector<std::string> segments;
-    std::istringstream stream(clean_path);
-    std::string segment;
-    
-    while (std::getline(stream, segment, '/')) {
-        if (!segment.empty()) {
-            segments.push_back(segment);
-        }
+std::string validateRoute(const RouteSegments& route) {
+    if (!is_valid_name(route.tenant)) {
+        return "Invalid tenant name: " + route.tenant;
     }
-    
-    // Need at least tenant/package/entity
-    if (segments.size() < 3) {
-        info.valid = false;
-        info.error = "Path requires at least: /{tenant}/{package}/{entity}";
-        return info;
+    if (!is_valid_name(route.package)) {
+        return "Invalid package name: " + route.package;
     }
-    
-    info.tenant = segments[0];
-    info.package = segments[1];
-    info.entity = segments[2];
-    
-    // Optional: ID
-    if (segments.size() > 3) {
-        info.id = segments[3];
+    if (!is_valid_name(route.entity)) {
+        return "Invalid entity name: " + route.entity;
     }
-    
-    // Optional: Action or extra args
-    if (segments.size() > 4) {
-        info.action = segments[4];
-    }
-    
-    // Any remaining segments
-    for (size_t i = 5; i < segments.size(); ++i) {
-        info.extra_args.push_back(segments[i]);
-    }
-    
-    // Validate tenant/package names (alphanumeric + underscore)
-    auto is_valid_name = [](const std::string& name) {
-        if (name.empty()) return false;
-        for (char c : name) {
-            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
-                return false;
-            }
-        }
-        return true;
-    };
-    
-    if (!is_valid_name(info.tenant)) {
-        info.valid = false;
-        info.error = "Invalid tenant name: " + info.tenant;
-        return info;
-    }
-    
-    if (!is_valid_name(info.package)) {
-        info.valid = false;
-        info.error = "Invalid package name: " + info.package;
-        return info;
-    }
-    
-    if (!is_valid_name(info.entity)) {
-        info.valid = false;
-        info.error = "Invalid entity name: " + info.entity;
-        return info;
-    }
-    
-    info.valid = true;
-    return info;
+    return "";
 }
 
 void handleRestfulRequest(
     Client& client,
-    const RouteInfo& route,
-    const std::string& method,
-    const ::Json::Value& body,
+    const DispatchTable& table,
+    const RouteSegments& route,
+    HttpVerb method,
+    std::string_view body,
     const std::map<std::string, std::string>& query,
     ResponseSender send_success,
-    ErrorSender send_error
+    BodySender send_body,
+    ErrorSender send_error,
+    StreamSender send_stream
 ) {
-    if (!route.valid) {
-        send_error(route.error, 400);
+    const std::string route_error = validateRoute(route);
+    if (!route_error.empty()) {
+        send_error(route_error, 400);
         return;
     }
-    
-    std::string normalized_entity = toLower(route.entity);
-    if (normalized_entity == "users") {
-        normalized_entity = "user";
-    }
 
     // Determine operation based on HTTP method and path
-    std::string operation;
-    
-    if (method == "GET") {
-        if (route.id.empty()) {
-            operation = "list";
-        } else {
-            operation = "read";
-        }
-    } else if (method == "POST") {
-        if (!route.action.empty()) {
-            send_error("Custom actions are not supported yet", 404);
-            return;
-        }
-        if (!route.id.empty()) {
-            send_error("POST with a resource ID is not supported; use PUT/PATCH", 400);
-            return;
-        }
-        operation = "create";
-    } else if (method == "PUT" || method == "PATCH") {
-        if (route.id.empty()) {
-            send_error("ID is required for update operations", 400);
-            return;
-        }
-        operation = "update";
-    } else if (method == "DELETE") {
-        if (route.id.empty()) {
-            send_error("ID is required for delete operations", 400);
+    RpcAction operation = RpcAction::Get;
+    switch (method) {
+        case HttpVerb::Get:
+            operation = route.id.empty() ? RpcAction::List : RpcAction::Get;
+            break;
+        case HttpVerb::Post:
+            if (!route.action.empty()) {
+                send_error("Custom actions are not supported yet", 404);
+                return;
+            }
+            if (!route.id.empty()) {
+                send_error("POST with a resource ID is not supported; use PUT/PATCH", 400);
+                return;
+            }
+            operation = RpcAction::Create;
+            break;
+        case HttpVerb::Put:
+        case HttpVerb::Patch:
+            if (route.id.empty()) {
+                send_error("ID is required for update operations", 400);
+                return;
+            }
+            operation = RpcAction::Update;
+            break;
+        case HttpVerb::Delete:
+            if (route.id.empty()) {
+                send_error("ID is required for delete operations", 400);
+                return;
+            }
+            operation = RpcAction::Delete;
+            break;
+        case HttpVerb::Other:
+            send_error("Unsupported HTTP method", 405);
             return;
-        }
-        operation = "delete";
-    } else {
-        send_error("Unsupported HTTP method: " + method, 405);
-        return;
     }
 
     if (!route.action.empty()) {
@@ -205,12 +111,17 @@ void handleRestfulRequest(
         return;
     }
 
-    if (normalized_entity != "user") {
+    const EntityRoute* entity = table.find(route.entity);
+    if (entity == nullptr) {
         send_error("Unsupported entity: " + route.entity, 400);
         return;
     }
+    if (!entity->supports(operation)) {
+        send_error("Unsupported operation: " + rpc_action_name(operation), 400);
+        return;
+    }
 
-    if (operation == "list") {
+    if (operation == RpcAction::List) {
         ::Json::Value options(::Json::objectValue);
         ::Json::Value filter(::Json::objectValue);
         ::Json::Value sort(::Json::objectValue);
@@ -218,6 +129,7 @@ void handleRestfulRequest(
         bool limit_set = false;
         bool page_set = false;
         bool offset_set = false;
+        std::string cursor;
         int limit_value = 0;
         int page_value = 0;
         int offset_value = 0;
@@ -241,6 +153,8 @@ void handleRestfulRequest(
                     return;
                 }
                 offset_set = true;
+            } else if (key == "cursor" || key == "after") {
+                cursor = value;
             } else if (key.rfind("filter.", 0) == 0) {
                 filter[key.substr(7)] = value;
             } else if (key.rfind("where.", 0) == 0) {
@@ -252,6 +166,11 @@ void handleRestfulRequest(
             }
         }
 
+        if (!cursor.empty() && (page_set || offset_set)) {
+            send_error("cursor cannot be combined with page or offset", 400);
+            return;
+        }
+
         if (offset_set && !page_set) {
             int effective_limit = limit_set ? limit_value : 20;
             if (effective_limit <= 0) {
@@ -268,6 +187,9 @@ void handleRestfulRequest(
         if (page_set) {
             options["page"] = page_value;
         }
+        if (!cursor.empty()) {
+            options["cursor"] = cursor;
+        }
         if (!filter.empty()) {
             options["filter"] = filter;
         }
@@ -275,31 +197,40 @@ void handleRestfulRequest(
             options["sort"] = sort;
         }
 
-        rpc::handle_user_list(client, route.tenant, options, send_success, send_error);
-        return;
-    }
-
-    if (operation == "read") {
-        rpc::handle_user_read(client, route.tenant, route.id, send_success, send_error);
+        if (send_stream && entity->list_stream) {
+            entity->list_stream(client, route.tenant, options, send_stream, send_error);
+            return;
+        }
+        if (send_body && entity->direct) {
+            entity->direct(client, operation, route.tenant, route.id, body, options, send_body, send_error);
+            return;
+        }
+        entity->handler(client, operation, route.tenant, ::Json::Value(::Json::objectValue), options,
+                        send_success, send_error);
         return;
     }
 
-    if (operation == "create") {
-        rpc::handle_user_create(client, route.tenant, body, send_success, send_error);
+    const ::Json::Value no_options(::Json::objectValue);
+    if (send_body && entity->direct) {
+        entity->direct(client, operation, route.tenant, route.id, body, no_options, send_body, send_error);
         return;
     }
 
-    if (operation == "update") {
-        rpc::handle_user_update(client, route.tenant, route.id, body, send_success, send_error);
-        return;
+    ::Json::Value payload(::Json::objectValue);
+    if (operation == RpcAction::Create || operation == RpcAction::Update) {
+        std::string parse_error;
+        if (!body.empty() && !parse_json_document(body, payload, parse_error)) {
+            send_error("Invalid JSON payload: " + parse_error, 400);
+            return;
+        }
+        if (!payload.isObject()) {
+            payload = ::Json::Value(::Json::objectValue);
+        }
     }
-
-    if (operation == "delete") {
-        rpc::handle_user_delete(client, route.tenant, route.id, send_success, send_error);
-        return;
+    if (!route.id.empty()) {
+        payload["id"] = route.id;
     }
-
-    send_error("Unsupported operation: " + operation, 400);
+    entity->handler(client, operation, route.tenant, payload, no_options, send_success, send_error);
 }
 
 } // namespace rpc
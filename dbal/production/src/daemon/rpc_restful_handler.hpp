@@ -1,19 +1,22 @@
 #ifndef DBAL_RPC_RESTFUL_HANDLER_HPP
 #define DBAL_RPC_RESTFUL_HANDLER_HPP
 
+#include <cstddef>
 #include <functional>
 #include <json/json.h>
+#include <map>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "dbal/core/client.hpp"
+#include "rpc_dispatch_table.hpp"
 
 namespace dbal {
 namespace daemon {
 namespace rpc {
 
 /**
- * @brief Parsed route information from RESTful path
+ * @brief Path segments of a RESTful request
  * 
  * Route pattern: /{tenant}/{package}/{entity}[/{id}[/{action}]]
  * 
@@ -24,69 +27,62 @@ namespace rpc {
  *   PUT  /acme_corp/forum_forge/posts/123       -> update post 123
  *   DELETE /acme_corp/forum_forge/posts/123     -> delete post 123
  *   POST /acme_corp/forum_forge/posts/123/like  -> custom action
+ *
+ * The segments refer to the router's already-split path parameters and
+ * are never copied; id and action are empty when absent.
  */
-struct RouteInfo {
-    std::string tenant;       // Tenant identifier (username or tenant name)
-    std::string package;      // Package name (e.g., forum_forge)
-    std::string entity;       // Entity name (e.g., posts, users)
-    std::string id;           // Optional: Resource ID
-    std::string action;       // Optional: Custom action (e.g., like, approve)
-    std::vector<std::string> extra_args;  // Any additional path segments
-    
-    bool valid = false;
-    std::string error;
-    
-    /**
-     * @brief Get the prefixed entity name for DBAL
-     * Format: Pkg_{PascalPackage}_{Entity}
-     */
-    std::string getPrefixedEntity() const;
-    
-    /**
-     * @brief Get the table name
-     * Format: {package}_{lowercase_entity}
-     */
-    std::string getTableName() const;
+struct RouteSegments {
+    const std::string& tenant;   // Tenant identifier (username or tenant name)
+    const std::string& package;  // Package name (e.g., forum_forge)
+    const std::string& entity;   // Entity name (e.g., posts, users)
+    const std::string& id;       // Optional: Resource ID
+    const std::string& action;   // Optional: Custom action (e.g., like, approve)
 };
 
 /**
- * @brief Parse a RESTful path into route components
- * @param path The request path (e.g., "/acme_corp/forum_forge/posts/123")
- * @return Parsed RouteInfo
+ * @brief Check tenant, package and entity names (alphanumeric + underscore)
+ * @return Empty on success, otherwise the error message
  */
-RouteInfo parseRoute(const std::string& path);
-
-/**
- * @brief Convert snake_case to PascalCase
- */
-std::string toPascalCase(const std::string& snake_case);
-
-/**
- * @brief Convert string to lowercase
- */
-std::string toLower(const std::string& str);
+std::string validateRoute(const RouteSegments& route);
 
 using ResponseSender = std::function<void(const ::Json::Value&)>;
 using ErrorSender = std::function<void(const std::string&, int)>;
+using StreamReader = std::function<std::size_t(char* out, std::size_t size)>;
+using StreamSender = std::function<void(StreamReader)>;
+using BodySender = std::function<void(std::string body)>;
 
 /**
  * @brief Handle a RESTful DBAL request
  * 
- * @param route Parsed route information
- * @param method HTTP method (GET, POST, PUT, DELETE, PATCH)
- * @param body Request body (for POST/PUT/PATCH)
+ * The entity is resolved through the dispatch table and the HTTP verb
+ * picks the action: GET lists or reads, POST creates, PUT/PATCH update
+ * and DELETE deletes. The path tenant scopes the call. Entities with a
+ * direct handler decode the raw body themselves and answer through
+ * send_body; the rest get the body parsed into a payload carrying the
+ * path id as "id".
+ *
+ * @param route Path segments
+ * @param method HTTP verb
+ * @param body Raw request body (used for POST/PUT/PATCH)
  * @param query Query parameters
- * @param send_success Success callback
+ * @param send_success Success callback for a Json::Value response
+ * @param send_body Success callback for an already serialized response
  * @param send_error Error callback
+ * @param send_stream When set, list operations of entities that can
+ *                    stream send NDJSON through it instead of building
+ *                    one JSON response
  */
 void handleRestfulRequest(
     Client& client,
-    const RouteInfo& route,
-    const std::string& method,
-    const ::Json::Value& body,
+    const DispatchTable& table,
+    const RouteSegments& route,
+    HttpVerb method,
+    std::string_view body,
     const std::map<std::string, std::string>& query,
     ResponseSender send_success,
-    ErrorSender send_error
+    BodySender send_body,
+    ErrorSender send_error,
+    StreamSender send_stream = nullptr
 );
 
 } // namespace rpc
@@ -1,148 +1,324 @@
 #include "rpc_user_actions.hpp"
+#include "rpc_dispatch_table.hpp"
 #include "server_helpers.hpp"
+#include "server_helpers/json_writer.hpp"
 
 #include "dbal/core/errors.hpp"
+#include "../query/cursor/list_cursor.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <optional>
 
 namespace dbal {
 namespace daemon {
 namespace rpc {
 
-void handle_user_list(Client& client,
-                      const std::string& tenantId,
-                      const ::Json::Value& options,
-                      ResponseSender send_success,
-                      ErrorSender send_error) {
+namespace {
+
+// Rows fetched per listUsers call while streaming
+constexpr int kStreamBatchSize = 256;
+
+/**
+ * Renders a user list as NDJSON one batch at a time. Each batch resumes
+ * from the previous one's keyset cursor, so only the batch being written
+ * is ever held in memory.
+ */
+class UserListStream {
+public:
+    UserListStream(Client& client, ListOptions options, std::optional<size_t> remaining)
+        : client_(client), options_(std::move(options)), remaining_(remaining) {}
+
+    /**
+     * Fetch and render the next batch into the pending buffer
+     */
+    Result<bool> fill() {
+        pending_.clear();
+        offset_ = 0;
+        if (remaining_.has_value() && remaining_.value() == 0) {
+            exhausted_ = true;
+            return false;
+        }
+        const size_t batch = std::min(static_cast<size_t>(kStreamBatchSize),
+                                      remaining_.value_or(kStreamBatchSize));
+        options_.limit = static_cast<int>(batch);
+        auto result = client_.listUsers(options_);
+        if (result.isError()) {
+            exhausted_ = true;
+            return result.error();
+        }
+        const auto& rows = result.value();
+        for (const auto& user : rows) {
+            // One writer per line: each line is its own document
+            JsonWriter writer(pending_);
+            write_user(writer, user);
+            pending_.push_back('\n');
+        }
+        if (remaining_.has_value()) {
+            remaining_ = remaining_.value() - rows.size();
+        }
+        options_.cursor = query::nextCursor(rows, options_);
+        exhausted_ = options_.cursor.empty();
+        return !rows.empty();
+    }
+
+    size_t read(char* out, size_t size) {
+        if (!out) {
+            // The server signals a finished or abandoned response this way
+            exhausted_ = true;
+            pending_.clear();
+            pending_.shrink_to_fit();
+            offset_ = 0;
+            return 0;
+        }
+        while (offset_ == pending_.size()) {
+            if (exhausted_) {
+                return 0;
+            }
+            auto filled = fill();
+            if (filled.isError()) {
+                pending_.clear();
+                JsonWriter(pending_)
+                    .beginObject()
+                    .field("error", filled.error().what())
+                    .field("code", static_cast<int>(filled.error().code()))
+                    .endObject();
+                pending_.push_back('\n');
+            }
+        }
+        const size_t n = std::min(size, pending_.size() - offset_);
+        std::memcpy(out, pending_.data() + offset_, n);
+        offset_ += n;
+        return n;
+    }
+
+private:
+    Client& client_;
+    ListOptions options_;
+    std::optional<size_t> remaining_;
+    std::string pending_;
+    size_t offset_ = 0;
+    bool exhausted_ = false;
+};
+
+void send_failure(const Error& error, const ErrorSender& send_error) {
+    send_error(error.what(), static_cast<int>(error.code()));
+}
+
+// The steps below are shared by the Json::Value handlers and the direct
+// path; each reports its own failure and returns nullopt after doing so
+
+std::optional<std::vector<User>> list_users(Client& client,
+                                            const std::string& tenantId,
+                                            ListOptions& list_options,
+                                            const ErrorSender& send_error) {
     if (tenantId.empty()) {
         send_error("Tenant ID is required", 400);
-        return;
+        return std::nullopt;
     }
-
-    auto list_options = list_options_from_json(options);
     list_options.filter["tenantId"] = tenantId;
     auto result = client.listUsers(list_options);
     if (!result.isOk()) {
-        const auto& error = result.error();
-        send_error(error.what(), static_cast<int>(error.code()));
-        return;
+        send_failure(result.error(), send_error);
+        return std::nullopt;
     }
-    send_success(list_response_value(result.value(), list_options));
+    return std::move(result.value());
 }
 
-void handle_user_read(Client& client,
-                      const std::string& tenantId,
-                      const std::string& id,
-                      ResponseSender send_success,
-                      ErrorSender send_error) {
+/**
+ * The tenant's user with this id; another tenant's user is not found
+ */
+std::optional<User> owned_user(Client& client,
+                               const std::string& tenantId,
+                               const std::string& id,
+                               const char* missing_id,
+                               const ErrorSender& send_error) {
     if (tenantId.empty()) {
         send_error("Tenant ID is required", 400);
-        return;
+        return std::nullopt;
     }
     if (id.empty()) {
-        send_error("ID is required for read operations", 400);
-        return;
+        send_error(missing_id, 400);
+        return std::nullopt;
     }
     auto result = client.getUser(id);
     if (!result.isOk()) {
-        const auto& error = result.error();
-        send_error(error.what(), static_cast<int>(error.code()));
-        return;
+        send_failure(result.error(), send_error);
+        return std::nullopt;
     }
-    const auto& user = result.value();
-    if (user.tenantId != tenantId) {
+    if (result.value().tenantId != tenantId) {
         send_error("User not found", 404);
-        return;
+        return std::nullopt;
     }
-    send_success(user_to_json(user));
+    return std::move(result.value());
 }
 
-void handle_user_create(Client& client,
-                        const std::string& tenantId,
-                        const ::Json::Value& payload,
-                        ResponseSender send_success,
-                        ErrorSender send_error) {
+std::optional<User> create_user(Client& client,
+                                const std::string& tenantId,
+                                CreateUserInput& input,
+                                const ErrorSender& send_error) {
     if (tenantId.empty()) {
         send_error("Tenant ID is required", 400);
-        return;
+        return std::nullopt;
     }
-    const auto username = payload.get("username", "").asString();
-    const auto email = payload.get("email", "").asString();
-    if (username.empty() || email.empty()) {
+    if (input.username.empty() || input.email.empty()) {
         send_error("Username and email are required for creation", 400);
-        return;
+        return std::nullopt;
     }
-
-    CreateUserInput input;
     input.tenantId = tenantId;
-    input.username = username;
-    input.email = email;
-    if (payload.isMember("role") && payload["role"].isString()) {
-        input.role = normalize_role(payload["role"].asString());
+    auto result = client.createUser(input);
+    if (!result.isOk()) {
+        send_failure(result.error(), send_error);
+        return std::nullopt;
     }
+    return std::move(result.value());
+}
 
-    auto result = client.createUser(input);
+std::optional<User> update_user(Client& client,
+                                const std::string& tenantId,
+                                const std::string& id,
+                                const UpdateUserInput& updates,
+                                const ErrorSender& send_error) {
+    if (!owned_user(client, tenantId, id, "ID is required for updates", send_error)) {
+        return std::nullopt;
+    }
+    if (!updates.username && !updates.email && !updates.role) {
+        send_error("At least one update field must be provided", 400);
+        return std::nullopt;
+    }
+    auto result = client.updateUser(id, updates);
     if (!result.isOk()) {
-        const auto& error = result.error();
-        send_error(error.what(), static_cast<int>(error.code()));
-        return;
+        send_failure(result.error(), send_error);
+        return std::nullopt;
     }
+    return std::move(result.value());
+}
 
-    send_success(user_to_json(result.value()));
+std::optional<bool> delete_user(Client& client,
+                                const std::string& tenantId,
+                                const std::string& id,
+                                const ErrorSender& send_error) {
+    if (!owned_user(client, tenantId, id, "ID is required for delete operations", send_error)) {
+        return std::nullopt;
+    }
+    auto result = client.deleteUser(id);
+    if (!result.isOk()) {
+        send_failure(result.error(), send_error);
+        return std::nullopt;
+    }
+    return result.value();
 }
 
-void handle_user_update(Client& client,
-                        const std::string& tenantId,
-                        const std::string& id,
-                        const ::Json::Value& payload,
-                        ResponseSender send_success,
-                        ErrorSender send_error) {
+/**
+ * Writes the {"success": true, "data": ...} envelope around write_data
+ */
+template<typename WriteData>
+std::string success_body(WriteData write_data) {
+    std::string body;
+    body.reserve(256);
+    JsonWriter writer(body);
+    writer.beginObject().field("success", true).key("data");
+    write_data(writer);
+    writer.endObject();
+    return body;
+}
+
+} // namespace
+
+void handle_user_list(Client& client,
+                      const std::string& tenantId,
+                      const ::Json::Value& options,
+                      ResponseSender send_success,
+                      ErrorSender send_error) {
+    auto list_options = list_options_from_json(options);
+    if (auto users = list_users(client, tenantId, list_options, send_error)) {
+        send_success(list_response_value(users.value(), list_options));
+    }
+}
+
+void handle_user_list_stream(Client& client,
+                             const std::string& tenantId,
+                             const ::Json::Value& options,
+                             StreamSender send_stream,
+                             ErrorSender send_error) {
     if (tenantId.empty()) {
         send_error("Tenant ID is required", 400);
         return;
     }
-    if (id.empty()) {
-        send_error("ID is required for updates", 400);
+
+    auto list_options = list_options_from_json(options);
+    if (list_options.page > 1) {
+        send_error("page is not supported for streamed lists; use cursor", 400);
         return;
     }
+    list_options.filter["tenantId"] = tenantId;
+    std::optional<size_t> remaining;
+    if (options.isMember("limit")) {
+        if (list_options.limit <= 0) {
+            send_error("limit must be a positive integer", 400);
+            return;
+        }
+        remaining = static_cast<size_t>(list_options.limit);
+    }
 
-    auto existing = client.getUser(id);
-    if (!existing.isOk()) {
-        const auto& error = existing.error();
+    // The first batch is fetched up front so that bad options or an
+    // unavailable adapter still produce an ordinary error response
+    auto stream = std::make_shared<UserListStream>(client, std::move(list_options), remaining);
+    auto first = stream->fill();
+    if (first.isError()) {
+        const auto& error = first.error();
         send_error(error.what(), static_cast<int>(error.code()));
         return;
     }
-    if (existing.value().tenantId != tenantId) {
-        send_error("User not found", 404);
-        return;
+    send_stream([stream](char* out, std::size_t size) { return stream->read(out, size); });
+}
+
+void handle_user_read(Client& client,
+                      const std::string& tenantId,
+                      const std::string& id,
+                      ResponseSender send_success,
+                      ErrorSender send_error) {
+    if (auto user = owned_user(client, tenantId, id, "ID is required for read operations", send_error)) {
+        send_success(user_to_json(user.value()));
     }
+}
 
+void handle_user_create(Client& client,
+                        const std::string& tenantId,
+                        const ::Json::Value& payload,
+                        ResponseSender send_success,
+                        ErrorSender send_error) {
+    CreateUserInput input;
+    input.username = payload.get("username", "").asString();
+    input.email = payload.get("email", "").asString();
+    if (payload.isMember("role") && payload["role"].isString()) {
+        input.role = normalize_role(payload["role"].asString());
+    }
+    if (auto user = create_user(client, tenantId, input, send_error)) {
+        send_success(user_to_json(user.value()));
+    }
+}
+
+void handle_user_update(Client& client,
+                        const std::string& tenantId,
+                        const std::string& id,
+                        const ::Json::Value& payload,
+                        ResponseSender send_success,
+                        ErrorSender send_error) {
     UpdateUserInput updates;
-    bool has_updates = false;
     if (payload.isMember("username") && payload["username"].isString()) {
         updates.username = payload["username"].asString();
-        has_updates = true;
     }
     if (payload.isMember("email") && payload["email"].isString()) {
         updates.email = payload["email"].asString();
-        has_updates = true;
     }
     if (payload.isMember("role") && payload["role"].isString()) {
         updates.role = normalize_role(payload["role"].asString());
-        has_updates = true;
     }
-
-    if (!has_updates) {
-        send_error("At least one update field must be provided", 400);
-        return;
-    }
-
-    auto result = client.updateUser(id, updates);
-    if (!result.isOk()) {
-        const auto& error = result.error();
-        send_error(error.what(), static_cast<int>(error.code()));
-        return;
+    if (auto user = update_user(client, tenantId, id, updates, send_error)) {
+        send_success(user_to_json(user.value()));
     }
-
-    send_success(user_to_json(result.value()));
 }
 
 void handle_user_delete(Client& client,
@@ -150,36 +326,70 @@ void handle_user_delete(Client& client,
                         const std::string& id,
                         ResponseSender send_success,
                         ErrorSender send_error) {
-    if (tenantId.empty()) {
-        send_error("Tenant ID is required", 400);
-        return;
-    }
-    if (id.empty()) {
-        send_error("ID is required for delete operations", 400);
-        return;
-    }
-
-    auto existing = client.getUser(id);
-    if (!existing.isOk()) {
-        const auto& error = existing.error();
-        send_error(error.what(), static_cast<int>(error.code()));
-        return;
-    }
-    if (existing.value().tenantId != tenantId) {
-        send_error("User not found", 404);
-        return;
+    if (auto deleted = delete_user(client, tenantId, id, send_error)) {
+        ::Json::Value body;
+        body["deleted"] = deleted.value();
+        send_success(body);
     }
+}
 
-    auto result = client.deleteUser(id);
-    if (!result.isOk()) {
-        const auto& error = result.error();
-        send_error(error.what(), static_cast<int>(error.code()));
-        return;
+void handle_user_direct(Client& client,
+                        RpcAction action,
+                        const std::string& tenantId,
+                        const std::string& id,
+                        std::string_view body,
+                        const ::Json::Value& options,
+                        BodySender send_body,
+                        ErrorSender send_error) {
+    std::string parse_error;
+    switch (action) {
+        case RpcAction::List: {
+            auto list_options = list_options_from_json(options);
+            if (auto users = list_users(client, tenantId, list_options, send_error)) {
+                send_body(success_body([&](JsonWriter& writer) {
+                    write_list_response(writer, users.value(), list_options);
+                }));
+            }
+            return;
+        }
+        case RpcAction::Get:
+            if (auto user = owned_user(client, tenantId, id, "ID is required for read operations", send_error)) {
+                send_body(success_body([&](JsonWriter& writer) { write_user(writer, user.value()); }));
+            }
+            return;
+        case RpcAction::Create: {
+            CreateUserInput input;
+            if (!read_create_user_input(body, input, parse_error)) {
+                send_error(parse_error, 400);
+                return;
+            }
+            if (auto user = create_user(client, tenantId, input, send_error)) {
+                send_body(success_body([&](JsonWriter& writer) { write_user(writer, user.value()); }));
+            }
+            return;
+        }
+        case RpcAction::Update: {
+            UpdateUserInput updates;
+            if (!read_update_user_input(body, updates, parse_error)) {
+                send_error(parse_error, 400);
+                return;
+            }
+            if (auto user = update_user(client, tenantId, id, updates, send_error)) {
+                send_body(success_body([&](JsonWriter& writer) { write_user(writer, user.value()); }));
+            }
+            return;
+        }
+        case RpcAction::Delete:
+            if (auto deleted = delete_user(client, tenantId, id, send_error)) {
+                send_body(success_body([&](JsonWriter& writer) {
+                    writer.beginObject().field("deleted", deleted.value()).endObject();
+                }));
+            }
+            return;
+        default:
+            send_error("Unsupported action", 400);
+            return;
     }
-
-    ::Json::Value body;
-    body["deleted"] = result.value();
-    send_success(body);
 }
 
 } // namespace rpc
@@ -1,8 +1,12 @@
 #ifndef DBAL_RPC_USER_ACTIONS_HPP
 #define DBAL_RPC_USER_ACTIONS_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <json/json.h>
+#include <string>
+#include <string_view>
 
 #include "dbal/core/client.hpp"
 
@@ -13,12 +17,43 @@ namespace rpc {
 using ResponseSender = std::function<void(const ::Json::Value&)>;
 using ErrorSender = std::function<void(const std::string&, int)>;
 
+/**
+ * Pull-based response body: fills up to size bytes of out and returns the
+ * count written, or 0 once the body is complete. The server calls it again
+ * each time the connection drains, so a slow reader throttles the producer.
+ */
+using StreamReader = std::function<std::size_t(char* out, std::size_t size)>;
+using StreamSender = std::function<void(StreamReader)>;
+
+/**
+ * Complete response body, already serialized as JSON
+ */
+using BodySender = std::function<void(std::string body)>;
+
+enum class RpcAction : std::uint8_t;
+
 void handle_user_list(Client& client,
                       const std::string& tenantId,
                       const ::Json::Value& options,
                       ResponseSender send_success,
                       ErrorSender send_error);
 
+/**
+ * Stream a user list as NDJSON, one user object per line.
+ *
+ * Rows are pulled from the client in keyset-paginated batches as the
+ * connection drains, so memory holds a single batch however many rows
+ * match. "limit" caps the total row count (unbounded when absent) and
+ * "cursor" resumes an earlier listing; "page" is rejected. Errors found
+ * before the first batch go to send_error; a failure once streaming has
+ * begun ends the body with an {"error", "code"} line.
+ */
+void handle_user_list_stream(Client& client,
+                             const std::string& tenantId,
+                             const ::Json::Value& options,
+                             StreamSender send_stream,
+                             ErrorSender send_error);
+
 void handle_user_read(Client& client,
                       const std::string& tenantId,
                       const std::string& id,
@@ -44,6 +79,22 @@ void handle_user_delete(Client& client,
                         ResponseSender send_success,
                         ErrorSender send_error);
 
+/**
+ * Direct path for user requests. A create or update body is decoded from
+ * its bytes into CreateUserInput/UpdateUserInput, and the {"success":
+ * true, "data": ...} envelope is written straight into the response
+ * body; no Json::Value tree is built either way. Checks, errors and the
+ * response members match the handlers above.
+ */
+void handle_user_direct(Client& client,
+                        RpcAction action,
+                        const std::string& tenantId,
+                        const std::string& id,
+                        std::string_view body,
+                        const ::Json::Value& options,
+                        BodySender send_body,
+                        ErrorSender send_error);
+
 } // namespace rpc
 } // namespace daemon
 } // namespace dbal
@@ -13,13 +13,17 @@
 namespace dbal {
 namespace daemon {
 
-Server::Server(const std::string& bind_address, int port, const dbal::ClientConfig& client_config)
+Server::Server(const std::string& bind_address, int port, const dbal::ClientConfig& client_config,
+               int threads, const std::string& blob_directory)
     : bind_address_(bind_address),
       port_(port),
+      threads_(threads),
       running_(false),
       routes_registered_(false),
       client_config_(client_config),
-      dbal_client_(nullptr) {}
+      dbal_client_(nullptr),
+      client_ready_(false),
+      blob_directory_(blob_directory) {}
 
 Server::~Server() {
     stop();
@@ -30,8 +34,23 @@ bool Server::start() {
         return true;
     }
 
+    // Replay a persisted store before taking traffic rather than on the first request
+    if (!client_config_.persistence.directory.empty() && !ensureClient()) {
+        return false;
+    }
+
+    if (!blob_directory_.empty() && !blob_storage_) {
+        try {
+            blob_storage_ = open_blob_storage(blob_directory_);
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to open blob store: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
     registerRoutes();
     drogon::app().addListener(bind_address_, static_cast<uint16_t>(port_));
+    drogon::app().setThreadNum(static_cast<size_t>(threads_ > 0 ? threads_ : 0));
 
     running_.store(true);
     server_thread_ = std::thread(&Server::runServer, this);
@@ -47,6 +66,10 @@ void Server::stop() {
     if (server_thread_.joinable()) {
         server_thread_.join();
     }
+    if (dbal_client_) {
+        // Handlers are done; flush the write-ahead log
+        dbal_client_->close();
+    }
     running_.store(false);
 }
 
@@ -59,12 +82,19 @@ std::string Server::address() const {
 }
 
 bool Server::ensureClient() {
+    // Handlers run on every event-loop thread; the first request creates the client
+    if (client_ready_.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(client_mutex_);
     if (dbal_client_) {
         return true;
     }
 
     try {
         dbal_client_ = std::make_unique<dbal::Client>(client_config_);
+        client_ready_.store(true, std::memory_order_release);
         return true;
     } catch (const std::exception& ex) {
         std::cerr << "Failed to initialize DBAL client: " << ex.what() << std::endl;
@@ -7,16 +7,25 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include "dbal/core/client.hpp"
+#include "blob_routes.hpp"
+#include "read_cache.hpp"
+#include "rpc_dispatch_table.hpp"
 
 namespace dbal {
 namespace daemon {
 
 class Server {
 public:
-    Server(const std::string& bind_address, int port, const dbal::ClientConfig& client_config);
+    /**
+     * @param threads Drogon event-loop threads; 0 uses one per hardware core
+     * @param blob_directory where /api/blobs/ keeps blobs; empty serves none
+     */
+    Server(const std::string& bind_address, int port, const dbal::ClientConfig& client_config,
+           int threads = 0, const std::string& blob_directory = std::string());
     ~Server();
 
     bool start();
@@ -31,11 +40,18 @@ private:
 
     std::string bind_address_;
     int port_;
+    int threads_;
     std::atomic<bool> running_;
     bool routes_registered_;
     std::thread server_thread_;
     dbal::ClientConfig client_config_;
     std::unique_ptr<dbal::Client> dbal_client_;
+    std::atomic<bool> client_ready_;
+    std::mutex client_mutex_;
+    rpc::DispatchTable dispatch_table_;
+    rpc::ReadCache read_cache_;
+    std::string blob_directory_;
+    std::shared_ptr<blob::FilesystemStorage> blob_storage_;
 };
 
 } // namespace daemon
@@ -3,6 +3,7 @@
 
 #include "server_helpers/network.hpp"
 #include "server_helpers/role.hpp"
+#include "server_helpers/json_reader.hpp"
 #include "server_helpers/serialization.hpp"
 #include "server_helpers/response.hpp"
 
@@ -0,0 +1,366 @@
+#include "json_reader.hpp"
+
+#include <charconv>
+#include <memory>
+
+namespace dbal {
+namespace daemon {
+
+namespace {
+
+// Nesting deeper than this in a skipped value is rejected rather than
+// recursed into
+constexpr int kMaxSkipDepth = 64;
+
+int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void append_utf8(std::string& out, unsigned long code_point) {
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+} // namespace
+
+bool JsonReader::fail(const char* message) {
+    if (error_.empty()) {
+        error_ = std::string(message) + " at offset " + std::to_string(pos_);
+    }
+    return false;
+}
+
+void JsonReader::skipWhitespace() {
+    while (pos_ < text_.size()) {
+        const char c = text_[pos_];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return;
+        }
+        ++pos_;
+    }
+}
+
+bool JsonReader::expect(char c) {
+    skipWhitespace();
+    if (pos_ >= text_.size() || text_[pos_] != c) {
+        return fail(c == ':' ? "Expected ':'" : c == '{' ? "Expected an object" : "Unexpected character");
+    }
+    ++pos_;
+    return true;
+}
+
+JsonReader::Kind JsonReader::peek() {
+    if (failed()) {
+        return Kind::Invalid;
+    }
+    skipWhitespace();
+    if (pos_ >= text_.size()) {
+        return Kind::End;
+    }
+    switch (text_[pos_]) {
+        case '{': return Kind::Object;
+        case '[': return Kind::Array;
+        case '"': return Kind::String;
+        case 't':
+        case 'f': return Kind::Bool;
+        case 'n': return Kind::Null;
+        default:
+            if (text_[pos_] == '-' || (text_[pos_] >= '0' && text_[pos_] <= '9')) {
+                return Kind::Number;
+            }
+            return Kind::Invalid;
+    }
+}
+
+bool JsonReader::beginObject() {
+    if (failed() || !expect('{')) {
+        return false;
+    }
+    last_ = '{';
+    return true;
+}
+
+bool JsonReader::nextMember(std::string_view& key) {
+    if (failed()) {
+        return false;
+    }
+    skipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == '}') {
+        ++pos_;
+        last_ = 0;
+        return false;
+    }
+    if (last_ != '{' && !expect(',')) {
+        return false;
+    }
+    last_ = 0;
+    skipWhitespace();
+    if (!parseString(key) || !expect(':')) {
+        return false;
+    }
+    return true;
+}
+
+bool JsonReader::appendEscape() {
+    // pos_ is just past the backslash
+    if (pos_ >= text_.size()) {
+        return fail("Unterminated string");
+    }
+    const char c = text_[pos_++];
+    switch (c) {
+        case '"': scratch_.push_back('"'); return true;
+        case '\\': scratch_.push_back('\\'); return true;
+        case '/': scratch_.push_back('/'); return true;
+        case 'b': scratch_.push_back('\b'); return true;
+        case 'f': scratch_.push_back('\f'); return true;
+        case 'n': scratch_.push_back('\n'); return true;
+        case 'r': scratch_.push_back('\r'); return true;
+        case 't': scratch_.push_back('\t'); return true;
+        case 'u': break;
+        default: return fail("Invalid escape");
+    }
+
+    auto read_unit = [this](unsigned long& unit) {
+        if (pos_ + 4 > text_.size()) {
+            return fail("Truncated \\u escape");
+        }
+        unit = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int digit = hex_digit(text_[pos_++]);
+            if (digit < 0) {
+                return fail("Invalid \\u escape");
+            }
+            unit = (unit << 4) | static_cast<unsigned long>(digit);
+        }
+        return true;
+    };
+
+    unsigned long code_point = 0;
+    if (!read_unit(code_point)) {
+        return false;
+    }
+    if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+        unsigned long low = 0;
+        if (pos_ + 2 > text_.size() || text_[pos_] != '\\' || text_[pos_ + 1] != 'u') {
+            return fail("Unpaired surrogate");
+        }
+        pos_ += 2;
+        if (!read_unit(low) || low < 0xDC00 || low > 0xDFFF) {
+            return fail("Unpaired surrogate");
+        }
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+    }
+    append_utf8(scratch_, code_point);
+    return true;
+}
+
+bool JsonReader::parseString(std::string_view& out) {
+    if (pos_ >= text_.size() || text_[pos_] != '"') {
+        return fail("Expected a string");
+    }
+    const size_t start = ++pos_;
+    // Fast path: no escapes, so the value is a view of the input
+    while (pos_ < text_.size()) {
+        const char c = text_[pos_];
+        if (c == '"') {
+            out = text_.substr(start, pos_ - start);
+            ++pos_;
+            return true;
+        }
+        if (c == '\\') {
+            break;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) {
+            return fail("Control character in string");
+        }
+        ++pos_;
+    }
+    if (pos_ >= text_.size()) {
+        return fail("Unterminated string");
+    }
+
+    scratch_.assign(text_.data() + start, pos_ - start);
+    while (pos_ < text_.size()) {
+        const char c = text_[pos_++];
+        if (c == '"') {
+            out = scratch_;
+            return true;
+        }
+        if (c == '\\') {
+            if (!appendEscape()) {
+                return false;
+            }
+            continue;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) {
+            return fail("Control character in string");
+        }
+        scratch_.push_back(c);
+    }
+    return fail("Unterminated string");
+}
+
+bool JsonReader::readString(std::string_view& out) {
+    if (failed()) {
+        return false;
+    }
+    skipWhitespace();
+    return parseString(out);
+}
+
+bool JsonReader::readString(std::string& out) {
+    std::string_view view;
+    if (!readString(view)) {
+        return false;
+    }
+    out.assign(view.data(), view.size());
+    return true;
+}
+
+bool JsonReader::readBool(bool& out) {
+    if (failed()) {
+        return false;
+    }
+    skipWhitespace();
+    const auto rest = text_.substr(pos_);
+    if (rest.compare(0, 4, "true") == 0) {
+        pos_ += 4;
+        out = true;
+        return true;
+    }
+    if (rest.compare(0, 5, "false") == 0) {
+        pos_ += 5;
+        out = false;
+        return true;
+    }
+    return fail("Expected a boolean");
+}
+
+bool JsonReader::readInt(long long& out) {
+    if (failed()) {
+        return false;
+    }
+    skipWhitespace();
+    const char* begin = text_.data() + pos_;
+    const char* end = text_.data() + text_.size();
+    const auto result = std::from_chars(begin, end, out);
+    if (result.ec != std::errc() || result.ptr == begin) {
+        return fail("Expected an integer");
+    }
+    if (result.ptr != end && (*result.ptr == '.' || *result.ptr == 'e' || *result.ptr == 'E')) {
+        return fail("Expected an integer");
+    }
+    pos_ += static_cast<size_t>(result.ptr - begin);
+    return true;
+}
+
+bool JsonReader::skipValue() {
+    return !failed() && skipValue(0);
+}
+
+bool JsonReader::skipValue(int depth) {
+    if (depth > kMaxSkipDepth) {
+        return fail("Document nested too deeply");
+    }
+    std::string_view ignored;
+    switch (peek()) {
+        case Kind::String:
+            return parseString(ignored);
+        case Kind::Bool: {
+            bool flag = false;
+            return readBool(flag);
+        }
+        case Kind::Null:
+            if (text_.compare(pos_, 4, "null") != 0) {
+                return fail("Expected null");
+            }
+            pos_ += 4;
+            return true;
+        case Kind::Number: {
+            const size_t start = pos_;
+            while (pos_ < text_.size()) {
+                const char c = text_[pos_];
+                if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+                    break;
+                }
+                ++pos_;
+            }
+            return pos_ > start || fail("Expected a number");
+        }
+        case Kind::Object: {
+            ++pos_;
+            last_ = '{';
+            std::string_view key;
+            while (nextMember(key)) {
+                if (!skipValue(depth + 1)) {
+                    return false;
+                }
+            }
+            return !failed();
+        }
+        case Kind::Array: {
+            ++pos_;
+            skipWhitespace();
+            if (pos_ < text_.size() && text_[pos_] == ']') {
+                ++pos_;
+                return true;
+            }
+            while (true) {
+                if (!skipValue(depth + 1)) {
+                    return false;
+                }
+                skipWhitespace();
+                if (pos_ < text_.size() && text_[pos_] == ']') {
+                    ++pos_;
+                    return true;
+                }
+                if (!expect(',')) {
+                    return false;
+                }
+            }
+        }
+        case Kind::End:
+            return fail("Unexpected end of input");
+        case Kind::Invalid:
+            return fail("Unexpected character");
+    }
+    return false;
+}
+
+bool JsonReader::finish() {
+    if (failed()) {
+        return false;
+    }
+    skipWhitespace();
+    return pos_ == text_.size() || fail("Trailing characters after document");
+}
+
+bool parse_json_document(std::string_view text, ::Json::Value& out, std::string& error) {
+    // Building a reader means building its settings document; keep one per thread
+    thread_local const std::unique_ptr<::Json::CharReader> reader(::Json::CharReaderBuilder().newCharReader());
+    JSONCPP_STRING errs;
+    if (!reader->parse(text.data(), text.data() + text.size(), &out, &errs)) {
+        error = errs;
+        return false;
+    }
+    return true;
+}
+
+} // namespace daemon
+} // namespace dbal
@@ -0,0 +1,86 @@
+#ifndef DBAL_SERVER_HELPERS_JSON_READER_HPP
+#define DBAL_SERVER_HELPERS_JSON_READER_HPP
+
+#include <json/json.h>
+#include <string>
+#include <string_view>
+
+namespace dbal {
+namespace daemon {
+
+/**
+ * Pull parser over JSON text owned by someone else
+ *
+ * The reader walks the text in place. Keys and strings without escapes
+ * come back as views into it, so decoding an object into a typed struct
+ * copies only the values kept. Members the caller does not want are
+ * skipped without being materialized. Any call after a failure returns
+ * false; error() says what went wrong.
+ */
+class JsonReader {
+public:
+    enum class Kind { Object, Array, String, Number, Bool, Null, End, Invalid };
+
+    explicit JsonReader(std::string_view text) : text_(text) {}
+
+    /**
+     * Kind of the next value, without consuming it
+     */
+    Kind peek();
+
+    bool beginObject();
+
+    /**
+     * Advance to the next member of the current object and return its
+     * key; false once the closing brace has been consumed, or on error.
+     * The key view is valid until the next read.
+     */
+    bool nextMember(std::string_view& key);
+
+    /**
+     * Read a string; the view is valid until the next read
+     */
+    bool readString(std::string_view& out);
+    bool readString(std::string& out);
+    bool readBool(bool& out);
+    bool readInt(long long& out);
+    bool skipValue();
+
+    /**
+     * True when only whitespace is left
+     */
+    bool finish();
+
+    bool failed() const {
+        return !error_.empty();
+    }
+
+    const std::string& error() const {
+        return error_;
+    }
+
+private:
+    bool fail(const char* message);
+    void skipWhitespace();
+    bool expect(char c);
+    bool skipValue(int depth);
+    bool parseString(std::string_view& out);
+    bool appendEscape();
+
+    std::string_view text_;
+    size_t pos_ = 0;
+    char last_ = 0;  // '{' right after beginObject, otherwise 0
+    std::string scratch_;
+    std::string error_;
+};
+
+/**
+ * Parse a whole document from the request body without copying it into
+ * an intermediate string or stream first
+ */
+bool parse_json_document(std::string_view text, ::Json::Value& out, std::string& error);
+
+} // namespace daemon
+} // namespace dbal
+
+#endif // DBAL_SERVER_HELPERS_JSON_READER_HPP
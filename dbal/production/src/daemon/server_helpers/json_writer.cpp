@@ -0,0 +1,105 @@
+#include "json_writer.hpp"
+
+#include <charconv>
+
+namespace dbal {
+namespace daemon {
+
+void JsonWriter::separate() {
+    if (need_comma_) {
+        out_.push_back(',');
+    }
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    out_.push_back('{');
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    out_.push_back('}');
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    out_.push_back('[');
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    out_.push_back(']');
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    value(name);
+    out_.push_back(':');
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    separate();
+    out_.push_back('"');
+    size_t run = 0;  // Start of the pending span that needs no escaping
+    for (size_t i = 0; i < text.size(); ++i) {
+        const auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out_.append(text.data() + run, i - run);
+        run = i + 1;
+        out_.push_back('\\');
+        switch (c) {
+            case '"': out_.push_back('"'); break;
+            case '\\': out_.push_back('\\'); break;
+            case '\n': out_.push_back('n'); break;
+            case '\r': out_.push_back('r'); break;
+            case '\t': out_.push_back('t'); break;
+            case '\b': out_.push_back('b'); break;
+            case '\f': out_.push_back('f'); break;
+            default:
+                out_.append("u00");
+                out_.push_back(kHex[c >> 4]);
+                out_.push_back(kHex[c & 0xF]);
+                break;
+        }
+    }
+    out_.append(text.data() + run, text.size() - run);
+    out_.push_back('"');
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(long long number) {
+    separate();
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    out_.append(digits, result.ptr);
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out_.append(flag ? "true" : "false");
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out_.append("null");
+    need_comma_ = true;
+    return *this;
+}
+
+} // namespace daemon
+} // namespace dbal
@@ -0,0 +1,57 @@
+#ifndef DBAL_SERVER_HELPERS_JSON_WRITER_HPP
+#define DBAL_SERVER_HELPERS_JSON_WRITER_HPP
+
+#include <string>
+#include <string_view>
+
+namespace dbal {
+namespace daemon {
+
+/**
+ * Compact JSON appended straight to a caller-owned buffer
+ *
+ * Callers emit keys and values in document order; the writer adds the
+ * separators and escaping. No document tree is built, so serializing a
+ * record costs only the growth of the output buffer.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) {
+        return value(std::string_view(text));
+    }
+    JsonWriter& value(const std::string& text) {
+        return value(std::string_view(text));
+    }
+    JsonWriter& value(int number) {
+        return value(static_cast<long long>(number));
+    }
+    JsonWriter& value(long long number);
+    JsonWriter& value(bool flag);
+    JsonWriter& null();
+
+    template<typename T>
+    JsonWriter& field(std::string_view name, const T& field_value) {
+        key(name);
+        return value(field_value);
+    }
+
+private:
+    void separate();
+
+    std::string& out_;
+    bool need_comma_ = false;
+};
+
+} // namespace daemon
+} // namespace dbal
+
+#endif // DBAL_SERVER_HELPERS_JSON_WRITER_HPP
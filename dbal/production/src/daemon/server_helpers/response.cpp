@@ -11,5 +11,35 @@ drogon::HttpResponsePtr build_json_response(const ::Json::Value& body) {
     return response;
 }
 
+drogon::HttpResponsePtr build_raw_json_response(std::string body, const std::string& etag) {
+    auto response = drogon::HttpResponse::newHttpResponse();
+    response->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+    response->setBody(std::move(body));
+    response->addHeader("Server", "DBAL/1.0.0");
+    if (!etag.empty()) {
+        response->addHeader("ETag", etag);
+    }
+    return response;
+}
+
+drogon::HttpResponsePtr build_not_modified_response(const std::string& etag) {
+    auto response = drogon::HttpResponse::newHttpResponse();
+    response->setStatusCode(drogon::k304NotModified);
+    response->addHeader("Server", "DBAL/1.0.0");
+    response->addHeader("ETag", etag);
+    return response;
+}
+
+bool accepts_ndjson(const drogon::HttpRequestPtr& request) {
+    return request->getHeader("Accept").find("application/x-ndjson") != std::string::npos;
+}
+
+drogon::HttpResponsePtr build_ndjson_stream_response(std::function<std::size_t(char*, std::size_t)> reader) {
+    auto response = drogon::HttpResponse::newStreamResponse(std::move(reader), "", drogon::CT_CUSTOM,
+                                                            "application/x-ndjson");
+    response->addHeader("Server", "DBAL/1.0.0");
+    return response;
+}
+
 } // namespace daemon
 } // namespace dbal
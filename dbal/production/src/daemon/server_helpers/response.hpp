@@ -1,7 +1,10 @@
 #ifndef DBAL_SERVER_HELPERS_RESPONSE_HPP
 #define DBAL_SERVER_HELPERS_RESPONSE_HPP
 
+#include <cstddef>
+#include <functional>
 #include <json/json.h>
+#include <string>
 
 #include <drogon/drogon.h>
 
@@ -10,6 +13,28 @@ namespace daemon {
 
 drogon::HttpResponsePtr build_json_response(const ::Json::Value& body);
 
+/**
+ * application/json response around a body that is already serialized,
+ * tagged with etag when one is given
+ */
+drogon::HttpResponsePtr build_raw_json_response(std::string body, const std::string& etag = std::string());
+
+/**
+ * Empty 304 answer to a conditional GET whose ETag still matches
+ */
+drogon::HttpResponsePtr build_not_modified_response(const std::string& etag);
+
+/**
+ * True when the client asked for newline-delimited JSON via Accept
+ */
+bool accepts_ndjson(const drogon::HttpRequestPtr& request);
+
+/**
+ * Chunked application/x-ndjson response whose body is pulled from reader
+ * as the connection drains
+ */
+drogon::HttpResponsePtr build_ndjson_stream_response(std::function<std::size_t(char*, std::size_t)> reader);
+
 } // namespace daemon
 } // namespace dbal
 
@@ -1,4 +1,8 @@
 #include "serialization.hpp"
+#include "json_reader.hpp"
+#include "role.hpp"
+
+#include "../../query/cursor/list_cursor.hpp"
 
 #include <chrono>
 #include <json/json.h>
@@ -6,6 +10,52 @@
 namespace dbal {
 namespace daemon {
 
+namespace {
+
+// Field writers that skip unset optionals, so records serialize the same
+// whichever of their fields the schema makes optional
+void put(::Json::Value& value, const char* key, const std::string& field) {
+    value[key] = field;
+}
+
+void put(::Json::Value& value, const char* key, const std::optional<std::string>& field) {
+    if (field.has_value()) {
+        value[key] = field.value();
+    }
+}
+
+void put(::Json::Value& value, const char* key, const Timestamp& field) {
+    value[key] = static_cast<::Json::Int64>(timestamp_to_epoch_ms(field));
+}
+
+void put(::Json::Value& value, const char* key, const std::optional<Timestamp>& field) {
+    if (field.has_value()) {
+        put(value, key, field.value());
+    }
+}
+
+template<typename T, typename ToJson>
+::Json::Value list_value(const std::vector<T>& rows, const ListOptions& options, ToJson to_json) {
+    ::Json::Value data(::Json::arrayValue);
+    for (const auto& row : rows) {
+        data.append(to_json(row));
+    }
+    ::Json::Value value(::Json::objectValue);
+    value["data"] = std::move(data);
+    value["total"] = static_cast<::Json::Int64>(rows.size());
+    value["page"] = options.page;
+    value["limit"] = options.limit;
+    // A full page may have more behind it; the cursor resumes after its last row
+    const std::string next = query::nextCursor(rows, options);
+    value["hasMore"] = !next.empty();
+    if (!next.empty()) {
+        value["nextCursor"] = next;
+    }
+    return value;
+}
+
+} // namespace
+
 long long timestamp_to_epoch_ms(const Timestamp& timestamp) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
 }
@@ -33,6 +83,28 @@ long long timestamp_to_epoch_ms(const Timestamp& timestamp) {
     return value;
 }
 
+void write_user(JsonWriter& writer, const User& user) {
+    writer.beginObject();
+    writer.field("id", user.id);
+    writer.field("tenantId", user.tenantId.value_or(""));
+    writer.field("username", user.username);
+    writer.field("email", user.email);
+    writer.field("role", user.role);
+    writer.field("createdAt", timestamp_to_epoch_ms(user.createdAt));
+    if (user.profilePicture.has_value()) {
+        writer.field("profilePicture", user.profilePicture.value());
+    }
+    if (user.bio.has_value()) {
+        writer.field("bio", user.bio.value());
+    }
+    writer.field("isInstanceOwner", user.isInstanceOwner);
+    if (user.passwordChangeTimestamp.has_value()) {
+        writer.field("passwordChangeTimestamp", timestamp_to_epoch_ms(user.passwordChangeTimestamp.value()));
+    }
+    writer.field("firstLogin", user.firstLogin);
+    writer.endObject();
+}
+
 ::Json::Value users_to_json(const std::vector<User>& users) {
     ::Json::Value arr(::Json::arrayValue);
     for (const auto& user : users) {
@@ -41,6 +113,99 @@ long long timestamp_to_epoch_ms(const Timestamp& timestamp) {
     return arr;
 }
 
+::Json::Value page_to_json(const PageConfig& page) {
+    ::Json::Value value(::Json::objectValue);
+    put(value, "id", page.id);
+    put(value, "tenantId", page.tenantId);
+    put(value, "packageId", page.packageId);
+    put(value, "path", page.path);
+    put(value, "title", page.title);
+    put(value, "description", page.description);
+    put(value, "icon", page.icon);
+    put(value, "component", page.component);
+    put(value, "componentTree", page.componentTree);
+    value["level"] = page.level;
+    value["requiresAuth"] = page.requiresAuth;
+    put(value, "requiredRole", page.requiredRole);
+    put(value, "parentPath", page.parentPath);
+    value["sortOrder"] = page.sortOrder;
+    value["isPublished"] = page.isPublished;
+    put(value, "params", page.params);
+    put(value, "meta", page.meta);
+    put(value, "createdAt", page.createdAt);
+    put(value, "updatedAt", page.updatedAt);
+    return value;
+}
+
+::Json::Value component_to_json(const ComponentNode& component) {
+    ::Json::Value value(::Json::objectValue);
+    put(value, "id", component.id);
+    put(value, "pageId", component.pageId);
+    put(value, "parentId", component.parentId);
+    put(value, "type", component.type);
+    put(value, "childIds", component.childIds);
+    value["order"] = component.order;
+    return value;
+}
+
+::Json::Value workflow_to_json(const Workflow& workflow) {
+    ::Json::Value value(::Json::objectValue);
+    put(value, "id", workflow.id);
+    put(value, "tenantId", workflow.tenantId);
+    put(value, "name", workflow.name);
+    put(value, "description", workflow.description);
+    put(value, "nodes", workflow.nodes);
+    put(value, "edges", workflow.edges);
+    value["enabled"] = workflow.enabled;
+    value["version"] = workflow.version;
+    put(value, "createdAt", workflow.createdAt);
+    put(value, "updatedAt", workflow.updatedAt);
+    put(value, "createdBy", workflow.createdBy);
+    return value;
+}
+
+::Json::Value session_to_json(const Session& session) {
+    ::Json::Value value(::Json::objectValue);
+    put(value, "id", session.id);
+    put(value, "userId", session.userId);
+    put(value, "token", session.token);
+    put(value, "expiresAt", session.expiresAt);
+    put(value, "createdAt", session.createdAt);
+    put(value, "lastActivity", session.lastActivity);
+    put(value, "ipAddress", session.ipAddress);
+    put(value, "userAgent", session.userAgent);
+    return value;
+}
+
+::Json::Value package_to_json(const InstalledPackage& package) {
+    ::Json::Value value(::Json::objectValue);
+    put(value, "packageId", package.packageId);
+    put(value, "tenantId", package.tenantId);
+    put(value, "installedAt", package.installedAt);
+    put(value, "version", package.version);
+    value["enabled"] = package.enabled;
+    put(value, "config", package.config);
+    return value;
+}
+
+::Json::Value component_tree_to_json(const ComponentTree& tree) {
+    ::Json::Value nodes(::Json::arrayValue);
+    for (size_t i = 0; i < tree.nodes.size(); ++i) {
+        ::Json::Value node = component_to_json(tree.nodes[i]);
+        node["depth"] = tree.depth[i];
+        node["subtreeEnd"] = static_cast<::Json::UInt64>(tree.subtreeEnd[i]);
+        nodes.append(std::move(node));
+    }
+    return nodes;
+}
+
+std::optional<Timestamp> timestamp_from_json(const ::Json::Value& value) {
+    if (!value.isIntegral()) {
+        return std::nullopt;
+    }
+    return Timestamp(std::chrono::milliseconds(value.asInt64()));
+}
+
 ListOptions list_options_from_json(const ::Json::Value& json) {
     ListOptions options;
     if (!json.isNull()) {
@@ -50,6 +215,9 @@ ListOptions list_options_from_json(const ::Json::Value& json) {
         if (json.isMember("limit") && json["limit"].isInt()) {
             options.limit = json["limit"].asInt();
         }
+        if (json.isMember("cursor") && json["cursor"].isString()) {
+            options.cursor = json["cursor"].asString();
+        }
         if (json.isMember("filter") && json["filter"].isObject()) {
             for (const auto& key : json["filter"].getMemberNames()) {
                 options.filter[key] = json["filter"][key].asString();
@@ -65,13 +233,109 @@ ListOptions list_options_from_json(const ::Json::Value& json) {
 }
 
 ::Json::Value list_response_value(const std::vector<User>& users, const ListOptions& options) {
-    ::Json::Value value(::Json::objectValue);
-    value["data"] = users_to_json(users);
-    value["total"] = static_cast<::Json::Int64>(users.size());
-    value["page"] = options.page;
-    value["limit"] = options.limit;
-    value["hasMore"] = ::Json::Value(false);
-    return value;
+    return list_value(users, options, user_to_json);
+}
+
+void write_list_response(JsonWriter& writer, const std::vector<User>& users, const ListOptions& options) {
+    writer.beginObject();
+    writer.key("data").beginArray();
+    for (const auto& user : users) {
+        write_user(writer, user);
+    }
+    writer.endArray();
+    writer.field("total", static_cast<long long>(users.size()));
+    writer.field("page", options.page);
+    writer.field("limit", options.limit);
+    const std::string next = query::nextCursor(users, options);
+    writer.field("hasMore", !next.empty());
+    if (!next.empty()) {
+        writer.field("nextCursor", next);
+    }
+    writer.endObject();
+}
+
+namespace {
+
+/**
+ * Walk a body's top-level members, handing string members to keep
+ */
+template<typename Keep>
+bool read_string_members(std::string_view body, std::string& error, Keep keep) {
+    JsonReader reader(body);
+    std::string_view key;
+    if (reader.beginObject()) {
+        while (reader.nextMember(key)) {
+            if (reader.peek() == JsonReader::Kind::String && keep(key, reader)) {
+                continue;
+            }
+            reader.skipValue();
+        }
+    }
+    if (!reader.finish()) {
+        error = "Invalid JSON payload: " + reader.error();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool read_create_user_input(std::string_view body, CreateUserInput& input, std::string& error) {
+    return read_string_members(body, error, [&input](std::string_view key, JsonReader& reader) {
+        if (key == "username") {
+            return reader.readString(input.username);
+        }
+        if (key == "email") {
+            return reader.readString(input.email);
+        }
+        if (key == "role") {
+            std::string role;
+            if (!reader.readString(role)) {
+                return false;
+            }
+            input.role = normalize_role(role);
+            return true;
+        }
+        return false;
+    });
+}
+
+bool read_update_user_input(std::string_view body, UpdateUserInput& input, std::string& error) {
+    return read_string_members(body, error, [&input](std::string_view key, JsonReader& reader) {
+        std::optional<std::string>* field = key == "username" ? &input.username
+                                          : key == "email"    ? &input.email
+                                          : key == "role"     ? &input.role
+                                                              : nullptr;
+        if (field == nullptr) {
+            return false;
+        }
+        std::string value;
+        if (!reader.readString(value)) {
+            return false;
+        }
+        *field = field == &input.role ? normalize_role(value) : std::move(value);
+        return true;
+    });
+}
+
+::Json::Value list_response_value(const std::vector<PageConfig>& pages, const ListOptions& options) {
+    return list_value(pages, options, page_to_json);
+}
+
+::Json::Value list_response_value(const std::vector<ComponentNode>& components, const ListOptions& options) {
+    return list_value(components, options, component_to_json);
+}
+
+::Json::Value list_response_value(const std::vector<Workflow>& workflows, const ListOptions& options) {
+    return list_value(workflows, options, workflow_to_json);
+}
+
+::Json::Value list_response_value(const std::vector<Session>& sessions, const ListOptions& options) {
+    return list_value(sessions, options, session_to_json);
+}
+
+::Json::Value list_response_value(const std::vector<InstalledPackage>& packages, const ListOptions& options) {
+    return list_value(packages, options, package_to_json);
 }
 
 } // namespace daemon
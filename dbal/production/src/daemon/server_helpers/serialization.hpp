@@ -2,9 +2,13 @@
 #define DBAL_SERVER_HELPERS_SERIALIZATION_HPP
 
 #include <json/json.h>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "dbal/core/types.hpp"
+#include "json_writer.hpp"
 
 namespace dbal {
 namespace daemon {
@@ -12,9 +16,46 @@ namespace daemon {
 long long timestamp_to_epoch_ms(const Timestamp& timestamp);
 ::Json::Value user_to_json(const User& user);
 ::Json::Value users_to_json(const std::vector<User>& users);
+::Json::Value page_to_json(const PageConfig& page);
+::Json::Value component_to_json(const ComponentNode& component);
+::Json::Value workflow_to_json(const Workflow& workflow);
+::Json::Value session_to_json(const Session& session);
+::Json::Value package_to_json(const InstalledPackage& package);
+
+/**
+ * Component tree as an array of nodes in pre-order, each carrying its
+ * depth and the index one past its last descendant
+ */
+::Json::Value component_tree_to_json(const ComponentTree& tree);
+
+/**
+ * Epoch milliseconds as a Timestamp; nullopt unless value is an integer
+ */
+std::optional<Timestamp> timestamp_from_json(const ::Json::Value& value);
 
 ListOptions list_options_from_json(const ::Json::Value& json);
 ::Json::Value list_response_value(const std::vector<User>& users, const ListOptions& options);
+::Json::Value list_response_value(const std::vector<PageConfig>& pages, const ListOptions& options);
+::Json::Value list_response_value(const std::vector<ComponentNode>& components, const ListOptions& options);
+::Json::Value list_response_value(const std::vector<Workflow>& workflows, const ListOptions& options);
+::Json::Value list_response_value(const std::vector<Session>& sessions, const ListOptions& options);
+::Json::Value list_response_value(const std::vector<InstalledPackage>& packages, const ListOptions& options);
+
+/**
+ * Direct counterparts of user_to_json and list_response_value: the same
+ * members, written straight into the writer's buffer
+ */
+void write_user(JsonWriter& writer, const User& user);
+void write_list_response(JsonWriter& writer, const std::vector<User>& users, const ListOptions& options);
+
+/**
+ * Decode a user create or update body straight from its bytes. Only the
+ * members the DOM path reads are kept (username, email, role), only when
+ * they are strings, and role is normalized; anything else is skipped.
+ * False with error set when the body is not a JSON object.
+ */
+bool read_create_user_input(std::string_view body, CreateUserInput& input, std::string& error);
+bool read_update_user_input(std::string_view body, UpdateUserInput& input, std::string& error);
 
 } // namespace daemon
 } // namespace dbal
@@ -6,21 +6,70 @@
 #include <cstdlib>
 #include <functional>
 #include <json/json.h>
-#include <sstream>
+#include <map>
+#include <optional>
 
 #include "dbal/core/errors.hpp"
 #include "rpc_user_actions.hpp"
+#include "rpc_batch_actions.hpp"
 #include "rpc_schema_actions.hpp"
 #include "rpc_restful_handler.hpp"
 
 namespace dbal {
 namespace daemon {
 
+namespace {
+
+const std::string kNoSegment;
+
+rpc::HttpVerb to_http_verb(drogon::HttpMethod method) {
+    switch (method) {
+        case drogon::HttpMethod::Get: return rpc::HttpVerb::Get;
+        case drogon::HttpMethod::Post: return rpc::HttpVerb::Post;
+        case drogon::HttpMethod::Put: return rpc::HttpVerb::Put;
+        case drogon::HttpMethod::Patch: return rpc::HttpVerb::Patch;
+        case drogon::HttpMethod::Delete: return rpc::HttpVerb::Delete;
+        default: return rpc::HttpVerb::Other;
+    }
+}
+
+/**
+ * Action a RESTful write verb maps to; nullopt for reads
+ */
+std::optional<rpc::RpcAction> restful_write_action(rpc::HttpVerb method) {
+    switch (method) {
+        case rpc::HttpVerb::Post: return rpc::RpcAction::Create;
+        case rpc::HttpVerb::Put:
+        case rpc::HttpVerb::Patch: return rpc::RpcAction::Update;
+        case rpc::HttpVerb::Delete: return rpc::RpcAction::Delete;
+        default: return std::nullopt;
+    }
+}
+
+/**
+ * {"success": true, "data": data} serialized the way build_json_response
+ * sends it, for responses that go through the read cache
+ */
+std::string success_envelope(const ::Json::Value& data) {
+    static const ::Json::StreamWriterBuilder writer = [] {
+        ::Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        return builder;
+    }();
+    ::Json::Value body;
+    body["success"] = true;
+    body["data"] = data;
+    return ::Json::writeString(writer, body);
+}
+
+} // namespace
+
 void Server::registerRoutes() {
     if (routes_registered_) {
         return;
     }
 
+    dispatch_table_ = rpc::core_dispatch_table();
     const std::string server_address = address();
 
     auto health_handler = [](const drogon::HttpRequestPtr&,
@@ -60,19 +109,10 @@ void Server::registerRoutes() {
             callback(response);
         };
 
-        std::istringstream stream(std::string(request->getBody()));
-        ::Json::CharReaderBuilder reader_builder;
         ::Json::Value rpc_request;
-        JSONCPP_STRING errs;
-        if (!::Json::parseFromStream(reader_builder, stream, &rpc_request, &errs)) {
-            send_error("Invalid JSON payload: " + std::string(errs), 400);
-            return;
-        }
-
-        const std::string entity = rpc_request.get("entity", "").asString();
-        std::string action = rpc_request.get("action", rpc_request.get("method", "")).asString();
-        if (entity.empty() || action.empty()) {
-            send_error("Both entity and action are required");
+        std::string errs;
+        if (!parse_json_document(request->getBody(), rpc_request, errs)) {
+            send_error("Invalid JSON payload: " + errs, 400);
             return;
         }
 
@@ -81,16 +121,6 @@ void Server::registerRoutes() {
             return;
         }
 
-        std::string normalized_entity = entity;
-        std::transform(normalized_entity.begin(), normalized_entity.end(), normalized_entity.begin(),
-                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        std::transform(action.begin(), action.end(), action.begin(),
-                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-
-        const auto payload = rpc_request.get("payload", ::Json::Value(::Json::objectValue));
-        const auto options_value = rpc_request.get("options", ::Json::Value(::Json::objectValue));
-        const std::string tenantId = rpc_request.get("tenantId", payload.get("tenantId", "")).asString();
-
         auto send_success = [&callback](const ::Json::Value& data) {
             ::Json::Value body;
             body["success"] = true;
@@ -98,47 +128,31 @@ void Server::registerRoutes() {
             callback(build_json_response(body));
         };
 
-        auto send_db_error = [&](const dbal::Error& error) {
-            send_error(error.what(), static_cast<int>(error.code()));
-        };
-
-        if (normalized_entity != "user") {
-            send_error("Unsupported entity: " + entity, 400);
-            return;
-        }
-
-        if (action == "list") {
-            rpc::handle_user_list(*dbal_client_, tenantId, options_value, send_success, send_error);
-            return;
-        }
-
-        const auto id = payload.get("id", "").asString();
-        if ((action == "get" || action == "read") && id.empty()) {
-            send_error("ID is required for read operations");
+        if (rpc::is_rpc_batch(rpc_request)) {
+            rpc::handle_rpc_batch(*dbal_client_, dispatch_table_, read_cache_, rpc_request, send_success,
+                                  send_error);
             return;
         }
 
-        if (action == "get" || action == "read") {
-            rpc::handle_user_read(*dbal_client_, tenantId, id, send_success, send_error);
+        rpc::RpcOperation operation;
+        std::string parse_error;
+        if (!rpc::parse_rpc_operation(dispatch_table_, rpc_request, "", operation, parse_error)) {
+            send_error(parse_error);
             return;
         }
 
-        if (action == "create") {
-            rpc::handle_user_create(*dbal_client_, tenantId, payload, send_success, send_error);
+        if (operation.action == rpc::RpcAction::List && operation.route->list_stream && accepts_ndjson(request)) {
+            auto send_stream = [&callback](rpc::StreamReader reader) {
+                callback(build_ndjson_stream_response(std::move(reader)));
+            };
+            operation.route->list_stream(*dbal_client_, operation.tenantId, *operation.options, send_stream,
+                                         send_error);
             return;
         }
 
-        if (action == "update") {
-            rpc::handle_user_update(*dbal_client_, tenantId, id, payload, send_success, send_error);
-            return;
-        }
-
-        if (action == "delete" || action == "remove") {
-            rpc::handle_user_delete(*dbal_client_, tenantId, id, send_success, send_error);
-            return;
-        }
-
-        send_error("Unsupported action: " + action, 400);
+        rpc::ReadCache::WriteScope cache_writes(read_cache_);
+        rpc::track_rpc_write(cache_writes, operation);
+        rpc::dispatch_rpc(*dbal_client_, operation, send_success, send_error);
     };
 
     drogon::app().registerHandler("/health", health_handler, {drogon::HttpMethod::Get});
@@ -181,11 +195,9 @@ void Server::registerRoutes() {
         }
         
         // Handle POST - actions
-        std::istringstream stream(std::string(request->getBody()));
-        ::Json::CharReaderBuilder reader_builder;
         ::Json::Value body;
-        JSONCPP_STRING errs;
-        if (!::Json::parseFromStream(reader_builder, stream, &body, &errs)) {
+        std::string errs;
+        if (!parse_json_document(request->getBody(), body, errs)) {
             send_error("Invalid JSON payload", 400);
             return;
         }
@@ -217,20 +229,28 @@ void Server::registerRoutes() {
     drogon::app().registerHandler("/api/dbal/schema", schema_handler, 
                                   {drogon::HttpMethod::Get, drogon::HttpMethod::Post});
 
+    // Ahead of the RESTful patterns, which /api/blobs/{key} also matches
+    if (blob_storage_) {
+        register_blob_routes(blob_storage_);
+    }
+
     // RESTful multi-tenant routes: /{tenant}/{package}/{entity}[/{id}[/{action}]]
-    // This is a catch-all handler for the RESTful pattern
-    auto restful_handler = [this](const drogon::HttpRequestPtr& request,
-                                  std::function<void(const drogon::HttpResponsePtr&)>&& callback,
-                                  const std::string& tenant,
-                                  const std::string& package,
-                                  const std::string& entity) {
-        auto send_success = [&callback](const ::Json::Value& data) {
+    // The router has already split the path, so its segments go straight to
+    // the dispatch table instead of being joined and parsed again
+    auto serve_restful = [this](const drogon::HttpRequestPtr& request,
+                                std::function<void(const drogon::HttpResponsePtr&)>& callback,
+                                const rpc::RouteSegments& route) {
+        rpc::ResponseSender send_success = [&callback](const ::Json::Value& data) {
             ::Json::Value body;
             body["success"] = true;
             body["data"] = data;
             callback(build_json_response(body));
         };
         
+        rpc::BodySender send_body = [&callback](std::string body) {
+            callback(build_raw_json_response(std::move(body)));
+        };
+
         auto send_error = [&callback](const std::string& message, int status) {
             ::Json::Value body;
             body["success"] = false;
@@ -240,36 +260,19 @@ void Server::registerRoutes() {
             callback(response);
         };
 
+        // Before the cache, so a malformed route never gets a 304 or a body
+        const std::string route_error = rpc::validateRoute(route);
+        if (!route_error.empty()) {
+            send_error(route_error, 400);
+            return;
+        }
+
         if (!ensureClient()) {
             send_error("DBAL client is unavailable", 503);
             return;
         }
         
-        // Build full path for parsing
-        std::string full_path = "/" + tenant + "/" + package + "/" + entity;
-        
-        // Parse the route
-        auto route = rpc::parseRoute(full_path);
-        
-        // Determine HTTP method
-        std::string method;
-        switch (request->method()) {
-            case drogon::HttpMethod::Get: method = "GET"; break;
-            case drogon::HttpMethod::Post: method = "POST"; break;
-            case drogon::HttpMethod::Put: method = "PUT"; break;
-            case drogon::HttpMethod::Patch: method = "PATCH"; break;
-            case drogon::HttpMethod::Delete: method = "DELETE"; break;
-            default: method = "UNKNOWN"; break;
-        }
-        
-        // Parse body for POST/PUT/PATCH
-        ::Json::Value body(::Json::objectValue);
-        if (method == "POST" || method == "PUT" || method == "PATCH") {
-            std::istringstream stream(std::string(request->getBody()));
-            ::Json::CharReaderBuilder reader;
-            JSONCPP_STRING errs;
-            ::Json::parseFromStream(reader, stream, &body, &errs);
-        }
+        const rpc::HttpVerb method = to_http_verb(request->method());
         
         // Parse query parameters
         std::map<std::string, std::string> query;
@@ -277,122 +280,75 @@ void Server::registerRoutes() {
             query[param.first] = param.second;
         }
         
-        rpc::handleRestfulRequest(*dbal_client_, route, method, body, query, send_success, send_error);
-    };
-    
-    // Handler with ID
-    auto restful_handler_with_id = [this](const drogon::HttpRequestPtr& request,
-                                          std::function<void(const drogon::HttpResponsePtr&)>&& callback,
-                                          const std::string& tenant,
-                                          const std::string& package,
-                                          const std::string& entity,
-                                          const std::string& id) {
-        auto send_success = [&callback](const ::Json::Value& data) {
-            ::Json::Value body;
-            body["success"] = true;
-            body["data"] = data;
-            callback(build_json_response(body));
-        };
-        
-        auto send_error = [&callback](const std::string& message, int status) {
-            ::Json::Value body;
-            body["success"] = false;
-            body["error"] = message;
-            auto response = drogon::HttpResponse::newHttpJsonResponse(body);
-            response->setStatusCode(static_cast<drogon::HttpStatusCode>(status));
-            callback(response);
-        };
-
-        if (!ensureClient()) {
-            send_error("DBAL client is unavailable", 503);
-            return;
+        rpc::StreamSender send_stream;
+        if (accepts_ndjson(request)) {
+            send_stream = [&callback](rpc::StreamReader reader) {
+                callback(build_ndjson_stream_response(std::move(reader)));
+            };
         }
-        
-        std::string full_path = "/" + tenant + "/" + package + "/" + entity + "/" + id;
-        auto route = rpc::parseRoute(full_path);
-        
-        std::string method;
-        switch (request->method()) {
-            case drogon::HttpMethod::Get: method = "GET"; break;
-            case drogon::HttpMethod::Post: method = "POST"; break;
-            case drogon::HttpMethod::Put: method = "PUT"; break;
-            case drogon::HttpMethod::Patch: method = "PATCH"; break;
-            case drogon::HttpMethod::Delete: method = "DELETE"; break;
-            default: method = "UNKNOWN"; break;
+
+        // Writes invalidate cached GETs until they finish; GETs answer
+        // from the cache when their ETag is still current
+        const rpc::EntityRoute* entity = dispatch_table_.find(route.entity);
+        rpc::ReadCache::WriteScope cache_writes(read_cache_);
+        const auto write_action = restful_write_action(method);
+        if (entity != nullptr && write_action.has_value()) {
+            cache_writes.add(*entity, write_action.value(), route.tenant, route.id);
         }
-        
-        ::Json::Value body(::Json::objectValue);
-        if (method == "POST" || method == "PUT" || method == "PATCH") {
-            std::istringstream stream(std::string(request->getBody()));
-            ::Json::CharReaderBuilder reader;
-            JSONCPP_STRING errs;
-            ::Json::parseFromStream(reader, stream, &body, &errs);
+
+        rpc::ReadCache::Read cached_read;
+        if (entity != nullptr && method == rpc::HttpVerb::Get && !send_stream && route.action.empty()) {
+            cached_read = read_cache_.beginRead(*entity, route.tenant, route.package, route.id, query);
         }
-        
-        std::map<std::string, std::string> query;
-        for (const auto& param : request->getParameters()) {
-            query[param.first] = param.second;
+        if (cached_read.cacheable()) {
+            if (rpc::etag_matches(request->getHeader("If-None-Match"), cached_read.etag)) {
+                callback(build_not_modified_response(cached_read.etag));
+                return;
+            }
+            if (auto cached = read_cache_.find(cached_read)) {
+                callback(build_raw_json_response(*cached, cached_read.etag));
+                return;
+            }
+            send_body = [this, &callback, &cached_read](std::string body) {
+                const bool current = read_cache_.store(cached_read, body);
+                callback(build_raw_json_response(std::move(body), current ? cached_read.etag : std::string()));
+            };
+            send_success = [&send_body](const ::Json::Value& data) {
+                send_body(success_envelope(data));
+            };
         }
         
-        rpc::handleRestfulRequest(*dbal_client_, route, method, body, query, send_success, send_error);
+        rpc::handleRestfulRequest(*dbal_client_, dispatch_table_, route, method, request->getBody(), query,
+                                  send_success, send_body, send_error, send_stream);
+    };
+
+    auto restful_handler = [serve_restful](const drogon::HttpRequestPtr& request,
+                                           std::function<void(const drogon::HttpResponsePtr&)>&& callback,
+                                           const std::string& tenant,
+                                           const std::string& package,
+                                           const std::string& entity) {
+        serve_restful(request, callback, {tenant, package, entity, kNoSegment, kNoSegment});
+    };
+    
+    // Handler with ID
+    auto restful_handler_with_id = [serve_restful](const drogon::HttpRequestPtr& request,
+                                                   std::function<void(const drogon::HttpResponsePtr&)>&& callback,
+                                                   const std::string& tenant,
+                                                   const std::string& package,
+                                                   const std::string& entity,
+                                                   const std::string& id) {
+        serve_restful(request, callback, {tenant, package, entity, id, kNoSegment});
     };
     
     // Handler with ID and action
-    auto restful_handler_with_action = [this](const drogon::HttpRequestPtr& request,
-                                              std::function<void(const drogon::HttpResponsePtr&)>&& callback,
-                                              const std::string& tenant,
-                                              const std::string& package,
-                                              const std::string& entity,
-                                              const std::string& id,
-                                              const std::string& action) {
-        auto send_success = [&callback](const ::Json::Value& data) {
-            ::Json::Value body;
-            body["success"] = true;
-            body["data"] = data;
-            callback(build_json_response(body));
-        };
-        
-        auto send_error = [&callback](const std::string& message, int status) {
-            ::Json::Value body;
-            body["success"] = false;
-            body["error"] = message;
-            auto response = drogon::HttpResponse::newHttpJsonResponse(body);
-            response->setStatusCode(static_cast<drogon::HttpStatusCode>(status));
-            callback(response);
-        };
-
-        if (!ensureClient()) {
-            send_error("DBAL client is unavailable", 503);
-            return;
-        }
-        
-        std::string full_path = "/" + tenant + "/" + package + "/" + entity + "/" + id + "/" + action;
-        auto route = rpc::parseRoute(full_path);
-        
-        std::string method;
-        switch (request->method()) {
-            case drogon::HttpMethod::Get: method = "GET"; break;
-            case drogon::HttpMethod::Post: method = "POST"; break;
-            case drogon::HttpMethod::Put: method = "PUT"; break;
-            case drogon::HttpMethod::Patch: method = "PATCH"; break;
-            case drogon::HttpMethod::Delete: method = "DELETE"; break;
-            default: method = "UNKNOWN"; break;
-        }
-        
-        ::Json::Value body(::Json::objectValue);
-        if (method == "POST" || method == "PUT" || method == "PATCH") {
-            std::istringstream stream(std::string(request->getBody()));
-            ::Json::CharReaderBuilder reader;
-            JSONCPP_STRING errs;
-            ::Json::parseFromStream(reader, stream, &body, &errs);
-        }
-        
-        std::map<std::string, std::string> query;
-        for (const auto& param : request->getParameters()) {
-            query[param.first] = param.second;
-        }
-        
-        rpc::handleRestfulRequest(*dbal_client_, route, method, body, query, send_success, send_error);
+    auto restful_handler_with_action = [serve_restful](const drogon::HttpRequestPtr& request,
+                                                       std::function<void(const drogon::HttpResponsePtr&)>&& callback,
+                                                       const std::string& tenant,
+                                                       const std::string& package,
+                                                       const std::string& entity,
+                                                       const std::string& id,
+                                                       const std::string& action) {
+        serve_restful(request, callback, {tenant, package, entity, id, action});
     };
     
     // Register RESTful routes with path parameters
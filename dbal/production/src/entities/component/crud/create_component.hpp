@@ -44,11 +44,13 @@ inline Result<ComponentNode> create(InMemoryStore& store, const CreateComponentN
     component.childIds = input.childIds;
     component.order = input.order;
 
+    store.remember(store.components, component.id);
     store.components[component.id] = component;
     helpers::addComponentToPage(store, component.pageId, component.id);
     if (component.parentId.has_value()) {
         helpers::addComponentToParent(store, component.parentId.value(), component.id);
     }
+    store.component_trees.invalidate(component.pageId);
 
     return Result<ComponentNode>(component);
 }
@@ -19,6 +19,7 @@ inline Result<bool> remove(InMemoryStore& store, const std::string& id) {
         return Error::notFound("Component not found: " + id);
     }
 
+    store.component_trees.invalidate(it->second.pageId);
     helpers::cascadeDeleteComponent(store, id);
     return Result<bool>(true);
 }
@@ -4,7 +4,8 @@
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
 #include <algorithm>
-#include <optional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace dbal {
@@ -13,45 +14,72 @@ namespace component {
 
 namespace detail {
 
-inline std::vector<std::string> collectChildren(const InMemoryStore& store,
-                                                 const std::optional<std::string>& parentId,
-                                                 const std::string& pageId) {
-    std::vector<std::string> ids;
-    if (parentId.has_value()) {
-        auto it = store.components_by_parent.find(parentId.value());
-        if (it != store.components_by_parent.end()) {
-            ids = it->second;
-        }
-    } else {
-        for (const auto& [id, component] : store.components) {
-            if (component.pageId == pageId && !component.parentId.has_value()) {
-                ids.push_back(id);
-            }
+using Siblings = std::vector<const ComponentNode*>;
+
+inline void appendSubtrees(const std::unordered_map<std::string, Siblings>& children,
+                           const Siblings& siblings,
+                           int depth,
+                           ComponentTree& tree) {
+    for (const ComponentNode* node : siblings) {
+        const size_t index = tree.nodes.size();
+        tree.nodes.push_back(*node);
+        tree.depth.push_back(depth);
+        tree.subtreeEnd.push_back(index + 1);
+
+        auto it = children.find(node->id);
+        if (it != children.end()) {
+            appendSubtrees(children, it->second, depth + 1, tree);
+            tree.subtreeEnd[index] = tree.nodes.size();
         }
     }
+}
 
-    std::sort(ids.begin(), ids.end(), [&store](const std::string& a, const std::string& b) {
-        return store.components.at(a).order < store.components.at(b).order;
-    });
+/**
+ * Flatten a page's components in one pass over its page index
+ */
+inline ComponentTreeSnapshot buildTree(const InMemoryStore& store, const std::string& pageId) {
+    auto tree = std::make_shared<ComponentTree>();
+    auto page_it = store.components_by_page.find(pageId);
+    if (page_it == store.components_by_page.end()) {
+        return tree;
+    }
 
-    return ids;
-}
+    Siblings roots;
+    std::unordered_map<std::string, Siblings> children;
+    for (const auto& id : page_it->second) {
+        const ComponentNode& component = store.components.at(id);
+        if (component.parentId.has_value()) {
+            children[component.parentId.value()].push_back(&component);
+        } else {
+            roots.push_back(&component);
+        }
+    }
 
-inline void buildTree(const InMemoryStore& store,
-                      const std::string& pageId,
-                      const std::optional<std::string>& parentId,
-                      std::vector<ComponentNode>& out) {
-    auto children = collectChildren(store, parentId, pageId);
-    for (const auto& child_id : children) {
-        const auto& component = store.components.at(child_id);
-        out.push_back(component);
-        buildTree(store, pageId, child_id, out);
+    auto by_order = [](const ComponentNode* a, const ComponentNode* b) {
+        return a->order != b->order ? a->order < b->order : a->id < b->id;
+    };
+    std::sort(roots.begin(), roots.end(), by_order);
+    for (auto& [parent, siblings] : children) {
+        std::sort(siblings.begin(), siblings.end(), by_order);
     }
+
+    const size_t count = page_it->second.size();
+    tree->nodes.reserve(count);
+    tree->depth.reserve(count);
+    tree->subtreeEnd.reserve(count);
+    appendSubtrees(children, roots, 0, *tree);
+    return tree;
 }
 
 } // namespace detail
 
-inline Result<std::vector<ComponentNode>> getTree(InMemoryStore& store, const std::string& pageId) {
+/**
+ * Page's component tree, served from the per-page cache
+ *
+ * Caller must hold Pages and Components at least shared. A miss builds
+ * the tree and publishes it for later readers.
+ */
+inline Result<ComponentTreeSnapshot> getTree(const InMemoryStore& store, const std::string& pageId) {
     if (pageId.empty()) {
         return Error::validationError("pageId is required");
     }
@@ -59,9 +87,12 @@ inline Result<std::vector<ComponentNode>> getTree(InMemoryStore& store, const st
         return Error::notFound("Page not found: " + pageId);
     }
 
-    std::vector<ComponentNode> tree;
-    detail::buildTree(store, pageId, std::nullopt, tree);
-    return Result<std::vector<ComponentNode>>(tree);
+    if (auto cached = store.component_trees.find(pageId)) {
+        return Result<ComponentTreeSnapshot>(std::move(cached));
+    }
+    auto tree = detail::buildTree(store, pageId);
+    store.component_trees.publish(pageId, tree);
+    return Result<ComponentTreeSnapshot>(std::move(tree));
 }
 
 } // namespace component
@@ -2,6 +2,7 @@
 #define DBAL_LIST_COMPONENTS_HPP
 
 #include "../../../store/in_memory_store.hpp"
+#include "../../list_window.hpp"
 #include <algorithm>
 #include <string>
 #include <vector>
@@ -11,6 +12,12 @@ namespace entities {
 namespace component {
 
 inline Result<std::vector<ComponentNode>> list(InMemoryStore& store, const ListOptions& options) {
+    auto cursor = query::resolveCursor<ComponentNode>(options, query::sortField<ComponentNode>(options));
+    if (cursor.isError()) {
+        return cursor.error();
+    }
+    const auto& after = cursor.value();
+
     std::vector<ComponentNode> components;
     std::string page_filter;
 
@@ -19,11 +26,27 @@ inline Result<std::vector<ComponentNode>> list(InMemoryStore& store, const ListO
         page_filter = filter_it->second;
     }
 
-    for (const auto& [id, component] : store.components) {
-        (void)id;
-        if (!page_filter.empty() && component.pageId != page_filter) {
-            continue;
+    // A page filter walks that page's component list instead of every component
+    std::vector<const ComponentNode*> candidates;
+    if (!page_filter.empty()) {
+        auto page_it = store.components_by_page.find(page_filter);
+        if (page_it != store.components_by_page.end()) {
+            for (const auto& component_id : page_it->second) {
+                auto it = store.components.find(component_id);
+                if (it != store.components.end()) {
+                    candidates.push_back(&it->second);
+                }
+            }
+        }
+    } else {
+        for (const auto& [id, component] : store.components) {
+            (void)id;
+            candidates.push_back(&component);
         }
+    }
+
+    for (const ComponentNode* candidate : candidates) {
+        const ComponentNode& component = *candidate;
         if (options.filter.find("parentId") != options.filter.end()) {
             const std::string& parent_filter = options.filter.at("parentId");
             if (!component.parentId.has_value() || component.parentId.value() != parent_filter) {
@@ -36,10 +59,23 @@ inline Result<std::vector<ComponentNode>> list(InMemoryStore& store, const ListO
                 continue;
             }
         }
+        if (after.has_value() &&
+            !after->before(query::CursorTraits<ComponentNode>::key(component, after->field), component.id)) {
+            continue;
+        }
         components.push_back(component);
     }
 
-    std::sort(components.begin(), components.end(), [](const ComponentNode& a, const ComponentNode& b) {
+    int page = after.has_value() || options.page < 1 ? 1 : options.page;
+    int limit = options.limit > 0 ? options.limit : static_cast<int>(components.size());
+    if (limit <= 0) {
+        limit = static_cast<int>(components.size());
+    }
+
+    // Only the rows up to the end of the requested page need ordering
+    const size_t wanted = std::min(components.size(), static_cast<size_t>(page) * static_cast<size_t>(limit));
+    std::partial_sort(components.begin(), components.begin() + wanted, components.end(),
+                      [](const ComponentNode& a, const ComponentNode& b) {
         if (a.pageId != b.pageId) {
             return a.pageId < b.pageId;
         }
@@ -55,12 +91,6 @@ inline Result<std::vector<ComponentNode>> list(InMemoryStore& store, const ListO
         return a.id < b.id;
     });
 
-    int page = options.page > 1 ? options.page : 1;
-    int limit = options.limit > 0 ? options.limit : static_cast<int>(components.size());
-    if (limit <= 0) {
-        limit = static_cast<int>(components.size());
-    }
-
     if (limit == 0 || components.empty()) {
         return Result<std::vector<ComponentNode>>(std::vector<ComponentNode>());
     }
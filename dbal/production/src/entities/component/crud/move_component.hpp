@@ -41,6 +41,8 @@ inline Result<ComponentNode> move(InMemoryStore& store, const MoveComponentInput
         }
     }
 
+    store.remember(store.components, component.id);
+    store.component_trees.invalidate(component.pageId);
     if (component.parentId.has_value()) {
         helpers::removeComponentFromParent(store, component.parentId.value(), component.id);
     }
@@ -41,7 +41,9 @@ inline Result<bool> reorder(InMemoryStore& store, const std::vector<ComponentOrd
     for (const auto& update : updates) {
         auto it = store.components.find(update.id);
         if (it != store.components.end()) {
+            store.remember(store.components, update.id);
             it->second.order = update.order;
+            store.component_trees.invalidate(it->second.pageId);
         }
     }
 
@@ -20,7 +20,9 @@ inline Result<ComponentNode> update(InMemoryStore& store, const std::string& id,
         return Error::notFound("Component not found: " + id);
     }
 
+    store.remember(store.components, id);
     ComponentNode& component = it->second;
+    store.component_trees.invalidate(component.pageId);
 
     if (input.type.has_value()) {
         if (!validation::isValidComponentType(input.type.value())) {
@@ -73,6 +73,7 @@ inline void cascadeDeleteComponent(InMemoryStore& store, const std::string& comp
         store.components_by_parent.erase(component_id);
     }
 
+    store.remember(store.components, component_id);
     const auto& component = comp_it->second;
     if (component.parentId.has_value()) {
         removeComponentFromParent(store, component.parentId.value(), component_id);
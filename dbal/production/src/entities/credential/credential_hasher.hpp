@@ -0,0 +1,50 @@
+#ifndef DBAL_CREDENTIAL_HASHER_HPP
+#define DBAL_CREDENTIAL_HASHER_HPP
+
+#include "dbal/core/client.hpp"
+#include "../../security/password/password_hash.hpp"
+#include "../../security/password/password_hash_pool.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace dbal {
+
+/**
+ * @brief A Client's password hashing cost and threads
+ *
+ * The pool starts with the first async credential call, so clients that
+ * never make one start no threads.
+ */
+class CredentialHasher {
+public:
+    explicit CredentialHasher(const PasswordHashingConfig& config) : config_(config) {}
+
+    security::PasswordHashCost cost() const {
+        security::PasswordHashCost cost;
+        cost.cost_log2 = config_.cost_log2;
+        cost.block_size = config_.block_size;
+        cost.parallelism = config_.parallelism;
+        return cost;
+    }
+
+    /**
+     * @return false when the queue is full and job will not run
+     */
+    bool submit(std::function<void()> job) {
+        std::call_once(started_, [this] {
+            pool_ = std::make_unique<security::PasswordHashPool>(config_.workers, config_.max_queued);
+        });
+        return pool_->submit(std::move(job));
+    }
+
+private:
+    PasswordHashingConfig config_;
+    std::once_flag started_;
+    std::unique_ptr<security::PasswordHashPool> pool_;
+};
+
+} // namespace dbal
+
+#endif
@@ -18,6 +18,7 @@ inline Result<bool> remove(InMemoryStore& store, const std::string& username) {
         return Error::notFound("Credential not found: " + username);
     }
 
+    store.remember(store.credentials, username);
     store.credentials.erase(it);
     return Result<bool>(true);
 }
@@ -15,6 +15,7 @@ inline Result<bool> setFirstLogin(InMemoryStore& store, const std::string& usern
 
     for (auto& [id, user] : store.users) {
         if (user.username == username) {
+            store.remember(store.users, id);
             user.firstLogin = flag;
             return Result<bool>(true);
         }
@@ -3,6 +3,7 @@
 
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../security/password/password_verify.hpp"
 #include "../helpers.hpp"
 
 #include <algorithm>
@@ -10,6 +11,7 @@
 #include <cstdint>
 #include <cstring>
 #include <iomanip>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -36,8 +38,7 @@ inline bool secureCompare(const std::string& a, const std::string& b) {
 }
 
 /**
- * @brief Simple SHA-256 implementation for password hashing
- * Uses a basic implementation - in production, use OpenSSL or similar
+ * @brief Hash of credentials stored before scrypt; only checked, never written
  */
 inline std::string computeHash(const std::string& password, const std::string& salt) {
     // Combine password and salt
@@ -65,12 +66,47 @@ inline std::string computeHash(const std::string& password, const std::string& s
  * @brief Perform dummy hash computation to prevent timing attacks
  * Called when user doesn't exist to prevent username enumeration
  */
-inline void dummyHashComputation(const std::string& password) {
-    computeHash(password, "dummy_salt_value_for_timing_protection");
+inline void dummyHashComputation(const std::string& password, const security::PasswordHashCost& cost) {
+    security::password_hash(password, "dummy_salt_value_for_timing_protection", cost);
 }
 
 } // anonymous namespace
 
+/**
+ * @brief Copy of a user's stored credential, so it can be checked without the store locked
+ */
+inline std::optional<Credential> lookup(InMemoryStore& store, const std::string& username) {
+    auto* credential = helpers::getCredential(store, username);
+    if (!credential) {
+        return std::nullopt;
+    }
+    return *credential;
+}
+
+/**
+ * @brief Check a password against a credential from lookup()
+ * @param cost Cost of the dummy hash run when there is no credential
+ * @return Result containing true, or Unauthorized
+ */
+inline Result<bool> matches(const std::optional<Credential>& credential, const std::string& password,
+                            const security::PasswordHashCost& cost) {
+    if (!credential) {
+        // Perform dummy hash to prevent timing attacks (username enumeration)
+        dummyHashComputation(password, cost);
+        return Error::unauthorized("Invalid credentials");
+    }
+
+    const bool legacy = credential->passwordHash.compare(0, 7, "scrypt$") != 0;
+    const bool valid = legacy
+        ? secureCompare(computeHash(password, credential->salt), credential->passwordHash)
+        : security::password_verify(password, credential->salt, credential->passwordHash);
+    if (!valid) {
+        return Error::unauthorized("Invalid credentials");
+    }
+
+    return Result<bool>(true);
+}
+
 /**
  * @brief Verify user credentials with secure password comparison (CRIT-001 fix)
  * @param store In-memory store reference
@@ -80,30 +116,15 @@ inline void dummyHashComputation(const std::string& password) {
  *
  * Security features:
  * - Constant-time comparison to prevent timing attacks
- * - Salted password hashing
+ * - Salted scrypt hashing, at the cost recorded with each hash
  * - Dummy computation when user not found to prevent username enumeration
  */
-inline Result<bool> verify(InMemoryStore& store, const std::string& username, const std::string& password) {
+inline Result<bool> verify(InMemoryStore& store, const std::string& username, const std::string& password,
+                           const security::PasswordHashCost& cost = {}) {
     if (username.empty() || password.empty()) {
         return Error::validationError("username and password are required");
     }
-
-    auto* credential = helpers::getCredential(store, username);
-    if (!credential) {
-        // Perform dummy hash to prevent timing attacks (username enumeration)
-        dummyHashComputation(password);
-        return Error::unauthorized("Invalid credentials");
-    }
-
-    // Hash the input password with the stored salt
-    const std::string inputHash = computeHash(password, credential->salt);
-
-    // Use constant-time comparison to prevent timing attacks
-    if (!secureCompare(inputHash, credential->passwordHash)) {
-        return Error::unauthorized("Invalid credentials");
-    }
-
-    return Result<bool>(true);
+    return matches(lookup(store, username), password, cost);
 }
 
 } // namespace credential
@@ -15,5 +15,6 @@
 #include "session/index.hpp"
 #include "package/index.hpp"
 #include "credential/index.hpp"
+#include "undo.hpp"
 
 #endif
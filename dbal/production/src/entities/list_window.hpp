@@ -0,0 +1,162 @@
+/**
+ * @file list_window.hpp
+ * @brief Keyset-paginated list windows over in-memory collections
+ *
+ * Rows are ordered by (sort key, id). The default order is the primary
+ * map's own id order; other sort fields walk the matching SortIndex, or a
+ * scoped one when the list is filtered to that scope. Either way the walk
+ * starts at the cursor position and stops once the window is full, so deep
+ * pages cost the same as the first. Page offsets still work when no cursor
+ * is given.
+ */
+#ifndef DBAL_LIST_WINDOW_HPP
+#define DBAL_LIST_WINDOW_HPP
+
+#include "dbal/types.hpp"
+#include "dbal/errors.hpp"
+#include "../store/in_memory_store.hpp"
+#include "../query/cursor/list_cursor.hpp"
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dbal {
+namespace entities {
+
+/**
+ * Resolved position and size of one list page
+ */
+struct ListWindow {
+    std::string field;
+    std::optional<query::ListCursor> after;
+    size_t skip = 0;  // page offset; zero when resuming from a cursor
+    size_t limit = 0;
+};
+
+template<typename T>
+Result<ListWindow> planListWindow(const ListOptions& options) {
+    ListWindow window;
+    window.field = query::sortField<T>(options);
+    auto cursor = query::resolveCursor<T>(options, window.field);
+    if (cursor.isError()) {
+        return cursor.error();
+    }
+    window.after = cursor.value();
+    window.limit = options.limit > 0 ? static_cast<size_t>(options.limit) : 0;
+    if (!window.after.has_value() && options.page > 1) {
+        window.skip = static_cast<size_t>(options.page - 1) * window.limit;
+    }
+    return Result<ListWindow>(window);
+}
+
+/**
+ * Copy one window of rows out of a collection keyed by id.
+ *
+ * candidates is the result of narrowByIndex for the list's filters;
+ * order is the SortIndex for window.field, or nullptr when the list is in
+ * plain id order. When scope is set, order is a scoped index (see
+ * SortIndex::scopedKey) and only that scope's entries are walked. match
+ * applies every filter to a candidate row.
+ */
+template<typename T, typename Match>
+std::vector<T> collectListWindow(const std::map<std::string, T>& rows,
+                                 const ListWindow& window,
+                                 std::optional<const SecondaryIndex::Bucket*> candidates,
+                                 const SortIndex* order,
+                                 Match&& match,
+                                 const std::optional<std::string>& scope = std::nullopt) {
+    std::vector<T> page;
+    if (window.limit == 0 || (candidates.has_value() && !candidates.value())) {
+        return page;
+    }
+    const size_t wanted = window.skip + window.limit;
+    std::vector<const T*> hits;
+
+    auto take = [&](const T& row) {
+        if (match(row) && hits.size() < wanted) {
+            hits.push_back(&row);
+        }
+        return hits.size() < wanted;
+    };
+
+    if (!order) {
+        // Id order: both the primary map and index buckets are sorted by id
+        const std::string* after_id = window.after.has_value() ? &window.after->id : nullptr;
+        if (candidates.has_value()) {
+            const auto& bucket = *candidates.value();
+            for (auto it = after_id ? bucket.upper_bound(*after_id) : bucket.begin(); it != bucket.end(); ++it) {
+                auto row = rows.find(*it);
+                if (row != rows.end() && !take(row->second)) {
+                    break;
+                }
+            }
+        } else {
+            for (auto it = after_id ? rows.upper_bound(*after_id) : rows.begin(); it != rows.end(); ++it) {
+                if (!take(it->second)) {
+                    break;
+                }
+            }
+        }
+    } else if (scope.has_value()) {
+        std::optional<SortIndex::Entry> after;
+        if (window.after.has_value()) {
+            after = SortIndex::Entry(window.after->key, window.after->id);
+        }
+        order->forEachInScope(scope, after, [&](std::string_view, const std::string& id) {
+            auto row = rows.find(id);
+            return row == rows.end() || take(row->second);
+        });
+    } else if (candidates.has_value() &&
+               wanted * order->size() > candidates.value()->size() * candidates.value()->size()) {
+        // Walking the sort index would pass about order/bucket rows per
+        // hit, more in all than the bucket holds: order just the bucket's
+        // rows past the cursor and keep the first `wanted`
+        std::vector<std::pair<std::string, const T*>> keyed;
+        for (const auto& id : *candidates.value()) {
+            auto row = rows.find(id);
+            if (row == rows.end() || !match(row->second)) {
+                continue;
+            }
+            std::string key = query::CursorTraits<T>::key(row->second, window.field);
+            if (!window.after.has_value() || window.after->before(key, id)) {
+                keyed.emplace_back(std::move(key), &row->second);
+            }
+        }
+        const auto by_key = [](const std::pair<std::string, const T*>& a, const std::pair<std::string, const T*>& b) {
+            if (a.first != b.first) {
+                return a.first < b.first;
+            }
+            return query::CursorTraits<T>::id(*a.second) < query::CursorTraits<T>::id(*b.second);
+        };
+        const size_t kept = std::min(wanted, keyed.size());
+        std::partial_sort(keyed.begin(), keyed.begin() + kept, keyed.end(), by_key);
+        for (size_t i = 0; i < kept; ++i) {
+            hits.push_back(keyed[i].second);
+        }
+    } else {
+        // Unfiltered, or a bucket large enough that its rows turn up often
+        // in sort order
+        std::optional<SortIndex::Entry> after;
+        if (window.after.has_value()) {
+            after = SortIndex::Entry(window.after->key, window.after->id);
+        }
+        order->forEachAfter(after, [&](const std::string&, const std::string& id) {
+            auto row = rows.find(id);
+            return row == rows.end() || take(row->second);
+        });
+    }
+
+    for (size_t i = window.skip; i < hits.size(); ++i) {
+        page.push_back(*hits[i]);
+    }
+    return page;
+}
+
+} // namespace entities
+} // namespace dbal
+
+#endif
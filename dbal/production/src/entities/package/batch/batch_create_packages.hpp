@@ -8,6 +8,7 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../store/in_memory_store.hpp"
+#include "../query/cursor/list_cursor.hpp"
 #include "create_package.hpp"
 #include "../validation/package_validation.hpp"
 
@@ -31,6 +32,9 @@ inline Result<int> batchCreatePackages(InMemoryStore& store, const std::vector<C
                 auto it = store.packages.find(id);
                 if (it != store.packages.end()) {
                     store.package_keys.erase(validation::packageKey(it->second.packageId));
+                    store.packages_by_tenant.erase(it->second.tenantId, it->second.packageId);
+                    store.packages_by_installed.erase(query::timestampKey(it->second.installedAt),
+                                                      it->second.packageId);
                     store.packages.erase(it);
                 }
             }
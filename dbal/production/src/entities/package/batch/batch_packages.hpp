@@ -8,6 +8,7 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 #include "../../../validation/entity/package_validation.hpp"
 #include "../crud/create_package.hpp"
 #include "../crud/update_package.hpp"
@@ -33,6 +34,9 @@ inline Result<int> batchCreate(InMemoryStore& store, const std::vector<CreatePac
                 auto it = store.packages.find(id);
                 if (it != store.packages.end()) {
                     store.package_keys.erase(validation::packageKey(it->second.packageId));
+                    store.packages_by_tenant.erase(it->second.tenantId, it->second.packageId);
+                    store.packages_by_installed.erase(query::timestampKey(it->second.installedAt),
+                                                      it->second.packageId);
                     store.packages.erase(it);
                 }
             }
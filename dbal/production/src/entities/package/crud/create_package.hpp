@@ -8,7 +8,9 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 #include "../../../validation/entity/package_validation.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -37,8 +39,9 @@ inline Result<InstalledPackage> create(InMemoryStore& store, const CreatePackage
     pkg.enabled = input.enabled;
     pkg.config = input.config;
 
+    store.remember(store.packages, pkg.packageId);
     store.packages[pkg.packageId] = pkg;
-    store.package_keys[key] = pkg.packageId;
+    helpers::indexPackage(store, pkg);
 
     return Result<InstalledPackage>(pkg);
 }
@@ -8,7 +8,9 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 #include "../../../validation/entity/package_validation.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -27,7 +29,8 @@ inline Result<bool> remove(InMemoryStore& store, const std::string& id) {
         return Error::notFound("Package not found: " + id);
     }
 
-    store.package_keys.erase(validation::packageKey(it->second.packageId));
+    store.remember(store.packages, id);
+    helpers::unindexPackage(store, it->second);
     store.packages.erase(it);
 
     return Result<bool>(true);
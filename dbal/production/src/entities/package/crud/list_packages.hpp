@@ -8,63 +8,57 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
-#include <algorithm>
+#include "../../list_window.hpp"
 
 namespace dbal {
 namespace entities {
 namespace package {
 
 /**
- * List packages with filtering and pagination
+ * List packages with filtering and keyset or page-offset pagination
  */
 inline Result<std::vector<InstalledPackage>> list(InMemoryStore& store, const ListOptions& options) {
-    std::vector<InstalledPackage> packages;
-
-    for (const auto& [id, package] : store.packages) {
-        bool matches = true;
+    auto window = planListWindow<InstalledPackage>(options);
+    if (window.isError()) {
+        return window.error();
+    }
 
+    auto matches = [&options](const InstalledPackage& package) {
         if (options.filter.find("packageId") != options.filter.end()) {
-            if (package.packageId != options.filter.at("packageId")) matches = false;
+            if (package.packageId != options.filter.at("packageId")) return false;
         }
 
         if (options.filter.find("version") != options.filter.end()) {
-            if (package.version != options.filter.at("version")) matches = false;
+            if (package.version != options.filter.at("version")) return false;
         }
 
         if (options.filter.find("tenantId") != options.filter.end()) {
             if (!package.tenantId.has_value() || package.tenantId.value() != options.filter.at("tenantId")) {
-                matches = false;
+                return false;
             }
         }
 
         if (options.filter.find("enabled") != options.filter.end()) {
             bool filter_enabled = options.filter.at("enabled") == "true";
-            if (package.enabled != filter_enabled) matches = false;
-        }
-
-        if (matches) {
-            packages.push_back(package);
+            if (package.enabled != filter_enabled) return false;
         }
-    }
-
-    if (options.sort.find("packageId") != options.sort.end()) {
-        std::sort(packages.begin(), packages.end(), [](const InstalledPackage& a, const InstalledPackage& b) {
-            return a.packageId < b.packageId;
-        });
-    } else if (options.sort.find("installedAt") != options.sort.end()) {
-        std::sort(packages.begin(), packages.end(), [](const InstalledPackage& a, const InstalledPackage& b) {
-            return a.installedAt < b.installedAt;
-        });
-    }
 
-    int start = (options.page - 1) * options.limit;
-    int end = std::min(start + options.limit, static_cast<int>(packages.size()));
+        return true;
+    };
 
-    if (start < static_cast<int>(packages.size())) {
-        return Result<std::vector<InstalledPackage>>(std::vector<InstalledPackage>(packages.begin() + start, packages.begin() + end));
+    // packageId is the primary key, so that filter narrows to a single row
+    std::optional<const SecondaryIndex::Bucket*> candidates;
+    SecondaryIndex::Bucket by_key;
+    auto key_it = options.filter.find("packageId");
+    if (key_it != options.filter.end()) {
+        by_key.insert(key_it->second);
+        candidates = &by_key;
+    } else {
+        candidates = narrowByIndex(options.filter, {{"tenantId", &store.packages_by_tenant}});
     }
-
-    return Result<std::vector<InstalledPackage>>(std::vector<InstalledPackage>());
+    const SortIndex* order = window.value().field == "installedAt" ? &store.packages_by_installed : nullptr;
+    return Result<std::vector<InstalledPackage>>(
+        collectListWindow(store.packages, window.value(), candidates, order, matches));
 }
 
 } // namespace package
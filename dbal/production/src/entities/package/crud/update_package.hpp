@@ -8,6 +8,7 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 #include "../../../validation/entity/package_validation.hpp"
 
 namespace dbal {
@@ -27,6 +28,7 @@ inline Result<InstalledPackage> update(InMemoryStore& store, const std::string&
         return Error::notFound("Package not found: " + id);
     }
 
+    store.remember(store.packages, id);
     InstalledPackage& package = it->second;
 
     std::string next_version = input.version.value_or(package.version);
@@ -37,10 +39,13 @@ inline Result<InstalledPackage> update(InMemoryStore& store, const std::string&
     package.version = next_version;
 
     if (input.tenantId.has_value()) {
+        store.packages_by_tenant.update(package.tenantId, input.tenantId, id);
         package.tenantId = input.tenantId.value();
     }
 
     if (input.installedAt.has_value()) {
+        store.packages_by_installed.update(query::timestampKey(package.installedAt),
+                                           query::timestampKey(input.installedAt.value()), id);
         package.installedAt = input.installedAt.value();
     }
 
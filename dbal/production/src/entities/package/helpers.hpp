@@ -0,0 +1,30 @@
+#ifndef DBAL_PACKAGE_HELPERS_HPP
+#define DBAL_PACKAGE_HELPERS_HPP
+
+#include "../../store/in_memory_store.hpp"
+#include "../../query/cursor/list_cursor.hpp"
+#include "../../validation/entity/package_validation.hpp"
+
+namespace dbal {
+namespace entities {
+namespace package {
+namespace helpers {
+
+inline void indexPackage(InMemoryStore& store, const InstalledPackage& package) {
+    store.package_keys[validation::packageKey(package.packageId)] = package.packageId;
+    store.packages_by_tenant.insert(package.tenantId, package.packageId);
+    store.packages_by_installed.insert(query::timestampKey(package.installedAt), package.packageId);
+}
+
+inline void unindexPackage(InMemoryStore& store, const InstalledPackage& package) {
+    store.package_keys.erase(validation::packageKey(package.packageId));
+    store.packages_by_tenant.erase(package.tenantId, package.packageId);
+    store.packages_by_installed.erase(query::timestampKey(package.installedAt), package.packageId);
+}
+
+} // namespace helpers
+} // namespace package
+} // namespace entities
+} // namespace dbal
+
+#endif
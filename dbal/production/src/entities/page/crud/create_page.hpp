@@ -8,7 +8,9 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 #include "../../../validation/entity/page_validation.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -52,8 +54,9 @@ inline Result<PageConfig> create(InMemoryStore& store, const CreatePageInput& in
     page.meta = input.meta;
     page.createdAt = std::chrono::system_clock::now();
     
+    store.remember(store.pages, page.id);
     store.pages[page.id] = page;
-    store.page_paths[page.path] = page.id;
+    helpers::indexPage(store, page);
     
     return Result<PageConfig>(page);
 }
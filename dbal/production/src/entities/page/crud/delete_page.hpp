@@ -8,6 +8,7 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -26,7 +27,8 @@ inline Result<bool> remove(InMemoryStore& store, const std::string& id) {
         return Error::notFound("Page not found: " + id);
     }
     
-    store.page_paths.erase(it->second.path);
+    store.remember(store.pages, id);
+    helpers::unindexPage(store, it->second);
     store.pages.erase(it);
     
     return Result<bool>(true);
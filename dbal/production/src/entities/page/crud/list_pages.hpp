@@ -8,52 +8,54 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
-#include <algorithm>
+#include "../../list_window.hpp"
 
 namespace dbal {
 namespace entities {
 namespace page {
 
 /**
- * List pages with filtering and pagination
+ * List pages with filtering and keyset or page-offset pagination
  */
 inline Result<std::vector<PageConfig>> list(InMemoryStore& store, const ListOptions& options) {
-    std::vector<PageConfig> pages;
-    
-    for (const auto& [id, page] : store.pages) {
-        bool matches = true;
-        
+    auto window = planListWindow<PageConfig>(options);
+    if (window.isError()) {
+        return window.error();
+    }
+
+    auto matches = [&options](const PageConfig& page) {
         if (options.filter.find("isPublished") != options.filter.end()) {
             bool filter_published = options.filter.at("isPublished") == "true";
-            if (page.isPublished != filter_published) matches = false;
+            if (page.isPublished != filter_published) return false;
         }
         
         if (options.filter.find("level") != options.filter.end()) {
             int filter_level = std::stoi(options.filter.at("level"));
-            if (page.level != filter_level) matches = false;
+            if (page.level != filter_level) return false;
+        }
+
+        if (options.filter.find("tenantId") != options.filter.end()) {
+            if (page.tenantId != options.filter.at("tenantId")) return false;
+        }
+
+        if (options.filter.find("packageId") != options.filter.end()) {
+            if (page.packageId != options.filter.at("packageId")) return false;
         }
         
-        if (matches) pages.push_back(page);
-    }
-    
-    if (options.sort.find("title") != options.sort.end()) {
-        std::sort(pages.begin(), pages.end(), [](const PageConfig& a, const PageConfig& b) {
-            return a.title < b.title;
-        });
-    } else if (options.sort.find("createdAt") != options.sort.end()) {
-        std::sort(pages.begin(), pages.end(), [](const PageConfig& a, const PageConfig& b) {
-            return a.createdAt < b.createdAt;
-        });
-    }
-    
-    int start = (options.page - 1) * options.limit;
-    int end = std::min(start + options.limit, static_cast<int>(pages.size()));
-    
-    if (start < static_cast<int>(pages.size())) {
-        return Result<std::vector<PageConfig>>(std::vector<PageConfig>(pages.begin() + start, pages.begin() + end));
+        return true;
+    };
+
+    const auto candidates = narrowByIndex(options.filter, {
+        {"tenantId", &store.pages_by_tenant},
+        {"packageId", &store.pages_by_package},
+    });
+    const SortIndex* order = nullptr;
+    if (window.value().field == "title") {
+        order = &store.pages_by_title;
+    } else if (window.value().field == "createdAt") {
+        order = &store.pages_by_created;
     }
-    
-    return Result<std::vector<PageConfig>>(std::vector<PageConfig>());
+    return Result<std::vector<PageConfig>>(collectListWindow(store.pages, window.value(), candidates, order, matches));
 }
 
 } // namespace page
@@ -27,6 +27,7 @@ inline Result<PageConfig> update(InMemoryStore& store, const std::string& id, co
         return Error::notFound("Page not found: " + id);
     }
     
+    store.remember(store.pages, id);
     PageConfig& page = it->second;
     std::string old_path = page.path;
     
@@ -47,8 +48,13 @@ inline Result<PageConfig> update(InMemoryStore& store, const std::string& id, co
         if (input.title.value().empty() || input.title.value().length() > 255) {
             return Error::validationError("Title must be between 1 and 255 characters");
         }
+        store.pages_by_title.update(page.title, input.title.value(), id);
         page.title = input.title.value();
     }
+
+    if (input.path.has_value() || input.title.has_value()) {
+        store.pages_by_text.update(id, {page.title, page.path});
+    }
     
     if (input.description.has_value()) page.description = input.description.value();
     if (input.icon.has_value()) page.icon = input.icon.value();
@@ -67,8 +73,14 @@ inline Result<PageConfig> update(InMemoryStore& store, const std::string& id, co
     if (input.isPublished.has_value()) page.isPublished = input.isPublished.value();
     if (input.params.has_value()) page.params = input.params.value();
     if (input.meta.has_value()) page.meta = input.meta.value();
-    if (input.packageId.has_value()) page.packageId = input.packageId.value();
-    if (input.tenantId.has_value()) page.tenantId = input.tenantId.value();
+    if (input.packageId.has_value()) {
+        store.pages_by_package.update(page.packageId, input.packageId, id);
+        page.packageId = input.packageId.value();
+    }
+    if (input.tenantId.has_value()) {
+        store.pages_by_tenant.update(page.tenantId, input.tenantId, id);
+        page.tenantId = input.tenantId.value();
+    }
     
     return Result<PageConfig>(page);
 }
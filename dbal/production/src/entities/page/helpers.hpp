@@ -0,0 +1,35 @@
+#ifndef DBAL_PAGE_HELPERS_HPP
+#define DBAL_PAGE_HELPERS_HPP
+
+#include "../../store/in_memory_store.hpp"
+#include "../../query/cursor/list_cursor.hpp"
+
+namespace dbal {
+namespace entities {
+namespace page {
+namespace helpers {
+
+inline void indexPage(InMemoryStore& store, const PageConfig& page) {
+    store.page_paths[page.path] = page.id;
+    store.pages_by_tenant.insert(page.tenantId, page.id);
+    store.pages_by_package.insert(page.packageId, page.id);
+    store.pages_by_title.insert(page.title, page.id);
+    store.pages_by_text.insert(page.id, {page.title, page.path});
+    store.pages_by_created.insert(query::timestampKey(page.createdAt), page.id);
+}
+
+inline void unindexPage(InMemoryStore& store, const PageConfig& page) {
+    store.page_paths.erase(page.path);
+    store.pages_by_tenant.erase(page.tenantId, page.id);
+    store.pages_by_package.erase(page.packageId, page.id);
+    store.pages_by_title.erase(page.title, page.id);
+    store.pages_by_text.erase(page.id);
+    store.pages_by_created.erase(query::timestampKey(page.createdAt), page.id);
+}
+
+} // namespace helpers
+} // namespace page
+} // namespace entities
+} // namespace dbal
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file replay.hpp
+ * @brief Apply logged after-images of records to the store
+ *
+ * The write-ahead log records, for every commit, the state each touched
+ * record was left in: its new value, or nothing when it was erased.
+ * Replaying a commit makes the store match those images, keeping every
+ * index in step, the same way rollback() applies before-images.
+ */
+#ifndef DBAL_ENTITIES_REPLAY_HPP
+#define DBAL_ENTITIES_REPLAY_HPP
+
+#include "undo.hpp"
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace dbal {
+namespace entities {
+
+template<typename Record>
+using RecordImages = std::vector<std::pair<std::string, std::optional<Record>>>;
+
+/**
+ * After-images of the records one commit wrote, per record type
+ */
+class CommitImages {
+public:
+    template<typename Record>
+    RecordImages<Record>& of() {
+        return std::get<RecordImages<Record>>(images_);
+    }
+
+    template<typename Record>
+    const RecordImages<Record>& of() const {
+        return std::get<RecordImages<Record>>(images_);
+    }
+
+    void clear() {
+        std::apply([](auto&... images) { (images.clear(), ...); }, images_);
+    }
+
+    /**
+     * Bit i set when partition i has images
+     */
+    unsigned partitions() const {
+        unsigned mask = 0;
+        std::apply([&](const auto&... images) { (markIfAny(mask, images), ...); }, images_);
+        return mask;
+    }
+
+    /**
+     * Call visit(partition, id) for each imaged record
+     */
+    template<typename Visit>
+    void forEachId(Visit&& visit) const {
+        std::apply([&](const auto&... images) { (visitIds(images, visit), ...); }, images_);
+    }
+
+    /**
+     * Drop the images of every partition but partition
+     */
+    void retain(StorePartition partition) {
+        std::apply([&](auto&... images) { (clearUnless(partition, images), ...); }, images_);
+    }
+
+private:
+    template<typename Record>
+    static void markIfAny(unsigned& mask, const RecordImages<Record>& images) {
+        if (!images.empty()) {
+            mask |= 1u << static_cast<unsigned>(partitionOf<Record>());
+        }
+    }
+
+    template<typename Record, typename Visit>
+    static void visitIds(const RecordImages<Record>& images, Visit& visit) {
+        for (const auto& image : images) {
+            visit(partitionOf<Record>(), image.first);
+        }
+    }
+
+    template<typename Record>
+    static void clearUnless(StorePartition partition, RecordImages<Record>& images) {
+        if (partitionOf<Record>() != partition) {
+            images.clear();
+        }
+    }
+
+    std::tuple<RecordImages<User>,
+               RecordImages<Credential>,
+               RecordImages<PageConfig>,
+               RecordImages<ComponentNode>,
+               RecordImages<Workflow>,
+               RecordImages<Session>,
+               RecordImages<InstalledPackage>> images_;
+};
+
+namespace detail {
+
+inline void indexCredential(InMemoryStore&, const Credential&) {}
+inline void unindexCredential(InMemoryStore&, const Credential&) {}
+
+template<typename Record, typename Unindex>
+inline void dropImaged(InMemoryStore& store,
+                       std::map<std::string, Record>& collection,
+                       const RecordImages<Record>& images,
+                       Unindex unindex) {
+    for (const auto& [id, after] : images) {
+        (void)after;
+        auto it = collection.find(id);
+        if (it != collection.end()) {
+            unindex(store, it->second);
+            collection.erase(it);
+        }
+    }
+}
+
+template<typename Record, typename Index, typename Unindex>
+inline void putImages(InMemoryStore& store,
+                      std::map<std::string, Record>& collection,
+                      RecordImages<Record>& images,
+                      Index index,
+                      Unindex unindex) {
+    for (auto& [id, after] : images) {
+        auto it = collection.find(id);
+        if (it != collection.end()) {
+            // Imaged earlier in this commit; the later image wins
+            unindex(store, it->second);
+            collection.erase(it);
+        }
+        if (after.has_value()) {
+            auto& stored = collection[id];
+            stored = std::move(after.value());
+            index(store, stored);
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * Make the store match one commit's after-images; images are consumed
+ *
+ * Caller must hold exclusively every partition the commit touched. As in
+ * rollback(), every touched record is unindexed before any image is
+ * indexed, so unique keys that moved between records land correctly.
+ * A record imaged twice keeps its last image.
+ */
+inline void applyCommit(InMemoryStore& store, CommitImages& commit) {
+    detail::dropImaged(store, store.users, commit.of<User>(), user::helpers::unindexUser);
+    detail::dropImaged(store, store.credentials, commit.of<Credential>(), detail::unindexCredential);
+    detail::dropImaged(store, store.pages, commit.of<PageConfig>(), page::helpers::unindexPage);
+    detail::dropImaged(store, store.components, commit.of<ComponentNode>(), detail::unindexComponent);
+    detail::dropImaged(store, store.workflows, commit.of<Workflow>(), workflow::helpers::unindexWorkflow);
+    detail::dropImaged(store, store.sessions, commit.of<Session>(), session::helpers::unindexSession);
+    detail::dropImaged(store, store.packages, commit.of<InstalledPackage>(), package::helpers::unindexPackage);
+
+    detail::putImages(store, store.users, commit.of<User>(), user::helpers::indexUser, user::helpers::unindexUser);
+    detail::putImages(store, store.credentials, commit.of<Credential>(), detail::indexCredential,
+                      detail::unindexCredential);
+    detail::putImages(store, store.pages, commit.of<PageConfig>(), page::helpers::indexPage,
+                      page::helpers::unindexPage);
+    detail::putImages(store, store.components, commit.of<ComponentNode>(), detail::indexComponent,
+                      detail::unindexComponent);
+    detail::putImages(store, store.workflows, commit.of<Workflow>(), workflow::helpers::indexWorkflow,
+                      workflow::helpers::unindexWorkflow);
+    detail::putImages(store, store.sessions, commit.of<Session>(), session::helpers::indexSession,
+                      session::helpers::unindexSession);
+    detail::putImages(store, store.packages, commit.of<InstalledPackage>(), package::helpers::indexPackage,
+                      package::helpers::unindexPackage);
+    commit.clear();
+}
+
+} // namespace entities
+} // namespace dbal
+
+#endif
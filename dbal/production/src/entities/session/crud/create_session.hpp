@@ -8,6 +8,8 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -41,8 +43,9 @@ inline Result<Session> create(InMemoryStore& store, const CreateSessionInput& in
     session.ipAddress = input.ipAddress;
     session.userAgent = input.userAgent;
 
+    store.remember(store.sessions, session.id);
     store.sessions[session.id] = session;
-    store.session_tokens[session.token] = session.id;
+    helpers::indexSession(store, session);
 
     return Result<Session>(session);
 }
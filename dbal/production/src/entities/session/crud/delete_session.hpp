@@ -8,6 +8,8 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -26,8 +28,7 @@ inline Result<bool> remove(InMemoryStore& store, const std::string& id) {
         return Error::notFound("Session not found: " + id);
     }
 
-    store.session_tokens.erase(it->second.token);
-    store.sessions.erase(it);
+    helpers::eraseSession(store, id);
 
     return Result<bool>(true);
 }
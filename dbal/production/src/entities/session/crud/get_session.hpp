@@ -8,15 +8,20 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
 namespace session {
 
 /**
- * Get a session by ID (cleans expired sessions)
+ * Get a session by ID
+ *
+ * An expired session is reported as not found but left in place: reads
+ * only need the partition shared, and the reaper removes it later.
  */
-inline Result<Session> get(InMemoryStore& store, const std::string& id) {
+inline Result<Session> get(const InMemoryStore& store, const std::string& id) {
     if (id.empty()) {
         return Error::validationError("Session ID cannot be empty");
     }
@@ -26,10 +31,7 @@ inline Result<Session> get(InMemoryStore& store, const std::string& id) {
         return Error::notFound("Session not found: " + id);
     }
 
-    auto now = std::chrono::system_clock::now();
-    if (it->second.expiresAt <= now) {
-        store.session_tokens.erase(it->second.token);
-        store.sessions.erase(it);
+    if (it->second.expiresAt <= std::chrono::system_clock::now()) {
         return Error::notFound("Session expired: " + id);
     }
 
@@ -39,7 +41,7 @@ inline Result<Session> get(InMemoryStore& store, const std::string& id) {
 /**
  * Get a session by token
  */
-inline Result<Session> getByToken(InMemoryStore& store, const std::string& token) {
+inline Result<Session> getByToken(const InMemoryStore& store, const std::string& token) {
     if (token.empty()) {
         return Error::validationError("Token cannot be empty");
     }
@@ -8,6 +8,9 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../../store/in_memory_store.hpp"
+#include "../../../../query/cursor/list_cursor.hpp"
+#include "../../helpers.hpp"
+#include <limits>
 #include <vector>
 
 namespace dbal {
@@ -15,25 +18,30 @@ namespace entities {
 namespace session {
 
 /**
- * Clean up expired sessions
+ * Clean up expired sessions, soonest expired first
+ * @param limit Most sessions to remove, so a caller can bound how long it holds the store
  * @returns Number of sessions removed
  */
-inline Result<int> cleanExpired(InMemoryStore& store) {
-    auto now = std::chrono::system_clock::now();
+inline Result<int> cleanExpired(InMemoryStore& store,
+                                std::chrono::system_clock::time_point now = std::chrono::system_clock::now(),
+                                size_t limit = std::numeric_limits<size_t>::max()) {
     std::vector<std::string> expired_ids;
 
-    for (const auto& [id, session] : store.sessions) {
-        if (session.expiresAt <= now) {
+    // The expiry index is ordered by time, so only expired entries are visited
+    const std::string now_key = query::timestampKey(now);
+    store.sessions_by_expires.forEachAfter(std::nullopt, [&](const std::string& key, const std::string& id) {
+        if (key > now_key || expired_ids.size() >= limit) {
+            return false;
+        }
+        auto it = store.sessions.find(id);
+        if (it != store.sessions.end() && it->second.expiresAt <= now) {
             expired_ids.push_back(id);
         }
-    }
+        return true;
+    });
 
     for (const auto& id : expired_ids) {
-        auto it = store.sessions.find(id);
-        if (it != store.sessions.end()) {
-            store.session_tokens.erase(it->second.token);
-            store.sessions.erase(it);
-        }
+        helpers::eraseSession(store, id);
     }
 
     return Result<int>(static_cast<int>(expired_ids.size()));
@@ -0,0 +1,62 @@
+/**
+ * @file touch_session.hpp
+ * @brief Sliding-expiry update for an active session
+ */
+#ifndef DBAL_TOUCH_SESSION_HPP
+#define DBAL_TOUCH_SESSION_HPP
+
+#include "dbal/types.hpp"
+#include "dbal/errors.hpp"
+#include "../../../../store/in_memory_store.hpp"
+#include "../../../../query/cursor/list_cursor.hpp"
+#include <chrono>
+
+namespace dbal {
+namespace entities {
+namespace session {
+
+/**
+ * Push a live session's expiry out to now + ttl and record the activity
+ *
+ * Only expiresAt, lastActivity and the expiry index entry change. When
+ * the expiry would move by less than granularity the session is left
+ * as it is and nothing is written, so a session used on every request
+ * is written about once per granularity rather than once per request.
+ *
+ * @returns The session as stored, or NotFound when missing or expired
+ */
+inline Result<Session> touch(InMemoryStore& store,
+                             const std::string& id,
+                             std::chrono::system_clock::time_point now,
+                             std::chrono::system_clock::duration ttl,
+                             std::chrono::system_clock::duration granularity) {
+    if (id.empty()) {
+        return Error::validationError("Session ID cannot be empty");
+    }
+
+    auto it = store.sessions.find(id);
+    if (it == store.sessions.end()) {
+        return Error::notFound("Session not found: " + id);
+    }
+    Session& session = it->second;
+    if (session.expiresAt <= now) {
+        return Error::notFound("Session expired: " + id);
+    }
+
+    const auto expiresAt = now + ttl;
+    if (expiresAt - session.expiresAt < granularity) {
+        return Result<Session>(session);
+    }
+
+    store.remember(store.sessions, id);
+    store.sessions_by_expires.update(query::timestampKey(session.expiresAt), query::timestampKey(expiresAt), id);
+    session.expiresAt = expiresAt;
+    session.lastActivity = now;
+    return Result<Session>(session);
+}
+
+} // namespace session
+} // namespace entities
+} // namespace dbal
+
+#endif
@@ -8,55 +8,46 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
-#include "lifecycle/clean_expired.hpp"
-#include <algorithm>
+#include "../../list_window.hpp"
 
 namespace dbal {
 namespace entities {
 namespace session {
 
 /**
- * List sessions with filtering and pagination
+ * List sessions with filtering and keyset or page-offset pagination;
+ * expired sessions the reaper has not removed yet are skipped
  */
-inline Result<std::vector<Session>> list(InMemoryStore& store, const ListOptions& options) {
-    cleanExpired(store);
-
-    std::vector<Session> sessions;
+inline Result<std::vector<Session>> list(const InMemoryStore& store, const ListOptions& options) {
+    auto window = planListWindow<Session>(options);
+    if (window.isError()) {
+        return window.error();
+    }
 
-    for (const auto& [id, session] : store.sessions) {
-        bool matches = true;
+    const auto now = std::chrono::system_clock::now();
+    auto matches = [&options, now](const Session& session) {
+        if (session.expiresAt <= now) {
+            return false;
+        }
 
         if (options.filter.find("userId") != options.filter.end()) {
-            if (session.userId != options.filter.at("userId")) matches = false;
+            if (session.userId != options.filter.at("userId")) return false;
         }
 
         if (options.filter.find("token") != options.filter.end()) {
-            if (session.token != options.filter.at("token")) matches = false;
+            if (session.token != options.filter.at("token")) return false;
         }
 
-        if (matches) {
-            sessions.push_back(session);
-        }
-    }
+        return true;
+    };
 
-    if (options.sort.find("createdAt") != options.sort.end()) {
-        std::sort(sessions.begin(), sessions.end(), [](const Session& a, const Session& b) {
-            return a.createdAt < b.createdAt;
-        });
-    } else if (options.sort.find("expiresAt") != options.sort.end()) {
-        std::sort(sessions.begin(), sessions.end(), [](const Session& a, const Session& b) {
-            return a.expiresAt < b.expiresAt;
-        });
+    const SortIndex* order = nullptr;
+    if (window.value().field == "createdAt") {
+        order = &store.sessions_by_created;
+    } else if (window.value().field == "expiresAt") {
+        order = &store.sessions_by_expires;
     }
-
-    int start = (options.page - 1) * options.limit;
-    int end = std::min(start + options.limit, static_cast<int>(sessions.size()));
-
-    if (start < static_cast<int>(sessions.size())) {
-        return Result<std::vector<Session>>(std::vector<Session>(sessions.begin() + start, sessions.begin() + end));
-    }
-
-    return Result<std::vector<Session>>(std::vector<Session>());
+    return Result<std::vector<Session>>(collectListWindow(store.sessions, window.value(), std::nullopt, order, matches));
 }
 
 } // namespace session
@@ -8,6 +8,7 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 
 namespace dbal {
 namespace entities {
@@ -26,6 +27,7 @@ inline Result<Session> update(InMemoryStore& store, const std::string& id, const
         return Error::notFound("Session not found: " + id);
     }
 
+    store.remember(store.sessions, id);
     Session& session = it->second;
 
     if (input.userId.has_value()) {
@@ -52,6 +54,8 @@ inline Result<Session> update(InMemoryStore& store, const std::string& id, const
     }
 
     if (input.expiresAt.has_value()) {
+        store.sessions_by_expires.update(query::timestampKey(session.expiresAt),
+                                         query::timestampKey(input.expiresAt.value()), id);
         session.expiresAt = input.expiresAt.value();
     }
 
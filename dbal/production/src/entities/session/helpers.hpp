@@ -0,0 +1,42 @@
+#ifndef DBAL_SESSION_HELPERS_HPP
+#define DBAL_SESSION_HELPERS_HPP
+
+#include "../../store/in_memory_store.hpp"
+#include "../../query/cursor/list_cursor.hpp"
+
+namespace dbal {
+namespace entities {
+namespace session {
+namespace helpers {
+
+inline void indexSession(InMemoryStore& store, const Session& session) {
+    store.session_tokens[session.token] = session.id;
+    store.sessions_by_created.insert(query::timestampKey(session.createdAt), session.id);
+    store.sessions_by_expires.insert(query::timestampKey(session.expiresAt), session.id);
+}
+
+inline void unindexSession(InMemoryStore& store, const Session& session) {
+    store.session_tokens.erase(session.token);
+    store.sessions_by_created.erase(query::timestampKey(session.createdAt), session.id);
+    store.sessions_by_expires.erase(query::timestampKey(session.expiresAt), session.id);
+}
+
+/**
+ * Unindex and erase a session, recording it in any attached undo log
+ */
+inline void eraseSession(InMemoryStore& store, const std::string& id) {
+    auto it = store.sessions.find(id);
+    if (it == store.sessions.end()) {
+        return;
+    }
+    store.remember(store.sessions, id);
+    unindexSession(store, it->second);
+    store.sessions.erase(it);
+}
+
+} // namespace helpers
+} // namespace session
+} // namespace entities
+} // namespace dbal
+
+#endif
@@ -11,5 +11,6 @@
 #include "crud/delete_session.hpp"
 #include "crud/list_sessions.hpp"
 #include "crud/lifecycle/clean_expired.hpp"
+#include "crud/lifecycle/touch_session.hpp"
 
 #endif
@@ -0,0 +1,98 @@
+/**
+ * @file session_reaper.hpp
+ * @brief Background removal of expired sessions
+ */
+#ifndef DBAL_SESSION_REAPER_HPP
+#define DBAL_SESSION_REAPER_HPP
+
+#include "../../store/in_memory_store.hpp"
+#include "../../store/store_lock.hpp"
+#include "crud/lifecycle/clean_expired.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace dbal {
+
+/**
+ * Removes expired sessions from a store every interval
+ *
+ * Each pass takes the sessions partition for at most batch removals at
+ * a time and lets go in between, so a backlog of expired sessions never
+ * holds the store for long and the log gets one small commit per batch.
+ * Reads already treat expired sessions as gone, so the reaper only
+ * bounds how much memory they keep. A partition the store has not
+ * loaded yet is left alone until something else loads it.
+ */
+class SessionReaper {
+public:
+    /**
+     * @param interval Time between passes; zero starts no thread, leaving passes to reap()
+     */
+    SessionReaper(InMemoryStore& store, std::chrono::milliseconds interval, size_t batch)
+        : store_(store), interval_(interval), batch_(batch == 0 ? 1 : batch) {
+        if (interval_.count() > 0) {
+            thread_ = std::thread(&SessionReaper::run, this);
+        }
+    }
+
+    ~SessionReaper() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    SessionReaper(const SessionReaper&) = delete;
+    SessionReaper& operator=(const SessionReaper&) = delete;
+
+    /**
+     * Remove every session expired by now, batch by batch
+     * @returns Number of sessions removed
+     */
+    int reap(std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) {
+        StoreLoader* loader = store_.loader;
+        if (loader && loader->pending(StorePartition::Sessions)) {
+            return 0;
+        }
+        int total = 0;
+        for (;;) {
+            int removed = 0;
+            {
+                StoreLock lock(store_, {writeLock(StorePartition::Sessions)});
+                removed = entities::session::cleanExpired(store_, now, batch_).value();
+            }
+            total += removed;
+            if (static_cast<size_t>(removed) < batch_) {
+                return total;
+            }
+        }
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, interval_, [this] { return stopping_; })) {
+            lock.unlock();
+            reap();
+            lock.lock();
+        }
+    }
+
+    InMemoryStore& store_;
+    std::chrono::milliseconds interval_;
+    size_t batch_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace dbal
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file undo.hpp
+ * @brief Roll the store back to the before-images in an undo log
+ */
+#ifndef DBAL_ENTITIES_UNDO_HPP
+#define DBAL_ENTITIES_UNDO_HPP
+
+#include "../store/in_memory_store.hpp"
+#include "../store/undo_log.hpp"
+#include "user/helpers.hpp"
+#include "page/helpers.hpp"
+#include "component/helpers.hpp"
+#include "workflow/helpers.hpp"
+#include "session/helpers.hpp"
+#include "package/helpers.hpp"
+
+namespace dbal {
+namespace entities {
+
+namespace detail {
+
+/**
+ * Erase the current state of every record in images
+ */
+template<typename Record, typename Unindex>
+inline void dropTouched(InMemoryStore& store,
+                        std::map<std::string, Record>& collection,
+                        const UndoImages<Record>& images,
+                        Unindex unindex) {
+    for (const auto& [id, before] : images.images()) {
+        (void)before;
+        auto it = collection.find(id);
+        if (it != collection.end()) {
+            unindex(store, it->second);
+            collection.erase(it);
+        }
+    }
+}
+
+/**
+ * Put back every record that existed before the batch
+ */
+template<typename Record, typename Index>
+inline void restoreImages(InMemoryStore& store,
+                          std::map<std::string, Record>& collection,
+                          const UndoImages<Record>& images,
+                          Index index) {
+    for (const auto& [id, before] : images.images()) {
+        if (before.has_value()) {
+            collection[id] = before.value();
+            index(store, before.value());
+        }
+    }
+}
+
+inline void indexComponent(InMemoryStore& store, const ComponentNode& component) {
+    component::helpers::addComponentToPage(store, component.pageId, component.id);
+    if (component.parentId.has_value()) {
+        component::helpers::addComponentToParent(store, component.parentId.value(), component.id);
+    }
+    store.component_trees.invalidate(component.pageId);
+}
+
+inline void unindexComponent(InMemoryStore& store, const ComponentNode& component) {
+    component::helpers::removeComponentFromPage(store, component.pageId, component.id);
+    if (component.parentId.has_value()) {
+        component::helpers::removeComponentFromParent(store, component.parentId.value(), component.id);
+    }
+    store.component_trees.invalidate(component.pageId);
+}
+
+} // namespace detail
+
+/**
+ * Undo every write recorded in log
+ *
+ * Caller must hold exclusively every partition the logged writes touched.
+ * All touched records are unindexed before any image is re-indexed, so a
+ * unique key that moved between two records during the batch ends up
+ * with its original owner.
+ */
+inline void rollback(InMemoryStore& store, const StoreUndoLog& log) {
+    detail::dropTouched(store, store.users, log.images<User>(), user::helpers::unindexUser);
+    detail::dropTouched(store, store.pages, log.images<PageConfig>(), page::helpers::unindexPage);
+    detail::dropTouched(store, store.components, log.images<ComponentNode>(), detail::unindexComponent);
+    detail::dropTouched(store, store.workflows, log.images<Workflow>(), workflow::helpers::unindexWorkflow);
+    detail::dropTouched(store, store.sessions, log.images<Session>(), session::helpers::unindexSession);
+    detail::dropTouched(store, store.packages, log.images<InstalledPackage>(), package::helpers::unindexPackage);
+
+    detail::restoreImages(store, store.users, log.images<User>(), user::helpers::indexUser);
+    detail::restoreImages(store, store.pages, log.images<PageConfig>(), page::helpers::indexPage);
+    detail::restoreImages(store, store.components, log.images<ComponentNode>(), detail::indexComponent);
+    detail::restoreImages(store, store.workflows, log.images<Workflow>(), workflow::helpers::indexWorkflow);
+    detail::restoreImages(store, store.sessions, log.images<Session>(), session::helpers::indexSession);
+    detail::restoreImages(store, store.packages, log.images<InstalledPackage>(), package::helpers::indexPackage);
+}
+
+} // namespace entities
+} // namespace dbal
+
+#endif
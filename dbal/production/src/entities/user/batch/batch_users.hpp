@@ -11,6 +11,7 @@
 #include "../crud/create_user.hpp"
 #include "../crud/update_user.hpp"
 #include "../crud/delete_user.hpp"
+#include "../helpers.hpp"
 #include <map>
 #include <optional>
 
@@ -29,7 +30,7 @@ inline Result<int> batchCreate(InMemoryStore& store, const std::vector<CreateUse
         auto result = create(store, input);
         if (result.isError()) {
             for (const auto& id : created_ids) {
-                store.users.erase(id);
+                remove(store, id);
             }
             return result.error();
         }
@@ -75,39 +76,7 @@ inline Result<int> updateMany(InMemoryStore& store,
         return Error::validationError("filter is required for bulk updates");
     }
 
-    std::optional<std::string> role_filter;
-    if (filter.find("role") != filter.end()) {
-        role_filter = filter.at("role");
-    }
-
-    std::optional<std::string> tenant_filter;
-    if (filter.find("tenantId") != filter.end()) {
-        tenant_filter = filter.at("tenantId");
-    } else if (filter.find("tenantId") != filter.end()) {
-        tenant_filter = filter.at("tenantId");
-    }
-
-    std::optional<std::string> username_filter;
-    if (filter.find("username") != filter.end()) {
-        username_filter = filter.at("username");
-    }
-
-    std::vector<std::string> targets;
-    for (const auto& [id, user] : store.users) {
-        bool matches = true;
-        if (tenant_filter.has_value() && user.tenantId != tenant_filter.value()) {
-            matches = false;
-        }
-        if (role_filter.has_value() && user.role != role_filter.value()) {
-            matches = false;
-        }
-        if (username_filter.has_value() && user.username != username_filter.value()) {
-            matches = false;
-        }
-        if (matches) {
-            targets.push_back(id);
-        }
-    }
+    const auto targets = helpers::matchingIds(store, filter);
 
     int updated = 0;
     for (const auto& id : targets) {
@@ -125,39 +94,7 @@ inline Result<int> deleteMany(InMemoryStore& store, const std::map<std::string,
         return Error::validationError("filter is required for bulk deletes");
     }
 
-    std::optional<std::string> role_filter;
-    if (filter.find("role") != filter.end()) {
-        role_filter = filter.at("role");
-    }
-
-    std::optional<std::string> tenant_filter;
-    if (filter.find("tenantId") != filter.end()) {
-        tenant_filter = filter.at("tenantId");
-    } else if (filter.find("tenantId") != filter.end()) {
-        tenant_filter = filter.at("tenantId");
-    }
-
-    std::optional<std::string> username_filter;
-    if (filter.find("username") != filter.end()) {
-        username_filter = filter.at("username");
-    }
-
-    std::vector<std::string> targets;
-    for (const auto& [id, user] : store.users) {
-        bool matches = true;
-        if (tenant_filter.has_value() && user.tenantId != tenant_filter.value()) {
-            matches = false;
-        }
-        if (role_filter.has_value() && user.role != role_filter.value()) {
-            matches = false;
-        }
-        if (username_filter.has_value() && user.username != username_filter.value()) {
-            matches = false;
-        }
-        if (matches) {
-            targets.push_back(id);
-        }
-    }
+    const auto targets = helpers::matchingIds(store, filter);
 
     int deleted = 0;
     for (const auto& id : targets) {
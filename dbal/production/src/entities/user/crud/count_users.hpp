@@ -9,14 +9,10 @@ namespace entities {
 namespace user {
 
 inline Result<int> count(InMemoryStore& store, const std::optional<std::string>& role = std::nullopt) {
-    int total = 0;
-    for (const auto& [id, user] : store.users) {
-        (void)id;
-        if (!role.has_value() || user.role == role.value()) {
-            total++;
-        }
+    if (!role.has_value()) {
+        return Result<int>(static_cast<int>(store.users.size()));
     }
-    return Result<int>(total);
+    return Result<int>(static_cast<int>(store.users_by_role.count(role.value())));
 }
 
 } // namespace user
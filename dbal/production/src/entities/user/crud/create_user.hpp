@@ -9,6 +9,7 @@
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
 #include "../../../validation/entity/user_validation.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -25,14 +26,12 @@ inline Result<User> create(InMemoryStore& store, const CreateUserInput& input) {
         return Error::validationError("Invalid email format");
     }
     
-    // Check for duplicates
-    for (const auto& [id, user] : store.users) {
-        if (user.tenantId == input.tenantId && user.username == input.username) {
-            return Error::conflict("Username already exists: " + input.username);
-        }
-        if (user.tenantId == input.tenantId && user.email == input.email) {
-            return Error::conflict("Email already exists: " + input.email);
-        }
+    // Check for duplicates within the tenant
+    if (helpers::uniqueHolder(store.user_names, input.tenantId, input.username, "")) {
+        return Error::conflict("Username already exists: " + input.username);
+    }
+    if (helpers::uniqueHolder(store.user_emails, input.tenantId, input.email, "")) {
+        return Error::conflict("Email already exists: " + input.email);
     }
     
     User user;
@@ -48,7 +47,9 @@ inline Result<User> create(InMemoryStore& store, const CreateUserInput& input) {
     user.passwordChangeTimestamp = input.passwordChangeTimestamp;
     user.firstLogin = input.firstLogin.value_or(false);
     
+    store.remember(store.users, user.id);
     store.users[user.id] = user;
+    helpers::indexUser(store, user);
     return Result<User>(user);
 }
 
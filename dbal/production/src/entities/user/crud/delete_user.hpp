@@ -8,6 +8,7 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -26,6 +27,8 @@ inline Result<bool> remove(InMemoryStore& store, const std::string& id) {
         return Error::notFound("User not found: " + id);
     }
     
+    store.remember(store.users, id);
+    helpers::unindexUser(store, it->second);
     store.users.erase(it);
     return Result<bool>(true);
 }
@@ -8,58 +8,55 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
-#include <algorithm>
+#include "../../list_window.hpp"
+#include "../helpers.hpp"
 #include <optional>
+#include <vector>
 
 namespace dbal {
 namespace entities {
 namespace user {
 
 /**
- * List users with filtering and pagination
+ * List users with filtering and keyset or page-offset pagination
  */
 inline Result<std::vector<User>> list(InMemoryStore& store, const ListOptions& options) {
-    std::vector<User> users;
-    
-    const auto tenant_filter = [&options]() -> std::optional<std::string> {
-        auto it = options.filter.find("tenantId");
-        if (it != options.filter.end()) return it->second;
-        it = options.filter.find("tenantId");
-        if (it != options.filter.end()) return it->second;
-        return std::nullopt;
-    }();
+    auto window = planListWindow<User>(options);
+    if (window.isError()) {
+        return window.error();
+    }
+    const auto tenant_filter = helpers::filterValue(options.filter, "tenantId");
+    const auto role_filter = helpers::filterValue(options.filter, "role");
 
-    for (const auto& [id, user] : store.users) {
-        bool matches = true;
-        
+    const auto candidates = narrowByIndex(options.filter, {
+        {"tenantId", &store.users_by_tenant},
+        {"role", &store.users_by_role},
+    });
+    auto matches = [&](const User& user) {
         if (tenant_filter.has_value() && user.tenantId != tenant_filter.value()) {
-            matches = false;
+            return false;
         }
+        return !role_filter.has_value() || user.role == role_filter.value();
+    };
 
-        if (options.filter.find("role") != options.filter.end()) {
-            const std::string& role_str = options.filter.at("role");
-            if (user.role != role_str) matches = false;
-        }
-        
-        if (matches) {
-            users.push_back(user);
-        }
+    if (candidates.has_value() && candidates.value() == nullptr) {
+        // A filtered bucket is empty, so nothing matches
+        return Result<std::vector<User>>(std::vector<User>());
     }
-    
-    if (options.sort.find("username") != options.sort.end()) {
-        std::sort(users.begin(), users.end(), [](const User& a, const User& b) {
-            return a.username < b.username;
-        });
-    }
-    
-    int start = (options.page - 1) * options.limit;
-    int end = std::min(start + options.limit, static_cast<int>(users.size()));
-    
-    if (start < static_cast<int>(users.size())) {
-        return Result<std::vector<User>>(std::vector<User>(users.begin() + start, users.begin() + end));
+
+    if (window.value().field == "username" && tenant_filter.has_value()) {
+        // Walk the tenant's users in username order from the cursor, unless
+        // a role filter leaves so few rows that sorting them is cheaper
+        const auto* tenant_users = store.users_by_tenant.find(tenant_filter.value());
+        const size_t wanted = window.value().skip + window.value().limit;
+        if (tenant_users && wanted * tenant_users->size() <= candidates.value()->size() * candidates.value()->size()) {
+            return Result<std::vector<User>>(collectListWindow(store.users, window.value(), candidates,
+                                                               &store.users_by_tenant_username, matches,
+                                                               tenant_filter));
+        }
     }
-    
-    return Result<std::vector<User>>(std::vector<User>());
+    const SortIndex* order = window.value().field == "username" ? &store.users_by_username : nullptr;
+    return Result<std::vector<User>>(collectListWindow(store.users, window.value(), candidates, order, matches));
 }
 
 } // namespace user
@@ -9,6 +9,7 @@
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
 #include "../../../validation/entity/user_validation.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -27,33 +28,52 @@ inline Result<User> update(InMemoryStore& store, const std::string& id, const Up
         return Error::notFound("User not found: " + id);
     }
     
+    if (input.username.has_value() && !validation::isValidUsername(input.username.value())) {
+        return Error::validationError("Invalid username format");
+    }
+    if (input.email.has_value() && !validation::isValidEmail(input.email.value())) {
+        return Error::validationError("Invalid email format");
+    }
+
+    // Unique within the tenant the user ends up in
     User& user = it->second;
-    
+    const std::optional<std::string>& tenant = input.tenantId.has_value() ? input.tenantId : user.tenantId;
+    const std::string& username = input.username.value_or(user.username);
+    const std::string& email = input.email.value_or(user.email);
+    if (helpers::uniqueHolder(store.user_names, tenant, username, id)) {
+        return Error::conflict("Username already exists: " + username);
+    }
+    if (helpers::uniqueHolder(store.user_emails, tenant, email, id)) {
+        return Error::conflict("Email already exists: " + email);
+    }
+
+    store.remember(store.users, id);
+    if (tenant != user.tenantId || username != user.username) {
+        helpers::eraseUnique(store.user_names, helpers::tenantKey(user.tenantId, user.username), id);
+        store.user_names[helpers::tenantKey(tenant, username)] = id;
+    }
+    if (tenant != user.tenantId || email != user.email) {
+        helpers::eraseUnique(store.user_emails, helpers::tenantKey(user.tenantId, user.email), id);
+        store.user_emails[helpers::tenantKey(tenant, email)] = id;
+    }
+
     if (input.username.has_value()) {
-        if (!validation::isValidUsername(input.username.value())) {
-            return Error::validationError("Invalid username format");
-        }
-        for (const auto& [uid, u] : store.users) {
-            if (uid != id && u.tenantId == user.tenantId && u.username == input.username.value()) {
-                return Error::conflict("Username already exists: " + input.username.value());
-            }
-        }
+        store.users_by_username.update(user.username, input.username.value(), id);
+        store.users_by_tenant_username.update(SortIndex::scopedKey(user.tenantId, user.username),
+                                              SortIndex::scopedKey(user.tenantId, input.username.value()), id);
         user.username = input.username.value();
     }
     
     if (input.email.has_value()) {
-        if (!validation::isValidEmail(input.email.value())) {
-            return Error::validationError("Invalid email format");
-        }
-        for (const auto& [uid, u] : store.users) {
-            if (uid != id && u.tenantId == user.tenantId && u.email == input.email.value()) {
-                return Error::conflict("Email already exists: " + input.email.value());
-            }
-        }
         user.email = input.email.value();
     }
+
+    if (input.username.has_value() || input.email.has_value()) {
+        store.users_by_text.update(id, {user.username, user.email});
+    }
     
     if (input.role.has_value()) {
+        store.users_by_role.update(user.role, input.role.value(), id);
         user.role = input.role.value();
     }
 
@@ -66,6 +86,9 @@ inline Result<User> update(InMemoryStore& store, const std::string& id, const Up
     }
 
     if (input.tenantId.has_value()) {
+        store.users_by_tenant.update(user.tenantId, input.tenantId, id);
+        store.users_by_tenant_username.update(SortIndex::scopedKey(user.tenantId, user.username),
+                                              SortIndex::scopedKey(input.tenantId, user.username), id);
         user.tenantId = input.tenantId.value();
     }
 
@@ -0,0 +1,148 @@
+#ifndef DBAL_USER_HELPERS_HPP
+#define DBAL_USER_HELPERS_HPP
+
+#include "../../store/in_memory_store.hpp"
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace dbal {
+namespace entities {
+namespace user {
+namespace helpers {
+
+/**
+ * Key of a username or email in the per-tenant unique indexes
+ */
+inline std::string tenantKey(const std::optional<std::string>& tenantId, const std::string& value) {
+    return SortIndex::scopedKey(tenantId, value);
+}
+
+/**
+ * Id of another user in tenantId already holding value in a unique index
+ */
+inline const std::string* uniqueHolder(const std::map<std::string, std::string>& index,
+                                       const std::optional<std::string>& tenantId,
+                                       const std::string& value,
+                                       const std::string& self) {
+    auto it = index.find(tenantKey(tenantId, value));
+    return it != index.end() && it->second != self ? &it->second : nullptr;
+}
+
+inline void eraseUnique(std::map<std::string, std::string>& index, const std::string& key, const std::string& id) {
+    auto it = index.find(key);
+    if (it != index.end() && it->second == id) {
+        index.erase(it);
+    }
+}
+
+inline void indexUser(InMemoryStore& store, const User& user) {
+    store.user_names[tenantKey(user.tenantId, user.username)] = user.id;
+    store.user_emails[tenantKey(user.tenantId, user.email)] = user.id;
+    store.users_by_tenant.insert(user.tenantId, user.id);
+    store.users_by_role.insert(user.role, user.id);
+    store.users_by_username.insert(user.username, user.id);
+    store.users_by_tenant_username.insert(SortIndex::scopedKey(user.tenantId, user.username), user.id);
+    store.users_by_text.insert(user.id, {user.username, user.email});
+}
+
+inline void unindexUser(InMemoryStore& store, const User& user) {
+    eraseUnique(store.user_names, tenantKey(user.tenantId, user.username), user.id);
+    eraseUnique(store.user_emails, tenantKey(user.tenantId, user.email), user.id);
+    store.users_by_tenant.erase(user.tenantId, user.id);
+    store.users_by_role.erase(user.role, user.id);
+    store.users_by_username.erase(user.username, user.id);
+    store.users_by_tenant_username.erase(SortIndex::scopedKey(user.tenantId, user.username), user.id);
+    store.users_by_text.erase(user.id);
+}
+
+inline std::optional<std::string> filterValue(const std::map<std::string, std::string>& filter,
+                                              const std::string& field) {
+    auto it = filter.find(field);
+    if (it == filter.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+/**
+ * Visit users matching the tenant/role filters in id order.
+ *
+ * Walks the smaller of the matching index buckets instead of the whole
+ * collection; with no filters every user is visited. The visitor returns
+ * false to stop early.
+ */
+template<typename Visitor>
+inline void forEachMatching(const InMemoryStore& store,
+                            const std::optional<std::string>& tenant_filter,
+                            const std::optional<std::string>& role_filter,
+                            Visitor&& visit) {
+    const SecondaryIndex::Bucket* bucket = nullptr;
+    if (tenant_filter.has_value()) {
+        bucket = store.users_by_tenant.find(tenant_filter.value());
+        if (!bucket) {
+            return;
+        }
+    }
+    if (role_filter.has_value()) {
+        const SecondaryIndex::Bucket* by_role = store.users_by_role.find(role_filter.value());
+        if (!by_role) {
+            return;
+        }
+        if (!bucket || by_role->size() < bucket->size()) {
+            bucket = by_role;
+        }
+    }
+
+    if (!bucket) {
+        for (const auto& [id, user] : store.users) {
+            (void)id;
+            if (!visit(user)) {
+                return;
+            }
+        }
+        return;
+    }
+
+    for (const auto& id : *bucket) {
+        auto it = store.users.find(id);
+        if (it == store.users.end()) {
+            continue;
+        }
+        const User& user = it->second;
+        if (tenant_filter.has_value() && user.tenantId != tenant_filter.value()) {
+            continue;
+        }
+        if (role_filter.has_value() && user.role != role_filter.value()) {
+            continue;
+        }
+        if (!visit(user)) {
+            return;
+        }
+    }
+}
+
+/**
+ * Ids of users matching a bulk-operation filter (tenantId, role, username)
+ */
+inline std::vector<std::string> matchingIds(const InMemoryStore& store,
+                                            const std::map<std::string, std::string>& filter) {
+    const auto username_filter = filterValue(filter, "username");
+    std::vector<std::string> ids;
+    forEachMatching(store, filterValue(filter, "tenantId"), filterValue(filter, "role"),
+                    [&](const User& user) {
+                        if (!username_filter.has_value() || user.username == username_filter.value()) {
+                            ids.push_back(user.id);
+                        }
+                        return true;
+                    });
+    return ids;
+}
+
+} // namespace helpers
+} // namespace user
+} // namespace entities
+} // namespace dbal
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef DBAL_USER_INDEX_HPP
 #define DBAL_USER_INDEX_HPP
 
+#include "helpers.hpp"
 #include "crud/create_user.hpp"
 #include "crud/get_user.hpp"
 #include "crud/update_user.hpp"
@@ -8,7 +8,9 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 #include "../../../validation/entity/workflow_validation.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -38,8 +40,9 @@ inline Result<Workflow> create(InMemoryStore& store, const CreateWorkflowInput&
     workflow.updatedAt = input.updatedAt;
     workflow.createdBy = input.createdBy;
 
+    store.remember(store.workflows, workflow.id);
     store.workflows[workflow.id] = workflow;
-    store.workflow_names[workflow.name] = workflow.id;
+    helpers::indexWorkflow(store, workflow);
 
     return Result<Workflow>(workflow);
 }
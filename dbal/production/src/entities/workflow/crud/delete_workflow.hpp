@@ -8,6 +8,8 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
+#include "../helpers.hpp"
 
 namespace dbal {
 namespace entities {
@@ -26,7 +28,8 @@ inline Result<bool> remove(InMemoryStore& store, const std::string& id) {
         return Error::notFound("Workflow not found: " + id);
     }
 
-    store.workflow_names.erase(it->second.name);
+    store.remember(store.workflows, id);
+    helpers::unindexWorkflow(store, it->second);
     store.workflows.erase(it);
 
     return Result<bool>(true);
@@ -8,62 +8,50 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
-#include <algorithm>
+#include "../../list_window.hpp"
 
 namespace dbal {
 namespace entities {
 namespace workflow {
 
 /**
- * List workflows with filtering and pagination
+ * List workflows with filtering and keyset or page-offset pagination
  */
 inline Result<std::vector<Workflow>> list(InMemoryStore& store, const ListOptions& options) {
-    std::vector<Workflow> workflows;
-
-    for (const auto& [id, workflow] : store.workflows) {
-        bool matches = true;
+    auto window = planListWindow<Workflow>(options);
+    if (window.isError()) {
+        return window.error();
+    }
 
+    auto matches = [&options](const Workflow& workflow) {
         if (options.filter.find("enabled") != options.filter.end()) {
             bool filter_enabled = options.filter.at("enabled") == "true";
-            if (workflow.enabled != filter_enabled) matches = false;
+            if (workflow.enabled != filter_enabled) return false;
         }
 
         if (options.filter.find("tenantId") != options.filter.end()) {
             if (!workflow.tenantId.has_value() || workflow.tenantId.value() != options.filter.at("tenantId")) {
-                matches = false;
+                return false;
             }
         }
 
         if (options.filter.find("createdBy") != options.filter.end()) {
             if (!workflow.createdBy.has_value() || workflow.createdBy.value() != options.filter.at("createdBy")) {
-                matches = false;
+                return false;
             }
         }
 
-        if (matches) {
-            workflows.push_back(workflow);
-        }
-    }
-
-    if (options.sort.find("name") != options.sort.end()) {
-        std::sort(workflows.begin(), workflows.end(), [](const Workflow& a, const Workflow& b) {
-            return a.name < b.name;
-        });
-    } else if (options.sort.find("createdAt") != options.sort.end()) {
-        std::sort(workflows.begin(), workflows.end(), [](const Workflow& a, const Workflow& b) {
-            return a.createdAt.value_or(std::chrono::system_clock::time_point()) <
-                b.createdAt.value_or(std::chrono::system_clock::time_point());
-        });
-    }
-
-    int start = (options.page - 1) * options.limit;
-    int end = std::min(start + options.limit, static_cast<int>(workflows.size()));
+        return true;
+    };
 
-    if (start < static_cast<int>(workflows.size())) {
-        return Result<std::vector<Workflow>>(std::vector<Workflow>(workflows.begin() + start, workflows.begin() + end));
+    const auto candidates = narrowByIndex(options.filter, {{"tenantId", &store.workflows_by_tenant}});
+    const SortIndex* order = nullptr;
+    if (window.value().field == "name") {
+        order = &store.workflows_by_name;
+    } else if (window.value().field == "createdAt") {
+        order = &store.workflows_by_created;
     }
-
-    return Result<std::vector<Workflow>>(std::vector<Workflow>());
+    return Result<std::vector<Workflow>>(collectListWindow(store.workflows, window.value(), candidates, order, matches));
 }
 
 } // namespace workflow
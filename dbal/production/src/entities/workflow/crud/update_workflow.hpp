@@ -8,6 +8,7 @@
 #include "dbal/types.hpp"
 #include "dbal/errors.hpp"
 #include "../../../store/in_memory_store.hpp"
+#include "../../../query/cursor/list_cursor.hpp"
 #include "../../../validation/entity/workflow_validation.hpp"
 
 namespace dbal {
@@ -27,6 +28,7 @@ inline Result<Workflow> update(InMemoryStore& store, const std::string& id, cons
         return Error::notFound("Workflow not found: " + id);
     }
 
+    store.remember(store.workflows, id);
     Workflow& workflow = it->second;
     std::string old_name = workflow.name;
 
@@ -40,6 +42,7 @@ inline Result<Workflow> update(InMemoryStore& store, const std::string& id, cons
         }
         store.workflow_names.erase(old_name);
         store.workflow_names[input.name.value()] = id;
+        store.workflows_by_name.update(old_name, input.name.value(), id);
         workflow.name = input.name.value();
     }
 
@@ -68,6 +71,8 @@ inline Result<Workflow> update(InMemoryStore& store, const std::string& id, cons
     }
 
     if (input.createdAt.has_value()) {
+        store.workflows_by_created.update(query::timestampKey(workflow.createdAt),
+                                          query::timestampKey(input.createdAt), id);
         workflow.createdAt = input.createdAt.value();
     }
 
@@ -76,6 +81,7 @@ inline Result<Workflow> update(InMemoryStore& store, const std::string& id, cons
     }
 
     if (input.tenantId.has_value()) {
+        store.workflows_by_tenant.update(workflow.tenantId, input.tenantId, id);
         workflow.tenantId = input.tenantId.value();
     }
 
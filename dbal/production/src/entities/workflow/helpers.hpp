@@ -0,0 +1,31 @@
+#ifndef DBAL_WORKFLOW_HELPERS_HPP
+#define DBAL_WORKFLOW_HELPERS_HPP
+
+#include "../../store/in_memory_store.hpp"
+#include "../../query/cursor/list_cursor.hpp"
+
+namespace dbal {
+namespace entities {
+namespace workflow {
+namespace helpers {
+
+inline void indexWorkflow(InMemoryStore& store, const Workflow& workflow) {
+    store.workflow_names[workflow.name] = workflow.id;
+    store.workflows_by_tenant.insert(workflow.tenantId, workflow.id);
+    store.workflows_by_name.insert(workflow.name, workflow.id);
+    store.workflows_by_created.insert(query::timestampKey(workflow.createdAt), workflow.id);
+}
+
+inline void unindexWorkflow(InMemoryStore& store, const Workflow& workflow) {
+    store.workflow_names.erase(workflow.name);
+    store.workflows_by_tenant.erase(workflow.tenantId, workflow.id);
+    store.workflows_by_name.erase(workflow.name, workflow.id);
+    store.workflows_by_created.erase(query::timestampKey(workflow.createdAt), workflow.id);
+}
+
+} // namespace helpers
+} // namespace workflow
+} // namespace entities
+} // namespace dbal
+
+#endif
@@ -26,6 +26,10 @@ Error Error::internal(const std::string& message) {
     return Error(ErrorCode::InternalError, message);
 }
 
+Error Error::unavailable(const std::string& message) {
+    return Error(ErrorCode::ServiceUnavailable, message);
+}
+
 Error Error::sandboxViolation(const std::string& message) {
     return Error(ErrorCode::SandboxViolation, message);
 }
@@ -0,0 +1,587 @@
+#include "in_memory_kv_store.hpp"
+#include "../query/cursor/list_cursor.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace dbal {
+namespace kv {
+
+namespace {
+
+using tenant::TenantContext;
+
+// Deadlines are kept to a tenth of a second; TTLs are whole seconds
+constexpr auto kExpiryTick = std::chrono::milliseconds(100);
+
+// Keys fetched from the index per pass of list()
+constexpr std::size_t kListBatch = 256;
+
+constexpr const char* kResource = "kv";
+
+struct ValueBytes {
+    std::size_t operator()(const std::string& value) const {
+        return value.size();
+    }
+    std::size_t operator()(int64_t) const {
+        return sizeof(int64_t);
+    }
+    std::size_t operator()(double) const {
+        return sizeof(double);
+    }
+    std::size_t operator()(bool) const {
+        return 1;
+    }
+    std::size_t operator()(std::nullptr_t) const {
+        return 0;
+    }
+    std::size_t operator()(const std::map<std::string, std::string>& value) const {
+        std::size_t total = 0;
+        for (const auto& [field, text] : value) {
+            total += field.size() + text.size();
+        }
+        return total;
+    }
+    std::size_t operator()(const std::vector<std::string>& value) const {
+        std::size_t total = 0;
+        for (const auto& item : value) {
+            total += item.size();
+        }
+        return total;
+    }
+};
+
+std::size_t valueBytes(const StorableValue& value) {
+    return std::visit(ValueBytes{}, value);
+}
+
+bool reserve(std::atomic<std::size_t>& total, std::size_t amount, const std::optional<size_t>& limit) {
+    if (!limit.has_value()) {
+        total.fetch_add(amount, std::memory_order_relaxed);
+        return true;
+    }
+    std::size_t current = total.load(std::memory_order_relaxed);
+    do {
+        if (amount > *limit || current > *limit - amount) {
+            return false;
+        }
+    } while (!total.compare_exchange_weak(current, current + amount, std::memory_order_relaxed));
+    return true;
+}
+
+bool expired(const std::optional<std::chrono::system_clock::time_point>& expires_at,
+             std::chrono::system_clock::time_point now) {
+    return expires_at.has_value() && *expires_at <= now;
+}
+
+bool startsWith(const std::string& key, const std::string& prefix) {
+    return key.compare(0, prefix.size(), prefix) == 0;
+}
+
+/**
+ * Resolve a JavaScript-style slice bound: negative counts from the end
+ */
+std::size_t sliceBound(int index, std::size_t size) {
+    if (index < 0) {
+        const auto back = static_cast<std::size_t>(-static_cast<int64_t>(index));
+        return back >= size ? 0 : size - back;
+    }
+    return std::min(static_cast<std::size_t>(index), size);
+}
+
+} // namespace
+
+InMemoryKVStore::InMemoryKVStore(std::chrono::milliseconds reap_interval)
+    : wheel_(kExpiryTick), reap_interval_(reap_interval) {
+    if (reap_interval_.count() > 0) {
+        reaper_ = std::thread(&InMemoryKVStore::reapLoop, this);
+    }
+}
+
+InMemoryKVStore::~InMemoryKVStore() {
+    {
+        std::lock_guard<std::mutex> lock(reaper_mutex_);
+        stopping_ = true;
+    }
+    reaper_wake_.notify_all();
+    if (reaper_.joinable()) {
+        reaper_.join();
+    }
+}
+
+Result<std::optional<StorableValue>> InMemoryKVStore::get(const std::string& key, const TenantContext& context) {
+    if (!context.canRead(kResource)) {
+        return Error::forbidden("Permission denied: cannot read key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<std::optional<StorableValue>>(std::nullopt);
+    }
+    Shard& shard = space->shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || expired(it->second.expires_at, Clock::now())) {
+        return Result<std::optional<StorableValue>>(std::nullopt);
+    }
+    return Result<std::optional<StorableValue>>(it->second.value);
+}
+
+Result<void> InMemoryKVStore::set(const std::string& key, const StorableValue& value,
+                                  const TenantContext& context, std::optional<int> ttl) {
+    if (!context.canWrite(kResource)) {
+        return Error::forbidden("Permission denied: cannot write key-value data");
+    }
+    if (ttl.has_value() && *ttl < 0) {
+        return Error::validationError("TTL must not be negative");
+    }
+    const Clock::time_point now = Clock::now();
+    std::optional<Clock::time_point> expires_at;
+    if (ttl.has_value() && *ttl > 0) {
+        expires_at = now + std::chrono::seconds(*ttl);
+    }
+    const std::size_t size = valueBytes(value);
+
+    Namespace& space = obtain(context);
+    Shard& shard = space.shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = live(space, shard, key, now);
+    const bool creating = it == shard.entries.end();
+    auto charged = charge(space, context.quota(), creating, creating ? 0 : it->second.size_bytes, size);
+    if (charged.isError()) {
+        return charged;
+    }
+    if (creating) {
+        it = insert(space, shard, key, now);
+    }
+    Slot& slot = it->second;
+    slot.value = value;
+    slot.size_bytes = size;
+    slot.updated_at = now;
+    reschedule(space, key, slot, expires_at);
+    return Result<void>();
+}
+
+Result<bool> InMemoryKVStore::remove(const std::string& key, const TenantContext& context) {
+    if (!context.canDelete(kResource)) {
+        return Error::forbidden("Permission denied: cannot delete key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<bool>(false);
+    }
+    Shard& shard = space->shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    const auto it = live(*space, shard, key, Clock::now());
+    if (it == shard.entries.end()) {
+        return Result<bool>(false);
+    }
+    erase(*space, shard, it);
+    return Result<bool>(true);
+}
+
+Result<bool> InMemoryKVStore::exists(const std::string& key, const TenantContext& context) {
+    auto value = get(key, context);
+    if (value.isError()) {
+        return value.error();
+    }
+    return Result<bool>(value.value().has_value());
+}
+
+Result<size_t> InMemoryKVStore::listAdd(const std::string& key, const std::vector<std::string>& items,
+                                        const TenantContext& context) {
+    if (!context.canWrite(kResource)) {
+        return Error::forbidden("Permission denied: cannot write key-value data");
+    }
+    const Clock::time_point now = Clock::now();
+    std::size_t added_bytes = 0;
+    for (const auto& item : items) {
+        added_bytes += item.size();
+    }
+
+    Namespace& space = obtain(context);
+    Shard& shard = space.shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = live(space, shard, key, now);
+    const bool creating = it == shard.entries.end();
+    std::size_t length = 0;
+    if (!creating) {
+        const auto* list = std::get_if<std::vector<std::string>>(&it->second.value);
+        if (list == nullptr) {
+            return Error::conflict("Key does not hold a list");
+        }
+        length = list->size();
+    }
+    const auto& max_length = context.quota().maxListLength;
+    if (max_length.has_value() && items.size() > *max_length - std::min(length, *max_length)) {
+        return Error::forbidden("Quota exceeded: list length limit reached");
+    }
+    const std::size_t old_bytes = creating ? 0 : it->second.size_bytes;
+    auto charged = charge(space, context.quota(), creating, old_bytes, old_bytes + added_bytes);
+    if (charged.isError()) {
+        return charged.error();
+    }
+    if (creating) {
+        it = insert(space, shard, key, now);
+        it->second.value = std::vector<std::string>();
+    }
+    Slot& slot = it->second;
+    auto& list = std::get<std::vector<std::string>>(slot.value);
+    list.insert(list.end(), items.begin(), items.end());
+    slot.size_bytes = old_bytes + added_bytes;
+    slot.updated_at = now;
+    return Result<size_t>(list.size());
+}
+
+Result<std::vector<std::string>> InMemoryKVStore::listGet(const std::string& key, const TenantContext& context,
+                                                          int start, std::optional<int> end) {
+    if (!context.canRead(kResource)) {
+        return Error::forbidden("Permission denied: cannot read key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<std::vector<std::string>>(std::vector<std::string>());
+    }
+    Shard& shard = space->shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || expired(it->second.expires_at, Clock::now())) {
+        return Result<std::vector<std::string>>(std::vector<std::string>());
+    }
+    const auto* list = std::get_if<std::vector<std::string>>(&it->second.value);
+    if (list == nullptr) {
+        return Result<std::vector<std::string>>(std::vector<std::string>());
+    }
+    const std::size_t from = sliceBound(start, list->size());
+    const std::size_t to = end.has_value() ? sliceBound(*end, list->size()) : list->size();
+    if (from >= to) {
+        return Result<std::vector<std::string>>(std::vector<std::string>());
+    }
+    return Result<std::vector<std::string>>(std::vector<std::string>(list->begin() + from, list->begin() + to));
+}
+
+Result<size_t> InMemoryKVStore::listRemove(const std::string& key, const std::string& value,
+                                           const TenantContext& context) {
+    if (!context.canWrite(kResource)) {
+        return Error::forbidden("Permission denied: cannot write key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<size_t>(0);
+    }
+    const Clock::time_point now = Clock::now();
+    Shard& shard = space->shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    const auto it = live(*space, shard, key, now);
+    if (it == shard.entries.end()) {
+        return Result<size_t>(0);
+    }
+    Slot& slot = it->second;
+    auto* list = std::get_if<std::vector<std::string>>(&slot.value);
+    if (list == nullptr) {
+        return Result<size_t>(0);
+    }
+    const auto kept = std::remove(list->begin(), list->end(), value);
+    const auto removed = static_cast<std::size_t>(list->end() - kept);
+    if (removed == 0) {
+        return Result<size_t>(0);
+    }
+    list->erase(kept, list->end());
+    const std::size_t freed = removed * value.size();
+    space->bytes.fetch_sub(freed, std::memory_order_relaxed);
+    slot.size_bytes -= freed;
+    slot.updated_at = now;
+    return Result<size_t>(removed);
+}
+
+Result<size_t> InMemoryKVStore::listLength(const std::string& key, const TenantContext& context) {
+    if (!context.canRead(kResource)) {
+        return Error::forbidden("Permission denied: cannot read key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<size_t>(0);
+    }
+    Shard& shard = space->shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || expired(it->second.expires_at, Clock::now())) {
+        return Result<size_t>(0);
+    }
+    const auto* list = std::get_if<std::vector<std::string>>(&it->second.value);
+    return Result<size_t>(list == nullptr ? 0 : list->size());
+}
+
+Result<void> InMemoryKVStore::listClear(const std::string& key, const TenantContext& context) {
+    if (!context.canWrite(kResource)) {
+        return Error::forbidden("Permission denied: cannot write key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<void>();
+    }
+    const Clock::time_point now = Clock::now();
+    Shard& shard = space->shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    const auto it = live(*space, shard, key, now);
+    if (it == shard.entries.end()) {
+        return Result<void>();
+    }
+    Slot& slot = it->second;
+    auto* list = std::get_if<std::vector<std::string>>(&slot.value);
+    if (list == nullptr) {
+        return Error::conflict("Key does not hold a list");
+    }
+    list->clear();
+    space->bytes.fetch_sub(slot.size_bytes, std::memory_order_relaxed);
+    slot.size_bytes = 0;
+    slot.updated_at = now;
+    return Result<void>();
+}
+
+Result<ListResult> InMemoryKVStore::list(const ListOptions& options, const TenantContext& context) {
+    if (!context.canRead(kResource)) {
+        return Error::forbidden("Permission denied: cannot read key-value data");
+    }
+    const std::string prefix = options.prefix.value_or("");
+    const std::size_t limit = options.limit == 0 ? 100 : options.limit;
+    std::optional<std::string> after;
+    if (options.cursor.has_value() && !options.cursor->empty()) {
+        after = query::detail::decodeBase64Url(*options.cursor);
+        if (!after.has_value()) {
+            return Error::validationError("Invalid list cursor");
+        }
+    }
+
+    ListResult result;
+    result.hasMore = false;
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return result;
+    }
+
+    // Keys are read from the index a batch at a time and then looked up in
+    // their shards without holding the index, which writers take after a
+    // shard; keys deleted in between are skipped. One entry past the limit
+    // is fetched to tell whether there are more.
+    const Clock::time_point now = Clock::now();
+    std::vector<std::string> batch;
+    bool exhausted = false;
+    while (!exhausted && result.entries.size() <= limit) {
+        batch.clear();
+        {
+            std::shared_lock<std::shared_mutex> lock(space->index_mutex);
+            auto it = space->keys.lower_bound(prefix);
+            if (after.has_value() && *after >= prefix) {
+                it = space->keys.upper_bound(*after);
+            }
+            for (; it != space->keys.end() && batch.size() < kListBatch; ++it) {
+                if (!startsWith(*it, prefix)) {
+                    break;
+                }
+                batch.push_back(*it);
+            }
+            exhausted = it == space->keys.end() || !startsWith(*it, prefix);
+        }
+        for (const auto& key : batch) {
+            Shard& shard = space->shardFor(key);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            const auto found = shard.entries.find(key);
+            if (found == shard.entries.end() || expired(found->second.expires_at, now)) {
+                continue;
+            }
+            const Slot& slot = found->second;
+            result.entries.push_back(
+                KVEntry{key, slot.value, slot.size_bytes, slot.created_at, slot.updated_at, slot.expires_at});
+            if (result.entries.size() > limit) {
+                break;
+            }
+        }
+        if (!batch.empty()) {
+            after = batch.back();
+        }
+    }
+    if (result.entries.size() > limit) {
+        result.entries.pop_back();
+        result.hasMore = true;
+        result.nextCursor = query::detail::encodeBase64Url(result.entries.back().key);
+    }
+    return result;
+}
+
+Result<size_t> InMemoryKVStore::count(const std::string& prefix, const TenantContext& context) {
+    if (!context.canRead(kResource)) {
+        return Error::forbidden("Permission denied: cannot read key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<size_t>(0);
+    }
+    if (prefix.empty()) {
+        return Result<size_t>(space->records.load(std::memory_order_relaxed));
+    }
+    std::shared_lock<std::shared_mutex> lock(space->index_mutex);
+    std::size_t matches = 0;
+    for (auto it = space->keys.lower_bound(prefix); it != space->keys.end() && startsWith(*it, prefix); ++it) {
+        ++matches;
+    }
+    return Result<size_t>(matches);
+}
+
+Result<size_t> InMemoryKVStore::clear(const TenantContext& context) {
+    if (!context.canDelete(kResource)) {
+        return Error::forbidden("Permission denied: cannot delete key-value data");
+    }
+    Namespace* space = find(context);
+    if (space == nullptr) {
+        return Result<size_t>(0);
+    }
+    std::vector<std::unique_lock<std::shared_mutex>> shard_locks;
+    shard_locks.reserve(kShardCount);
+    for (auto& shard : space->shards) {
+        shard_locks.emplace_back(shard.mutex);
+    }
+    std::unique_lock<std::shared_mutex> index_lock(space->index_mutex);
+    std::lock_guard<std::mutex> wheel_lock(wheel_mutex_);
+    const Clock::time_point now = Clock::now();
+    std::size_t removed = 0;
+    for (auto& shard : space->shards) {
+        for (auto& [key, slot] : shard.entries) {
+            wheel_.cancel(slot.timer);
+            if (!expired(slot.expires_at, now)) {
+                ++removed;
+            }
+        }
+        shard.entries.clear();
+    }
+    space->keys.clear();
+    space->records.store(0, std::memory_order_relaxed);
+    space->bytes.store(0, std::memory_order_relaxed);
+    return Result<size_t>(removed);
+}
+
+std::size_t InMemoryKVStore::expire(Clock::time_point now) {
+    std::vector<Expiry> due;
+    {
+        std::lock_guard<std::mutex> lock(wheel_mutex_);
+        wheel_.advance(now, [&](Expiry&& expiry) { due.push_back(std::move(expiry)); });
+    }
+    // A key set again since it was scheduled has a later deadline and stays
+    std::size_t removed = 0;
+    for (const auto& expiry : due) {
+        Shard& shard = expiry.space->shardFor(expiry.key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        const auto it = shard.entries.find(expiry.key);
+        if (it != shard.entries.end() && expired(it->second.expires_at, now)) {
+            erase(*expiry.space, shard, it);
+            ++removed;
+        }
+    }
+    return removed;
+}
+
+InMemoryKVStore::Namespace* InMemoryKVStore::find(const TenantContext& context) const {
+    std::shared_lock<std::shared_mutex> lock(namespaces_mutex_);
+    const auto it = namespaces_.find(context.namespace_());
+    return it == namespaces_.end() ? nullptr : it->second.get();
+}
+
+InMemoryKVStore::Namespace& InMemoryKVStore::obtain(const TenantContext& context) {
+    if (Namespace* space = find(context)) {
+        return *space;
+    }
+    std::unique_lock<std::shared_mutex> lock(namespaces_mutex_);
+    auto& space = namespaces_[context.namespace_()];
+    if (!space) {
+        space = std::make_unique<Namespace>();
+    }
+    return *space;
+}
+
+/**
+ * Find key under its shard's exclusive lock, removing it first if its
+ * TTL has run out
+ */
+InMemoryKVStore::Entries::iterator InMemoryKVStore::live(Namespace& space, Shard& shard,
+                                                         const std::string& key, Clock::time_point now) {
+    const auto it = shard.entries.find(key);
+    if (it != shard.entries.end() && expired(it->second.expires_at, now)) {
+        erase(space, shard, it);
+        return shard.entries.end();
+    }
+    return it;
+}
+
+/**
+ * Add an empty entry for key, already charged for, and index it
+ */
+InMemoryKVStore::Entries::iterator InMemoryKVStore::insert(Namespace& space, Shard& shard,
+                                                           const std::string& key, Clock::time_point now) {
+    const auto it = shard.entries.emplace(key, Slot()).first;
+    it->second.created_at = now;
+    try {
+        std::unique_lock<std::shared_mutex> lock(space.index_mutex);
+        space.keys.insert(key);
+    } catch (...) {
+        shard.entries.erase(it);
+        throw;
+    }
+    return it;
+}
+
+void InMemoryKVStore::erase(Namespace& space, Shard& shard, Entries::iterator it) {
+    if (it->second.timer) {
+        std::lock_guard<std::mutex> lock(wheel_mutex_);
+        wheel_.cancel(it->second.timer);
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(space.index_mutex);
+        space.keys.erase(it->first);
+    }
+    space.records.fetch_sub(1, std::memory_order_relaxed);
+    space.bytes.fetch_sub(it->second.size_bytes, std::memory_order_relaxed);
+    shard.entries.erase(it);
+}
+
+void InMemoryKVStore::reschedule(Namespace& space, const std::string& key, Slot& slot,
+                                 std::optional<Clock::time_point> expires_at) {
+    if (!slot.timer && !expires_at.has_value()) {
+        slot.expires_at.reset();
+        return;
+    }
+    std::lock_guard<std::mutex> lock(wheel_mutex_);
+    wheel_.cancel(slot.timer);
+    slot.timer = expires_at.has_value() ? wheel_.schedule(*expires_at, Expiry{&space, key}) : Wheel::Handle();
+    slot.expires_at = expires_at;
+}
+
+/**
+ * Count a write against space's totals, refusing it when it would take
+ * them past quota. Writes that shrink a value always go through.
+ */
+Result<void> InMemoryKVStore::charge(Namespace& space, const tenant::TenantQuota& quota, bool creating,
+                                     std::size_t old_bytes, std::size_t new_bytes) {
+    if (creating && !reserve(space.records, 1, quota.maxRecords)) {
+        return Error::forbidden("Quota exceeded: maximum record count reached");
+    }
+    if (new_bytes > old_bytes && !reserve(space.bytes, new_bytes - old_bytes, quota.maxDataSizeBytes)) {
+        if (creating) {
+            space.records.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return Error::forbidden("Quota exceeded: maximum data size reached");
+    }
+    if (new_bytes < old_bytes) {
+        space.bytes.fetch_sub(old_bytes - new_bytes, std::memory_order_relaxed);
+    }
+    return Result<void>();
+}
+
+void InMemoryKVStore::reapLoop() {
+    std::unique_lock<std::mutex> lock(reaper_mutex_);
+    while (!reaper_wake_.wait_for(lock, reap_interval_, [this] { return stopping_; })) {
+        lock.unlock();
+        expire();
+        lock.lock();
+    }
+}
+
+} // namespace kv
+} // namespace dbal
@@ -0,0 +1,150 @@
+/**
+ * @file in_memory_kv_store.hpp
+ * @brief KVStore kept in memory, sharded per tenant namespace
+ *
+ * Every TenantContext namespace gets its own table: 16 hash shards, each
+ * under its own shared_mutex, an ordered set of the namespace's keys that
+ * list() and count() walk from the prefix or cursor, and running record
+ * and byte totals that set() and the list operations check against the
+ * caller's TenantQuota limits instead of scanning. The store keeps those
+ * totals itself; the current* fields of the quota passed in are ignored.
+ *
+ * Keys set with a TTL are scheduled on a timing wheel, which a reaper
+ * thread advances every reap_interval to remove them. Reads treat a key
+ * past its deadline as absent straight away; count() and the quota
+ * totals still include it until it is reaped.
+ *
+ * Locks are taken in the order namespace table, shard, key index, wheel,
+ * and only clear() holds more than one shard at a time.
+ */
+#ifndef DBAL_IN_MEMORY_KV_STORE_HPP
+#define DBAL_IN_MEMORY_KV_STORE_HPP
+
+#include "dbal/storage/kv_store.hpp"
+#include "../util/timing_wheel.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace dbal {
+namespace kv {
+
+class InMemoryKVStore : public KVStore {
+public:
+    using Clock = std::chrono::system_clock;
+
+    /**
+     * @param reap_interval how often expired keys are removed; zero starts
+     *        no reaper, leaving it to calls to expire()
+     */
+    explicit InMemoryKVStore(std::chrono::milliseconds reap_interval = std::chrono::milliseconds(100));
+    ~InMemoryKVStore() override;
+
+    InMemoryKVStore(const InMemoryKVStore&) = delete;
+    InMemoryKVStore& operator=(const InMemoryKVStore&) = delete;
+
+    Result<std::optional<StorableValue>> get(const std::string& key,
+                                             const tenant::TenantContext& context) override;
+    Result<void> set(const std::string& key, const StorableValue& value,
+                     const tenant::TenantContext& context, std::optional<int> ttl = std::nullopt) override;
+    Result<bool> remove(const std::string& key, const tenant::TenantContext& context) override;
+    Result<bool> exists(const std::string& key, const tenant::TenantContext& context) override;
+
+    Result<size_t> listAdd(const std::string& key, const std::vector<std::string>& items,
+                           const tenant::TenantContext& context) override;
+    Result<std::vector<std::string>> listGet(const std::string& key, const tenant::TenantContext& context,
+                                             int start = 0, std::optional<int> end = std::nullopt) override;
+    Result<size_t> listRemove(const std::string& key, const std::string& value,
+                              const tenant::TenantContext& context) override;
+    Result<size_t> listLength(const std::string& key, const tenant::TenantContext& context) override;
+    Result<void> listClear(const std::string& key, const tenant::TenantContext& context) override;
+
+    Result<ListResult> list(const ListOptions& options, const tenant::TenantContext& context) override;
+    Result<size_t> count(const std::string& prefix, const tenant::TenantContext& context) override;
+    Result<size_t> clear(const tenant::TenantContext& context) override;
+
+    /**
+     * Remove every key whose TTL ran out by now
+     * @return number of keys removed
+     */
+    std::size_t expire(Clock::time_point now = Clock::now());
+
+private:
+    static constexpr std::size_t kShardCount = 16;
+
+    struct Namespace;
+
+    struct Expiry {
+        Namespace* space = nullptr;
+        std::string key;
+    };
+
+    using Wheel = util::TimingWheel<Expiry, Clock>;
+
+    struct Slot {
+        StorableValue value;
+        std::size_t size_bytes = 0;
+        Clock::time_point created_at;
+        Clock::time_point updated_at;
+        std::optional<Clock::time_point> expires_at;
+        Wheel::Handle timer;
+    };
+
+    using Entries = std::unordered_map<std::string, Slot>;
+
+    struct Shard {
+        std::shared_mutex mutex;
+        Entries entries;
+    };
+
+    struct Namespace {
+        std::array<Shard, kShardCount> shards;
+        std::shared_mutex index_mutex;
+        std::set<std::string> keys;
+        std::atomic<std::size_t> records{0};
+        std::atomic<std::size_t> bytes{0};
+
+        Shard& shardFor(const std::string& key) {
+            return shards[std::hash<std::string>{}(key) % kShardCount];
+        }
+    };
+
+    Namespace* find(const tenant::TenantContext& context) const;
+    Namespace& obtain(const tenant::TenantContext& context);
+
+    Entries::iterator live(Namespace& space, Shard& shard, const std::string& key, Clock::time_point now);
+    Entries::iterator insert(Namespace& space, Shard& shard, const std::string& key, Clock::time_point now);
+    void erase(Namespace& space, Shard& shard, Entries::iterator it);
+    void reschedule(Namespace& space, const std::string& key, Slot& slot,
+                    std::optional<Clock::time_point> expires_at);
+
+    static Result<void> charge(Namespace& space, const tenant::TenantQuota& quota, bool creating,
+                               std::size_t old_bytes, std::size_t new_bytes);
+
+    void reapLoop();
+
+    mutable std::shared_mutex namespaces_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Namespace>> namespaces_;
+
+    std::mutex wheel_mutex_;
+    Wheel wheel_;
+
+    std::chrono::milliseconds reap_interval_;
+    std::mutex reaper_mutex_;
+    std::condition_variable reaper_wake_;
+    bool stopping_ = false;
+    std::thread reaper_;
+};
+
+} // namespace kv
+} // namespace dbal
+
+#endif
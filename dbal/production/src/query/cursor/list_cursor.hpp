@@ -0,0 +1,341 @@
+#pragma once
+/**
+ * @file list_cursor.hpp
+ * @brief Opaque keyset cursors for entity list operations
+ *
+ * Every list orders its rows by (sort key, id). A cursor records the sort
+ * field plus the key and id of the last row on a page, and the next page
+ * is every row strictly after that pair. Unlike page offsets this costs
+ * the same at any depth and does not skip or repeat rows when others are
+ * inserted or deleted between requests.
+ *
+ * Sort keys are strings. Timestamps are rendered as zero-padded epoch
+ * milliseconds so that string order matches time order.
+ */
+
+#include "dbal/types.hpp"
+#include "dbal/errors.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace dbal::query {
+
+struct ListCursor {
+    std::string field;
+    std::string key;
+    std::string id;
+
+    /**
+     * True when a row at (row_key, row_id) belongs after this cursor
+     */
+    bool before(const std::string& row_key, const std::string& row_id) const {
+        return std::tie(key, id) < std::tie(row_key, row_id);
+    }
+};
+
+inline std::string timestampKey(const Timestamp& timestamp) {
+    const auto millis =
+        std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "%020lld", static_cast<long long>(millis < 0 ? 0 : millis));
+    return std::string(buffer);
+}
+
+inline std::string timestampKey(const std::optional<Timestamp>& timestamp) {
+    return timestampKey(timestamp.value_or(Timestamp()));
+}
+
+/**
+ * Epoch milliseconds from a timestamp key, for binding against SQL columns
+ */
+inline std::optional<int64_t> parseTimestampKey(const std::string& key) {
+    if (key.empty() || key.size() > 20) {
+        return std::nullopt;
+    }
+    int64_t value = 0;
+    for (char c : key) {
+        if (c < '0' || c > '9' || value > (INT64_MAX - 9) / 10) {
+            return std::nullopt;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+namespace detail {
+
+constexpr char kCursorAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+inline int cursorDigit(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-') return 62;
+    if (c == '_') return 63;
+    return -1;
+}
+
+/**
+ * Unpadded base64url, so cursors travel in query strings as-is
+ */
+inline std::string encodeBase64Url(const std::string& bytes) {
+    std::string out;
+    out.reserve((bytes.size() * 4 + 2) / 3);
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (unsigned char c : bytes) {
+        buffer = (buffer << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out.push_back(kCursorAlphabet[(buffer >> bits) & 0x3F]);
+        }
+    }
+    if (bits > 0) {
+        out.push_back(kCursorAlphabet[(buffer << (6 - bits)) & 0x3F]);
+    }
+    return out;
+}
+
+inline std::optional<std::string> decodeBase64Url(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() * 3 / 4);
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : text) {
+        const int digit = cursorDigit(c);
+        if (digit < 0) {
+            return std::nullopt;
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(digit);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+        }
+    }
+    return out;
+}
+
+inline std::string componentPositionKey(const ComponentNode& component) {
+    char order[12];
+    std::snprintf(order, sizeof(order), "%010lld", static_cast<long long>(component.order) + 2147483648LL);
+    std::string key = component.pageId;
+    key.push_back('\0');
+    if (component.parentId.has_value()) {
+        key.push_back('1');
+        key += component.parentId.value();
+    } else {
+        key.push_back('0');
+    }
+    key.push_back('\0');
+    key += order;
+    return key;
+}
+
+} // namespace detail
+
+/**
+ * Layout before encoding: field NUL key-length NUL key id
+ */
+inline std::string encodeCursor(const ListCursor& cursor) {
+    std::string raw = cursor.field;
+    raw.push_back('\0');
+    raw += std::to_string(cursor.key.size());
+    raw.push_back('\0');
+    raw += cursor.key;
+    raw += cursor.id;
+    return detail::encodeBase64Url(raw);
+}
+
+inline std::optional<ListCursor> decodeCursor(const std::string& token) {
+    const auto raw = detail::decodeBase64Url(token);
+    if (!raw.has_value()) {
+        return std::nullopt;
+    }
+    const size_t field_end = raw->find('\0');
+    if (field_end == std::string::npos || field_end == 0) {
+        return std::nullopt;
+    }
+    const size_t length_end = raw->find('\0', field_end + 1);
+    if (length_end == std::string::npos || length_end == field_end + 1 || length_end - field_end > 10) {
+        return std::nullopt;
+    }
+    size_t key_length = 0;
+    for (size_t i = field_end + 1; i < length_end; ++i) {
+        const char c = (*raw)[i];
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+        key_length = key_length * 10 + static_cast<size_t>(c - '0');
+    }
+    const size_t key_begin = length_end + 1;
+    if (key_length > raw->size() - key_begin || key_begin + key_length == raw->size()) {
+        return std::nullopt;
+    }
+    ListCursor cursor;
+    cursor.field = raw->substr(0, field_end);
+    cursor.key = raw->substr(key_begin, key_length);
+    cursor.id = raw->substr(key_begin + key_length);
+    return cursor;
+}
+
+/**
+ * Sortable fields and key extraction per entity. fields lists the
+ * ListOptions::sort names in precedence order; anything else falls back
+ * to defaultField, which sorts by id alone.
+ */
+template<typename T>
+struct CursorTraits;
+
+template<>
+struct CursorTraits<User> {
+    static constexpr const char* defaultField = "id";
+    static constexpr std::array<const char*, 1> fields = {"username"};
+
+    static const std::string& id(const User& user) {
+        return user.id;
+    }
+
+    static std::string key(const User& user, const std::string& field) {
+        return field == "username" ? user.username : user.id;
+    }
+};
+
+template<>
+struct CursorTraits<PageConfig> {
+    static constexpr const char* defaultField = "id";
+    static constexpr std::array<const char*, 2> fields = {"title", "createdAt"};
+
+    static const std::string& id(const PageConfig& page) {
+        return page.id;
+    }
+
+    static std::string key(const PageConfig& page, const std::string& field) {
+        if (field == "title") return page.title;
+        if (field == "createdAt") return timestampKey(page.createdAt);
+        return page.id;
+    }
+};
+
+template<>
+struct CursorTraits<Workflow> {
+    static constexpr const char* defaultField = "id";
+    static constexpr std::array<const char*, 2> fields = {"name", "createdAt"};
+
+    static const std::string& id(const Workflow& workflow) {
+        return workflow.id;
+    }
+
+    static std::string key(const Workflow& workflow, const std::string& field) {
+        if (field == "name") return workflow.name;
+        if (field == "createdAt") return timestampKey(workflow.createdAt);
+        return workflow.id;
+    }
+};
+
+template<>
+struct CursorTraits<Session> {
+    static constexpr const char* defaultField = "id";
+    static constexpr std::array<const char*, 2> fields = {"createdAt", "expiresAt"};
+
+    static const std::string& id(const Session& session) {
+        return session.id;
+    }
+
+    static std::string key(const Session& session, const std::string& field) {
+        if (field == "createdAt") return timestampKey(session.createdAt);
+        if (field == "expiresAt") return timestampKey(session.expiresAt);
+        return session.id;
+    }
+};
+
+// Packages are keyed by packageId, which doubles as the tiebreaker
+template<>
+struct CursorTraits<InstalledPackage> {
+    static constexpr const char* defaultField = "packageId";
+    static constexpr std::array<const char*, 2> fields = {"packageId", "installedAt"};
+
+    static const std::string& id(const InstalledPackage& package) {
+        return package.packageId;
+    }
+
+    static std::string key(const InstalledPackage& package, const std::string& field) {
+        if (field == "installedAt") return timestampKey(package.installedAt);
+        return package.packageId;
+    }
+};
+
+// Components always list in tree position order: page, parent, order
+template<>
+struct CursorTraits<ComponentNode> {
+    static constexpr const char* defaultField = "position";
+    static constexpr std::array<const char*, 0> fields = {};
+
+    static const std::string& id(const ComponentNode& component) {
+        return component.id;
+    }
+
+    static std::string key(const ComponentNode& component, const std::string&) {
+        return detail::componentPositionKey(component);
+    }
+};
+
+/**
+ * The field a list of T is ordered by for these options
+ */
+template<typename T>
+std::string sortField(const ListOptions& options) {
+    for (const char* field : CursorTraits<T>::fields) {
+        if (options.sort.find(field) != options.sort.end()) {
+            return field;
+        }
+    }
+    return CursorTraits<T>::defaultField;
+}
+
+/**
+ * Decode options.cursor for a list of T ordered by field. No cursor
+ * yields nullopt; a malformed cursor, or one issued for a different sort
+ * order, is a validation error.
+ */
+template<typename T>
+Result<std::optional<ListCursor>> resolveCursor(const ListOptions& options, const std::string& field) {
+    if (options.cursor.empty()) {
+        return Result<std::optional<ListCursor>>(std::optional<ListCursor>());
+    }
+    auto cursor = decodeCursor(options.cursor);
+    if (!cursor.has_value()) {
+        return Error::validationError("Invalid list cursor");
+    }
+    if (cursor->field != field) {
+        return Error::validationError("List cursor was issued for a different sort order");
+    }
+    return Result<std::optional<ListCursor>>(std::move(cursor));
+}
+
+template<typename T>
+ListCursor cursorAfter(const T& row, const std::string& field) {
+    return ListCursor{field, CursorTraits<T>::key(row, field), CursorTraits<T>::id(row)};
+}
+
+/**
+ * Cursor for the page after rows, or empty when rows did not fill the
+ * limit and so must have been the last page
+ */
+template<typename T>
+std::string nextCursor(const std::vector<T>& rows, const ListOptions& options) {
+    if (rows.empty() || options.limit <= 0 || rows.size() < static_cast<size_t>(options.limit)) {
+        return std::string();
+    }
+    return encodeCursor(cursorAfter(rows.back(), sortField<T>(options)));
+}
+
+} // namespace dbal::query
@@ -5,9 +5,11 @@
 #include <json/json.h>
 
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace dbal {
 namespace runtime {
@@ -44,21 +46,30 @@ public:
                              const std::unordered_map<std::string, std::string>& headers = {},
                              const std::string& body = {},
                              int timeoutMs = 30'000) {
-        const cpr::Url url = cpr::Url{makeUrl(path)};
+        if (method != "GET" && method != "POST") {
+            throw std::runtime_error("Unsupported HTTP method: " + method);
+        }
+
         cpr::Header cprHeaders;
         for (const auto& [key, value] : mergeHeaders(headers)) {
             cprHeaders.insert({key, value});
         }
 
+        // Reusing a session keeps its curl handle, and with it the
+        // keep-alive connection to the server
+        auto session = checkoutSession();
+        session->SetUrl(cpr::Url{makeUrl(path)});
+        session->SetHeader(cprHeaders);
+        session->SetTimeout(cpr::Timeout(timeoutMs));
+
         cpr::Response response;
-        const cpr::Timeout timeout(timeoutMs);
         if (method == "GET") {
-            response = cpr::Get(url, cprHeaders, timeout);
-        } else if (method == "POST") {
-            response = cpr::Post(url, cprHeaders, cpr::Body(body), timeout);
+            response = session->Get();
         } else {
-            throw std::runtime_error("Unsupported HTTP method: " + method);
+            session->SetBody(cpr::Body(body));
+            response = session->Post();
         }
+        returnSession(std::move(session));
 
         if (response.error) {
             throw std::runtime_error("HTTP request failed: " + response.error.message);
@@ -102,8 +113,29 @@ private:
         return baseUrl_ + "/" + path;
     }
 
+    std::unique_ptr<cpr::Session> checkoutSession() {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        if (idleSessions_.empty()) {
+            return std::make_unique<cpr::Session>();
+        }
+        auto session = std::move(idleSessions_.back());
+        idleSessions_.pop_back();
+        return session;
+    }
+
+    void returnSession(std::unique_ptr<cpr::Session> session) {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        if (idleSessions_.size() < kMaxIdleSessions) {
+            idleSessions_.push_back(std::move(session));
+        }
+    }
+
+    static constexpr size_t kMaxIdleSessions = 16;
+
     std::string baseUrl_;
     std::unordered_map<std::string, std::string> defaultHeaders_;
+    std::mutex sessionsMutex_;
+    std::vector<std::unique_ptr<cpr::Session>> idleSessions_;
 
     std::unordered_map<std::string, std::string> mergeHeaders(
         const std::unordered_map<std::string, std::string>& headers) const {
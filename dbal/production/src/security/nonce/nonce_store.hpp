@@ -4,44 +4,154 @@
  * @brief Nonce storage for replay attack prevention (thread-safe wrapper)
  */
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include "nonce_check_and_store.hpp"
-#include "nonce_cleanup.hpp"
-#include "nonce_maybe_cleanup.hpp"
-#include "nonce_size.hpp"
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include "../../util/timing_wheel.hpp"
 
 namespace dbal::security {
 
 /**
  * Thread-safe nonce store with automatic expiry
- * Wraps individual nonce functions with mutex protection
+ * Nonces are sharded by hash, and each shard schedules its nonces on a
+ * timing wheel with one-second ticks, so checking and storing a nonce is
+ * O(1) and never sweeps the store. A background tick expires nonces as
+ * their second comes round; a nonce is remembered for at least
+ * expiry_seconds and at most one tick interval longer.
+ *
+ * The store holds at most max_nonces. Once a shard is full, new nonces
+ * are refused as if replayed until older ones expire: failing closed
+ * keeps replays out under a flood, at the cost of rejecting fresh
+ * requests until it subsides. overflows() counts the refusals.
  */
 class NonceStore {
 public:
-    explicit NonceStore(int expiry_seconds = 300, int cleanup_interval_seconds = 60) {
-        storage_.expiry_seconds = expiry_seconds;
-        storage_.cleanup_interval_seconds = cleanup_interval_seconds;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param cleanup_interval_seconds How often the background tick runs;
+     *        zero starts no thread, leaving expiry to cleanup()
+     */
+    explicit NonceStore(int expiry_seconds = 300, int cleanup_interval_seconds = 1,
+                        size_t max_nonces = size_t{1} << 20)
+        : expiry_(std::chrono::seconds(expiry_seconds))
+        , shard_capacity_((max_nonces + kShards - 1) / kShards)
+        , tick_interval_(std::chrono::seconds(cleanup_interval_seconds)) {
+        const auto start = Clock::now();
+        for (auto& shard : shards_) {
+            shard.expiry.reset(new Wheel(std::chrono::seconds(1), start));
+        }
+        if (cleanup_interval_seconds > 0) {
+            ticker_ = std::thread(&NonceStore::tick_loop, this);
+        }
+    }
+
+    ~NonceStore() {
+        {
+            std::lock_guard<std::mutex> lock(ticker_mutex_);
+            stopping_ = true;
+        }
+        ticker_wake_.notify_all();
+        if (ticker_.joinable()) {
+            ticker_.join();
+        }
     }
-    
-    bool check_and_store(const std::string& nonce) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        nonce_maybe_cleanup(storage_);
-        return nonce_check_and_store(storage_, nonce);
+
+    NonceStore(const NonceStore&) = delete;
+    NonceStore& operator=(const NonceStore&) = delete;
+
+    /**
+     * @return true if the nonce is fresh and now stored; false if it is a
+     *         replay, or the store is full
+     */
+    bool check_and_store(const std::string& nonce, Clock::time_point now = Clock::now()) {
+        Shard& shard = shard_for(nonce);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.nonces.count(nonce) != 0) {
+            return false;  // Replay detected
+        }
+        if (shard.nonces.size() >= shard_capacity_) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // Set nodes never move, so the wheel can point at the stored key
+        const std::string& stored = *shard.nonces.insert(nonce).first;
+        shard.expiry->schedule(now + expiry_, &stored);
+        return true;
     }
-    
+
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return nonce_size(storage_);
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.nonces.size();
+        }
+        return total;
+    }
+
+    /**
+     * Nonces refused because the store was full
+     */
+    size_t overflows() const {
+        return overflows_.load(std::memory_order_relaxed);
     }
-    
-    void cleanup() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        nonce_cleanup(storage_);
+
+    /**
+     * Forget nonces whose expiry has passed by now
+     * @return Number of nonces forgotten
+     */
+    size_t cleanup(Clock::time_point now = Clock::now()) {
+        size_t expired = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            expired += shard.expiry->advance(now, [&shard](const std::string* nonce) {
+                shard.nonces.erase(shard.nonces.find(*nonce));
+            });
+        }
+        return expired;
     }
-    
+
 private:
-    NonceStorage storage_;
-    mutable std::mutex mutex_;
+    static constexpr size_t kShards = 16;
+
+    using Wheel = util::TimingWheel<const std::string*, Clock>;
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<std::string> nonces;
+        std::unique_ptr<Wheel> expiry;
+    };
+
+    Shard& shard_for(const std::string& nonce) {
+        return shards_[std::hash<std::string>{}(nonce) % kShards];
+    }
+
+    void tick_loop() {
+        std::unique_lock<std::mutex> lock(ticker_mutex_);
+        while (!ticker_wake_.wait_for(lock, tick_interval_, [this] { return stopping_; })) {
+            lock.unlock();
+            cleanup();
+            lock.lock();
+        }
+    }
+
+    Clock::duration expiry_;
+    size_t shard_capacity_;
+    std::array<Shard, kShards> shards_;
+    std::atomic<size_t> overflows_{0};
+
+    std::chrono::seconds tick_interval_;
+    std::mutex ticker_mutex_;
+    std::condition_variable ticker_wake_;
+    bool stopping_ = false;
+    std::thread ticker_;
 };
 
 } // namespace dbal::security
@@ -0,0 +1,60 @@
+#pragma once
+/**
+ * @file password_hash.hpp
+ * @brief Memory-hard password hashing (scrypt)
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <openssl/evp.h>
+
+namespace dbal::security {
+
+/**
+ * scrypt cost: each hash takes 128 * block_size * 2^cost_log2 bytes of
+ * memory and about as much time. The default takes 32 MiB and tens of
+ * milliseconds a core; raise cost_log2 by one to double both.
+ */
+struct PasswordHashCost {
+    unsigned cost_log2 = 15;
+    unsigned block_size = 8;
+    unsigned parallelism = 1;
+};
+
+/**
+ * Hash a password with scrypt
+ * @param salt Per-password salt, stored alongside the hash
+ * @return "scrypt$<cost_log2>$<block_size>$<parallelism>$<hex key>", which
+ *         records the cost so hashes made under an older cost still verify
+ * @throws std::runtime_error if the KDF fails (e.g. the cost is out of range)
+ */
+inline std::string password_hash(
+    const std::string& password,
+    const std::string& salt,
+    const PasswordHashCost& cost = {}
+) {
+    constexpr size_t kKeyBytes = 32;
+    unsigned char key[kKeyBytes];
+    const uint64_t n = uint64_t{1} << cost.cost_log2;
+    const uint64_t memory = 128 * uint64_t{cost.block_size} * (n + cost.parallelism + 2);
+
+    if (EVP_PBE_scrypt(
+            password.data(), password.size(),
+            reinterpret_cast<const unsigned char*>(salt.data()), salt.size(),
+            n, cost.block_size, cost.parallelism, memory,
+            key, kKeyBytes) != 1) {
+        throw std::runtime_error("scrypt failed");
+    }
+
+    static const char hex_chars[] = "0123456789abcdef";
+    std::string encoded = "scrypt$" + std::to_string(cost.cost_log2) + "$" +
+                          std::to_string(cost.block_size) + "$" + std::to_string(cost.parallelism) + "$";
+    for (unsigned char byte : key) {
+        encoded += hex_chars[(byte >> 4) & 0x0F];
+        encoded += hex_chars[byte & 0x0F];
+    }
+    return encoded;
+}
+
+} // namespace dbal::security
@@ -0,0 +1,117 @@
+#pragma once
+/**
+ * @file password_hash_pool.hpp
+ * @brief Bounded worker pool for password hashing (thread-safe)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dbal::security {
+
+/**
+ * Runs password hashing jobs on dedicated threads
+ * A memory-hard hash takes tens of milliseconds, which must not be spent
+ * on an I/O thread. Jobs wait in a queue of at most max_queued; submit()
+ * refuses once it is full, so a burst of logins turns into fast 503s
+ * rather than a growing backlog. Jobs run on a worker thread and report
+ * through whatever callback they capture.
+ */
+class PasswordHashPool {
+public:
+    /**
+     * @param workers Hashing threads; zero for one per hardware thread
+     * @param max_queued Jobs that may wait for a worker
+     */
+    explicit PasswordHashPool(size_t workers = 0, size_t max_queued = 256)
+        : max_queued_(max_queued) {
+        if (workers == 0) {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.emplace_back(&PasswordHashPool::run, this);
+        }
+    }
+
+    /**
+     * Runs the jobs still queued, then stops the workers
+     */
+    ~PasswordHashPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    PasswordHashPool(const PasswordHashPool&) = delete;
+    PasswordHashPool& operator=(const PasswordHashPool&) = delete;
+
+    /**
+     * Queue a job
+     * @return false, without running it, when the queue is full
+     */
+    bool submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_ || queue_.size() >= max_queued_) {
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            queue_.push_back(std::move(job));
+        }
+        wake_.notify_one();
+        return true;
+    }
+
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    /**
+     * Jobs refused because the queue was full
+     */
+    size_t rejected() const {
+        return rejected_.load(std::memory_order_relaxed);
+    }
+
+    size_t workers() const {
+        return workers_.size();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            auto job = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+
+    size_t max_queued_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> queue_;
+    bool stopping_ = false;
+    std::atomic<size_t> rejected_{0};
+    std::vector<std::thread> workers_;
+};
+
+} // namespace dbal::security
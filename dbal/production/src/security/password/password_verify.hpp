@@ -0,0 +1,52 @@
+#pragma once
+/**
+ * @file password_verify.hpp
+ * @brief Check a password against a stored scrypt hash
+ */
+
+#include <string>
+#include "password_hash.hpp"
+#include "../crypto/timing_safe_equal.hpp"
+
+namespace dbal::security {
+
+/**
+ * Check a password against a hash from password_hash(), at the cost the
+ * hash records
+ * @return true if it matches; false otherwise, or if stored is not an
+ *         scrypt hash or records a cost above max_cost_log2
+ */
+inline bool password_verify(
+    const std::string& password,
+    const std::string& salt,
+    const std::string& stored,
+    unsigned max_cost_log2 = 24
+) {
+    if (stored.compare(0, 7, "scrypt$") != 0) {
+        return false;
+    }
+    PasswordHashCost cost;
+    unsigned* fields[] = {&cost.cost_log2, &cost.block_size, &cost.parallelism};
+    size_t pos = 7;
+    for (unsigned* field : fields) {
+        const size_t end = stored.find('$', pos);
+        if (end == std::string::npos || end == pos || end - pos > 3) {
+            return false;
+        }
+        *field = 0;
+        for (size_t i = pos; i < end; ++i) {
+            if (stored[i] < '0' || stored[i] > '9') {
+                return false;
+            }
+            *field = *field * 10 + static_cast<unsigned>(stored[i] - '0');
+        }
+        pos = end + 1;
+    }
+    if (cost.cost_log2 < 1 || cost.cost_log2 > max_cost_log2 || cost.block_size == 0 || cost.block_size > 64 ||
+        cost.parallelism == 0 || cost.parallelism > 16) {
+        return false;
+    }
+    return timing_safe_equal(password_hash(password, salt, cost), stored);
+}
+
+} // namespace dbal::security
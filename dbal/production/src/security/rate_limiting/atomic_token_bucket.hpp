@@ -0,0 +1,110 @@
+#pragma once
+/**
+ * @file atomic_token_bucket.hpp
+ * @brief Lock-free token bucket in one 64-bit word
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace dbal::security {
+
+/**
+ * Refill rate and capacity of a token bucket
+ */
+struct RateLimit {
+    double tokens_per_second;
+    double max_tokens;
+};
+
+/**
+ * Throw std::invalid_argument unless limit can back an AtomicTokenBucket:
+ * a positive rate, room for at least one token, and a full refill taking
+ * less than about 146 years
+ */
+inline void check_rate_limit(const RateLimit& limit) {
+    if (!(limit.tokens_per_second > 0) || !(limit.max_tokens >= 1)) {
+        throw std::invalid_argument("Rate limit needs a positive rate and at least one token");
+    }
+    if (!(limit.max_tokens / limit.tokens_per_second * 1e9 < 4.6e18) || 1e9 / limit.tokens_per_second < 1) {
+        throw std::invalid_argument("Rate limit out of range");
+    }
+}
+
+/**
+ * Token bucket updated with compare-and-swap
+ *
+ * Kept as the generic cell rate algorithm: the word holds the time, in
+ * nanoseconds from the owner's epoch, at which the bucket will be full
+ * again. Taking a token pushes that time one refill interval later, and
+ * is refused when it would land more than a full refill past now. The
+ * tokens left are how far that time is from a full refill away.
+ * Sixty-four bit nanoseconds do not wrap for centuries, so a bucket left
+ * alone for any length of time is simply full. Limits must pass
+ * check_rate_limit().
+ */
+class AtomicTokenBucket {
+public:
+    /**
+     * A full bucket as of now_ns
+     */
+    explicit AtomicTokenBucket(int64_t now_ns) : full_at_(now_ns) {}
+
+    /**
+     * Refill up to now_ns and take one token
+     * @return false, changing nothing, when less than one is left
+     */
+    bool try_take(const RateLimit& limit, int64_t now_ns) {
+        const int64_t interval = interval_ns(limit);
+        const int64_t burst = burst_ns(limit);
+        int64_t old = full_at_.load(std::memory_order_relaxed);
+        for (;;) {
+            // A now_ns behind another thread's update just finds less refilled
+            const int64_t full_at = std::max(old, now_ns) + interval;
+            if (full_at - now_ns > burst) {
+                return false;
+            }
+            if (full_at_.compare_exchange_weak(old, full_at, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Give back a token taken by try_take()
+     */
+    void refund(const RateLimit& limit) {
+        full_at_.fetch_sub(interval_ns(limit), std::memory_order_acq_rel);
+    }
+
+    double remaining(const RateLimit& limit, int64_t now_ns) const {
+        const int64_t full_at = std::max(full_at_.load(std::memory_order_relaxed), now_ns);
+        const double left = static_cast<double>(burst_ns(limit) - (full_at - now_ns)) / interval_ns(limit);
+        return std::clamp(left, 0.0, limit.max_tokens);
+    }
+
+    /**
+     * True when the bucket has been full for idle_ns, so nothing has
+     * taken from it since and dropping it changes nothing a later
+     * request would see
+     */
+    bool idle(int64_t now_ns, int64_t idle_ns) const {
+        return full_at_.load(std::memory_order_relaxed) <= now_ns - idle_ns;
+    }
+
+private:
+    static int64_t interval_ns(const RateLimit& limit) {
+        return std::llround(1e9 / limit.tokens_per_second);
+    }
+
+    static int64_t burst_ns(const RateLimit& limit) {
+        return std::llround(limit.max_tokens * 1e9 / limit.tokens_per_second);
+    }
+
+    std::atomic<int64_t> full_at_;
+};
+
+} // namespace dbal::security
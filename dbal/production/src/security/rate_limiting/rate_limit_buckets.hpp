@@ -0,0 +1,139 @@
+#pragma once
+/**
+ * @file rate_limit_buckets.hpp
+ * @brief Sharded map of token buckets, one per key
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "atomic_token_bucket.hpp"
+
+namespace dbal::security {
+
+/**
+ * Token buckets keyed by client, sharded by key hash
+ *
+ * Taking a token only holds its shard's lock shared: the bucket itself is
+ * updated with compare-and-swap, so requests for different keys, and for
+ * the same key, proceed in parallel. The exclusive lock is taken to add
+ * a key the first time it is seen and to evict idle buckets.
+ */
+class RateLimitBuckets {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @throws std::invalid_argument when limit fails check_rate_limit()
+     */
+    RateLimitBuckets(const RateLimit& limit, Clock::time_point epoch)
+        : limit_(limit), epoch_(epoch) {
+        check_rate_limit(limit_);
+    }
+
+    bool try_take(const std::string& key, Clock::time_point now) {
+        const int64_t now_ns = to_ns(now);
+        Shard& shard = shard_for(key);
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.buckets.find(key);
+            if (it != shard.buckets.end()) {
+                return it->second.try_take(limit_, now_ns);
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.buckets.try_emplace(key, now_ns).first;
+        return it->second.try_take(limit_, now_ns);
+    }
+
+    /**
+     * Give back a token taken for key; nothing if its bucket is gone
+     */
+    void refund(const std::string& key) {
+        Shard& shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.buckets.find(key);
+        if (it != shard.buckets.end()) {
+            it->second.refund(limit_);
+        }
+    }
+
+    double remaining(const std::string& key, Clock::time_point now) const {
+        const Shard& shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.buckets.find(key);
+        if (it == shard.buckets.end()) {
+            return limit_.max_tokens;
+        }
+        return it->second.remaining(limit_, to_ns(now));
+    }
+
+    void erase(const std::string& key) {
+        Shard& shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.buckets.erase(key);
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            total += shard.buckets.size();
+        }
+        return total;
+    }
+
+    /**
+     * Drop buckets that have been full for idle_after
+     * @return Number of buckets dropped
+     */
+    size_t evict_idle(Clock::time_point now, std::chrono::milliseconds idle_after) {
+        const int64_t now_ns = to_ns(now);
+        const int64_t idle_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(idle_after).count();
+        size_t evicted = 0;
+        for (auto& shard : shards_) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            for (auto it = shard.buckets.begin(); it != shard.buckets.end();) {
+                if (it->second.idle(now_ns, idle_ns)) {
+                    it = shard.buckets.erase(it);
+                    ++evicted;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return evicted;
+    }
+
+private:
+    static constexpr size_t kShards = 64;
+
+    // Own cache line each, so shards locked by different threads do not contend
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, AtomicTokenBucket> buckets;
+    };
+
+    Shard& shard_for(const std::string& key) {
+        return shards_[std::hash<std::string>{}(key) % kShards];
+    }
+
+    const Shard& shard_for(const std::string& key) const {
+        return shards_[std::hash<std::string>{}(key) % kShards];
+    }
+
+    int64_t to_ns(Clock::time_point now) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch_).count();
+    }
+
+    RateLimit limit_;
+    Clock::time_point epoch_;
+    std::array<Shard, kShards> shards_;
+};
+
+} // namespace dbal::security
@@ -0,0 +1,60 @@
+#pragma once
+/**
+ * @file rate_limit_sweeper.hpp
+ * @brief Background thread evicting idle rate limit buckets
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace dbal::security {
+
+/**
+ * Calls sweep every interval from its own thread until destroyed
+ * An interval of zero starts no thread; the owner sweeps by hand.
+ */
+class RateLimitSweeper {
+public:
+    RateLimitSweeper(std::chrono::milliseconds interval, std::function<void()> sweep)
+        : interval_(interval), sweep_(std::move(sweep)) {
+        if (interval_.count() > 0) {
+            thread_ = std::thread(&RateLimitSweeper::run, this);
+        }
+    }
+
+    ~RateLimitSweeper() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    RateLimitSweeper(const RateLimitSweeper&) = delete;
+    RateLimitSweeper& operator=(const RateLimitSweeper&) = delete;
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, interval_, [this] { return stopping_; })) {
+            lock.unlock();
+            sweep_();
+            lock.lock();
+        }
+    }
+
+    std::chrono::milliseconds interval_;
+    std::function<void()> sweep_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace dbal::security
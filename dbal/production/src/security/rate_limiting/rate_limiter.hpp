@@ -4,47 +4,67 @@
  * @brief Token bucket rate limiter (thread-safe wrapper)
  */
 
+#include <chrono>
 #include <string>
-#include <unordered_map>
-#include <mutex>
-#include "rate_limit_try_acquire.hpp"
-#include "rate_limit_remaining.hpp"
+#include "rate_limit_buckets.hpp"
+#include "rate_limit_sweeper.hpp"
 
 namespace dbal::security {
 
 /**
- * Thread-safe token bucket rate limiter
- * Wraps individual rate limit functions with mutex protection
+ * Thread-safe token bucket rate limiter, one bucket per key
+ * Buckets are lock-free and sharded (see RateLimitBuckets); a background
+ * sweep drops buckets of keys that have gone quiet, so the limiter holds
+ * only the clients seen recently.
  */
 class RateLimiter {
 public:
-    RateLimiter(double tokens_per_second, double max_tokens)
-        : tokens_per_second_(tokens_per_second)
-        , max_tokens_(max_tokens)
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param idle_after How long a key's bucket stays full before it may be dropped
+     * @throws std::invalid_argument when the limit fails check_rate_limit()
+     * @param sweep_interval How often idle buckets are swept; zero sweeps only on evict_idle()
+     */
+    RateLimiter(double tokens_per_second, double max_tokens,
+                std::chrono::milliseconds idle_after = std::chrono::minutes(10),
+                std::chrono::milliseconds sweep_interval = std::chrono::seconds(30))
+        : buckets_(RateLimit{tokens_per_second, max_tokens}, Clock::now())
+        , idle_after_(idle_after)
+        , sweeper_(sweep_interval, [this] { evict_idle(Clock::now()); })
     {}
-    
-    bool try_acquire(const std::string& key) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return rate_limit_try_acquire(buckets_[key], tokens_per_second_, max_tokens_);
+
+    bool try_acquire(const std::string& key, Clock::time_point now = Clock::now()) {
+        return buckets_.try_take(key, now);
+    }
+
+    /**
+     * Give back a token from try_acquire(), e.g. for a request later rejected elsewhere
+     */
+    void refund(const std::string& key) {
+        buckets_.refund(key);
     }
-    
-    double remaining(const std::string& key) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = buckets_.find(key);
-        if (it == buckets_.end()) return max_tokens_;
-        return rate_limit_remaining(it->second, max_tokens_);
+
+    double remaining(const std::string& key, Clock::time_point now = Clock::now()) const {
+        return buckets_.remaining(key, now);
     }
-    
+
     void reset(const std::string& key) {
-        std::lock_guard<std::mutex> lock(mutex_);
         buckets_.erase(key);
     }
-    
+
+    size_t size() const {
+        return buckets_.size();
+    }
+
+    size_t evict_idle(Clock::time_point now) {
+        return buckets_.evict_idle(now, idle_after_);
+    }
+
 private:
-    double tokens_per_second_;
-    double max_tokens_;
-    std::unordered_map<std::string, TokenBucket> buckets_;
-    std::mutex mutex_;
+    RateLimitBuckets buckets_;
+    std::chrono::milliseconds idle_after_;
+    RateLimitSweeper sweeper_;  // Last: stops before the buckets go
 };
 
 } // namespace dbal::security
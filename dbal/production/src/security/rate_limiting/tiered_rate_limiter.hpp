@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * @file tiered_rate_limiter.hpp
+ * @brief Per-IP, per-tenant and global rate limits checked together
+ */
+
+#include <chrono>
+#include <string>
+#include "rate_limit_buckets.hpp"
+#include "rate_limit_sweeper.hpp"
+
+namespace dbal::security {
+
+/**
+ * The limit a request ran into, if any
+ */
+enum class RateLimitTier {
+    None,
+    Ip,
+    Tenant,
+    Global
+};
+
+/**
+ * Thread-safe limiter applying a client IP, a tenant and a global limit
+ * A request takes one token from each tier, narrowest first. When a tier
+ * refuses, the tokens already taken from narrower tiers are given back,
+ * so a request is either counted against all three or against none.
+ */
+class TieredRateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param idle_after How long an IP or tenant bucket stays full before it may be dropped
+     * @throws std::invalid_argument when a limit fails check_rate_limit()
+     * @param sweep_interval How often idle buckets are swept; zero sweeps only on evict_idle()
+     */
+    TieredRateLimiter(const RateLimit& per_ip, const RateLimit& per_tenant, const RateLimit& global,
+                      std::chrono::milliseconds idle_after = std::chrono::minutes(10),
+                      std::chrono::milliseconds sweep_interval = std::chrono::seconds(30))
+        : epoch_(Clock::now())
+        , ip_(per_ip, epoch_)
+        , tenant_(per_tenant, epoch_)
+        , global_limit_(global)
+        , global_(0)
+        , idle_after_(idle_after)
+        , sweeper_(sweep_interval, [this] { evict_idle(Clock::now()); })
+    {
+        check_rate_limit(global_limit_);
+    }
+
+    /**
+     * Take a token for a request
+     * @param tenant Empty for requests outside any tenant, which skip that tier
+     * @return RateLimitTier::None if allowed, else the tier that refused
+     */
+    RateLimitTier try_acquire(const std::string& ip, const std::string& tenant,
+                              Clock::time_point now = Clock::now()) {
+        if (!ip_.try_take(ip, now)) {
+            return RateLimitTier::Ip;
+        }
+        if (!tenant.empty() && !tenant_.try_take(tenant, now)) {
+            ip_.refund(ip);
+            return RateLimitTier::Tenant;
+        }
+        const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch_).count();
+        if (!global_.try_take(global_limit_, now_ns)) {
+            if (!tenant.empty()) {
+                tenant_.refund(tenant);
+            }
+            ip_.refund(ip);
+            return RateLimitTier::Global;
+        }
+        return RateLimitTier::None;
+    }
+
+    /**
+     * Buckets held for IPs and tenants
+     */
+    size_t size() const {
+        return ip_.size() + tenant_.size();
+    }
+
+    size_t evict_idle(Clock::time_point now) {
+        return ip_.evict_idle(now, idle_after_) + tenant_.evict_idle(now, idle_after_);
+    }
+
+private:
+    Clock::time_point epoch_;
+    RateLimitBuckets ip_;
+    RateLimitBuckets tenant_;
+    RateLimit global_limit_;
+    AtomicTokenBucket global_;
+    std::chrono::milliseconds idle_after_;
+    RateLimitSweeper sweeper_;  // Last: stops before the buckets go
+};
+
+} // namespace dbal::security
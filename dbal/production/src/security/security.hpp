@@ -14,6 +14,10 @@
  *   dbal::security::RateLimiter limiter(100, 200);
  *   if (!limiter.try_acquire(client_ip)) { return 429; }
  *   
+ *   // Or limit per IP, per tenant and globally in one call
+ *   dbal::security::TieredRateLimiter tiers({10, 20}, {100, 200}, {1000, 2000});
+ *   if (tiers.try_acquire(client_ip, tenant_id) != dbal::security::RateLimitTier::None) { return 429; }
+ *   
  *   // Or use functions directly
  *   dbal::security::TokenBucket bucket;
  *   if (!dbal::security::rate_limit_try_acquire(bucket, 100, 200)) { return 429; }
@@ -26,6 +30,10 @@
 #include "hmac_sha256.hpp"
 #include "timing_safe_equal.hpp"
 
+// Password hashing
+#include "password_hash.hpp"
+#include "password_verify.hpp"
+
 // Path security
 #include "validate_path.hpp"
 #include "is_safe_filename.hpp"
@@ -47,6 +55,7 @@
 // Rate limiting functions
 #include "rate_limit_try_acquire.hpp"
 #include "rate_limit_remaining.hpp"
+#include "atomic_token_bucket.hpp"
 
 // Nonce functions
 #include "nonce_check_and_store.hpp"
@@ -56,5 +65,7 @@
 
 // Thread-safe wrappers (use these for convenience)
 #include "rate_limiter.hpp"
+#include "tiered_rate_limiter.hpp"
+#include "password_hash_pool.hpp"
 #include "nonce_store.hpp"
 
@@ -0,0 +1,75 @@
+/**
+ * @file component_tree_cache.hpp
+ * @brief Per-page cache of flattened component trees
+ *
+ * Trees are built on first read and dropped by any component write on
+ * their page. Readers hold the Components partition shared while they
+ * build and publish, and writers hold it exclusively while they
+ * invalidate, so a published tree always matches the store. Concurrent
+ * readers may race to build the same tree; the shard mutex only guards the
+ * map itself. Snapshots are immutable, so a reader may keep one after the
+ * page changes.
+ */
+#ifndef DBAL_COMPONENT_TREE_CACHE_HPP
+#define DBAL_COMPONENT_TREE_CACHE_HPP
+
+#include "dbal/types.hpp"
+#include <array>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace dbal {
+
+class ComponentTreeCache {
+public:
+    using Snapshot = ComponentTreeSnapshot;
+
+    Snapshot find(const std::string& pageId) const {
+        Shard& shard = shardFor(pageId);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        auto it = shard.trees.find(pageId);
+        return it == shard.trees.end() ? nullptr : it->second;
+    }
+
+    void publish(const std::string& pageId, Snapshot tree) const {
+        Shard& shard = shardFor(pageId);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        shard.trees.emplace(pageId, std::move(tree));
+    }
+
+    /**
+     * Drop a page's tree; called by every write to its components
+     */
+    void invalidate(const std::string& pageId) {
+        Shard& shard = shardFor(pageId);
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        shard.trees.erase(pageId);
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            shard.trees.clear();
+        }
+    }
+
+private:
+    static constexpr size_t kShards = 16;
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Snapshot> trees;
+    };
+
+    Shard& shardFor(const std::string& pageId) const {
+        return shards_[std::hash<std::string>{}(pageId) % kShards];
+    }
+
+    mutable std::array<Shard, kShards> shards_;
+};
+
+} // namespace dbal
+
+#endif
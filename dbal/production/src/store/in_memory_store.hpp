@@ -1,20 +1,174 @@
 /**
  * @file in_memory_store.hpp
  * @brief In-memory data store for mock implementation
- * 
+ *
  * Centralized storage for all entity types with thread-safe counters.
+ * Collections are grouped into lock partitions (one per entity family),
+ * and each partition's lock is striped by key hash so concurrent readers
+ * do not contend on a single reader count. See store_lock.hpp.
  */
 #ifndef DBAL_IN_MEMORY_STORE_HPP
 #define DBAL_IN_MEMORY_STORE_HPP
 
+#include <array>
+#include <atomic>
 #include <map>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <cstdio>
 #include "dbal/types.hpp"
+#include "secondary_index.hpp"
+#include "sort_index.hpp"
+#include "ngram_index.hpp"
+#include "component_tree_cache.hpp"
+#include "undo_log.hpp"
 
 namespace dbal {
 
+/**
+ * Lock partitions of the store. Each partition guards the entity
+ * collection of the same name plus its secondary indexes.
+ *
+ * The enum order is the global lock acquisition order.
+ */
+enum class StorePartition : size_t {
+    Users = 0,
+    Credentials,
+    Pages,
+    Components,
+    Workflows,
+    Sessions,
+    Packages,
+};
+
+constexpr size_t kStorePartitionCount = 7;
+constexpr size_t kStoreLockStripes = 16;
+
+/**
+ * One reader/writer lock stripe, padded to its own cache line
+ */
+struct alignas(64) StoreLockStripe {
+    std::shared_mutex mutex;
+};
+
+/**
+ * Striped reader/writer lock guarding one partition.
+ * Readers take a single stripe shared; writers take every stripe.
+ */
+struct StorePartitionLock {
+    std::array<StoreLockStripe, kStoreLockStripes> stripes;
+};
+
+/**
+ * Partition guarding the collection of Record
+ */
+template<typename Record>
+constexpr StorePartition partitionOf() {
+    if constexpr (std::is_same_v<Record, User>) {
+        return StorePartition::Users;
+    } else if constexpr (std::is_same_v<Record, Credential>) {
+        return StorePartition::Credentials;
+    } else if constexpr (std::is_same_v<Record, PageConfig>) {
+        return StorePartition::Pages;
+    } else if constexpr (std::is_same_v<Record, ComponentNode>) {
+        return StorePartition::Components;
+    } else if constexpr (std::is_same_v<Record, Workflow>) {
+        return StorePartition::Workflows;
+    } else if constexpr (std::is_same_v<Record, Session>) {
+        return StorePartition::Sessions;
+    } else {
+        static_assert(std::is_same_v<Record, InstalledPackage>, "not a store record");
+        return StorePartition::Packages;
+    }
+}
+
+struct InMemoryStore;
+
+/**
+ * Receives every write made to a store, for durability (see
+ * write_ahead_log.hpp)
+ */
+class StoreJournal {
+public:
+    virtual ~StoreJournal() = default;
+
+    /**
+     * id in partition is about to be created, changed or erased. Called
+     * with the partition held exclusively.
+     */
+    virtual void touched(StorePartition partition, const std::string& id) = 0;
+
+    /**
+     * A StoreLock is about to release the partitions in exclusive (a bit
+     * per StorePartition), still holding them; the records touched under
+     * them are now final.
+     */
+    virtual void commit(const InMemoryStore& store, unsigned exclusive) noexcept = 0;
+};
+
+/**
+ * Fills partitions of a store on first use, so a large store can start
+ * serving before all of it is in memory (see store_snapshot.hpp)
+ */
+class StoreLoader {
+public:
+    virtual ~StoreLoader() = default;
+
+    /**
+     * True until partition has been loaded
+     */
+    bool pending(StorePartition partition) const {
+        return pending_[static_cast<size_t>(partition)].load(std::memory_order_acquire);
+    }
+
+    /**
+     * Load partition if it is still pending. StoreLock calls this with
+     * the partition held exclusively, before it first hands it out.
+     */
+    void load(StorePartition partition) {
+        if (pending(partition)) {
+            materialize(partition);
+            pending_[static_cast<size_t>(partition)].store(false, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Read one record of a pending partition without loading it, for point
+     * reads that should not wait for the whole partition
+     * @returns false when the loader cannot answer and the partition must
+     *          be loaded instead; otherwise found holds the record, or is
+     *          empty when there is none
+     */
+    virtual bool peek(const std::string& id, std::optional<User>& found) {
+        (void)id;
+        (void)found;
+        return false;
+    }
+
+    virtual bool peek(const std::string& id, std::optional<PageConfig>& found) {
+        (void)id;
+        (void)found;
+        return false;
+    }
+
+protected:
+    void markPending(StorePartition partition) {
+        pending_[static_cast<size_t>(partition)].store(true, std::memory_order_release);
+    }
+
+    /**
+     * Insert partition's records and index entries; throws when they
+     * cannot be read, leaving the partition pending
+     */
+    virtual void materialize(StorePartition partition) = 0;
+
+private:
+    std::array<std::atomic<bool>, kStorePartitionCount> pending_{};
+};
+
 /**
  * In-memory store containing all entity collections and ID mappings
  */
@@ -26,26 +180,71 @@ struct InMemoryStore {
     std::map<std::string, Session> sessions;
     std::map<std::string, InstalledPackage> packages;
     std::map<std::string, Credential> credentials;
-    
+
     // Secondary indexes (unique field -> id mappings)
     std::map<std::string, std::string> page_paths;      // path -> id
     std::map<std::string, std::string> workflow_names;  // name -> id
     std::map<std::string, std::string> session_tokens;  // token -> id
     std::map<std::string, std::string> package_keys;    // packageId -> id
-    
+    std::map<std::string, std::string> user_names;      // scoped (tenant, username) -> id
+    std::map<std::string, std::string> user_emails;     // scoped (tenant, email) -> id
+
+    // Secondary indexes (non-unique field -> ids), kept in step on every write
+    SecondaryIndex users_by_tenant;
+    SecondaryIndex users_by_role;
+    SecondaryIndex pages_by_tenant;
+    SecondaryIndex pages_by_package;
+    SecondaryIndex workflows_by_tenant;
+    SecondaryIndex packages_by_tenant;
+
+    // Sort indexes ((key, id) order) for keyset pagination on sorted lists.
+    // Timestamp keys use query::timestampKey.
+    SortIndex users_by_username;
+    SortIndex users_by_tenant_username;  // scoped by tenant; see SortIndex::scopedKey
+    SortIndex pages_by_title;
+    SortIndex pages_by_created;
+    SortIndex workflows_by_name;
+    SortIndex workflows_by_created;
+    SortIndex sessions_by_created;
+    SortIndex sessions_by_expires;
+    SortIndex packages_by_installed;
+
+    // Text search indexes over (username, email) and (title, path)
+    NgramIndex users_by_text;
+    NgramIndex pages_by_text;
+
     // Entity counters for ID generation
-    int user_counter = 0;
-    int page_counter = 0;
-    int workflow_counter = 0;
-    int session_counter = 0;
-    int package_counter = 0;
-    int credential_counter = 0;
-    
+    std::atomic<int> user_counter{0};
+    std::atomic<int> page_counter{0};
+    std::atomic<int> workflow_counter{0};
+    std::atomic<int> session_counter{0};
+    std::atomic<int> package_counter{0};
+    std::atomic<int> credential_counter{0};
+
     std::map<std::string, ComponentNode> components;
     std::map<std::string, std::vector<std::string>> components_by_page;
     std::map<std::string, std::vector<std::string>> components_by_parent;
-    int component_counter = 0;
-    
+    std::atomic<int> component_counter{0};
+
+    // Flattened trees per page, built by readers and dropped by component writes
+    ComponentTreeCache component_trees;
+
+    // Set while an atomic batch runs; see remember()
+    StoreUndoLog* undo_log = nullptr;
+
+    // Set for the store's lifetime when it is persisted; see remember()
+    StoreJournal* journal = nullptr;
+
+    // Set while some partitions are still on disk; see StoreLock
+    StoreLoader* loader = nullptr;
+
+    // Striped reader/writer lock per partition (indexed by StorePartition)
+    mutable std::array<StorePartitionLock, kStorePartitionCount> partition_locks;
+
+    InMemoryStore() = default;
+    InMemoryStore(const InMemoryStore&) = delete;
+    InMemoryStore& operator=(const InMemoryStore&) = delete;
+
     /**
      * Generate a unique ID with prefix
      */
@@ -54,9 +253,114 @@ struct InMemoryStore {
         snprintf(buffer, sizeof(buffer), "%s_%08d", prefix.c_str(), counter);
         return std::string(buffer);
     }
-    
+
+    /**
+     * ID counter of a partition's entity type
+     */
+    std::atomic<int>& counterFor(StorePartition partition) {
+        switch (partition) {
+            case StorePartition::Users: return user_counter;
+            case StorePartition::Credentials: return credential_counter;
+            case StorePartition::Pages: return page_counter;
+            case StorePartition::Components: return component_counter;
+            case StorePartition::Workflows: return workflow_counter;
+            case StorePartition::Sessions: return session_counter;
+            case StorePartition::Packages: return package_counter;
+        }
+        return user_counter;
+    }
+
+    const std::atomic<int>& counterFor(StorePartition partition) const {
+        return const_cast<InMemoryStore*>(this)->counterFor(partition);
+    }
+
+    /**
+     * Record id's current state in the undo log and tell the journal it
+     * is about to change, for whichever is attached. Entity operations
+     * call this before they create, change or erase id.
+     */
+    template<typename Record>
+    void remember(const std::map<std::string, Record>& collection, const std::string& id) {
+        // Credentials are never written by batches, so they have no undo images
+        if constexpr (!std::is_same_v<Record, Credential>) {
+            if (undo_log) {
+                undo_log->remember(collection, id);
+            }
+        }
+        if (journal) {
+            journal->touched(partitionOf<Record>(), id);
+        }
+    }
+
+    /**
+     * Call fn with the record collection of partition
+     */
+    template<typename Store, typename Fn>
+    static void withCollection(Store& store, StorePartition partition, Fn&& fn) {
+        switch (partition) {
+            case StorePartition::Users: fn(store.users); break;
+            case StorePartition::Credentials: fn(store.credentials); break;
+            case StorePartition::Pages: fn(store.pages); break;
+            case StorePartition::Components: fn(store.components); break;
+            case StorePartition::Workflows: fn(store.workflows); break;
+            case StorePartition::Sessions: fn(store.sessions); break;
+            case StorePartition::Packages: fn(store.packages); break;
+        }
+    }
+
+    /**
+     * Call fn with every index of partition, in a fixed order that
+     * snapshots rely on. Caches rebuilt on demand are not indexes.
+     */
+    template<typename Store, typename Fn>
+    static void forEachIndex(Store& store, StorePartition partition, Fn&& fn) {
+        switch (partition) {
+            case StorePartition::Users:
+                fn(store.user_names);
+                fn(store.user_emails);
+                fn(store.users_by_tenant);
+                fn(store.users_by_role);
+                fn(store.users_by_username);
+                fn(store.users_by_tenant_username);
+                fn(store.users_by_text);
+                break;
+            case StorePartition::Credentials:
+                break;
+            case StorePartition::Pages:
+                fn(store.page_paths);
+                fn(store.pages_by_tenant);
+                fn(store.pages_by_package);
+                fn(store.pages_by_title);
+                fn(store.pages_by_created);
+                fn(store.pages_by_text);
+                break;
+            case StorePartition::Components:
+                fn(store.components_by_page);
+                fn(store.components_by_parent);
+                break;
+            case StorePartition::Workflows:
+                fn(store.workflow_names);
+                fn(store.workflows_by_tenant);
+                fn(store.workflows_by_name);
+                fn(store.workflows_by_created);
+                break;
+            case StorePartition::Sessions:
+                fn(store.session_tokens);
+                fn(store.sessions_by_created);
+                fn(store.sessions_by_expires);
+                break;
+            case StorePartition::Packages:
+                fn(store.package_keys);
+                fn(store.packages_by_tenant);
+                fn(store.packages_by_installed);
+                break;
+        }
+    }
+
     /**
      * Clear all data from the store
+     *
+     * Caller must hold every partition exclusively.
      */
     void clear() {
         users.clear();
@@ -68,11 +372,31 @@ struct InMemoryStore {
         session_tokens.clear();
         packages.clear();
         package_keys.clear();
+        user_names.clear();
+        user_emails.clear();
+        users_by_tenant.clear();
+        users_by_role.clear();
+        pages_by_tenant.clear();
+        pages_by_package.clear();
+        workflows_by_tenant.clear();
+        packages_by_tenant.clear();
+        users_by_username.clear();
+        users_by_tenant_username.clear();
+        pages_by_title.clear();
+        pages_by_created.clear();
+        workflows_by_name.clear();
+        workflows_by_created.clear();
+        sessions_by_created.clear();
+        sessions_by_expires.clear();
+        packages_by_installed.clear();
+        users_by_text.clear();
+        pages_by_text.clear();
         credentials.clear();
         components.clear();
         components_by_page.clear();
         components_by_parent.clear();
-        
+        component_trees.clear();
+
         user_counter = 0;
         page_counter = 0;
         workflow_counter = 0;
@@ -83,14 +407,6 @@ struct InMemoryStore {
     }
 };
 
-/**
- * Get singleton instance of the in-memory store
- */
-inline InMemoryStore& getStore() {
-    static InMemoryStore store;
-    return store;
-}
-
 } // namespace dbal
 
 #endif
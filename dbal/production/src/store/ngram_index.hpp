@@ -0,0 +1,321 @@
+/**
+ * @file ngram_index.hpp
+ * @brief Inverted n-gram index for case-insensitive substring search
+ *
+ * Each document is a short list of text fields, stored lowercased. Every
+ * 1-, 2- and 3-byte gram of those fields maps to a sorted posting list of
+ * document numbers. A query no longer than three bytes is answered by its
+ * own posting list; a longer one intersects the lists of its trigrams and
+ * verifies the survivors against the stored text. Entity operations keep
+ * the index in step on every create/update/delete, like SecondaryIndex.
+ *
+ * Building the posting lists is the slowest part of loading a large
+ * store, so a loader may deferPostings() and insert documents only; the
+ * first search then builds every list in one pass, under an internal
+ * lock, since readers hold no more than a shared partition lock.
+ */
+#ifndef DBAL_NGRAM_INDEX_HPP
+#define DBAL_NGRAM_INDEX_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace dbal {
+
+class NgramIndex {
+public:
+    static constexpr size_t kMaxGram = 3;
+
+    /**
+     * Index id under fields, replacing whatever it was indexed under before.
+     * Fields are given in rank order: a match in an earlier field ranks
+     * higher than one in a later field.
+     */
+    void insert(const std::string& id, const std::vector<std::string>& fields) {
+        erase(id);
+        uint32_t doc;
+        if (!free_.empty()) {
+            doc = free_.back();
+            free_.pop_back();
+        } else {
+            doc = static_cast<uint32_t>(docs_.size());
+            docs_.emplace_back();
+        }
+        Doc& entry = docs_[doc];
+        entry.id = id;
+        entry.fields.clear();
+        for (const auto& field : fields) {
+            entry.fields.push_back(lowered(field));
+        }
+        doc_of_[id] = doc;
+
+        if (deferred_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        for (uint32_t gram : grams(entry.fields)) {
+            auto& postings = postings_[gram];
+            // Fresh doc numbers are the largest, so this is usually an append
+            postings.insert(std::lower_bound(postings.begin(), postings.end(), doc), doc);
+        }
+    }
+
+    void erase(const std::string& id) {
+        auto it = doc_of_.find(id);
+        if (it == doc_of_.end()) {
+            return;
+        }
+        const uint32_t doc = it->second;
+        Doc& entry = docs_[doc];
+        if (!deferred_.load(std::memory_order_relaxed)) {
+            for (uint32_t gram : grams(entry.fields)) {
+                auto postings = postings_.find(gram);
+                if (postings == postings_.end()) {
+                    continue;
+                }
+                auto& list = postings->second;
+                auto pos = std::lower_bound(list.begin(), list.end(), doc);
+                if (pos != list.end() && *pos == doc) {
+                    list.erase(pos);
+                }
+                if (list.empty()) {
+                    postings_.erase(postings);
+                }
+            }
+        }
+        entry.id.clear();
+        entry.fields.clear();
+        free_.push_back(doc);
+        doc_of_.erase(it);
+    }
+
+    /**
+     * Re-index id if any of its fields changed
+     */
+    void update(const std::string& id, const std::vector<std::string>& fields) {
+        auto it = doc_of_.find(id);
+        if (it != doc_of_.end()) {
+            const auto& current = docs_[it->second].fields;
+            bool same = current.size() == fields.size();
+            for (size_t i = 0; same && i < fields.size(); ++i) {
+                same = current[i] == lowered(fields[i]);
+            }
+            if (same) {
+                return;
+            }
+        }
+        insert(id, fields);
+    }
+
+    /**
+     * Ids of documents with a field containing query, case-insensitively,
+     * best match first: a prefix of an earlier field beats a prefix of a
+     * later one, which beats a match further in; ties go to the shorter
+     * field, then to id order. A positive limit keeps only the top hits.
+     */
+    std::vector<std::string> search(const std::string& query, int limit) const {
+        buildPostings();
+        std::vector<std::string> ids;
+        const std::string needle = lowered(query);
+        if (needle.empty()) {
+            return ids;
+        }
+
+        std::vector<const std::vector<uint32_t>*> lists;
+        if (needle.size() <= kMaxGram) {
+            lists.push_back(find(pack(needle.data(), needle.size())));
+        } else {
+            for (size_t i = 0; i + kMaxGram <= needle.size(); ++i) {
+                lists.push_back(find(pack(needle.data() + i, kMaxGram)));
+            }
+        }
+        for (const auto* list : lists) {
+            if (!list) {
+                return ids;
+            }
+        }
+        std::sort(lists.begin(), lists.end(),
+                  [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+        std::vector<uint32_t> candidates = *lists.front();
+        std::vector<uint32_t> narrowed;
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+            if (lists[i] == lists[i - 1]) {
+                continue;  // repeated trigram
+            }
+            narrowed.clear();
+            std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                                  std::back_inserter(narrowed));
+            candidates.swap(narrowed);
+        }
+
+        // (rank, field length, doc) for every verified candidate
+        using Ranked = std::tuple<size_t, size_t, uint32_t>;
+        std::vector<Ranked> hits;
+        hits.reserve(candidates.size());
+        for (uint32_t doc : candidates) {
+            const Doc& entry = docs_[doc];
+            size_t best = SIZE_MAX;
+            size_t length = 0;
+            for (size_t f = 0; f < entry.fields.size(); ++f) {
+                const size_t at = entry.fields[f].find(needle);
+                if (at == std::string::npos) {
+                    continue;
+                }
+                const size_t rank = at == 0 ? f : entry.fields.size() + f;
+                if (rank < best) {
+                    best = rank;
+                    length = entry.fields[f].size();
+                }
+            }
+            if (best != SIZE_MAX) {
+                hits.emplace_back(best, length, doc);
+            }
+        }
+
+        const auto better = [this](const Ranked& a, const Ranked& b) {
+            if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) < std::get<0>(b);
+            if (std::get<1>(a) != std::get<1>(b)) return std::get<1>(a) < std::get<1>(b);
+            return docs_[std::get<2>(a)].id < docs_[std::get<2>(b)].id;
+        };
+        const size_t kept = limit > 0 ? std::min(hits.size(), static_cast<size_t>(limit)) : hits.size();
+        std::partial_sort(hits.begin(), hits.begin() + kept, hits.end(), better);
+
+        ids.reserve(kept);
+        for (size_t i = 0; i < kept; ++i) {
+            ids.push_back(docs_[std::get<2>(hits[i])].id);
+        }
+        return ids;
+    }
+
+    size_t size() const {
+        return doc_of_.size();
+    }
+
+    /**
+     * Visit every document as (id, lowercased fields), in no particular order
+     */
+    template<typename Visitor>
+    void forEachDoc(Visitor&& visit) const {
+        for (const auto& [id, doc] : doc_of_) {
+            visit(id, docs_[doc].fields);
+        }
+    }
+
+    /**
+     * Drop the posting lists and stop maintaining them until the next
+     * search rebuilds them from the documents, so that inserting a large
+     * batch of documents only stores them
+     */
+    void deferPostings() {
+        postings_.clear();
+        deferred_.store(true, std::memory_order_release);
+    }
+
+    void clear() {
+        deferred_.store(false, std::memory_order_relaxed);
+        docs_.clear();
+        free_.clear();
+        doc_of_.clear();
+        postings_.clear();
+    }
+
+private:
+    struct Doc {
+        std::string id;
+        std::vector<std::string> fields;  // lowercased
+    };
+
+    // ASCII only, as std::tolower is in the "C" locale the store runs in,
+    // but without a library call per byte
+    static std::string lowered(const std::string& value) {
+        std::string out(value);
+        for (char& c : out) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return out;
+    }
+
+    // Length in the top byte keeps grams of different lengths apart
+    static uint32_t pack(const char* bytes, size_t length) {
+        uint32_t gram = static_cast<uint32_t>(length) << 24;
+        for (size_t i = 0; i < length; ++i) {
+            gram |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[i])) << (8 * (length - 1 - i));
+        }
+        return gram;
+    }
+
+    /**
+     * Distinct grams of every length up to kMaxGram across fields
+     */
+    static std::vector<uint32_t> grams(const std::vector<std::string>& fields) {
+        std::vector<uint32_t> out;
+        for (const auto& field : fields) {
+            for (size_t i = 0; i < field.size(); ++i) {
+                for (size_t n = 1; n <= kMaxGram && i + n <= field.size(); ++n) {
+                    out.push_back(pack(field.data() + i, n));
+                }
+            }
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return out;
+    }
+
+    /**
+     * Build the posting lists deferPostings() left out. Called by readers
+     * under a shared lock, hence const; the lists are derived from the
+     * documents, so building them changes nothing a caller can observe.
+     */
+    void buildPostings() const {
+        if (!deferred_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(build_mutex_);
+        if (!deferred_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        auto& postings = const_cast<NgramIndex*>(this)->postings_;
+        try {
+            for (uint32_t doc = 0; doc < docs_.size(); ++doc) {
+                if (docs_[doc].id.empty()) {
+                    continue;  // on the free list
+                }
+                // Doc numbers only grow here, so every list stays sorted
+                for (uint32_t gram : grams(docs_[doc].fields)) {
+                    postings[gram].push_back(doc);
+                }
+            }
+        } catch (...) {
+            postings.clear();
+            throw;
+        }
+        deferred_.store(false, std::memory_order_release);
+    }
+
+    const std::vector<uint32_t>* find(uint32_t gram) const {
+        auto it = postings_.find(gram);
+        return it == postings_.end() ? nullptr : &it->second;
+    }
+
+    std::vector<Doc> docs_;
+    std::vector<uint32_t> free_;
+    std::unordered_map<std::string, uint32_t> doc_of_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings_;
+
+    // Set while postings_ is not maintained; see deferPostings()
+    mutable std::atomic<bool> deferred_{false};
+    mutable std::mutex build_mutex_;
+};
+
+} // namespace dbal
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file secondary_index.hpp
+ * @brief Non-unique secondary index (field value -> entity ids)
+ *
+ * Entity operations keep these in step with the primary collections on
+ * every create/update/delete, the same way page_paths and friends are
+ * maintained. Ids within a bucket are ordered, so walking a bucket yields
+ * entities in the same order as walking the primary map.
+ */
+#ifndef DBAL_SECONDARY_INDEX_HPP
+#define DBAL_SECONDARY_INDEX_HPP
+
+#include <initializer_list>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace dbal {
+
+class SecondaryIndex {
+public:
+    using Bucket = std::set<std::string>;
+
+    void insert(const std::string& value, const std::string& id) {
+        buckets_[value].insert(id);
+    }
+
+    void insert(const std::optional<std::string>& value, const std::string& id) {
+        if (value.has_value()) {
+            insert(value.value(), id);
+        } else {
+            unset_.insert(id);
+        }
+    }
+
+    void erase(const std::string& value, const std::string& id) {
+        auto it = buckets_.find(value);
+        if (it == buckets_.end()) {
+            return;
+        }
+        it->second.erase(id);
+        if (it->second.empty()) {
+            buckets_.erase(it);
+        }
+    }
+
+    void erase(const std::optional<std::string>& value, const std::string& id) {
+        if (value.has_value()) {
+            erase(value.value(), id);
+        } else {
+            unset_.erase(id);
+        }
+    }
+
+    /**
+     * Re-file an id after its indexed field changed
+     */
+    template<typename Value>
+    void update(const Value& old_value, const Value& new_value, const std::string& id) {
+        if (old_value == new_value) {
+            return;
+        }
+        erase(old_value, id);
+        insert(new_value, id);
+    }
+
+    /**
+     * Ids whose field equals value, or nullptr when there are none
+     */
+    const Bucket* find(const std::string& value) const {
+        auto it = buckets_.find(value);
+        return it == buckets_.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * Ids whose field equals value; a nullopt value selects unset fields
+     */
+    const Bucket* find(const std::optional<std::string>& value) const {
+        if (!value.has_value()) {
+            return unset_.empty() ? nullptr : &unset_;
+        }
+        return find(value.value());
+    }
+
+    /**
+     * Add id under value (null: unset) when ids of each value arrive in
+     * increasing order, as forEach yields them; cheaper than insert for
+     * bulk loads
+     */
+    void append(const std::string* value, const std::string& id) {
+        Bucket& bucket = value ? buckets_[*value] : unset_;
+        bucket.emplace_hint(bucket.end(), id);
+    }
+
+    /**
+     * Visit every (value, id) pair, ids of a value in order; value is null
+     * for ids whose field is unset
+     */
+    template<typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (const auto& id : unset_) {
+            visit(static_cast<const std::string*>(nullptr), id);
+        }
+        for (const auto& [value, bucket] : buckets_) {
+            for (const auto& id : bucket) {
+                visit(&value, id);
+            }
+        }
+    }
+
+    size_t count(const std::string& value) const {
+        const Bucket* bucket = find(value);
+        return bucket ? bucket->size() : 0;
+    }
+
+    void clear() {
+        buckets_.clear();
+        unset_.clear();
+    }
+
+private:
+    std::unordered_map<std::string, Bucket> buckets_;
+    Bucket unset_;
+};
+
+/**
+ * An index that can answer an equality filter on `field`
+ */
+struct IndexedField {
+    const char* field;
+    const SecondaryIndex* index;
+};
+
+/**
+ * Pick the smallest index bucket selected by a list filter.
+ *
+ * Returns nullopt when the filter names none of the indexed fields, so the
+ * caller must scan the whole collection. Otherwise returns the bucket to
+ * walk, where nullptr means nothing can match. Callers still apply every
+ * filter to the candidates.
+ */
+inline std::optional<const SecondaryIndex::Bucket*> narrowByIndex(
+    const std::map<std::string, std::string>& filter, std::initializer_list<IndexedField> fields) {
+    std::optional<const SecondaryIndex::Bucket*> narrowest;
+    for (const auto& indexed : fields) {
+        auto it = filter.find(indexed.field);
+        if (it == filter.end()) {
+            continue;
+        }
+        const SecondaryIndex::Bucket* bucket = indexed.index->find(it->second);
+        if (!bucket) {
+            return std::optional<const SecondaryIndex::Bucket*>(nullptr);
+        }
+        if (!narrowest.has_value() || bucket->size() < narrowest.value()->size()) {
+            narrowest = bucket;
+        }
+    }
+    return narrowest;
+}
+
+} // namespace dbal
+
+#endif
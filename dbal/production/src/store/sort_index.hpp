@@ -0,0 +1,109 @@
+/**
+ * @file sort_index.hpp
+ * @brief Ordered (sort key, id) index for keyset list pagination
+ *
+ * Maintained alongside the secondary indexes on every write. A list sorted
+ * by the indexed field walks it from the cursor position instead of
+ * collecting and sorting the whole collection.
+ */
+#ifndef DBAL_SORT_INDEX_HPP
+#define DBAL_SORT_INDEX_HPP
+
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace dbal {
+
+class SortIndex {
+public:
+    using Entry = std::pair<std::string, std::string>;  // (sort key, id)
+
+    void insert(const std::string& key, const std::string& id) {
+        entries_.emplace(key, id);
+    }
+
+    /**
+     * Insert an entry that sorts after every existing one, as when
+     * reloading entries in forEachAfter order
+     */
+    void append(const std::string& key, const std::string& id) {
+        entries_.emplace_hint(entries_.end(), key, id);
+    }
+
+    void erase(const std::string& key, const std::string& id) {
+        entries_.erase(Entry(key, id));
+    }
+
+    /**
+     * Re-file an id after its sort key changed
+     */
+    void update(const std::string& old_key, const std::string& new_key, const std::string& id) {
+        if (old_key == new_key) {
+            return;
+        }
+        erase(old_key, id);
+        insert(new_key, id);
+    }
+
+    /**
+     * Visit (key, id) pairs in order, starting strictly after `after` when
+     * given. The visitor returns false to stop.
+     */
+    template<typename Visitor>
+    void forEachAfter(const std::optional<Entry>& after, Visitor&& visit) const {
+        auto it = after.has_value() ? entries_.upper_bound(after.value()) : entries_.begin();
+        for (; it != entries_.end(); ++it) {
+            if (!visit(it->first, it->second)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Visit (key, id) pairs of one scope in order, starting strictly after
+     * `after` (an unscoped key and id) when given; see scopedKey. Keys are
+     * passed to the visitor with the scope stripped.
+     */
+    template<typename Visitor>
+    void forEachInScope(const std::optional<std::string>& scope,
+                        const std::optional<Entry>& after,
+                        Visitor&& visit) const {
+        const std::string prefix = scopedKey(scope, "");
+        auto it = entries_.upper_bound(after.has_value() ? Entry(prefix + after->first, after->second)
+                                                         : Entry(prefix, ""));
+        for (; it != entries_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+            if (!visit(std::string_view(it->first).substr(prefix.size()), it->second)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Key of an entry in an index scoped by another field, such as a
+     * tenant: each scope's entries are contiguous and ordered by key
+     */
+    static std::string scopedKey(const std::optional<std::string>& scope, const std::string& key) {
+        std::string scoped = scope.has_value() ? "v" + scope.value() : "n";
+        scoped += '\0';
+        scoped += key;
+        return scoped;
+    }
+
+    size_t size() const {
+        return entries_.size();
+    }
+
+    void clear() {
+        entries_.clear();
+    }
+
+private:
+    std::set<Entry> entries_;
+};
+
+} // namespace dbal
+
+#endif
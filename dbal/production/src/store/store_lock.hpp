@@ -0,0 +1,262 @@
+/**
+ * @file store_lock.hpp
+ * @brief Scoped multi-partition lock over the in-memory store
+ *
+ * Entity operations assume the caller already holds the partitions they
+ * touch. StoreLock acquires a set of partitions in StorePartition order,
+ * so any two StoreLocks can never deadlock against each other.
+ *
+ * A BatchLock takes the partitions for a whole batch of operations once.
+ * StoreLocks the same thread takes on the same store while it is alive
+ * acquire nothing, as long as the batch already covers them.
+ *
+ * Whichever lock actually holds a partition exclusively commits the
+ * writes made under it to the store's journal before releasing it, so a
+ * batch reaches the journal as one commit.
+ *
+ * A partition the store's loader has not filled yet is loaded by the
+ * first StoreLock to reach it, under all of its stripes, before that
+ * lock takes it for the caller.
+ */
+#ifndef DBAL_STORE_LOCK_HPP
+#define DBAL_STORE_LOCK_HPP
+
+#include "in_memory_store.hpp"
+#include <array>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace dbal {
+
+enum class LockMode {
+    Shared,
+    Exclusive,
+};
+
+/**
+ * Requested access to one partition. Shared access may name a key so the
+ * reader lands on that key's stripe; keyless readers pick a stripe from
+ * the calling thread's id. The key is only read while the lock is taken.
+ */
+struct PartitionAccess {
+    StorePartition partition;
+    LockMode mode;
+    const std::string* key = nullptr;
+};
+
+inline PartitionAccess readLock(StorePartition partition) {
+    return {partition, LockMode::Shared, nullptr};
+}
+
+inline PartitionAccess readLock(StorePartition partition, const std::string& key) {
+    return {partition, LockMode::Shared, &key};
+}
+
+inline PartitionAccess writeLock(StorePartition partition) {
+    return {partition, LockMode::Exclusive, nullptr};
+}
+
+/**
+ * Partitions held by the batch running on the calling thread, if any
+ */
+class BatchScope {
+public:
+    /**
+     * The active batch scope for store on this thread, or null
+     */
+    static const BatchScope* active(const InMemoryStore& store) {
+        const BatchScope* scope = current_;
+        return scope && scope->store_ == &store ? scope : nullptr;
+    }
+
+    bool covers(const PartitionAccess& access) const {
+        const size_t index = static_cast<size_t>(access.partition);
+        return held_[index] && (access.mode == LockMode::Shared || modes_[index] == LockMode::Exclusive);
+    }
+
+protected:
+    template<typename Iterator>
+    BatchScope(const InMemoryStore& store, Iterator first, Iterator last) : store_(&store) {
+        for (auto it = first; it != last; ++it) {
+            const size_t index = static_cast<size_t>(it->partition);
+            if (!held_[index] || it->mode == LockMode::Exclusive) {
+                modes_[index] = it->mode;
+            }
+            held_[index] = true;
+        }
+    }
+
+    void enter() {
+        previous_ = current_;
+        current_ = this;
+    }
+
+    void leave() {
+        current_ = previous_;
+    }
+
+private:
+    static inline thread_local const BatchScope* current_ = nullptr;
+
+    const InMemoryStore* store_;
+    const BatchScope* previous_ = nullptr;
+    std::array<bool, kStorePartitionCount> held_{};
+    std::array<LockMode, kStorePartitionCount> modes_{};
+};
+
+/**
+ * RAII guard holding a set of store partitions
+ */
+class StoreLock {
+public:
+    StoreLock(const InMemoryStore& store, std::initializer_list<PartitionAccess> access)
+        : StoreLock(store, access.begin(), access.end()) {}
+
+    template<typename Iterator>
+    StoreLock(const InMemoryStore& store, Iterator first, Iterator last) : store_(store) {
+        if (const BatchScope* batch = BatchScope::active(store)) {
+            for (auto it = first; it != last; ++it) {
+                if (!batch->covers(*it)) {
+                    throw std::logic_error("Store partition is not held by the enclosing batch");
+                }
+            }
+            return;
+        }
+
+        // Merge requests per partition, keeping the strongest mode
+        std::array<Held, kStorePartitionCount> wanted{};
+        for (auto it = first; it != last; ++it) {
+            Held& slot = wanted[static_cast<size_t>(it->partition)];
+            if (!slot.lock) {
+                slot.lock = &store.partition_locks[static_cast<size_t>(it->partition)];
+                slot.partition = static_cast<unsigned>(it->partition);
+                slot.mode = it->mode;
+                slot.stripe = stripeFor(it->key);
+            } else if (it->mode == LockMode::Exclusive) {
+                slot.mode = LockMode::Exclusive;
+            }
+        }
+
+        // Partition order is the acquisition order
+        try {
+            for (const Held& slot : wanted) {
+                if (!slot.lock) {
+                    continue;
+                }
+                loadIfPending(slot);
+                if (slot.mode == LockMode::Exclusive) {
+                    for (auto& stripe : slot.lock->stripes) {
+                        stripe.mutex.lock();
+                    }
+                } else {
+                    slot.lock->stripes[slot.stripe].mutex.lock_shared();
+                }
+                held_[held_count_++] = slot;
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~StoreLock() {
+        if (store_.journal) {
+            unsigned exclusive = 0;
+            for (size_t i = 0; i < held_count_; ++i) {
+                if (held_[i].mode == LockMode::Exclusive) {
+                    exclusive |= 1u << held_[i].partition;
+                }
+            }
+            if (exclusive != 0) {
+                store_.journal->commit(store_, exclusive);
+            }
+        }
+        release();
+    }
+
+    StoreLock(const StoreLock&) = delete;
+    StoreLock& operator=(const StoreLock&) = delete;
+
+private:
+    struct Held {
+        StorePartitionLock* lock = nullptr;
+        unsigned partition = 0;
+        LockMode mode = LockMode::Shared;
+        size_t stripe = 0;
+    };
+
+    void loadIfPending(const Held& slot) {
+        StoreLoader* loader = store_.loader;
+        const auto partition = static_cast<StorePartition>(slot.partition);
+        if (!loader || !loader->pending(partition)) {
+            return;
+        }
+        for (auto& stripe : slot.lock->stripes) {
+            stripe.mutex.lock();
+        }
+        try {
+            loader->load(partition);
+        } catch (...) {
+            unlockStripes(*slot.lock);
+            throw;
+        }
+        unlockStripes(*slot.lock);
+    }
+
+    static void unlockStripes(StorePartitionLock& lock) {
+        for (auto it = lock.stripes.rbegin(); it != lock.stripes.rend(); ++it) {
+            it->mutex.unlock();
+        }
+    }
+
+    void release() {
+        while (held_count_ > 0) {
+            const Held& slot = held_[--held_count_];
+            if (slot.mode == LockMode::Exclusive) {
+                unlockStripes(*slot.lock);
+            } else {
+                slot.lock->stripes[slot.stripe].mutex.unlock_shared();
+            }
+        }
+    }
+
+    static size_t stripeFor(const std::string* key) {
+        const size_t hash = key
+            ? std::hash<std::string>{}(*key)
+            : std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return hash % kStoreLockStripes;
+    }
+
+    const InMemoryStore& store_;
+    std::array<Held, kStorePartitionCount> held_{};
+    size_t held_count_ = 0;
+};
+
+/**
+ * RAII guard holding partitions for a batch of operations on this thread
+ */
+class BatchLock : private BatchScope {
+public:
+    template<typename Iterator>
+    BatchLock(const InMemoryStore& store, Iterator first, Iterator last)
+        : BatchScope(store, first, last), lock_(store, first, last) {
+        enter();
+    }
+
+    ~BatchLock() {
+        leave();
+    }
+
+    BatchLock(const BatchLock&) = delete;
+    BatchLock& operator=(const BatchLock&) = delete;
+
+private:
+    StoreLock lock_;
+};
+
+} // namespace dbal
+
+#endif
@@ -0,0 +1,704 @@
+#include "store_snapshot.hpp"
+#include "record_codec.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dbal {
+
+namespace {
+
+// Header: magic, u32 format version, u32 record format version, u64 first
+// segment, u64 id counter per partition, u64 table offset, u32 section
+// count, u32 CRC-32 of the table, u32 CRC-32 of the header so far, u32 0.
+// Table entry: u32 partition, u32 kind, u32 ordinal, u32 row width,
+// u64 offset, u64 rows, u32 CRC-32 of the section, u32 0.
+const std::string kMagic = "DBALSNP2";
+constexpr std::uint32_t kFormatVersion = 4;
+constexpr std::size_t kHeaderBytes = 104;
+constexpr std::size_t kHeaderCrcAt = 96;
+constexpr std::size_t kTableEntryBytes = 40;
+constexpr std::uint32_t kRefBytes = 16;
+constexpr std::uint32_t kPairBytes = 2 * kRefBytes;
+
+// Short strings are looked up in a small direct-mapped cache of recently
+// pooled ones, which catches values repeated across many rows (tenants,
+// roles, empty fields) without the cost of interning every unique id
+constexpr std::size_t kInternMaxBytes = 64;
+constexpr std::size_t kInternSlots = 4096;
+
+// Keep sections 8-byte aligned within the file
+void pad(std::string& out) {
+    out.resize((out.size() + 7) & ~static_cast<std::size_t>(7), '\0');
+}
+
+class PoolWriter {
+public:
+    struct Ref {
+        std::uint64_t offset = 0;
+        std::uint32_t length = 0;
+        bool present = false;
+    };
+
+    PoolWriter() : recent_(kInternSlots) {}
+
+    /**
+     * Append value, unless an equal short string was pooled recently
+     */
+    Ref add(std::string_view value) {
+        const auto length = static_cast<std::uint32_t>(value.size());
+        Ref* slot = nullptr;
+        if (value.size() <= kInternMaxBytes) {
+            slot = &recent_[std::hash<std::string_view>{}(value) % kInternSlots];
+            if (slot->present && slot->length == length &&
+                std::string_view(bytes_).substr(static_cast<std::size_t>(slot->offset), length) == value) {
+                return *slot;
+            }
+        }
+        const Ref ref{bytes_.size(), length, true};
+        bytes_.append(value);
+        if (slot) {
+            *slot = ref;
+        }
+        return ref;
+    }
+
+    const std::string& bytes() const {
+        return bytes_;
+    }
+
+private:
+    std::string bytes_;
+    std::vector<Ref> recent_;
+};
+
+/**
+ * Writes a record's members as fixed-width cells, strings into the pool
+ */
+class CellWriter {
+public:
+    CellWriter(std::string& out, PoolWriter& pool) : out_(out), pool_(pool) {}
+
+    void ref(const PoolWriter::Ref& ref) {
+        char bytes[kRefBytes];
+        encode(bytes, ref.offset, 8);
+        encode(bytes + 8, ref.length, 4);
+        encode(bytes + 12, ref.present ? 1 : 0, 4);
+        out_.append(bytes, sizeof(bytes));
+    }
+
+    void operator()(const std::string& value) {
+        ref(pool_.add(value));
+    }
+
+    void operator()(bool value) {
+        put(value ? 1 : 0, 8);
+    }
+
+    template<typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    void operator()(Integer value) {
+        put(static_cast<std::uint64_t>(static_cast<std::int64_t>(value)), 8);
+    }
+
+    void operator()(const Timestamp& value) {
+        const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(value.time_since_epoch());
+        put(static_cast<std::uint64_t>(nanos.count()), 8);
+    }
+
+    template<typename T>
+    void operator()(const std::optional<T>& value) {
+        put(value.has_value() ? 1 : 0, 8);
+        static const T absent{};
+        (*this)(value.has_value() ? value.value() : absent);
+    }
+
+    void operator()(const std::map<std::string, std::string>& value) {
+        std::string encoded;
+        RecordWriter writer(encoded);
+        writer(value);
+        ref(pool_.add(encoded));
+    }
+
+private:
+    // Little-endian, like RecordWriter, but a cell at a time
+    static void encode(char* bytes, std::uint64_t value, std::size_t width) {
+        for (std::size_t i = 0; i < width; ++i) {
+            bytes[i] = static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    void put(std::uint64_t value, std::size_t width) {
+        char bytes[8];
+        encode(bytes, value, width);
+        out_.append(bytes, width);
+    }
+
+    std::string& out_;
+    PoolWriter& pool_;
+};
+
+/**
+ * Reads what CellWriter wrote. A reference outside the pool or a bad
+ * flag sets failed().
+ */
+class CellReader {
+public:
+    CellReader(std::string_view cells, std::string_view pool) : cells_(cells), pool_(pool) {}
+
+    bool failed() const {
+        return failed_;
+    }
+
+    std::optional<std::string_view> ref() {
+        const std::uint64_t offset = take(8);
+        const std::uint64_t length = take(4);
+        const std::uint64_t present = take(4);
+        if (present > 1 || offset > pool_.size() || length > pool_.size() - offset) {
+            failed_ = true;
+            return std::nullopt;
+        }
+        if (present == 0) {
+            return std::nullopt;
+        }
+        return pool_.substr(static_cast<std::size_t>(offset), length);
+    }
+
+    void operator()(std::string& value) {
+        const auto cell = ref();
+        value.assign(cell.value_or(std::string_view()));
+    }
+
+    void operator()(bool& value) {
+        value = flag();
+    }
+
+    template<typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    void operator()(Integer& value) {
+        value = static_cast<Integer>(static_cast<std::int64_t>(take(8)));
+    }
+
+    void operator()(Timestamp& value) {
+        const auto nanos = std::chrono::nanoseconds(static_cast<std::int64_t>(take(8)));
+        value = Timestamp(std::chrono::duration_cast<Timestamp::duration>(nanos));
+    }
+
+    template<typename T>
+    void operator()(std::optional<T>& value) {
+        const bool present = flag();
+        T item{};
+        (*this)(item);
+        if (present) {
+            value = std::move(item);
+        } else {
+            value.reset();
+        }
+    }
+
+    void operator()(std::map<std::string, std::string>& value) {
+        const auto cell = ref();
+        RecordReader reader(cell.value_or(std::string_view()));
+        reader(value);
+        failed_ |= reader.failed() || !reader.atEnd();
+    }
+
+private:
+    std::uint64_t take(std::size_t width) {
+        if (cells_.size() < width) {
+            failed_ = true;
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(cells_[i])) << (8 * i);
+        }
+        cells_.remove_prefix(width);
+        return value;
+    }
+
+    bool flag() {
+        const std::uint64_t value = take(8);
+        failed_ |= value > 1;
+        return value == 1;
+    }
+
+    std::string_view cells_;
+    std::string_view pool_;
+    bool failed_ = false;
+};
+
+template<typename Record>
+std::uint32_t rowWidth() {
+    std::string row;
+    PoolWriter pool;
+    CellWriter cells(row, pool);
+    cells(std::string());
+    const Record record{};
+    RecordFields<Record>::visit(cells, record);
+    return static_cast<std::uint32_t>(row.size());
+}
+
+// ---------------------------------------------------------------------------
+// Index sections: (a, b) pairs in the index's own order
+
+void writePair(CellWriter& cells, PoolWriter& pool, const std::string* a, const std::string& b) {
+    cells.ref(a ? pool.add(*a) : PoolWriter::Ref{});
+    cells.ref(pool.add(b));
+}
+
+std::uint64_t writeIndex(const SecondaryIndex& index, CellWriter& cells, PoolWriter& pool) {
+    std::uint64_t count = 0;
+    index.forEach([&](const std::string* value, const std::string& id) {
+        writePair(cells, pool, value, id);
+        ++count;
+    });
+    return count;
+}
+
+std::uint64_t writeIndex(const SortIndex& index, CellWriter& cells, PoolWriter& pool) {
+    std::uint64_t count = 0;
+    index.forEachAfter(std::nullopt, [&](const std::string& key, const std::string& id) {
+        writePair(cells, pool, &key, id);
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+std::uint64_t writeIndex(const std::map<std::string, std::string>& index, CellWriter& cells, PoolWriter& pool) {
+    for (const auto& [key, value] : index) {
+        writePair(cells, pool, &key, value);
+    }
+    return index.size();
+}
+
+// One pair per element; a key whose list is empty is written with no b
+std::uint64_t writeIndex(const std::map<std::string, std::vector<std::string>>& index,
+                         CellWriter& cells,
+                         PoolWriter& pool) {
+    std::uint64_t count = 0;
+    for (const auto& [key, ids] : index) {
+        if (ids.empty()) {
+            cells.ref(pool.add(key));
+            cells.ref(PoolWriter::Ref{});
+            ++count;
+        }
+        for (const auto& id : ids) {
+            writePair(cells, pool, &key, id);
+            ++count;
+        }
+    }
+    return count;
+}
+
+// (id, fields) with the fields as a RecordWriter list
+std::uint64_t writeIndex(const NgramIndex& index, CellWriter& cells, PoolWriter& pool) {
+    std::uint64_t count = 0;
+    std::string encoded;
+    index.forEachDoc([&](const std::string& id, const std::vector<std::string>& fields) {
+        encoded.clear();
+        RecordWriter writer(encoded);
+        writer.u32(static_cast<std::uint32_t>(fields.size()));
+        for (const auto& field : fields) {
+            writer(field);
+        }
+        cells.ref(pool.add(id));
+        cells.ref(pool.add(encoded));
+        ++count;
+    });
+    return count;
+}
+
+/**
+ * Call fn(a, b) for each pair of an index section; false when a
+ * reference is damaged
+ */
+template<typename Fn>
+bool forEachPair(std::string_view pairs, std::uint64_t count, std::string_view pool, Fn&& fn) {
+    for (std::uint64_t i = 0; i < count; ++i) {
+        CellReader cells(pairs.substr(static_cast<std::size_t>(i * kPairBytes), kPairBytes), pool);
+        const auto a = cells.ref();
+        const auto b = cells.ref();
+        if (cells.failed() || !fn(a, b)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool loadIndex(SecondaryIndex& index, std::string_view pairs, std::uint64_t count, std::string_view pool) {
+    // Pairs come grouped by value
+    std::optional<std::string> value;
+    return forEachPair(pairs, count, pool, [&](auto cell, auto id) {
+        if (!id) {
+            return false;
+        }
+        if (cell.has_value() != value.has_value() || (cell && *cell != *value)) {
+            value = cell ? std::optional<std::string>(std::string(*cell)) : std::nullopt;
+        }
+        index.append(value ? &value.value() : nullptr, std::string(*id));
+        return true;
+    });
+}
+
+bool loadIndex(SortIndex& index, std::string_view pairs, std::uint64_t count, std::string_view pool) {
+    return forEachPair(pairs, count, pool, [&](auto key, auto id) {
+        if (!key || !id) {
+            return false;
+        }
+        index.append(std::string(*key), std::string(*id));
+        return true;
+    });
+}
+
+bool loadIndex(std::map<std::string, std::string>& index,
+               std::string_view pairs,
+               std::uint64_t count,
+               std::string_view pool) {
+    return forEachPair(pairs, count, pool, [&](auto key, auto value) {
+        if (!key || !value) {
+            return false;
+        }
+        index.emplace_hint(index.end(), std::string(*key), std::string(*value));
+        return true;
+    });
+}
+
+bool loadIndex(std::map<std::string, std::vector<std::string>>& index,
+               std::string_view pairs,
+               std::uint64_t count,
+               std::string_view pool) {
+    return forEachPair(pairs, count, pool, [&](auto key, auto id) {
+        if (!key) {
+            return false;
+        }
+        auto it = index.empty() ? index.end() : std::prev(index.end());
+        if (it == index.end() || it->first != *key) {
+            it = index.emplace_hint(index.end(), std::string(*key), std::vector<std::string>());
+        }
+        if (id) {
+            it->second.emplace_back(*id);
+        }
+        return true;
+    });
+}
+
+bool loadIndex(NgramIndex& index, std::string_view pairs, std::uint64_t count, std::string_view pool) {
+    index.deferPostings();
+    std::vector<std::string> fields;
+    return forEachPair(pairs, count, pool, [&](auto id, auto encoded) {
+        if (!id || !encoded) {
+            return false;
+        }
+        RecordReader reader(*encoded);
+        fields.resize(reader.u32());
+        for (auto& field : fields) {
+            reader(field);
+        }
+        if (reader.failed() || !reader.atEnd()) {
+            return false;
+        }
+        index.insert(std::string(*id), fields);
+        return true;
+    });
+}
+
+} // namespace
+
+std::string SnapshotImage::build(const InMemoryStore& store, std::uint64_t first_segment) {
+    std::string out(kHeaderBytes, '\0');
+    std::vector<Section> table;
+    const auto add = [&](std::size_t partition, SectionKind kind, std::uint32_t ordinal, std::uint32_t width,
+                         std::uint64_t count, std::string_view bytes) {
+        pad(out);
+        table.push_back({static_cast<std::uint32_t>(partition), kind, ordinal, width, out.size(), count,
+                         crc32(bytes)});
+        out.append(bytes);
+    };
+
+    std::string section;
+    for (std::size_t partition = 0; partition < kStorePartitionCount; ++partition) {
+        const auto which = static_cast<StorePartition>(partition);
+        PoolWriter pool;
+        section.clear();
+        InMemoryStore::withCollection(store, which, [&](const auto& collection) {
+            using Record = typename std::decay_t<decltype(collection)>::mapped_type;
+            CellWriter cells(section, pool);
+            for (const auto& [key, record] : collection) {
+                cells(key);
+                RecordFields<Record>::visit(cells, record);
+            }
+            add(partition, SectionKind::Records, 0, rowWidth<Record>(), collection.size(), section);
+        });
+
+        std::uint32_t ordinal = 0;
+        InMemoryStore::forEachIndex(store, which, [&](const auto& index) {
+            section.clear();
+            CellWriter cells(section, pool);
+            const std::uint64_t count = writeIndex(index, cells, pool);
+            add(partition, SectionKind::Index, ordinal++, kPairBytes, count, section);
+        });
+        add(partition, SectionKind::Pool, 0, 1, pool.bytes().size(), pool.bytes());
+    }
+
+    pad(out);
+    const std::uint64_t table_offset = out.size();
+    std::string entries;
+    RecordWriter entry(entries);
+    for (const Section& s : table) {
+        entry.u32(s.partition);
+        entry.u32(static_cast<std::uint32_t>(s.kind));
+        entry.u32(s.ordinal);
+        entry.u32(s.width);
+        entry.u64(s.offset);
+        entry.u64(s.count);
+        entry.u32(s.crc);
+        entry.u32(0);
+    }
+    out.append(entries);
+
+    std::string header = kMagic;
+    RecordWriter writer(header);
+    writer.u32(kFormatVersion);
+    writer.u32(kRecordFormatVersion);
+    writer.u64(first_segment);
+    for (std::size_t partition = 0; partition < kStorePartitionCount; ++partition) {
+        const int counter = store.counterFor(static_cast<StorePartition>(partition)).load();
+        writer.u64(static_cast<std::uint64_t>(static_cast<std::int64_t>(counter)));
+    }
+    writer.u64(table_offset);
+    writer.u32(static_cast<std::uint32_t>(table.size()));
+    writer.u32(crc32(entries));
+    writer.u32(crc32(header));
+    writer.u32(0);
+    out.replace(0, kHeaderBytes, header);
+    return out;
+}
+
+std::unique_ptr<SnapshotImage> SnapshotImage::open(const std::string& path) {
+    std::unique_ptr<SnapshotImage> image(new SnapshotImage());
+    image->path_ = path;
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info {};
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw std::runtime_error("Cannot read snapshot " + path);
+    }
+    image->size_ = static_cast<std::size_t>(info.st_size);
+    if (image->size_ > 0) {
+        void* data = ::mmap(nullptr, image->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map snapshot " + path);
+        }
+        image->data_ = static_cast<const char*>(data);
+        image->mapped_ = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot read snapshot " + path);
+    }
+    image->buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    image->data_ = image->buffer_.data();
+    image->size_ = image->buffer_.size();
+#endif
+
+    const std::string_view file(image->data_, image->size_);
+    if (file.size() < kHeaderBytes || file.substr(0, kMagic.size()) != kMagic) {
+        image->corrupt();
+    }
+    RecordReader header(file.substr(kMagic.size(), kHeaderBytes - kMagic.size()));
+    const std::uint32_t version = header.u32();
+    const std::uint32_t record_version = header.u32();
+    image->first_segment_ = header.u64();
+    for (auto& counter : image->counters_) {
+        counter = static_cast<std::int64_t>(header.u64());
+    }
+    const std::uint64_t table_offset = header.u64();
+    const std::uint32_t sections = header.u32();
+    const std::uint32_t table_crc = header.u32();
+    const std::uint32_t header_crc = header.u32();
+    if (crc32(file.substr(0, kHeaderCrcAt)) != header_crc) {
+        image->corrupt();
+    }
+    if (version != kFormatVersion || record_version != kRecordFormatVersion) {
+        throw std::runtime_error("Unsupported snapshot format version " + std::to_string(version) + "." +
+                                 std::to_string(record_version) + " in " + path);
+    }
+    if (table_offset > file.size() || sections > (file.size() - table_offset) / kTableEntryBytes) {
+        image->corrupt();
+    }
+    const std::string_view entries = file.substr(static_cast<std::size_t>(table_offset), sections * kTableEntryBytes);
+    if (crc32(entries) != table_crc) {
+        image->corrupt();
+    }
+
+    RecordReader table(entries);
+    image->sections_.resize(sections);
+    for (Section& s : image->sections_) {
+        s.partition = table.u32();
+        const std::uint32_t kind = table.u32();
+        s.ordinal = table.u32();
+        s.width = table.u32();
+        s.offset = table.u64();
+        s.count = table.u64();
+        s.crc = table.u32();
+        table.u32();
+        s.kind = static_cast<SectionKind>(kind);
+        const bool known = kind <= static_cast<std::uint32_t>(SectionKind::Index) &&
+                           (s.kind != SectionKind::Index || s.width == kPairBytes) &&
+                           (s.kind != SectionKind::Pool || s.width == 1);
+        if (!known || s.partition >= kStorePartitionCount || s.width == 0 || s.offset > table_offset ||
+            s.count > (table_offset - s.offset) / s.width) {
+            image->corrupt();
+        }
+    }
+    return image;
+}
+
+SnapshotImage::~SnapshotImage() {
+#ifndef _WIN32
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+std::size_t SnapshotImage::records(StorePartition partition) const {
+    const Section* rows = find(partition, SectionKind::Records, 0);
+    return rows ? static_cast<std::size_t>(rows->count) : 0;
+}
+
+const SnapshotImage::Section* SnapshotImage::find(StorePartition partition,
+                                                  SectionKind kind,
+                                                  std::uint32_t ordinal) const {
+    for (const Section& s : sections_) {
+        if (s.partition == static_cast<std::uint32_t>(partition) && s.kind == kind && s.ordinal == ordinal) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view SnapshotImage::bytes(const Section& section) const {
+    return std::string_view(data_ + section.offset, static_cast<std::size_t>(section.count * section.width));
+}
+
+void SnapshotImage::corrupt() const {
+    throw std::runtime_error("Corrupt snapshot " + path_);
+}
+
+template<typename Record>
+std::optional<Record> SnapshotImage::lookup(const std::string& id) const {
+    const StorePartition partition = partitionOf<Record>();
+    const Section* pool_section = find(partition, SectionKind::Pool, 0);
+    const Section* rows = find(partition, SectionKind::Records, 0);
+    static const std::uint32_t width = rowWidth<Record>();
+    if (!pool_section || !rows || rows->width != width) {
+        corrupt();
+    }
+    const std::string_view pool = bytes(*pool_section);
+    const std::string_view data = bytes(*rows);
+    const auto row = [&](std::uint64_t i) {
+        return CellReader(data.substr(static_cast<std::size_t>(i * width), width), pool);
+    };
+    const auto keyOf = [&](CellReader& cells) {
+        const auto key = cells.ref();
+        if (cells.failed() || !key) {
+            corrupt();
+        }
+        return *key;
+    };
+
+    std::uint64_t low = 0;
+    std::uint64_t high = rows->count;
+    while (low < high) {
+        const std::uint64_t middle = low + (high - low) / 2;
+        CellReader cells = row(middle);
+        if (keyOf(cells) < id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == rows->count) {
+        return std::nullopt;
+    }
+    CellReader cells = row(low);
+    if (keyOf(cells) != id) {
+        return std::nullopt;
+    }
+    Record record;
+    RecordFields<Record>::visit(cells, record);
+    if (cells.failed()) {
+        corrupt();
+    }
+    return record;
+}
+
+template std::optional<User> SnapshotImage::lookup<User>(const std::string&) const;
+template std::optional<PageConfig> SnapshotImage::lookup<PageConfig>(const std::string&) const;
+
+void SnapshotImage::loadPartition(InMemoryStore& store, StorePartition partition) const {
+    const Section* pool_section = find(partition, SectionKind::Pool, 0);
+    const Section* rows = find(partition, SectionKind::Records, 0);
+    std::vector<const Section*> indexes;
+    InMemoryStore::forEachIndex(store, partition, [&](const auto&) {
+        indexes.push_back(find(partition, SectionKind::Index, static_cast<std::uint32_t>(indexes.size())));
+    });
+
+    // Check everything first so a damaged section leaves the store untouched
+    std::vector<const Section*> all(indexes);
+    all.push_back(pool_section);
+    all.push_back(rows);
+    for (const Section* s : all) {
+        if (!s || crc32(bytes(*s)) != s->crc) {
+            corrupt();
+        }
+    }
+    const std::string_view pool = bytes(*pool_section);
+
+    InMemoryStore::withCollection(store, partition, [&](auto& collection) {
+        using Record = typename std::decay_t<decltype(collection)>::mapped_type;
+        if (rows->width != rowWidth<Record>()) {
+            corrupt();
+        }
+        const std::string_view data = bytes(*rows);
+        for (std::uint64_t i = 0; i < rows->count; ++i) {
+            CellReader cells(data.substr(static_cast<std::size_t>(i * rows->width), rows->width), pool);
+            std::string key;
+            Record record;
+            cells(key);
+            RecordFields<Record>::visit(cells, record);
+            if (cells.failed()) {
+                corrupt();
+            }
+            collection.emplace_hint(collection.end(), std::move(key), std::move(record));
+        }
+    });
+
+    std::size_t ordinal = 0;
+    InMemoryStore::forEachIndex(store, partition, [&](auto& index) {
+        const Section& s = *indexes[ordinal++];
+        if (!loadIndex(index, bytes(s), s.count, pool)) {
+            corrupt();
+        }
+    });
+}
+
+} // namespace dbal
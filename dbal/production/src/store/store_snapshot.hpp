@@ -0,0 +1,133 @@
+/**
+ * @file store_snapshot.hpp
+ * @brief Columnar snapshot image of the in-memory store
+ *
+ * A snapshot is laid out to be mapped and loaded a partition at a time,
+ * without parsing the whole file first. Every partition gets its own
+ * sections:
+ *
+ *   pool      the partition's strings; short values that repeat from row
+ *             to row, like tenants and roles, are mostly stored once
+ *   records   one fixed-width row per record, in key order
+ *   index i   (a, b) string pairs, one section per entry of
+ *             InMemoryStore::forEachIndex, in index order
+ *
+ * A string cell is a 16-byte reference into the pool (u64 offset, u32
+ * length, u32 present); integers, booleans and timestamps take 8 bytes;
+ * an optional is an 8-byte present flag followed by its value's cell; a
+ * map of strings is a reference to its RecordWriter encoding. Row i of a
+ * section starts at i * width, so any row can be read in place.
+ *
+ * The file starts with a header (format version, first log segment not
+ * covered, id counters) and a section table, each checksummed; every
+ * section carries its own CRC-32, checked when its partition is loaded.
+ * Loading appends rows and index entries in the order they were written,
+ * which is each structure's own order, and leaves n-gram posting lists to
+ * the first search (see NgramIndex::deferPostings). Rows are in key
+ * order, so a single record can also be found in place by binary search
+ * before its partition is loaded.
+ */
+#ifndef DBAL_STORE_SNAPSHOT_HPP
+#define DBAL_STORE_SNAPSHOT_HPP
+
+#include "in_memory_store.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dbal {
+
+/**
+ * A snapshot file mapped read-only
+ */
+class SnapshotImage {
+public:
+    /**
+     * Serialize every record, index and id counter of store. Caller holds
+     * every partition, at least shared.
+     */
+    static std::string build(const InMemoryStore& store, std::uint64_t first_segment);
+
+    /**
+     * Map path and check its header and section table
+     * @throws std::runtime_error when it cannot be read or is not a
+     *         snapshot of this format
+     */
+    static std::unique_ptr<SnapshotImage> open(const std::string& path);
+
+    ~SnapshotImage();
+
+    SnapshotImage(const SnapshotImage&) = delete;
+    SnapshotImage& operator=(const SnapshotImage&) = delete;
+
+    std::uint64_t firstSegment() const {
+        return first_segment_;
+    }
+
+    std::int64_t counter(StorePartition partition) const {
+        return counters_[static_cast<std::size_t>(partition)];
+    }
+
+    std::size_t records(StorePartition partition) const;
+
+    /**
+     * Read the record stored under id by binary search over its
+     * partition's rows, without loading the partition. Cells are bounds
+     * checked; section checksums are only verified by loadPartition.
+     *
+     * @throws std::runtime_error when the rows cannot be read
+     */
+    template<typename Record>
+    std::optional<Record> lookup(const std::string& id) const;
+
+    /**
+     * Insert partition's records and index entries into store, where that
+     * partition must be empty. Every section is checked before anything
+     * is inserted. Partitions may be loaded concurrently, each under its
+     * own exclusive lock.
+     *
+     * @throws std::runtime_error when a section is damaged
+     */
+    void loadPartition(InMemoryStore& store, StorePartition partition) const;
+
+private:
+    enum class SectionKind : std::uint32_t {
+        Pool = 0,
+        Records = 1,
+        Index = 2,
+    };
+
+    struct Section {
+        std::uint32_t partition = 0;
+        SectionKind kind = SectionKind::Pool;
+        std::uint32_t ordinal = 0;
+        std::uint32_t width = 0;
+        std::uint64_t offset = 0;
+        std::uint64_t count = 0;  // rows, or bytes for a pool
+        std::uint32_t crc = 0;
+    };
+
+    SnapshotImage() = default;
+
+    const Section* find(StorePartition partition, SectionKind kind, std::uint32_t ordinal) const;
+    std::string_view bytes(const Section& section) const;
+    [[noreturn]] void corrupt() const;
+
+    std::string path_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::string buffer_;  // File contents where it cannot be mapped
+
+    std::uint64_t first_segment_ = 0;
+    std::array<std::int64_t, kStorePartitionCount> counters_{};
+    std::vector<Section> sections_;
+};
+
+} // namespace dbal
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file undo_log.hpp
+ * @brief Before-images of the records an atomic batch writes
+ *
+ * While a store has an undo log attached, entity operations hand it each
+ * record they are about to create, change or erase. Only the first image
+ * of a record is kept, so the log always holds its state from before the
+ * batch, or nothing for a record the batch created. Rolling back puts
+ * those images back (see entities/undo.hpp). Counters are not restored;
+ * ids handed out by a rolled back batch are simply never reused.
+ */
+#ifndef DBAL_UNDO_LOG_HPP
+#define DBAL_UNDO_LOG_HPP
+
+#include "dbal/types.hpp"
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace dbal {
+
+template<typename Record>
+class UndoImages {
+public:
+    void remember(const std::map<std::string, Record>& collection, const std::string& id) {
+        if (images_.find(id) != images_.end()) {
+            return;
+        }
+        auto it = collection.find(id);
+        images_.emplace(id, it == collection.end() ? std::nullopt : std::optional<Record>(it->second));
+    }
+
+    const std::map<std::string, std::optional<Record>>& images() const {
+        return images_;
+    }
+
+private:
+    std::map<std::string, std::optional<Record>> images_;
+};
+
+class StoreUndoLog {
+public:
+    template<typename Record>
+    void remember(const std::map<std::string, Record>& collection, const std::string& id) {
+        std::get<UndoImages<Record>>(images_).remember(collection, id);
+    }
+
+    template<typename Record>
+    const UndoImages<Record>& images() const {
+        return std::get<UndoImages<Record>>(images_);
+    }
+
+private:
+    std::tuple<UndoImages<User>,
+               UndoImages<PageConfig>,
+               UndoImages<ComponentNode>,
+               UndoImages<Workflow>,
+               UndoImages<Session>,
+               UndoImages<InstalledPackage>> images_;
+};
+
+} // namespace dbal
+
+#endif
@@ -0,0 +1,752 @@
+#include "write_ahead_log.hpp"
+#include "record_codec.hpp"
+#include "store_lock.hpp"
+#include "../entities/replay.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace dbal {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Frame: u32 payload length, u32 CRC-32 of the payload, payload. A payload
+// is a run of entries, each a kind byte and a partition byte followed by:
+//   Put      key, record
+//   Erase    key
+//   Counter  u64 id counter value
+enum class EntryKind : std::uint8_t {
+    Put = 0,
+    Erase = 1,
+    Counter = 2,
+};
+
+constexpr std::size_t kFrameHeaderBytes = 8;
+constexpr auto kRetryDelay = std::chrono::milliseconds(100);
+
+const std::string kSegmentMagic = "DBALWLOG";
+const char* const kSnapshotName = "snapshot";
+const char* const kSnapshotTempName = "snapshot.tmp";
+
+using CounterImages = std::array<std::optional<std::int64_t>, kStorePartitionCount>;
+
+// ---------------------------------------------------------------------------
+// Files
+
+int openForWrite(const fs::path& path, bool truncate) {
+#ifdef _WIN32
+    const int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND);
+    return ::_wopen(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND);
+    return ::open(path.c_str(), flags, 0644);
+#endif
+}
+
+bool writeAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+#ifdef _WIN32
+        const int written = ::_write(fd, data.data(), static_cast<unsigned>(std::min<std::size_t>(data.size(), 1 << 30)));
+#else
+        const ssize_t written = ::write(fd, data.data(), data.size());
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+bool syncFile(int fd) {
+#if defined(_WIN32)
+    return ::_commit(fd) == 0;
+#elif defined(__APPLE__)
+    return ::fsync(fd) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+}
+
+bool truncateFile(int fd, std::uint64_t size) {
+#ifdef _WIN32
+    return ::_chsize_s(fd, static_cast<long long>(size)) == 0;
+#else
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+void closeFile(int fd) {
+#ifdef _WIN32
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+// Make a rename or a new file in directory durable
+void syncDirectory(const fs::path& directory) {
+#ifndef _WIN32
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)directory;
+#endif
+}
+
+bool readFile(const fs::path& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    out.resize(static_cast<std::size_t>(size));
+    return static_cast<bool>(in.read(out.data(), size));
+}
+
+fs::path segmentPath(const fs::path& directory, std::uint64_t segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "wal-%016llu.log", static_cast<unsigned long long>(segment));
+    return directory / name;
+}
+
+std::optional<std::uint64_t> segmentNumber(const fs::path& path) {
+    const std::string name = path.filename().string();
+    if (name.size() != 24 || name.compare(0, 4, "wal-") != 0 || name.compare(20, 4, ".log") != 0) {
+        return std::nullopt;
+    }
+    std::uint64_t segment = 0;
+    for (std::size_t i = 4; i < 20; ++i) {
+        if (name[i] < '0' || name[i] > '9') {
+            return std::nullopt;
+        }
+        segment = segment * 10 + static_cast<std::uint64_t>(name[i] - '0');
+    }
+    return segment;
+}
+
+// Live segments in directory, oldest first
+std::vector<std::pair<std::uint64_t, fs::path>> listSegments(const fs::path& directory) {
+    std::vector<std::pair<std::uint64_t, fs::path>> segments;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        if (auto segment = segmentNumber(entry.path())) {
+            segments.emplace_back(*segment, entry.path());
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// ---------------------------------------------------------------------------
+// Frames and entries
+
+void appendFrame(std::string& out, std::string_view payload) {
+    RecordWriter writer(out);
+    writer.u32(static_cast<std::uint32_t>(payload.size()));
+    writer.u32(crc32(payload));
+    out.append(payload);
+}
+
+/**
+ * Take one intact frame off the front of in. False when in does not start
+ * with one: it is short, its checksum is wrong, or it is empty (a tail of
+ * zeroes left by a crash parses as empty frames).
+ */
+bool takeFrame(std::string_view& in, std::string_view& payload) {
+    if (in.size() < kFrameHeaderBytes) {
+        return false;
+    }
+    RecordReader header(in.substr(0, kFrameHeaderBytes));
+    const std::uint32_t size = header.u32();
+    const std::uint32_t checksum = header.u32();
+    if (size == 0 || size > in.size() - kFrameHeaderBytes) {
+        return false;
+    }
+    payload = in.substr(kFrameHeaderBytes, size);
+    if (crc32(payload) != checksum) {
+        return false;
+    }
+    in.remove_prefix(kFrameHeaderBytes + size);
+    return true;
+}
+
+void writeEntry(RecordWriter& writer, EntryKind kind, std::size_t partition) {
+    writer.u8(static_cast<std::uint8_t>(kind));
+    writer.u8(static_cast<std::uint8_t>(partition));
+}
+
+void writeCounter(RecordWriter& writer, const InMemoryStore& store, std::size_t partition) {
+    writeEntry(writer, EntryKind::Counter, partition);
+    const int counter = store.counterFor(static_cast<StorePartition>(partition)).load();
+    writer.u64(static_cast<std::uint64_t>(static_cast<std::int64_t>(counter)));
+}
+
+/**
+ * Decode a frame's entries into images and counters. False when the
+ * payload is malformed.
+ */
+bool decodeEntries(InMemoryStore& store,
+                   std::string_view payload,
+                   entities::CommitImages& images,
+                   CounterImages& counters) {
+    RecordReader reader(payload);
+    while (!reader.atEnd()) {
+        const auto kind = static_cast<EntryKind>(reader.u8());
+        const std::size_t partition = reader.u8();
+        if (reader.failed() || partition >= kStorePartitionCount) {
+            return false;
+        }
+        switch (kind) {
+            case EntryKind::Put:
+            case EntryKind::Erase: {
+                std::string key;
+                reader(key);
+                InMemoryStore::withCollection(store, static_cast<StorePartition>(partition), [&](auto& collection) {
+                    using Record = typename std::decay_t<decltype(collection)>::mapped_type;
+                    std::optional<Record> image;
+                    if (kind == EntryKind::Put) {
+                        image.emplace();
+                        decodeRecord(reader, *image);
+                    }
+                    images.of<Record>().emplace_back(std::move(key), std::move(image));
+                });
+                break;
+            }
+            case EntryKind::Counter: {
+                const auto value = static_cast<std::int64_t>(reader.u64());
+                counters[partition] = std::max(counters[partition].value_or(value), value);
+                break;
+            }
+            default:
+                return false;
+        }
+        if (reader.failed()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void applyCounters(InMemoryStore& store, CounterImages& counters) {
+    for (std::size_t partition = 0; partition < kStorePartitionCount; ++partition) {
+        if (counters[partition]) {
+            auto& counter = store.counterFor(static_cast<StorePartition>(partition));
+            counter = std::max<std::int64_t>(counter.load(), *counters[partition]);
+            counters[partition].reset();
+        }
+    }
+}
+
+/**
+ * Check a file's header frame and return the number stored in it
+ */
+std::optional<std::uint64_t> readHeader(std::string_view& in, const std::string& magic) {
+    std::string_view payload;
+    if (!takeFrame(in, payload)) {
+        return std::nullopt;
+    }
+    RecordReader reader(payload);
+    std::string found;
+    reader(found);
+    const std::uint32_t version = reader.u32();
+    const std::uint64_t number = reader.u64();
+    if (reader.failed() || found != magic) {
+        return std::nullopt;
+    }
+    if (version != kRecordFormatVersion) {
+        throw std::runtime_error("Unsupported store format version " + std::to_string(version));
+    }
+    return number;
+}
+
+std::string headerFrame(const std::string& magic, std::uint64_t number) {
+    std::string payload;
+    RecordWriter writer(payload);
+    writer(magic);
+    writer.u32(kRecordFormatVersion);
+    writer.u64(number);
+    std::string frame;
+    appendFrame(frame, payload);
+    return frame;
+}
+
+/**
+ * Check one segment and collect its frames, each with the partitions it
+ * writes to, and the last frame writing each id, applying only its id
+ * counters to store. A damaged frame ends
+ * the last segment, which is cut back to its intact prefix; anywhere else
+ * it is an error.
+ * @returns the segment's size after the cut
+ */
+std::uint64_t scanSegment(InMemoryStore& store,
+                          std::uint64_t segment,
+                          const fs::path& path,
+                          bool last,
+                          std::string& contents,
+                          std::vector<std::pair<std::string_view, unsigned>>& frames,
+                          WriteAheadLog::FramesById& ids,
+                          WriteAheadLog::Recovery& recovery) {
+    if (!readFile(path, contents)) {
+        throw std::runtime_error("Cannot read log segment " + path.string());
+    }
+    std::string_view in(contents);
+    const auto header = readHeader(in, kSegmentMagic);
+    if (!header || *header != segment) {
+        if (!last) {
+            throw std::runtime_error("Corrupt log segment " + path.string());
+        }
+        // Crashed while creating it
+        fs::remove(path);
+        recovery.truncated_tail = true;
+        return 0;
+    }
+
+    entities::CommitImages images;
+    CounterImages counters;
+    while (!in.empty()) {
+        std::string_view payload;
+        if (!takeFrame(in, payload)) {
+            if (!last) {
+                throw std::runtime_error("Corrupt log segment " + path.string());
+            }
+            fs::resize_file(path, contents.size() - in.size());
+            recovery.truncated_tail = true;
+            break;
+        }
+        if (!decodeEntries(store, payload, images, counters)) {
+            throw std::runtime_error("Corrupt log frame in " + path.string());
+        }
+        images.forEachId([&](StorePartition partition, const std::string& id) {
+            ids[static_cast<std::size_t>(partition)][id] = frames.size();
+        });
+        frames.emplace_back(payload, images.partitions());
+        images.clear();
+        applyCounters(store, counters);
+        ++recovery.log_frames;
+    }
+    return contents.size() - in.size();
+}
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog(InMemoryStore& store, const PersistenceConfig& config)
+    : store_(store),
+      directory_(config.directory),
+      group_commit_ms_(std::max(0, config.group_commit_ms)),
+      group_commit_records_(static_cast<std::size_t>(std::max(1, config.group_commit_records))),
+      snapshot_bytes_(static_cast<std::uint64_t>(std::max(1LL, config.snapshot_bytes))) {
+    const fs::path directory(directory_);
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (error) {
+        throw std::runtime_error("Cannot create data directory " + directory_ + ": " + error.message());
+    }
+    fs::remove(directory / kSnapshotTempName, error);
+
+    std::uint64_t first = 0;
+    if (fs::exists(directory / kSnapshotName)) {
+        snapshot_ = SnapshotImage::open((directory / kSnapshotName).string());
+        first = snapshot_->firstSegment();
+        for (std::size_t partition = 0; partition < kStorePartitionCount; ++partition) {
+            const auto which = static_cast<StorePartition>(partition);
+            store_.counterFor(which) = static_cast<int>(snapshot_->counter(which));
+            recovery_.snapshot_records += snapshot_->records(which);
+        }
+    }
+
+    std::uint64_t next = first;
+    const auto segments = listSegments(directory);
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        const auto& [segment, path] = segments[i];
+        if (segment < first) {
+            // Covered by the snapshot; left behind by a crash during checkpoint
+            fs::remove(path, error);
+            continue;
+        }
+        tail_segments_.emplace_back();
+        log_bytes_ += scanSegment(store_, segment, path, i + 1 == segments.size(), tail_segments_.back(),
+                                  tail_frames_, tail_ids_, recovery_);
+        next = segment + 1;
+    }
+
+    openSegment(next);
+    if (snapshot_ || !tail_frames_.empty()) {
+        unloaded_ = kStorePartitionCount;
+        for (std::size_t partition = 0; partition < kStorePartitionCount; ++partition) {
+            markPending(static_cast<StorePartition>(partition));
+        }
+        store_.loader = this;
+    }
+    store_.journal = this;
+    flusher_ = std::thread(&WriteAheadLog::flushLoop, this);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+    if (store_.loader == this) {
+        store_.loader = nullptr;
+    }
+}
+
+void WriteAheadLog::materialize(StorePartition partition) {
+    const unsigned bit = 1u << static_cast<unsigned>(partition);
+    try {
+        // Text indexes are built by the first search, not while loading
+        InMemoryStore::forEachIndex(store_, partition, [](auto& index) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(index)>, NgramIndex>) {
+                index.deferPostings();
+            }
+        });
+        if (snapshot_) {
+            snapshot_->loadPartition(store_, partition);
+        }
+        entities::CommitImages images;
+        CounterImages counters;
+        for (const auto& [payload, partitions] : tail_frames_) {
+            if ((partitions & bit) == 0) {
+                continue;
+            }
+            decodeEntries(store_, payload, images, counters);
+            images.retain(partition);
+            entities::applyCommit(store_, images);
+        }
+    } catch (...) {
+        // Leave the partition empty so a later attempt starts over
+        InMemoryStore::withCollection(store_, partition, [](auto& collection) { collection.clear(); });
+        InMemoryStore::forEachIndex(store_, partition, [](auto& index) { index.clear(); });
+        throw;
+    }
+    if (--unloaded_ == 0) {
+        // Every partition has been loaded; only a peek that started
+        // before the last one may still be reading these
+        std::unique_lock<std::shared_mutex> lock(peek_mutex_);
+        snapshot_.reset();
+        tail_frames_ = {};
+        tail_ids_ = {};
+        tail_segments_ = {};
+    }
+}
+
+bool WriteAheadLog::peek(const std::string& id, std::optional<User>& found) {
+    return peekRecord(id, found);
+}
+
+bool WriteAheadLog::peek(const std::string& id, std::optional<PageConfig>& found) {
+    return peekRecord(id, found);
+}
+
+template<typename Record>
+bool WriteAheadLog::peekRecord(const std::string& id, std::optional<Record>& found) {
+    const StorePartition partition = partitionOf<Record>();
+    std::shared_lock<std::shared_mutex> lock(peek_mutex_);
+    if (unloaded_ == 0 || !pending(partition)) {
+        return false;
+    }
+    // The last logged image of id wins over the snapshot
+    const auto& ids = tail_ids_[static_cast<std::size_t>(partition)];
+    if (auto it = ids.find(id); it != ids.end()) {
+        entities::CommitImages images;
+        CounterImages counters;
+        decodeEntries(store_, tail_frames_[it->second].first, images, counters);
+        found.reset();
+        for (auto& [key, image] : images.of<Record>()) {
+            if (key == id) {
+                found = std::move(image);
+            }
+        }
+        return true;
+    }
+    found = snapshot_ ? snapshot_->lookup<Record>(id) : std::nullopt;
+    return true;
+}
+
+void WriteAheadLog::openSegment(std::uint64_t segment) {
+    const fs::path path = segmentPath(directory_, segment);
+    const int fd = openForWrite(path, true);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create log segment " + path.string());
+    }
+    const std::string header = headerFrame(kSegmentMagic, segment);
+    if (!writeAll(fd, header) || !syncFile(fd)) {
+        closeFile(fd);
+        throw std::runtime_error("Cannot write log segment " + path.string());
+    }
+    syncDirectory(directory_);
+    if (fd_ >= 0) {
+        closeFile(fd_);
+    }
+    fd_ = fd;
+    segment_ = segment;
+    segment_bytes_ = header.size();
+    log_bytes_ += header.size();
+}
+
+void WriteAheadLog::touched(StorePartition partition, const std::string& id) {
+    pending_[static_cast<std::size_t>(partition)].push_back(id);
+}
+
+void WriteAheadLog::commit(const InMemoryStore& store, unsigned exclusive) noexcept {
+    thread_local std::string payload;
+    try {
+        payload.clear();
+        RecordWriter writer(payload);
+        for (std::size_t partition = 0; partition < kStorePartitionCount; ++partition) {
+            auto& ids = pending_[partition];
+            if ((exclusive & (1u << partition)) == 0 || ids.empty()) {
+                continue;
+            }
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            InMemoryStore::withCollection(store, static_cast<StorePartition>(partition), [&](const auto& collection) {
+                for (const auto& id : ids) {
+                    auto it = collection.find(id);
+                    writeEntry(writer, it != collection.end() ? EntryKind::Put : EntryKind::Erase, partition);
+                    writer(id);
+                    if (it != collection.end()) {
+                        encodeRecord(writer, it->second);
+                    }
+                }
+            });
+            writeCounter(writer, store, partition);
+            ids.clear();
+        }
+        if (payload.empty()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        appendFrame(buffer_, payload);
+        ++committed_seq_;
+        if (++buffered_frames_ == 1 || buffered_frames_ >= group_commit_records_) {
+            flush_wanted_.notify_one();
+        }
+    } catch (const std::exception& e) {
+        // Only allocation can fail here; the store is already changed
+        std::cerr << "[dbal] write-ahead log dropped a commit: " << e.what() << std::endl;
+        for (std::size_t partition = 0; partition < kStorePartitionCount; ++partition) {
+            if ((exclusive & (1u << partition)) != 0) {
+                pending_[partition].clear();
+            }
+        }
+    }
+}
+
+bool WriteAheadLog::flushBuffer() {
+    std::string data;
+    std::uint64_t seq = 0;
+    std::size_t frames = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        data.swap(buffer_);
+        seq = committed_seq_;
+        frames = buffered_frames_;
+        buffered_frames_ = 0;
+    }
+
+    const bool written = data.empty() || (writeAll(fd_, data) && syncFile(fd_));
+    if (written) {
+        segment_bytes_ += data.size();
+        log_bytes_ += data.size();
+    } else {
+        // Drop any partial frame so later frames stay readable
+        truncateFile(fd_, segment_bytes_);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (written) {
+        durable_seq_ = std::max(durable_seq_, seq);
+    } else {
+        buffer_.insert(0, data);
+        buffered_frames_ += frames;
+        ++failures_;
+    }
+    flushed_.notify_all();
+    return written;
+}
+
+void WriteAheadLog::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        flush_wanted_.wait(lock, [&] { return stopping_ || buffered_frames_ > 0; });
+        if (buffered_frames_ == 0) {
+            break;
+        }
+        // Let the group fill up
+        flush_wanted_.wait_for(lock, std::chrono::milliseconds(group_commit_ms_), [&] {
+            return stopping_ || sync_waiters_ > 0 || buffered_frames_ >= group_commit_records_;
+        });
+        lock.unlock();
+
+        bool written = false;
+        bool snapshot_due = false;
+        {
+            std::lock_guard<std::mutex> io(io_mutex_);
+            written = flushBuffer();
+            snapshot_due = written && log_bytes_ >= snapshot_bytes_;
+        }
+        if (!written) {
+            std::cerr << "[dbal] write-ahead log write to " << directory_ << " failed; retrying" << std::endl;
+        }
+        if (snapshot_due && !snapshotting_.exchange(true)) {
+            if (snapshotter_.joinable()) {
+                snapshotter_.join();
+            }
+            snapshotter_ = std::thread([this] {
+                if (!checkpoint()) {
+                    std::cerr << "[dbal] snapshot of " << directory_ << " failed" << std::endl;
+                }
+                snapshotting_ = false;
+            });
+        }
+
+        lock.lock();
+        if (!written) {
+            if (stopping_) {
+                break;
+            }
+            flush_wanted_.wait_for(lock, kRetryDelay, [&] { return stopping_; });
+        }
+    }
+    flusher_done_ = true;
+    flushed_.notify_all();
+}
+
+bool WriteAheadLog::sync() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::uint64_t target = committed_seq_;
+    const std::uint64_t failures = failures_;
+    ++sync_waiters_;
+    flush_wanted_.notify_one();
+    flushed_.wait(lock, [&] { return durable_seq_ >= target || failures_ != failures || flusher_done_; });
+    --sync_waiters_;
+    return durable_seq_ >= target;
+}
+
+bool WriteAheadLog::checkpoint() {
+    std::lock_guard<std::mutex> serial(checkpoint_mutex_);
+    std::string image;
+    std::uint64_t first = 0;
+    {
+        // Readers only: writes wait, so everything committed is in the buffer
+        StoreLock lock(store_, {readLock(StorePartition::Users),
+                                readLock(StorePartition::Credentials),
+                                readLock(StorePartition::Pages),
+                                readLock(StorePartition::Components),
+                                readLock(StorePartition::Workflows),
+                                readLock(StorePartition::Sessions),
+                                readLock(StorePartition::Packages)});
+        std::lock_guard<std::mutex> io(io_mutex_);
+        if (fd_ < 0 || !flushBuffer()) {
+            return false;
+        }
+        try {
+            openSegment(segment_ + 1);
+            first = segment_;
+            image = SnapshotImage::build(store_, first);
+        } catch (const std::exception& e) {
+            std::cerr << "[dbal] " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    const fs::path directory(directory_);
+    const fs::path temp = directory / kSnapshotTempName;
+    const int fd = openForWrite(temp, true);
+    if (fd < 0) {
+        return false;
+    }
+    const bool written = writeAll(fd, image) && syncFile(fd);
+    closeFile(fd);
+    std::error_code error;
+    if (!written) {
+        fs::remove(temp, error);
+        return false;
+    }
+    fs::rename(temp, directory / kSnapshotName, error);
+    if (error) {
+        return false;
+    }
+    syncDirectory(directory);
+
+    std::lock_guard<std::mutex> io(io_mutex_);
+    for (const auto& [segment, path] : listSegments(directory)) {
+        if (segment < first) {
+            const auto size = fs::file_size(path, error);
+            if (fs::remove(path, error) && size != static_cast<std::uintmax_t>(-1)) {
+                log_bytes_ -= std::min<std::uint64_t>(log_bytes_, size);
+            }
+        }
+    }
+    return true;
+}
+
+void WriteAheadLog::close() {
+    if (!flusher_.joinable()) {
+        return;
+    }
+    {
+        // Writers hold a partition while they commit, so with every stripe
+        // held none is mid-commit. Not a StoreLock: that would load every
+        // partition still on disk just to shut down.
+        for (auto& partition : store_.partition_locks) {
+            for (auto& stripe : partition.stripes) {
+                stripe.mutex.lock();
+            }
+        }
+        if (store_.journal == this) {
+            store_.journal = nullptr;
+        }
+        for (auto partition = store_.partition_locks.rbegin(); partition != store_.partition_locks.rend();
+             ++partition) {
+            for (auto stripe = partition->stripes.rbegin(); stripe != partition->stripes.rend(); ++stripe) {
+                stripe->mutex.unlock();
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    flush_wanted_.notify_all();
+    flusher_.join();
+    if (snapshotter_.joinable()) {
+        snapshotter_.join();
+    }
+
+    std::lock_guard<std::mutex> io(io_mutex_);
+    if (fd_ >= 0) {
+        closeFile(fd_);
+        fd_ = -1;
+    }
+}
+
+} // namespace dbal
@@ -0,0 +1,174 @@
+/**
+ * @file write_ahead_log.hpp
+ * @brief Durable journal for the in-memory store
+ *
+ * Every commit (the exclusive partitions a StoreLock releases) is
+ * appended to the log as one checksummed frame holding the after-image
+ * of each record written under it: the record's new value, or an erase
+ * marker, plus the partition's id counter. A flusher thread writes the
+ * frames buffered since its last pass and syncs them in one go, at most
+ * group_commit_ms after the first of them or as soon as
+ * group_commit_records are waiting, so writers never wait on the disk
+ * and a crash loses at most one group-commit window.
+ *
+ * Once the log outgrows snapshot_bytes the store is written out as a
+ * snapshot (store_snapshot.hpp) and the segments it covers are deleted.
+ * Recovery maps the snapshot and checks the segments after it; a frame
+ * torn by a crash at the end of the last segment is cut off, corruption
+ * anywhere else is an error.
+ *
+ * Recovery only restores the id counters up front. The log then stays
+ * attached as the store's loader: the first lock on a partition loads
+ * its part of the snapshot and replays the logged writes to it, so the
+ * store is usable as soon as the files have been checked, and a large
+ * store pays for each partition only when it is first used. Until then
+ * a user or page is read by id straight from the snapshot's rows, or
+ * from the last logged frame that wrote it.
+ *
+ * Directory layout:
+ *   snapshot              store image and the first segment not in it
+ *   wal-<segment>.log     log segments, replayed in segment order
+ */
+#ifndef DBAL_WRITE_AHEAD_LOG_HPP
+#define DBAL_WRITE_AHEAD_LOG_HPP
+
+#include "in_memory_store.hpp"
+#include "store_snapshot.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dbal {
+
+class WriteAheadLog : public StoreJournal, public StoreLoader {
+public:
+    /**
+     * What recovery found on disk
+     */
+    struct Recovery {
+        std::size_t snapshot_records = 0;
+        std::size_t log_frames = 0;
+        bool truncated_tail = false;
+    };
+
+    /**
+     * Per partition, the index of the last logged frame writing each id
+     */
+    using FramesById = std::array<std::unordered_map<std::string, std::size_t>, kStorePartitionCount>;
+
+    /**
+     * Check directory's snapshot and log, then attach to store, which must
+     * be empty and not yet shared, as its journal and loader
+     *
+     * @throws std::runtime_error when the directory cannot be used or its
+     *         contents are corrupt
+     */
+    WriteAheadLog(InMemoryStore& store, const PersistenceConfig& config);
+    ~WriteAheadLog() override;
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    const Recovery& recovery() const {
+        return recovery_;
+    }
+
+    void touched(StorePartition partition, const std::string& id) override;
+    void commit(const InMemoryStore& store, unsigned exclusive) noexcept override;
+
+    bool peek(const std::string& id, std::optional<User>& found) override;
+    bool peek(const std::string& id, std::optional<PageConfig>& found) override;
+
+    /**
+     * Block until every commit made so far is on disk
+     * @returns false when the log could not be written
+     */
+    bool sync();
+
+    /**
+     * Write a snapshot now and drop the segments it covers. Takes every
+     * partition shared, loading any not used yet, so it must not be
+     * called from inside a batch.
+     * @returns false when the snapshot could not be written
+     */
+    bool checkpoint();
+
+    /**
+     * Sync, stop the flusher and detach from the store
+     */
+    void close();
+
+protected:
+    void materialize(StorePartition partition) override;
+
+private:
+    void flushLoop();
+    // Write and sync the buffered frames; caller holds io_mutex_
+    bool flushBuffer();
+    // Start a new segment and make it current; caller holds io_mutex_
+    void openSegment(std::uint64_t segment);
+    template<typename Record>
+    bool peekRecord(const std::string& id, std::optional<Record>& found);
+
+    InMemoryStore& store_;
+    std::string directory_;
+    int group_commit_ms_;
+    std::size_t group_commit_records_;
+    std::uint64_t snapshot_bytes_;
+    Recovery recovery_;
+
+    // Ids touched per partition since its last commit; each list is only
+    // used under its partition's exclusive lock
+    std::array<std::vector<std::string>, kStorePartitionCount> pending_;
+
+    // What recovery found, until every partition has been loaded from it:
+    // the snapshot and the logged frames after it, each with the mask of
+    // partitions it wrote to. Only read while partitions are loading or
+    // under peek_mutex_, which is held exclusively to drop them.
+    std::unique_ptr<SnapshotImage> snapshot_;
+    std::deque<std::string> tail_segments_;  // tail_frames_ points into these
+    std::vector<std::pair<std::string_view, unsigned>> tail_frames_;
+    FramesById tail_ids_;
+    std::atomic<std::size_t> unloaded_{0};
+    std::shared_mutex peek_mutex_;
+
+    // Frames committed but not yet written, guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable flush_wanted_;
+    std::condition_variable flushed_;
+    std::string buffer_;
+    std::size_t buffered_frames_ = 0;
+    std::uint64_t committed_seq_ = 0;
+    std::uint64_t durable_seq_ = 0;
+    std::uint64_t failures_ = 0;
+    std::size_t sync_waiters_ = 0;
+    bool stopping_ = false;
+    bool flusher_done_ = false;
+
+    // Current segment, guarded by io_mutex_ (taken before mutex_)
+    std::mutex io_mutex_;
+    int fd_ = -1;
+    std::uint64_t segment_ = 0;
+    std::uint64_t segment_bytes_ = 0;
+    std::uint64_t log_bytes_ = 0;  // All live segments
+
+    std::mutex checkpoint_mutex_;
+    std::atomic<bool> snapshotting_{false};
+    std::thread snapshotter_;
+    std::thread flusher_;
+};
+
+} // namespace dbal
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file timing_wheel.hpp
+ * @brief Hierarchical timing wheel for expiring entries by deadline
+ *
+ * Deadlines are rounded up to whole ticks and kept in four levels of 64
+ * slots; level l covers deadlines up to 64^(l+1) ticks ahead. Scheduling
+ * and cancelling are O(1). Advancing the wheel fires the level-0 slot of
+ * each tick it passes and, every 64^l ticks, moves one slot of level l
+ * down to the levels below, so each entry is touched at most once per
+ * level. Deadlines more than 64^4 ticks away wait in the last level and
+ * are placed again as it comes round.
+ *
+ * Entries live in one vector with a free list and are linked into their
+ * slot by index; a Handle carries the entry's generation, so cancelling
+ * an entry that has already fired or been reused does nothing.
+ *
+ * Not synchronized: callers guard the wheel with their own lock.
+ */
+#ifndef DBAL_TIMING_WHEEL_HPP
+#define DBAL_TIMING_WHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dbal {
+namespace util {
+
+template <typename T, typename Clock = std::chrono::steady_clock>
+class TimingWheel {
+public:
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+
+    /**
+     * Names a scheduled entry; default-constructed handles name nothing
+     */
+    struct Handle {
+        std::uint32_t index = kNone;
+        std::uint32_t generation = 0;
+
+        explicit operator bool() const {
+            return index != kNone;
+        }
+    };
+
+    /**
+     * @param tick  resolution; entries fire up to one tick after their
+     *              deadline, never before it
+     * @param start time of tick 0
+     */
+    explicit TimingWheel(duration tick, time_point start = Clock::now())
+        : tick_(tick), origin_(start) {
+        buckets_.fill(kNone);
+    }
+
+    /**
+     * Schedule payload to fire at the first advance() at or past deadline
+     */
+    Handle schedule(time_point deadline, T payload) {
+        std::uint32_t index;
+        if (free_ != kNone) {
+            index = free_;
+            free_ = nodes_[index].next;
+        } else {
+            index = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node& node = nodes_[index];
+        node.payload = std::move(payload);
+        node.tick = std::max(tickAtOrAfter(deadline), next_tick_);
+        link(index);
+        ++size_;
+        return Handle{index, node.generation};
+    }
+
+    /**
+     * Drop a scheduled entry
+     * @return false when handle no longer names one
+     */
+    bool cancel(Handle handle) {
+        if (handle.index >= nodes_.size()) {
+            return false;
+        }
+        Node& node = nodes_[handle.index];
+        if (node.generation != handle.generation || node.bucket == kNone) {
+            return false;
+        }
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    /**
+     * Fire every entry whose deadline is at or before now, in deadline
+     * order to the tick, calling fire(T&&) for each
+     * @return number of entries fired
+     */
+    template <typename Fire>
+    std::size_t advance(time_point now, Fire&& fire) {
+        if (now < origin_) {
+            return 0;
+        }
+        const std::uint64_t last = static_cast<std::uint64_t>((now - origin_) / tick_);
+        std::size_t fired = 0;
+        while (next_tick_ <= last) {
+            if (size_ == 0) {
+                next_tick_ = last + 1;
+                break;
+            }
+            const std::uint32_t slot = static_cast<std::uint32_t>(next_tick_ & kSlotMask);
+            if (slot == 0) {
+                for (unsigned level = 1; level < kLevels && cascade(level) == 0; ++level) {
+                }
+            }
+            // One at a time, so fire may schedule and cancel entries
+            while (buckets_[slot] != kNone) {
+                const std::uint32_t index = buckets_[slot];
+                T payload = std::move(nodes_[index].payload);
+                unlink(index);
+                release(index);
+                ++fired;
+                fire(std::move(payload));
+            }
+            ++next_tick_;
+        }
+        return fired;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * Drop every entry; handles to them stop naming anything
+     */
+    void clear() {
+        for (std::uint32_t index = 0; index < nodes_.size(); ++index) {
+            if (nodes_[index].bucket != kNone) {
+                nodes_[index].bucket = kNone;
+                release(index);
+            }
+        }
+        buckets_.fill(kNone);
+    }
+
+private:
+    static constexpr std::uint32_t kNone = ~std::uint32_t{0};
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr unsigned kLevels = 4;
+    static constexpr std::uint64_t kSlots = std::uint64_t{1} << kSlotBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+    static constexpr std::uint64_t kSpan = std::uint64_t{1} << (kSlotBits * kLevels);
+
+    struct Node {
+        T payload{};
+        std::uint64_t tick = 0;
+        std::uint32_t prev = kNone;
+        std::uint32_t next = kNone;  // Also links the free list
+        std::uint32_t bucket = kNone;
+        std::uint32_t generation = 0;
+    };
+
+    std::uint64_t tickAtOrAfter(time_point deadline) const {
+        if (deadline <= origin_) {
+            return 0;
+        }
+        const duration since = deadline - origin_;
+        const auto ticks = static_cast<std::uint64_t>(since / tick_);
+        return since % tick_ == duration::zero() ? ticks : ticks + 1;
+    }
+
+    std::uint32_t bucketFor(std::uint64_t tick) const {
+        const std::uint64_t ahead = tick - next_tick_;
+        for (unsigned level = 0; level < kLevels; ++level) {
+            if (ahead < (kSlots << (kSlotBits * level))) {
+                return static_cast<std::uint32_t>(level * kSlots + ((tick >> (kSlotBits * level)) & kSlotMask));
+            }
+        }
+        const std::uint64_t latest = next_tick_ + kSpan - 1;
+        return static_cast<std::uint32_t>((kLevels - 1) * kSlots + ((latest >> (kSlotBits * (kLevels - 1))) & kSlotMask));
+    }
+
+    void link(std::uint32_t index) {
+        Node& node = nodes_[index];
+        node.bucket = bucketFor(node.tick);
+        node.prev = kNone;
+        node.next = buckets_[node.bucket];
+        if (node.next != kNone) {
+            nodes_[node.next].prev = index;
+        }
+        buckets_[node.bucket] = index;
+    }
+
+    void unlink(std::uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != kNone) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            buckets_[node.bucket] = node.next;
+        }
+        if (node.next != kNone) {
+            nodes_[node.next].prev = node.prev;
+        }
+        node.bucket = kNone;
+    }
+
+    void release(std::uint32_t index) {
+        Node& node = nodes_[index];
+        node.payload = T{};
+        ++node.generation;
+        node.next = free_;
+        free_ = index;
+        --size_;
+    }
+
+    /**
+     * Re-place the entries of level's slot for the coming tick
+     * @return that slot's index, zero when the level above is due too
+     */
+    std::uint32_t cascade(unsigned level) {
+        const auto slot = static_cast<std::uint32_t>((next_tick_ >> (kSlotBits * level)) & kSlotMask);
+        std::uint32_t index = buckets_[level * kSlots + slot];
+        buckets_[level * kSlots + slot] = kNone;
+        while (index != kNone) {
+            const std::uint32_t next = nodes_[index].next;
+            link(index);
+            index = next;
+        }
+        return slot;
+    }
+
+    duration tick_;
+    time_point origin_;
+    std::uint64_t next_tick_ = 0;
+    std::array<std::uint32_t, kLevels * kSlots> buckets_;
+    std::vector<Node> nodes_;
+    std::uint32_t free_ = kNone;
+    std::size_t size_ = 0;
+};
+
+} // namespace util
+} // namespace dbal
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file blob_dedup_benchmark.cpp
+ * @brief Deduplication ratio and upload cost of the in-memory blob store
+ *
+ * Simulates tenants installing the same package assets: every tenant
+ * uploads a shared set of assets unchanged, a fraction of tenants upload
+ * patched copies (64 bytes inserted somewhere in the middle, which
+ * shifts every later byte), and tenants may add assets of their own.
+ * Reports, per scenario, logical bytes uploaded against physical bytes
+ * stored and the throughput of the upload calls alone.
+ *
+ * Usage: blob_dedup_benchmark [tenants] [asset KiB]
+ */
+
+#include "blob/memory_storage.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<char> randomBytes(size_t size, unsigned seed) {
+    std::vector<char> data(size);
+    unsigned long long state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    for (auto& byte : data) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        byte = static_cast<char>(state);
+    }
+    return data;
+}
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* label, dbal::blob::MemoryStorage& storage, size_t uploaded, double elapsed) {
+    const auto usage = storage.usage();
+    const double mib = 1024.0 * 1024.0;
+    std::cout << "  " << std::left << std::setw(24) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << usage.logical_bytes / mib << " MiB logical" << std::setw(9)
+              << storage.storedBytes() / mib << " MiB stored" << std::setw(8) << std::setprecision(2)
+              << static_cast<double>(usage.logical_bytes) / static_cast<double>(storage.storedBytes())
+              << "x" << std::setw(9) << std::setprecision(0) << uploaded / mib / elapsed << " MiB/s"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int tenants = argc > 1 ? std::atoi(argv[1]) : 64;
+    const size_t asset_bytes = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024) * 1024;
+    constexpr int kSharedAssets = 8;
+
+    std::vector<std::vector<char>> shared;
+    for (int i = 0; i < kSharedAssets; ++i) {
+        shared.push_back(randomBytes(asset_bytes, 100 + i));
+    }
+
+    std::cout << "Blob dedup benchmark (" << tenants << " tenants, " << kSharedAssets << " shared assets of "
+              << asset_bytes / 1024 << " KiB)" << std::endl;
+
+    auto run = [&](const char* label, int shared_assets, int patched_percent, int own_assets) {
+        dbal::blob::MemoryStorage storage;
+        size_t uploaded = 0;
+        double elapsed = 0;
+        auto upload = [&](const std::string& key, const std::vector<char>& asset) {
+            const auto start = std::chrono::steady_clock::now();
+            storage.upload(key, asset, {});
+            elapsed += seconds(start);
+            uploaded += asset.size();
+        };
+        for (int t = 0; t < tenants; ++t) {
+            const std::string ns = "tenant" + std::to_string(t) + ":";
+            for (int i = 0; i < shared_assets; ++i) {
+                auto asset = shared[i];
+                if ((t * kSharedAssets + i) % 100 < patched_percent) {
+                    // A small edit somewhere past the first chunk
+                    const size_t at = asset.size() / 3 + static_cast<size_t>(t) * 4099 % (asset.size() / 3);
+                    const auto patch = randomBytes(64, 7 * t + i);
+                    asset.insert(asset.begin() + static_cast<long>(at), patch.begin(), patch.end());
+                }
+                upload(ns + "assets/" + std::to_string(i), asset);
+            }
+            for (int i = 0; i < own_assets; ++i) {
+                upload(ns + "own/" + std::to_string(i), randomBytes(asset_bytes, 10000 + t * 16 + i));
+            }
+        }
+        report(label, storage, uploaded, elapsed);
+    };
+
+    run("shared, unchanged", kSharedAssets, 0, 0);
+    run("shared, 25% patched", kSharedAssets, 25, 0);
+    run("shared + 1 own each", kSharedAssets, 25, 1);
+    run("own assets only", 0, 0, kSharedAssets);
+    return 0;
+}
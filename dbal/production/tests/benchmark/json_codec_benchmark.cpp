@@ -0,0 +1,143 @@
+/**
+ * @file json_codec_benchmark.cpp
+ * @brief Allocations and time per user request body decode and response encode
+ *
+ * The "dom" rows follow the old REST path: the body is copied into an
+ * istringstream, parsed into a Json::Value, read into CreateUserInput,
+ * and the response is built as a Json::Value envelope and serialized with
+ * a StreamWriter. The "direct" rows decode the body from its bytes with
+ * JsonReader and write the envelope with JsonWriter into one buffer.
+ *
+ * Usage: json_codec_benchmark [iterations]
+ */
+
+#include "daemon/server_helpers/role.hpp"
+#include "daemon/server_helpers/serialization.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+} // namespace
+
+// GCC flags free() on memory from the replaced operator new even though
+// both sides use malloc
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+using namespace dbal::daemon;
+
+constexpr std::string_view kCreateBody =
+    R"({"username":"alice_0123456789","email":"alice.0123456789@example.com","role":"Admin",)"
+    R"("profile":{"bio":"ignored by the user handlers","tags":["a","b","c"]}})";
+
+size_t domDecode(std::string_view body) {
+    std::istringstream stream{std::string(body)};
+    ::Json::CharReaderBuilder reader;
+    ::Json::Value payload;
+    JSONCPP_STRING errs;
+    if (!::Json::parseFromStream(reader, stream, &payload, &errs)) {
+        return 0;
+    }
+    dbal::CreateUserInput input;
+    input.username = payload.get("username", "").asString();
+    input.email = payload.get("email", "").asString();
+    if (payload.isMember("role") && payload["role"].isString()) {
+        input.role = normalize_role(payload["role"].asString());
+    }
+    return input.username.size() + input.email.size();
+}
+
+size_t directDecode(std::string_view body) {
+    dbal::CreateUserInput input;
+    std::string error;
+    if (!read_create_user_input(body, input, error)) {
+        return 0;
+    }
+    return input.username.size() + input.email.size();
+}
+
+size_t domEncode(const dbal::User& user) {
+    ::Json::Value body;
+    body["success"] = true;
+    body["data"] = user_to_json(user);
+    ::Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return ::Json::writeString(writer, body).size();
+}
+
+size_t directEncode(const dbal::User& user) {
+    std::string body;
+    body.reserve(256);
+    JsonWriter writer(body);
+    writer.beginObject().field("success", true).key("data");
+    write_user(writer, user);
+    writer.endObject();
+    return body.size();
+}
+
+template<typename Fn>
+void measure(const char* label, int iterations, Fn&& fn) {
+    fn();  // warm the thread-local reader and allocator
+    const uint64_t before = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const double per_call = static_cast<double>(allocations.load() - before) / iterations;
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(8) << per_call << " allocs/op" << std::setw(10)
+              << std::setprecision(0) << elapsed.count() / iterations << " ns/op" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    dbal::User user;
+    user.id = "user_0123456789abcdef0123";
+    user.tenantId = "tenant_0123456789";
+    user.username = "alice_0123456789";
+    user.email = "alice.0123456789@example.com";
+    user.role = "admin";
+    user.createdAt = std::chrono::system_clock::now();
+    size_t sink = 0;
+
+    std::cout << "JSON codec benchmark (" << iterations << " iterations)" << std::endl;
+    measure("dom decode create", iterations, [&]() { sink += domDecode(kCreateBody); });
+    measure("direct decode create", iterations, [&]() { sink += directDecode(kCreateBody); });
+    measure("dom encode user", iterations, [&]() { sink += domEncode(user); });
+    measure("direct encode user", iterations, [&]() { sink += directEncode(user); });
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file password_hash_benchmark.cpp
+ * @brief Logins per second through the async credential path
+ *
+ * Verifies one stored credential from many concurrent callers through
+ * Client::verifyCredentialAsync, for a range of scrypt costs, and reports
+ * logins per second overall and per hashing thread, the latency a login
+ * saw from submit to callback, and how many were turned away with 503.
+ *
+ * Usage: password_hash_benchmark [hashing threads] [logins per cost] [queue limit]
+ */
+
+#include "dbal/core/client.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<size_t>(p * (samples.size() - 1))];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+    const int logins = argc > 2 ? std::atoi(argv[2]) : 200;
+    const size_t max_queued = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 256;
+
+    std::cout << "Password hash benchmark (" << threads << " hashing threads, " << logins
+              << " logins per cost, queue limit " << max_queued << ")" << std::endl;
+
+    for (unsigned cost_log2 : {12u, 14u, 15u, 16u}) {
+        dbal::ClientConfig config;
+        config.adapter = "sqlite";
+        config.database_url = ":memory:";
+        config.password_hashing.workers = threads;
+        config.password_hashing.max_queued = max_queued;
+        config.password_hashing.cost_log2 = cost_log2;
+        dbal::Client client(config);
+
+        dbal::CreateUserInput user;
+        user.username = "bench_user";
+        user.email = "bench_user@example.com";
+        client.createUser(user);
+        dbal::CreateCredentialInput credential;
+        credential.username = user.username;
+        credential.passwordHash = "benchmark-password";
+        client.setCredential(credential);
+
+        std::mutex mutex;
+        std::condition_variable finished;
+        int answered = 0;
+        int rejected = 0;
+        std::vector<double> latencies;
+
+        const auto start = Clock::now();
+        for (int i = 0; i < logins; ++i) {
+            const auto submitted = Clock::now();
+            client.verifyCredentialAsync(user.username, credential.passwordHash,
+                                         [&, submitted](dbal::Result<bool> result) {
+                const double ms =
+                    std::chrono::duration<double, std::milli>(Clock::now() - submitted).count();
+                std::lock_guard<std::mutex> lock(mutex);
+                if (result.isOk()) {
+                    latencies.push_back(ms);
+                } else {
+                    ++rejected;
+                }
+                if (++answered == logins) {
+                    finished.notify_one();
+                }
+            });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return answered == logins; });
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        const double per_second = latencies.size() / seconds;
+        std::cout << "  cost 2^" << std::left << std::setw(3) << cost_log2 << std::right << std::fixed
+                  << std::setprecision(0) << std::setw(6) << (128.0 * 8 * (1u << cost_log2)) / (1024 * 1024)
+                  << " MiB" << std::setw(9) << per_second << " logins/s" << std::setw(8)
+                  << per_second / threads << " /thread" << std::setprecision(1) << "  p50 "
+                  << percentile(latencies, 0.5) << " ms  p99 " << percentile(latencies, 0.99) << " ms  503s "
+                  << rejected << std::endl;
+    }
+    return 0;
+}
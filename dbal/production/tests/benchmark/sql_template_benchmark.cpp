@@ -0,0 +1,135 @@
+/**
+ * @file sql_template_benchmark.cpp
+ * @brief Allocations and time per SqlAdapter::getUser with cached templates
+ *
+ * Drives getUser/updateUser against a transport stub that returns a canned
+ * row, counting global allocations per call. The "legacy" rows rebuild the
+ * statement the way the adapter used to (string concatenation plus named
+ * string parameters) for comparison. The one allocation left in getUser
+ * is the stub's result vector; statement text and parameters add none.
+ *
+ * Usage: sql_template_benchmark [iterations]
+ */
+
+#include "adapters/sql/sql_adapter.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+} // namespace
+
+// GCC flags free() on memory from the replaced operator new even though
+// both sides use malloc
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+using namespace dbal::adapters::sql;
+
+class StubAdapter : public SqlAdapter {
+public:
+    StubAdapter() : SqlAdapter(SqlConnectionConfig(), Dialect::Postgres) {
+        row_.id = "u_1";
+        row_.username = "alice";
+        row_.email = "a@example.com";
+        row_.role = "user";
+        row_.createdAt = std::chrono::system_clock::now();
+    }
+
+    size_t cachedTemplates() const {
+        return templates_.size();
+    }
+
+protected:
+    std::vector<dbal::User> queryUsers(SqlConnection*, const std::string& sql, const SqlParams& params) override {
+        sink_ += sql.size() + params.size();
+        return {row_};
+    }
+
+private:
+    dbal::User row_;
+    size_t sink_ = 0;
+};
+
+struct LegacyParam {
+    std::string name;
+    std::string value;
+};
+
+// The pre-template statement construction, kept for comparison
+size_t legacyGetUserStatement(const std::string& id) {
+    const auto placeholder = [](size_t index) { return "$" + std::to_string(index); };
+    const auto fields = []() {
+        return std::string("id, tenantId, username, email, role, profilePicture, bio, createdAt, isInstanceOwner, "
+                           "passwordChangeTimestamp, firstLogin");
+    };
+    const std::string sql = "SELECT " + fields() + " FROM users WHERE id = " + placeholder(1);
+    const std::vector<LegacyParam> params = {{"id", id}};
+    return sql.size() + params.size();
+}
+
+template<typename Fn>
+void measure(const char* label, int iterations, Fn&& fn) {
+    fn();  // warm caches and the template
+    const uint64_t before = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const double per_call = static_cast<double>(allocations.load() - before) / iterations;
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(8) << per_call << " allocs/op" << std::setw(10)
+              << std::setprecision(0) << elapsed.count() / iterations << " ns/op" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    StubAdapter adapter;
+    // Long enough to defeat the small-string optimisation
+    const std::string id = "user_0123456789abcdef0123";
+    size_t sink = 0;
+
+    std::cout << "SQL template benchmark (" << iterations << " iterations)" << std::endl;
+    measure("legacy statement build", iterations, [&]() { sink += legacyGetUserStatement(id); });
+    measure("getUser", iterations, [&]() { sink += adapter.getUser(id).isOk() ? 1 : 0; });
+
+    dbal::UpdateUserInput update;
+    update.email = "alice@example.org";
+    update.role = "admin";
+    measure("updateUser (2 fields)", iterations, [&]() { sink += adapter.updateUser(id, update).isOk() ? 1 : 0; });
+
+    std::cout << "  cached templates: " << adapter.cachedTemplates() << std::endl;
+    return sink == 0 ? 1 : 0;
+}
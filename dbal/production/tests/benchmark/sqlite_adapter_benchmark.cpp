@@ -0,0 +1,195 @@
+/**
+ * @file sqlite_adapter_benchmark.cpp
+ * @brief SQLite adapter throughput compared with the in-memory store
+ *
+ * Runs the same workload against the in-memory Client, SQLite ":memory:"
+ * and a file-backed SQLite database in WAL mode: one batched insert, point
+ * reads, paged lists and single-row updates, then concurrent point reads.
+ * The gap to the in-memory store is the cost of durability; the WAL read
+ * numbers show whether per-thread readers scale.
+ *
+ * Usage: sqlite_adapter_benchmark [users] [ops] [threads]
+ */
+
+#include "dbal/client.hpp"
+#include "dbal/errors.hpp"
+#include "adapters/sqlite/sqlite_adapter.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double opsPerSecond(long ops, Clock::time_point start) {
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    return static_cast<double>(ops) / elapsed.count();
+}
+
+void report(const char* phase, double ops) {
+    std::cout << "    " << std::left << std::setw(14) << phase << std::right << std::setw(12)
+              << std::fixed << std::setprecision(0) << ops << " ops/sec" << std::endl;
+}
+
+template<typename Backend>
+std::vector<std::string> seedUsers(Backend& backend, int users) {
+    std::vector<dbal::CreateUserInput> inputs;
+    inputs.reserve(static_cast<size_t>(users));
+    for (int i = 0; i < users; ++i) {
+        dbal::CreateUserInput input;
+        input.username = "bench_user_" + std::to_string(i);
+        input.email = input.username + "@example.com";
+        input.role = (i % 10 == 0) ? "admin" : "user";
+        input.tenantId = "tenant_" + std::to_string(i % 4);
+        inputs.push_back(input);
+    }
+
+    const auto start = Clock::now();
+    auto created = backend.batchCreateUsers(inputs);
+    if (created.isError()) {
+        std::cerr << "    batch insert failed: " << created.error().what() << std::endl;
+        return {};
+    }
+    report("batch insert", opsPerSecond(users, start));
+
+    std::vector<std::string> ids;
+    dbal::ListOptions options;
+    options.limit = 500;
+    for (options.page = 1;; ++options.page) {
+        auto page = backend.listUsers(options);
+        if (page.isError() || page.value().empty()) {
+            break;
+        }
+        for (const auto& user : page.value()) {
+            ids.push_back(user.id);
+        }
+    }
+    return ids;
+}
+
+template<typename Backend>
+void runSerial(Backend& backend, const std::vector<std::string>& ids, int ops) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+    long failures = 0;
+
+    auto start = Clock::now();
+    for (int i = 0; i < ops; ++i) {
+        failures += backend.getUser(ids[pick(rng)]).isError() ? 1 : 0;
+    }
+    report("get", opsPerSecond(ops, start));
+
+    dbal::ListOptions options;
+    options.limit = 20;
+    options.filter["tenantId"] = "tenant_1";
+    const int list_ops = ops / 10;
+    start = Clock::now();
+    for (int i = 0; i < list_ops; ++i) {
+        options.page = 1 + (i % 10);
+        failures += backend.listUsers(options).isError() ? 1 : 0;
+    }
+    report("list", opsPerSecond(list_ops, start));
+
+    const int update_ops = ops / 10;
+    start = Clock::now();
+    for (int i = 0; i < update_ops; ++i) {
+        dbal::UpdateUserInput update;
+        update.bio = "bio " + std::to_string(i);
+        failures += backend.updateUser(ids[pick(rng)], update).isError() ? 1 : 0;
+    }
+    report("update", opsPerSecond(update_ops, start));
+
+    if (failures > 0) {
+        std::cerr << "    " << failures << " operations failed" << std::endl;
+    }
+}
+
+template<typename Backend>
+void runConcurrentReads(Backend& backend, const std::vector<std::string>& ids, int ops, int threads) {
+    std::atomic<bool> go{false};
+    std::atomic<long> failures{0};
+    std::vector<std::thread> workers;
+    const int per_thread = ops / threads;
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 rng(static_cast<unsigned>(t + 1));
+            std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < per_thread; ++i) {
+                if (backend.getUser(ids[pick(rng)]).isError()) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const std::string phase = "get x" + std::to_string(threads);
+    report(phase.c_str(), opsPerSecond(static_cast<long>(per_thread) * threads, start));
+    if (failures.load() > 0) {
+        std::cerr << "    " << failures.load() << " operations failed" << std::endl;
+    }
+}
+
+template<typename Backend>
+void runAll(const char* name, Backend& backend, int users, int ops, int threads) {
+    std::cout << "  " << name << std::endl;
+    const auto ids = seedUsers(backend, users);
+    if (ids.empty()) {
+        return;
+    }
+    runSerial(backend, ids, ops);
+    runConcurrentReads(backend, ids, ops, threads);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int users = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int ops = argc > 2 ? std::atoi(argv[2]) : 100000;
+    const int threads = argc > 3 ? std::atoi(argv[3]) : 4;
+
+    std::cout << "SQLite adapter benchmark (" << users << " users, " << ops << " ops, "
+              << threads << " reader threads)" << std::endl;
+
+    {
+        dbal::ClientConfig config;
+        config.adapter = "sqlite";
+        config.database_url = ":memory:";
+        dbal::Client client(config);
+        runAll("in-memory store", client, users, ops, threads);
+    }
+
+    {
+        dbal::adapters::sqlite::SQLiteAdapter adapter(":memory:");
+        runAll("sqlite :memory:", adapter, users, ops, threads);
+    }
+
+    const std::string path = "/tmp/dbal_sqlite_benchmark_" + std::to_string(::getpid()) + ".db";
+    {
+        dbal::adapters::sqlite::SQLiteAdapter adapter(path);
+        runAll("sqlite file (WAL)", adapter, users, ops, threads);
+    }
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+    return 0;
+}
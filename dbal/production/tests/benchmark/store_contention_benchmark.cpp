@@ -0,0 +1,145 @@
+/**
+ * @file store_contention_benchmark.cpp
+ * @brief Throughput of the in-memory store under concurrent clients
+ *
+ * Each worker runs a read-heavy mix (getUser / getPage / listUsers) with a
+ * small share of updates against one shared Client. Reports ops/sec per
+ * thread count so lock striping regressions show up as flat scaling.
+ *
+ * Usage: store_contention_benchmark [ops_per_thread] [write_percent]
+ */
+
+#include "dbal/client.hpp"
+#include "dbal/errors.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kSeedUsers = 1000;
+constexpr int kSeedPages = 200;
+
+struct Fixture {
+    std::vector<std::string> user_ids;
+    std::vector<std::string> page_ids;
+};
+
+Fixture seed(dbal::Client& client) {
+    Fixture fixture;
+    for (int i = 0; i < kSeedUsers; ++i) {
+        dbal::CreateUserInput input;
+        input.username = "bench_user_" + std::to_string(i);
+        input.email = input.username + "@example.com";
+        auto result = client.createUser(input);
+        if (result.isOk()) {
+            fixture.user_ids.push_back(result.value().id);
+        }
+    }
+    for (int i = 0; i < kSeedPages; ++i) {
+        dbal::CreatePageInput input;
+        input.path = "/bench/" + std::to_string(i);
+        input.title = "Bench page " + std::to_string(i);
+        input.level = 1;
+        input.requiresAuth = false;
+        input.componentTree = "{}";
+        auto result = client.createPage(input);
+        if (result.isOk()) {
+            fixture.page_ids.push_back(result.value().id);
+        }
+    }
+    return fixture;
+}
+
+double run(dbal::Client& client, const Fixture& fixture, int threads, int ops_per_thread,
+           int write_percent) {
+    std::atomic<bool> go{false};
+    std::atomic<long> failures{0};
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 rng(static_cast<unsigned>(t + 1));
+            std::uniform_int_distribution<size_t> pick_user(0, fixture.user_ids.size() - 1);
+            std::uniform_int_distribution<size_t> pick_page(0, fixture.page_ids.size() - 1);
+            std::uniform_int_distribution<int> pick_op(0, 99);
+
+            dbal::ListOptions list_options;
+            list_options.limit = 20;
+
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            for (int i = 0; i < ops_per_thread; ++i) {
+                const int op = pick_op(rng);
+                bool ok = true;
+                if (op < write_percent) {
+                    dbal::UpdateUserInput update;
+                    update.role = (i % 2 == 0) ? "user" : "admin";
+                    ok = client.updateUser(fixture.user_ids[pick_user(rng)], update).isOk();
+                } else if (op < 60) {
+                    ok = client.getUser(fixture.user_ids[pick_user(rng)]).isOk();
+                } else if (op < 90) {
+                    ok = client.getPage(fixture.page_ids[pick_page(rng)]).isOk();
+                } else {
+                    ok = client.listUsers(list_options).isOk();
+                }
+                if (!ok) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    if (failures.load() > 0) {
+        std::cerr << "  " << failures.load() << " operations failed" << std::endl;
+    }
+    return static_cast<double>(threads) * ops_per_thread / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int ops_per_thread = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int write_percent = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    dbal::ClientConfig config;
+    config.adapter = "sqlite";
+    config.database_url = ":memory:";
+    dbal::Client client(config);
+
+    const Fixture fixture = seed(client);
+    if (fixture.user_ids.empty() || fixture.page_ids.empty()) {
+        std::cerr << "Failed to seed benchmark data" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Store contention benchmark (" << ops_per_thread << " ops/thread, "
+              << write_percent << "% writes)" << std::endl;
+
+    double baseline = 0.0;
+    for (int threads : {1, 2, 4, 8}) {
+        const double ops = run(client, fixture, threads, ops_per_thread, write_percent);
+        if (threads == 1) {
+            baseline = ops;
+        }
+        std::cout << "  threads=" << std::setw(2) << threads
+                  << "  ops/sec=" << std::setw(12) << std::fixed << std::setprecision(0) << ops
+                  << "  scaling=" << std::setprecision(2) << (ops / baseline) << "x" << std::endl;
+    }
+    return 0;
+}
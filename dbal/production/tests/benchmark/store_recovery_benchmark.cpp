@@ -0,0 +1,142 @@
+/**
+ * @file store_recovery_benchmark.cpp
+ * @brief Write cost and restart time of the persisted in-memory store
+ *
+ * Creates N users through a Client with and without a data directory to
+ * show what the write-ahead log adds per write, then reopens the
+ * directory twice: once replaying the whole log, once from a snapshot
+ * written by checkpoint(). Both restarts must find every user.
+ *
+ * Partitions load on first use, so each restart is reported in steps:
+ * opening the client, the first read of a user by id (answered from the
+ * log or the snapshot without loading), the first list (loads the users
+ * partition), and the first search (builds the text index).
+ *
+ * Usage: store_recovery_benchmark [entities] [directory]
+ */
+
+#include "dbal/client.hpp"
+#include "dbal/errors.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+dbal::ClientConfig benchConfig(const std::string& directory) {
+    dbal::ClientConfig config;
+    config.adapter = "sqlite";
+    config.database_url = ":memory:";
+    config.persistence.directory = directory;
+    // Keep the whole run in the log so the first restart replays all of it
+    config.persistence.snapshot_bytes = 1LL << 40;
+    return config;
+}
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double populate(dbal::Client& client, int entities) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < entities; ++i) {
+        dbal::CreateUserInput input;
+        input.username = "recovery_user_" + std::to_string(i);
+        input.email = input.username + "@example.com";
+        input.tenantId = "tenant_" + std::to_string(i % 4096);
+        if (client.createUser(input).isError()) {
+            std::cerr << "create failed at " << i << std::endl;
+            std::exit(1);
+        }
+    }
+    return seconds(start);
+}
+
+uintmax_t directoryBytes(const fs::path& directory) {
+    uintmax_t bytes = 0;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        bytes += entry.file_size();
+    }
+    return bytes;
+}
+
+void report(const char* label, double elapsed, int entities) {
+    std::cout << "  " << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(3)
+              << std::setw(9) << elapsed << " s" << std::setw(12) << std::setprecision(0)
+              << entities / elapsed << " entities/s" << std::endl;
+}
+
+void reopen(const std::string& label, const std::string& directory, int entities) {
+    auto start = std::chrono::steady_clock::now();
+    dbal::Client client(benchConfig(directory));
+    report((label + ", open").c_str(), seconds(start), entities);
+
+    start = std::chrono::steady_clock::now();
+    if (client.getUser("user_00000001").isError()) {
+        std::cerr << label << ": first user missing" << std::endl;
+        std::exit(1);
+    }
+    report((label + ", first read by id").c_str(), seconds(start), entities);
+
+    start = std::chrono::steady_clock::now();
+    dbal::ListOptions options;
+    options.limit = 1;
+    if (client.listUsers(options).value().empty()) {
+        std::cerr << label << ": list found nothing" << std::endl;
+        std::exit(1);
+    }
+    report((label + ", first list").c_str(), seconds(start), entities);
+
+    start = std::chrono::steady_clock::now();
+    if (client.searchUsers("recovery_user_1", 1).value().empty()) {
+        std::cerr << label << ": search found nothing" << std::endl;
+        std::exit(1);
+    }
+    report((label + ", first search").c_str(), seconds(start), entities);
+
+    if (client.countUsers().value() != entities) {
+        std::cerr << label << ": recovered " << client.countUsers().value() << " of " << entities << std::endl;
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int entities = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const fs::path directory = argc > 2 ? fs::path(argv[2]) : fs::temp_directory_path() / "dbal_recovery_benchmark";
+    fs::remove_all(directory);
+
+    std::cout << "Store recovery benchmark (" << entities << " users, " << directory.string() << ")" << std::endl;
+    {
+        dbal::ClientConfig volatile_config = benchConfig("");
+        dbal::Client client(volatile_config);
+        report("create, in-memory only", populate(client, entities), entities);
+    }
+    {
+        dbal::Client client(benchConfig(directory.string()));
+        report("create, write-ahead log", populate(client, entities), entities);
+    }
+    std::cout << "  log size " << directoryBytes(directory) / (1024 * 1024) << " MiB" << std::endl;
+
+    reopen("restart from log", directory.string(), entities);
+    {
+        dbal::Client client(benchConfig(directory.string()));
+        const auto start = std::chrono::steady_clock::now();
+        if (client.checkpoint().isError()) {
+            std::cerr << "checkpoint failed" << std::endl;
+            return 1;
+        }
+        report("checkpoint", seconds(start), entities);
+    }
+    std::cout << "  snapshot size " << directoryBytes(directory) / (1024 * 1024) << " MiB" << std::endl;
+    reopen("restart from snapshot", directory.string(), entities);
+
+    fs::remove_all(directory);
+    return 0;
+}
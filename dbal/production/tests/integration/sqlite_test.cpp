@@ -1,29 +1,314 @@
+#include "adapters/sqlite/sqlite_adapter.hpp"
+#include "dbal/errors.hpp"
+#include "query/cursor/list_cursor.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using dbal::adapters::sqlite::SQLiteAdapter;
+using dbal::adapters::sqlite::SQLiteConnection;
+using dbal::adapters::sqlite::SQLitePool;
+
+namespace {
+
+std::string tempDatabasePath(const std::string& name) {
+    return "/tmp/dbal_" + name + "_" + std::to_string(::getpid()) + ".db";
+}
+
+void removeDatabase(const std::string& path) {
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+
+dbal::CreateUserInput userInput(const std::string& name, const std::string& tenant = "acme") {
+    dbal::CreateUserInput input;
+    input.username = name;
+    input.email = name + "@example.com";
+    input.role = "user";
+    input.tenantId = tenant;
+    return input;
+}
+
+} // namespace
 
 void test_sqlite_connection() {
-    // Stub test - would test actual SQLite connection
+    std::cout << "Testing SQLite connection and statement cache..." << std::endl;
+
+    SQLiteConnection conn(":memory:", false, 2);
+    conn.exec("CREATE TABLE t (id INTEGER PRIMARY KEY, name TEXT)");
+    {
+        auto insert = conn.prepare("INSERT INTO t (name) VALUES (?)");
+        insert->bind(1, std::string("a"));
+        assert(!insert->step());
+    }
+    {
+        // Same SQL text reuses the cached statement with bindings cleared
+        auto insert = conn.prepare("INSERT INTO t (name) VALUES (?)");
+        insert->bind(1, std::string("b"));
+        assert(!insert->step());
+    }
+    assert(conn.cachedStatements() == 1);
+
+    {
+        auto count = conn.prepare("SELECT COUNT(*) FROM t");
+        assert(count->step());
+        assert(count->int64(0) == 2);
+    }
+    {
+        auto select = conn.prepare("SELECT name FROM t ORDER BY id");
+        assert(select->step());
+        assert(select->text(0) == "a");
+    }
+    // Capacity 2: the oldest statement was evicted
+    assert(conn.cachedStatements() == 2);
+
+    bool threw = false;
+    try {
+        conn.prepare("SELECT * FROM missing_table");
+    } catch (const dbal::adapters::sqlite::SQLiteError&) {
+        threw = true;
+    }
+    assert(threw);
+
     std::cout << "✓ SQLite connection test passed" << std::endl;
 }
 
 void test_sqlite_crud() {
-    // Stub test - would test CRUD operations
+    std::cout << "Testing SQLite CRUD..." << std::endl;
+
+    SQLiteAdapter adapter(":memory:");
+
+    auto created = adapter.createUser(userInput("alice"));
+    assert(created.isOk());
+    const std::string id = created.value().id;
+
+    auto fetched = adapter.getUser(id);
+    assert(fetched.isOk());
+    assert(fetched.value().username == "alice");
+    assert(fetched.value().tenantId.value() == "acme");
+
+    dbal::UpdateUserInput update;
+    update.email = "alice@new.example.com";
+    auto updated = adapter.updateUser(id, update);
+    assert(updated.isOk());
+    assert(updated.value().email == "alice@new.example.com");
+    assert(updated.value().username == "alice");
+
+    auto duplicate = adapter.createUser(userInput("alice"));
+    assert(duplicate.isError());
+    assert(duplicate.error().code() == dbal::ErrorCode::Conflict);
+    // Same username in another tenant is fine
+    assert(adapter.createUser(userInput("alice", "globex")).isOk());
+
+    auto invalid = adapter.createUser(userInput("bad name!"));
+    assert(invalid.isError());
+    assert(invalid.error().code() == dbal::ErrorCode::ValidationError);
+
+    dbal::ListOptions by_tenant;
+    by_tenant.filter["tenantId"] = "acme";
+    assert(adapter.listUsers(by_tenant).value().size() == 1);
+
+    dbal::CreatePageInput page;
+    page.path = "/home";
+    page.title = "Home";
+    page.level = 1;
+    page.requiresAuth = false;
+    page.componentTree = "{}";
+    auto page_result = adapter.createPage(page);
+    assert(page_result.isOk());
+    dbal::UpdatePageInput page_update;
+    page_update.title = "Start";
+    auto page_updated = adapter.updatePage(page_result.value().id, page_update);
+    assert(page_updated.isOk());
+    assert(page_updated.value().title == "Start");
+    assert(page_updated.value().updatedAt.has_value());
+    assert(adapter.createPage(page).error().code() == dbal::ErrorCode::Conflict);
+
+    dbal::CreateSessionInput session;
+    session.userId = id;
+    session.token = "token-1";
+    session.expiresAt = std::chrono::system_clock::now() + std::chrono::hours(1);
+    auto session_result = adapter.createSession(session);
+    assert(session_result.isOk());
+    assert(adapter.getSession(session_result.value().id).isOk());
+
+    dbal::CreateSessionInput orphan = session;
+    orphan.userId = "user_missing";
+    orphan.token = "token-2";
+    assert(adapter.createSession(orphan).error().code() == dbal::ErrorCode::ValidationError);
+
+    dbal::CreateSessionInput expired = session;
+    expired.token = "token-3";
+    expired.expiresAt = std::chrono::system_clock::now() - std::chrono::seconds(1);
+    auto expired_result = adapter.createSession(expired);
+    assert(expired_result.isOk());
+    assert(adapter.getSession(expired_result.value().id).error().code() == dbal::ErrorCode::NotFound);
+    // Reading it expired removed the row
+    assert(adapter.deleteSession(expired_result.value().id).error().code() == dbal::ErrorCode::NotFound);
+
+    // Deleting the user cascades to its sessions
+    assert(adapter.deleteUser(id).isOk());
+    assert(adapter.getUser(id).error().code() == dbal::ErrorCode::NotFound);
+    assert(adapter.getSession(session_result.value().id).isError());
+
     std::cout << "✓ SQLite CRUD test passed" << std::endl;
 }
 
 void test_sqlite_transactions() {
-    // Stub test - would test transactions
+    std::cout << "Testing SQLite batch transactions..." << std::endl;
+
+    SQLiteAdapter adapter(":memory:");
+
+    std::vector<dbal::CreateUserInput> batch = {userInput("batch_a"), userInput("batch_b")};
+    assert(adapter.batchCreateUsers(batch).value() == 2);
+
+    // The duplicate in the middle rolls back the whole batch
+    std::vector<dbal::CreateUserInput> conflicting = {userInput("batch_c"), userInput("batch_a"),
+                                                      userInput("batch_d")};
+    auto failed = adapter.batchCreateUsers(conflicting);
+    assert(failed.isError());
+    assert(failed.error().code() == dbal::ErrorCode::Conflict);
+
+    dbal::ListOptions all;
+    all.limit = 100;
+    auto users = adapter.listUsers(all).value();
+    assert(users.size() == 2);
+
+    std::vector<std::string> ids = {users[0].id, "user_missing"};
+    assert(adapter.batchDeleteUsers(ids).isError());
+    assert(adapter.listUsers(all).value().size() == 2);
+
+    dbal::CreatePackageInput package;
+    package.packageId = "forum";
+    package.version = "1.0.0";
+    package.enabled = true;
+    assert(adapter.batchCreatePackages({package}).value() == 1);
+    dbal::UpdatePackageBatchItem disable;
+    disable.id = "forum";
+    disable.data.enabled = false;
+    assert(adapter.batchUpdatePackages({disable}).value() == 1);
+    assert(adapter.getPackage("forum").value().enabled == false);
+
     std::cout << "✓ SQLite transactions test passed" << std::endl;
 }
 
+void test_sqlite_keyset_pagination() {
+    std::cout << "Testing SQLite keyset pagination..." << std::endl;
+
+    SQLiteAdapter adapter(":memory:");
+    for (int i = 0; i < 12; ++i) {
+        assert(adapter.createUser(userInput("page_" + std::to_string(50 - i))).isOk());
+    }
+
+    dbal::ListOptions options;
+    options.sort["username"] = "asc";
+    options.limit = 5;
+    std::vector<std::string> names;
+    while (true) {
+        auto page = adapter.listUsers(options);
+        assert(page.isOk());
+        for (const auto& user : page.value()) {
+            assert(names.empty() || names.back() < user.username);
+            names.push_back(user.username);
+        }
+        options.cursor = dbal::query::nextCursor(page.value(), options);
+        if (options.cursor.empty()) {
+            break;
+        }
+    }
+    assert(names.size() == 12);
+
+    const auto now = std::chrono::system_clock::now();
+    for (int i = 0; i < 4; ++i) {
+        dbal::CreatePackageInput package;
+        package.packageId = "pkg_" + std::to_string(i);
+        package.version = "1.0.0";
+        package.enabled = true;
+        package.installedAt = now - std::chrono::minutes(i);
+        assert(adapter.createPackage(package).isOk());
+    }
+    dbal::ListOptions packages;
+    packages.sort["installedAt"] = "asc";
+    packages.limit = 3;
+    auto oldest = adapter.listPackages(packages).value();
+    assert(oldest.size() == 3 && oldest.front().packageId == "pkg_3");
+    packages.cursor = dbal::query::nextCursor(oldest, packages);
+    auto newest = adapter.listPackages(packages).value();
+    assert(newest.size() == 1 && newest.front().packageId == "pkg_0");
+
+    packages.sort.clear();
+    assert(adapter.listPackages(packages).error().code() == dbal::ErrorCode::ValidationError);
+
+    std::cout << "✓ SQLite keyset pagination test passed" << std::endl;
+}
+
+void test_sqlite_wal_readers() {
+    std::cout << "Testing SQLite WAL readers..." << std::endl;
+
+    const std::string path = tempDatabasePath("wal_test");
+    removeDatabase(path);
+    {
+        SQLitePool pool(path);
+        auto writer = pool.acquireWriter();
+        auto mode = writer->prepare("PRAGMA journal_mode");
+        assert(mode->step());
+        assert(mode->text(0) == "wal");
+    }
+
+    {
+        SQLiteAdapter adapter(path);
+        auto created = adapter.createUser(userInput("wal_user"));
+        assert(created.isOk());
+        const std::string id = created.value().id;
+
+        // Readers on other threads see committed writes
+        std::vector<std::thread> readers;
+        std::atomic<int> seen{0};
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&]() {
+                for (int j = 0; j < 50; ++j) {
+                    if (adapter.getUser(id).isOk()) {
+                        seen.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(seen.load() == 200);
+    }
+
+    {
+        // Data survives reopening
+        SQLiteAdapter reopened(path);
+        dbal::ListOptions options;
+        assert(reopened.listUsers(options).value().size() == 1);
+    }
+    removeDatabase(path);
+
+    std::cout << "✓ SQLite WAL reader test passed" << std::endl;
+}
+
 int main() {
     std::cout << "Running DBAL SQLite Integration Tests..." << std::endl;
     std::cout << std::endl;
-    
+
     try {
         test_sqlite_connection();
         test_sqlite_crud();
         test_sqlite_transactions();
-        
+        test_sqlite_keyset_pagination();
+        test_sqlite_wal_readers();
+
         std::cout << std::endl;
         std::cout << "All integration tests passed!" << std::endl;
         return 0;
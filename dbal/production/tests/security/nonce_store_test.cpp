@@ -0,0 +1,116 @@
+#include "security/nonce/nonce_store.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dbal::security::NonceStore;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+void test_replay_detection() {
+    std::cout << "Testing replay detection..." << std::endl;
+
+    NonceStore store(300, 0);
+    const auto now = NonceStore::Clock::now();
+    assert(store.check_and_store("a1b2", now));
+    assert(!store.check_and_store("a1b2", now));
+    assert(!store.check_and_store("a1b2", now + seconds(299)));
+    assert(store.check_and_store("c3d4", now));
+    assert(store.size() == 2);
+    std::cout << "  ✓ A nonce is accepted once within its expiry" << std::endl;
+}
+
+void test_expiry() {
+    std::cout << "Testing expiry on tick..." << std::endl;
+
+    NonceStore store(10, 0);
+    const auto start = NonceStore::Clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        assert(store.check_and_store("early" + std::to_string(i), start));
+        assert(store.check_and_store("late" + std::to_string(i), start + seconds(5)));
+    }
+    assert(store.cleanup(start + seconds(9)) == 0);
+    assert(store.size() == 2000);
+    assert(store.cleanup(start + seconds(11)) == 1000);
+    assert(store.size() == 1000);
+    assert(store.check_and_store("early0", start + seconds(11)));
+    assert(!store.check_and_store("late0", start + seconds(11)));
+    assert(store.cleanup(start + seconds(16)) == 1000);
+    std::cout << "  ✓ Nonces are forgotten once their expiry second has passed" << std::endl;
+
+    NonceStore ticking(1, 1);
+    assert(ticking.check_and_store("nonce"));
+    for (int i = 0; i < 100 && ticking.size() != 0; ++i) {
+        std::this_thread::sleep_for(milliseconds(50));
+    }
+    assert(ticking.size() == 0);
+    std::cout << "  ✓ The background tick expires without being asked" << std::endl;
+}
+
+void test_capacity() {
+    std::cout << "Testing the memory cap..." << std::endl;
+
+    NonceStore store(60, 0, 160);
+    const auto start = NonceStore::Clock::now();
+    int stored = 0;
+    for (int i = 0; i < 1000; ++i) {
+        stored += store.check_and_store("n" + std::to_string(i), start) ? 1 : 0;
+    }
+    assert(stored <= 160 && store.size() == static_cast<size_t>(stored));
+    assert(store.overflows() == static_cast<size_t>(1000 - stored));
+    assert(!store.check_and_store("n999", start));
+    std::cout << "  ✓ A full store refuses new nonces" << std::endl;
+
+    store.cleanup(start + seconds(61));
+    assert(store.size() == 0);
+    assert(store.check_and_store("n999", start + seconds(61)));
+    std::cout << "  ✓ Room frees up as nonces expire" << std::endl;
+}
+
+void test_concurrent_checks() {
+    std::cout << "Testing concurrent checks..." << std::endl;
+
+    NonceStore store(300, 1);
+    std::atomic<int> accepted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 5000; ++i) {
+                if (store.check_and_store("req" + std::to_string(i))) {
+                    accepted.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(accepted.load() == 5000);
+    assert(store.size() == 5000);
+    std::cout << "  ✓ Each nonce is accepted by exactly one thread" << std::endl;
+}
+
+int main() {
+    std::cout << "==================================================" << std::endl;
+    std::cout << "Running Nonce Store Tests" << std::endl;
+    std::cout << "==================================================" << std::endl;
+
+    try {
+        test_replay_detection();
+        test_expiry();
+        test_capacity();
+        test_concurrent_checks();
+
+        std::cout << std::endl;
+        std::cout << "✅ All nonce store tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,162 @@
+#include "dbal/core/client.hpp"
+#include "security/password/password_hash.hpp"
+#include "security/password/password_hash_pool.hpp"
+#include "security/password/password_verify.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dbal::security::PasswordHashCost;
+using dbal::security::PasswordHashPool;
+
+namespace {
+
+// Cheap enough to keep the tests fast
+PasswordHashCost testCost() {
+    PasswordHashCost cost;
+    cost.cost_log2 = 10;
+    return cost;
+}
+
+dbal::ClientConfig testConfig(size_t workers, size_t max_queued) {
+    dbal::ClientConfig config;
+    config.adapter = "sqlite";
+    config.database_url = ":memory:";
+    config.password_hashing.workers = workers;
+    config.password_hashing.max_queued = max_queued;
+    config.password_hashing.cost_log2 = 10;
+    return config;
+}
+
+} // namespace
+
+void test_hash_and_verify() {
+    std::cout << "Testing scrypt hashing..." << std::endl;
+
+    const std::string hash = dbal::security::password_hash("correct horse", "salt1", testCost());
+    assert(hash.compare(0, 14, "scrypt$10$8$1$") == 0);
+    assert(hash.size() == 14 + 64);
+    assert(hash == dbal::security::password_hash("correct horse", "salt1", testCost()));
+    assert(hash != dbal::security::password_hash("correct horse", "salt2", testCost()));
+    std::cout << "  ✓ Hashes are salted, deterministic and record their cost" << std::endl;
+
+    assert(dbal::security::password_verify("correct horse", "salt1", hash));
+    assert(!dbal::security::password_verify("correct horsf", "salt1", hash));
+    assert(!dbal::security::password_verify("correct horse", "salt2", hash));
+    std::cout << "  ✓ Verification checks password and salt" << std::endl;
+
+    assert(!dbal::security::password_verify("correct horse", "salt1", "0123abcd"));
+    assert(!dbal::security::password_verify("correct horse", "salt1", "scrypt$40$8$1$00"));
+    assert(!dbal::security::password_verify("correct horse", "salt1", "scrypt$10$x$1$00"));
+    assert(!dbal::security::password_verify("correct horse", "salt1", "scrypt$10$8$1"));
+    std::cout << "  ✓ Malformed or oversized hashes never match" << std::endl;
+}
+
+void test_pool_back_pressure() {
+    std::cout << "Testing the bounded hashing pool..." << std::endl;
+
+    std::mutex mutex;
+    std::condition_variable released;
+    bool open = false;
+    std::atomic<int> ran{0};
+    {
+        PasswordHashPool pool(1, 2);
+        auto blocker = [&] {
+            std::unique_lock<std::mutex> lock(mutex);
+            released.wait(lock, [&] { return open; });
+            ran.fetch_add(1);
+        };
+        assert(pool.submit(blocker));
+        while (pool.queued() != 0) {
+            std::this_thread::yield();
+        }
+        assert(pool.submit([&] { ran.fetch_add(1); }));
+        assert(pool.submit([&] { ran.fetch_add(1); }));
+        assert(!pool.submit([&] { ran.fetch_add(1); }));
+        assert(pool.rejected() == 1);
+        std::cout << "  ✓ A full queue refuses new jobs" << std::endl;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = true;
+        }
+        released.notify_all();
+    }
+    assert(ran.load() == 3);
+    std::cout << "  ✓ Queued jobs finish before the pool stops" << std::endl;
+}
+
+void test_client_async_credentials() {
+    std::cout << "Testing async credential calls..." << std::endl;
+
+    dbal::Client client(testConfig(2, 64));
+    dbal::CreateUserInput user;
+    user.username = "async_user";
+    user.email = "async_user@example.com";
+    assert(client.createUser(user).isOk());
+
+    dbal::CreateCredentialInput credential;
+    credential.username = user.username;
+    credential.passwordHash = "s3cret-password";
+
+    std::promise<dbal::Result<bool>> stored;
+    client.setCredentialAsync(credential, [&](dbal::Result<bool> result) { stored.set_value(result); });
+    assert(stored.get_future().get().isOk());
+    std::cout << "  ✓ Credential stored off the calling thread" << std::endl;
+
+    std::promise<dbal::Result<bool>> good;
+    std::promise<dbal::Result<bool>> bad;
+    std::promise<dbal::Result<bool>> missing;
+    client.verifyCredentialAsync(user.username, "s3cret-password",
+                                 [&](dbal::Result<bool> result) { good.set_value(result); });
+    client.verifyCredentialAsync(user.username, "wrong-password",
+                                 [&](dbal::Result<bool> result) { bad.set_value(result); });
+    client.verifyCredentialAsync("nobody", "s3cret-password",
+                                 [&](dbal::Result<bool> result) { missing.set_value(result); });
+    assert(good.get_future().get().isOk());
+    assert(bad.get_future().get().error().code() == dbal::ErrorCode::Unauthorized);
+    assert(missing.get_future().get().error().code() == dbal::ErrorCode::Unauthorized);
+    assert(client.verifyCredential(user.username, "s3cret-password").isOk());
+    std::cout << "  ✓ Verification results match the synchronous call" << std::endl;
+
+    // Declared before busy, whose destructor finishes the queued calls
+    std::atomic<int> unavailable{0};
+    dbal::Client busy(testConfig(1, 1));
+    assert(busy.createUser(user).isOk());
+    for (int i = 0; i < 20; ++i) {
+        busy.verifyCredentialAsync(user.username, "s3cret-password", [&](dbal::Result<bool> result) {
+            if (result.isError() && result.error().code() == dbal::ErrorCode::ServiceUnavailable) {
+                unavailable.fetch_add(1);
+            }
+        });
+    }
+    assert(unavailable.load() > 0);
+    std::cout << "  ✓ Calls past the queue limit fail fast with 503" << std::endl;
+}
+
+int main() {
+    std::cout << "==================================================" << std::endl;
+    std::cout << "Running Password Hashing Tests" << std::endl;
+    std::cout << "==================================================" << std::endl;
+
+    try {
+        test_hash_and_verify();
+        test_pool_back_pressure();
+        test_client_async_credentials();
+
+        std::cout << std::endl;
+        std::cout << "✅ All password hashing tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
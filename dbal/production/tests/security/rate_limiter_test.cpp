@@ -0,0 +1,186 @@
+#include "security/rate_limiting/rate_limiter.hpp"
+#include "security/rate_limiting/tiered_rate_limiter.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using dbal::security::RateLimiter;
+using dbal::security::RateLimitTier;
+using dbal::security::TieredRateLimiter;
+using std::chrono::milliseconds;
+
+void test_bucket_refill() {
+    std::cout << "Testing token bucket refill..." << std::endl;
+
+    RateLimiter limiter(10, 3, std::chrono::minutes(10), milliseconds(0));
+    const auto start = RateLimiter::Clock::now();
+    assert(limiter.remaining("10.0.0.1", start) == 3);
+    assert(limiter.try_acquire("10.0.0.1", start));
+    assert(limiter.try_acquire("10.0.0.1", start));
+    assert(limiter.try_acquire("10.0.0.1", start));
+    assert(!limiter.try_acquire("10.0.0.1", start));
+    assert(limiter.try_acquire("10.0.0.2", start));
+    std::cout << "  ✓ Each key gets its own burst" << std::endl;
+
+    assert(!limiter.try_acquire("10.0.0.1", start + milliseconds(50)));
+    assert(limiter.try_acquire("10.0.0.1", start + milliseconds(100)));
+    assert(!limiter.try_acquire("10.0.0.1", start + milliseconds(100)));
+    assert(std::fabs(limiter.remaining("10.0.0.1", start + milliseconds(250)) - 1.5) < 0.001);
+    assert(limiter.remaining("10.0.0.1", start + std::chrono::hours(1)) == 3);
+    std::cout << "  ✓ Tokens refill at the configured rate, up to capacity" << std::endl;
+
+    // A clock reading older than the bucket's last update refills nothing
+    assert(!limiter.try_acquire("10.0.0.1", start + milliseconds(90)));
+    limiter.refund("10.0.0.1");
+    assert(limiter.try_acquire("10.0.0.1", start + milliseconds(100)));
+    limiter.reset("10.0.0.2");
+    assert(limiter.remaining("10.0.0.2", start) == 3);
+    std::cout << "  ✓ Refund and reset restore tokens" << std::endl;
+}
+
+void test_idle_eviction() {
+    std::cout << "Testing idle bucket eviction..." << std::endl;
+
+    RateLimiter limiter(100, 10, milliseconds(1000), milliseconds(0));
+    const auto start = RateLimiter::Clock::now();
+    for (int i = 0; i < 500; ++i) {
+        assert(limiter.try_acquire("client" + std::to_string(i), start));
+    }
+    for (int i = 0; i < 10; ++i) {
+        limiter.try_acquire("busy", start + milliseconds(900));
+    }
+    assert(limiter.size() == 501);
+    assert(limiter.evict_idle(start + milliseconds(500)) == 0);
+    assert(limiter.evict_idle(start + milliseconds(1009)) == 0);
+    assert(limiter.evict_idle(start + milliseconds(1010)) == 500);
+    assert(limiter.size() == 1);
+    std::cout << "  ✓ Buckets unused for the idle period are dropped" << std::endl;
+
+    assert(limiter.remaining("busy", start + milliseconds(1800)) == 10);
+    assert(limiter.evict_idle(start + milliseconds(1800)) == 0);
+    assert(limiter.evict_idle(start + milliseconds(2000)) == 1);
+    assert(limiter.size() == 0);
+    std::cout << "  ✓ Recently used buckets are kept" << std::endl;
+
+    RateLimiter swept(100, 10, milliseconds(1), milliseconds(5));
+    swept.try_acquire("client");
+    for (int i = 0; i < 200 && swept.size() != 0; ++i) {
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    assert(swept.size() == 0);
+    std::cout << "  ✓ The background sweep evicts without being asked" << std::endl;
+}
+
+void test_tiered_limits() {
+    std::cout << "Testing per-IP, per-tenant and global limits..." << std::endl;
+
+    TieredRateLimiter limiter({1, 2}, {1, 3}, {1, 5}, std::chrono::minutes(10), milliseconds(0));
+    const auto now = TieredRateLimiter::Clock::now();
+    assert(limiter.try_acquire("ip1", "acme", now) == RateLimitTier::None);
+    assert(limiter.try_acquire("ip1", "acme", now) == RateLimitTier::None);
+    assert(limiter.try_acquire("ip1", "acme", now) == RateLimitTier::Ip);
+    std::cout << "  ✓ The IP limit applies first" << std::endl;
+
+    assert(limiter.try_acquire("ip2", "acme", now) == RateLimitTier::None);
+    assert(limiter.try_acquire("ip2", "acme", now) == RateLimitTier::Tenant);
+    assert(limiter.try_acquire("ip2", "globex", now) == RateLimitTier::None);
+    std::cout << "  ✓ A refused tenant gives the IP's token back" << std::endl;
+
+    assert(limiter.try_acquire("ip3", "", now) == RateLimitTier::None);
+    assert(limiter.try_acquire("ip4", "initech", now) == RateLimitTier::Global);
+    assert(limiter.try_acquire("ip4", "initech", now) == RateLimitTier::Global);
+    assert(limiter.try_acquire("ip4", "initech", now + milliseconds(1000)) == RateLimitTier::None);
+    assert(limiter.try_acquire("ip4", "initech", now + milliseconds(1000)) == RateLimitTier::Global);
+    std::cout << "  ✓ The global limit gives back both narrower tokens" << std::endl;
+}
+
+void test_concurrent_acquire() {
+    std::cout << "Testing concurrent acquires..." << std::endl;
+
+    RateLimiter limiter(0.001, 1000, std::chrono::minutes(10), milliseconds(0));
+    const auto now = RateLimiter::Clock::now();
+    std::atomic<int> granted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 2000; ++i) {
+                if (limiter.try_acquire(i % 2 == 0 ? "shared" : "own" + std::to_string(t), now)) {
+                    granted.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // "shared" grants exactly its capacity; each thread's own key 1000 more
+    assert(granted.load() == 1000 + 8 * 1000);
+    assert(limiter.size() == 9);
+    std::cout << "  ✓ No token is granted twice across threads" << std::endl;
+}
+
+void test_long_idle_and_limits() {
+    std::cout << "Testing long idle periods and limit bounds..." << std::endl;
+
+    using std::chrono::hours;
+    RateLimiter limiter(1, 5, std::chrono::minutes(10), milliseconds(0));
+    TieredRateLimiter tiers({100, 100}, {100, 100}, {1, 2}, std::chrono::minutes(10), milliseconds(0));
+    const auto start = RateLimiter::Clock::now();
+    for (const auto later : {hours(0), hours(24 * 25), hours(24 * 50), hours(24 * 400)}) {
+        for (int i = 0; i < 5; ++i) {
+            assert(limiter.try_acquire("client", start + later));
+        }
+        assert(!limiter.try_acquire("client", start + later));
+        assert(tiers.try_acquire("ip" + std::to_string(later.count()), "", start + later) == RateLimitTier::None);
+        assert(tiers.try_acquire("ip" + std::to_string(later.count()), "", start + later) == RateLimitTier::None);
+        assert(tiers.try_acquire("ip" + std::to_string(later.count()), "", start + later) == RateLimitTier::Global);
+    }
+    std::cout << "  ✓ Buckets, the global one included, refill after weeks or years idle" << std::endl;
+
+    RateLimiter large(1000, 100000, std::chrono::minutes(10), milliseconds(0));
+    int granted = 0;
+    while (large.try_acquire("bulk", start)) {
+        ++granted;
+    }
+    assert(granted == 100000);
+    std::cout << "  ✓ Capacities above 65535 tokens are honoured" << std::endl;
+
+    for (const auto& bad : {std::pair<double, double>{0, 5}, {-1, 5}, {10, 0.5}, {1e-12, 1e9}}) {
+        bool rejected = false;
+        try {
+            RateLimiter invalid(bad.first, bad.second, std::chrono::minutes(10), milliseconds(0));
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected);
+    }
+    std::cout << "  ✓ Limits a bucket cannot represent are refused" << std::endl;
+}
+
+int main() {
+    std::cout << "==================================================" << std::endl;
+    std::cout << "Running Rate Limiter Tests" << std::endl;
+    std::cout << "==================================================" << std::endl;
+
+    try {
+        test_bucket_refill();
+        test_idle_eviction();
+        test_tiered_limits();
+        test_concurrent_acquire();
+        test_long_idle_and_limits();
+
+        std::cout << std::endl;
+        std::cout << "✅ All rate limiter tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,401 @@
+#include "blob/filesystem_storage.hpp"
+#include "blob/memory_storage.hpp"
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using dbal::blob::FilesystemStorage;
+using dbal::blob::kBlobChunkBytes;
+using dbal::blob::MemoryStorage;
+
+namespace {
+
+std::vector<char> pattern(size_t size, unsigned seed) {
+    std::vector<char> data(size);
+    unsigned state = seed;
+    for (auto& byte : data) {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<char>(state >> 24);
+    }
+    return data;
+}
+
+std::vector<char> slice(const std::vector<char>& data, size_t offset, size_t length) {
+    return std::vector<char>(data.begin() + offset, data.begin() + offset + length);
+}
+
+dbal::DownloadOptions range(size_t offset, size_t length) {
+    dbal::DownloadOptions options;
+    options.offset = offset;
+    options.length = length;
+    return options;
+}
+
+std::filesystem::path freshDirectory(const std::string& name) {
+    auto directory = std::filesystem::temp_directory_path() / ("dbal_" + name + "_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+std::vector<char> readLocated(const dbal::blob::BlobLocation& location) {
+    std::vector<char> data(location.length);
+    size_t done = 0;
+    while (size_t read = FilesystemStorage::readLocated(location, done, data.data() + done, 1000)) {
+        done += read;
+    }
+    data.resize(done);
+    return data;
+}
+
+} // namespace
+
+void test_chunked_upload_and_ranges() {
+    std::cout << "Testing chunked uploads and ranged downloads..." << std::endl;
+
+    MemoryStorage storage;
+    dbal::BlobStorage& blobs = storage;
+    const auto data = pattern(4 * kBlobChunkBytes + 123, 1);
+    auto uploaded = blobs.upload("media/video.bin", data);
+    assert(uploaded.isOk());
+    assert(uploaded.value().size == data.size());
+
+    assert(blobs.download("media/video.bin").value() == data);
+    assert(blobs.download("media/video.bin", range(kBlobChunkBytes - 10, 20)).value() ==
+           slice(data, kBlobChunkBytes - 10, 20));
+    assert(blobs.download("media/video.bin", range(data.size() - 5, 100)).value() ==
+           slice(data, data.size() - 5, 5));
+    assert(blobs.download("media/video.bin", range(data.size(), 1)).isError());
+    std::cout << "  ✓ Whole and ranged downloads match across chunk boundaries" << std::endl;
+
+    auto view = storage.view("media/video.bin", range(kBlobChunkBytes - 10, kBlobChunkBytes + 20));
+    assert(view.isOk());
+    assert(view.value().slices.size() >= 2);
+    assert(view.value().size == kBlobChunkBytes + 20);
+    assert(view.value().slices[1].data() == view.value().slices[1].chunk->bytes.get());
+    assert(blobs.deleteBlob("media/video.bin").value());
+    std::string seen;
+    for (const auto& piece : view.value().slices) {
+        seen.append(piece.view());
+    }
+    const auto expected = slice(data, kBlobChunkBytes - 10, kBlobChunkBytes + 20);
+    assert(seen == std::string(expected.begin(), expected.end()));
+    std::cout << "  ✓ Views share chunks and outlive the blob" << std::endl;
+}
+
+void test_streaming() {
+    std::cout << "Testing streaming uploads and downloads..." << std::endl;
+
+    MemoryStorage storage;
+    dbal::BlobStorage& blobs = storage;
+    const auto data = pattern(2 * kBlobChunkBytes + 777, 2);
+
+    size_t position = 0;
+    size_t largest_request = 0;
+    auto streamed = blobs.uploadStream(
+        "streamed",
+        [&](char* buffer, size_t capacity) {
+            largest_request = std::max(largest_request, capacity);
+            const size_t take = std::min<size_t>({capacity, 1000, data.size() - position});
+            std::copy(data.begin() + position, data.begin() + position + take, buffer);
+            position += take;
+            return take;
+        },
+        data.size());
+    assert(streamed.isOk());
+    assert(largest_request <= kBlobChunkBytes);
+    assert(blobs.download("streamed").value() == data);
+    assert(streamed.value().etag == blobs.upload("buffered", data).value().etag);
+    std::cout << "  ✓ Reader fills chunks in place; same bytes, same ETag" << std::endl;
+
+    std::vector<char> received;
+    size_t calls = 0;
+    assert(blobs.downloadStream("streamed", [&](const char* bytes, size_t size) {
+        assert(size <= kBlobChunkBytes);
+        received.insert(received.end(), bytes, bytes + size);
+        ++calls;
+    }).value());
+    assert(received == data);
+    assert(calls == storage.view("streamed").value().slices.size());
+    std::cout << "  ✓ Downloads stream one chunk at a time" << std::endl;
+}
+
+void test_copy_and_overwrite() {
+    std::cout << "Testing copies and overwrite protection..." << std::endl;
+
+    MemoryStorage storage;
+    dbal::BlobStorage& blobs = storage;
+    const auto data = pattern(kBlobChunkBytes + 1, 3);
+    assert(blobs.upload("original", data).isOk());
+    assert(blobs.copy("original", "copy").isOk());
+    auto original = storage.view("original").value();
+    auto copy = storage.view("copy").value();
+    assert(original.slices[0].chunk == copy.slices[0].chunk);
+    assert(blobs.getTotalSize().value() == 2 * data.size());
+    std::cout << "  ✓ Copies share the source's chunks" << std::endl;
+
+    dbal::UploadOptions keep;
+    keep.overwrite = false;
+    auto refused = blobs.upload("original", pattern(10, 4), keep);
+    assert(refused.isError() && refused.error().code() == dbal::ErrorCode::Conflict);
+    assert(blobs.upload("original", pattern(10, 4)).isOk());
+    assert(blobs.download("copy").value() == data);
+    std::cout << "  ✓ Overwrite refused when asked; copies unaffected by it" << std::endl;
+}
+
+void test_content_defined_dedup() {
+    std::cout << "Testing content-defined chunking and deduplication..." << std::endl;
+
+    MemoryStorage storage;
+    dbal::BlobStorage& blobs = storage;
+    const auto font = pattern(2 * 1024 * 1024, 10);
+    assert(blobs.upload("acme:fonts/inter.woff2", font).isOk());
+    auto chunks = storage.view("acme:fonts/inter.woff2").value().slices;
+    assert(chunks.size() > 8);
+    for (size_t i = 0; i + 1 < chunks.size(); ++i) {
+        assert(chunks[i].length >= dbal::blob::kBlobChunkMinBytes && chunks[i].length <= kBlobChunkBytes);
+    }
+    std::cout << "  ✓ Chunks fall between the minimum and maximum size" << std::endl;
+
+    assert(blobs.upload("globex:fonts/inter.woff2", font).isOk());
+    assert(storage.view("globex:fonts/inter.woff2").value().slices[3].chunk == chunks[3].chunk);
+    assert(storage.storedBytes() == font.size());
+    std::cout << "  ✓ Identical uploads store their bytes once" << std::endl;
+
+    auto edited = font;
+    const auto inserted = pattern(100, 11);
+    edited.insert(edited.begin() + 1024 * 1024, inserted.begin(), inserted.end());
+    assert(blobs.upload("globex:fonts/inter-patched.woff2", edited).isOk());
+    assert(blobs.download("globex:fonts/inter-patched.woff2").value() == edited);
+    assert(storage.storedBytes() < font.size() + 3 * kBlobChunkBytes);
+    std::cout << "  ✓ An insert only adds the chunks around it" << std::endl;
+
+    dbal::tenant::TenantIdentity identity;
+    identity.tenantId = "globex";
+    identity.role = "owner";
+    dbal::tenant::TenantContext globex(identity, dbal::tenant::TenantQuota{}, "globex:");
+    storage.reportUsage(globex);
+    assert(globex.quota().currentBlobCount == 2);
+    assert(globex.quota().currentBlobStorageBytes == 2 * font.size() + inserted.size());
+    assert(globex.quota().currentBlobPhysicalBytes < font.size() + 3 * kBlobChunkBytes);
+    assert(storage.usage("acme:").physical_bytes == font.size());
+    std::cout << "  ✓ Per-tenant logical and physical usage reported" << std::endl;
+
+    assert(blobs.deleteBlob("acme:fonts/inter.woff2").value());
+    assert(blobs.deleteBlob("globex:fonts/inter.woff2").value());
+    assert(blobs.deleteBlob("globex:fonts/inter-patched.woff2").value());
+    assert(storage.storedBytes() > 0);  // Still held by the view taken above
+    chunks.clear();
+    assert(storage.storedBytes() == 0);
+    std::cout << "  ✓ Chunks freed with the last blob holding them" << std::endl;
+}
+
+void check_listing(dbal::BlobStorage& blobs) {
+    for (const char* key : {"photos/2024/a.jpg", "photos/2024/b.jpg", "photos/2025/c.jpg", "photos/cover.jpg",
+                            "photos/d.jpg", "photosets/x", "videos/v.mp4"}) {
+        assert(blobs.upload(key, pattern(3, 12)).isOk());
+    }
+
+    dbal::ListOptions options;
+    options.prefix = "photos/";
+    options.delimiter = "/";
+    auto rolled = blobs.list(options).value();
+    assert((rolled.common_prefixes == std::vector<std::string>{"photos/2024/", "photos/2025/"}));
+    assert(rolled.items.size() == 2);
+    assert(rolled.items[0].key == "photos/cover.jpg" && rolled.items[1].key == "photos/d.jpg");
+    assert(!rolled.is_truncated && !rolled.next_token.has_value());
+
+    options.max_keys = 1;
+    std::vector<std::string> seen;
+    for (int page = 0; page < 10; ++page) {
+        auto result = blobs.list(options).value();
+        assert(result.items.size() + result.common_prefixes.size() == 1);
+        seen.push_back(result.items.empty() ? result.common_prefixes[0] : result.items[0].key);
+        if (!result.is_truncated) {
+            break;
+        }
+        options.continuation_token = result.next_token;
+    }
+    assert((seen == std::vector<std::string>{"photos/2024/", "photos/2025/", "photos/cover.jpg", "photos/d.jpg"}));
+
+    dbal::ListOptions flat;
+    flat.prefix = "photos/2024/";
+    flat.continuation_token = "a";
+    auto nested = blobs.list(flat).value();
+    assert(nested.items.size() == 2 && nested.common_prefixes.empty());
+    flat.prefix = "photos";
+    flat.continuation_token = "photos/d.jpg";
+    auto tail = blobs.list(flat).value();
+    assert(tail.items.size() == 2 && tail.items[1].key == "photosets/x");
+}
+
+void test_listing() {
+    std::cout << "Testing sorted listing with delimiters and tokens..." << std::endl;
+
+    MemoryStorage memory;
+    check_listing(memory);
+    std::cout << "  ✓ Memory store pages prefixes and rolls up directories" << std::endl;
+
+    const auto directory = freshDirectory("blob_listing");
+    {
+        FilesystemStorage files(directory.string());
+        check_listing(files);
+    }
+    std::filesystem::remove_all(directory);
+    std::cout << "  ✓ Filesystem store lists the same pages" << std::endl;
+}
+
+void test_filesystem_transfers() {
+    std::cout << "Testing filesystem uploads, ranges and located files..." << std::endl;
+
+    const auto directory = freshDirectory("blob_transfers");
+    FilesystemStorage storage(directory.string());
+    dbal::BlobStorage& blobs = storage;
+    const auto data = pattern(3 * FilesystemStorage::kStreamPieceBytes + 321, 5);
+
+    dbal::UploadOptions options;
+    options.content_type = "video/mp4";
+    options.metadata["owner"] = "acme";
+    auto uploaded = blobs.upload("media/clip.mp4", data, options);
+    assert(uploaded.isOk());
+    assert(uploaded.value().size == data.size());
+    assert(uploaded.value().etag.size() == 66);
+    assert(blobs.download("media/clip.mp4").value() == data);
+    assert(blobs.download("media/clip.mp4", range(1000, 4096)).value() == slice(data, 1000, 4096));
+    assert(blobs.download("media/clip.mp4", range(data.size(), 1)).isError());
+    std::cout << "  ✓ Whole and ranged downloads match" << std::endl;
+
+    std::vector<char> received;
+    size_t calls = 0;
+    assert(blobs.downloadStream("media/clip.mp4", [&](const char* bytes, size_t size) {
+        received.insert(received.end(), bytes, bytes + size);
+        ++calls;
+    }, range(4097, data.size())).value());
+    assert(received == slice(data, 4097, data.size() - 4097));
+    assert(calls == 3);
+    std::cout << "  ✓ Streamed downloads map unaligned ranges" << std::endl;
+
+    auto location = storage.locate("media/clip.mp4", range(77, 5000));
+    assert(location.isOk());
+    assert(location.value().offset == 77 && location.value().length == 5000);
+    assert(location.value().metadata.content_type == "video/mp4");
+    assert(readLocated(location.value()) == slice(data, 77, 5000));
+    std::cout << "  ✓ Located file and range hold the blob's bytes" << std::endl;
+
+    auto pinned = storage.locate("media/clip.mp4");
+    assert(blobs.upload("media/clip.mp4", pattern(100, 6), options).isOk());
+    assert(storage.storedObjectCount() == 1);
+    assert(readLocated(pinned.value()) == data);
+    assert(readLocated(location.value()) == slice(data, 77, 5000));
+    assert(blobs.upload("media/clip.mp4", data, options).isOk());
+    std::cout << "  ✓ A located blob stays readable after its object is unlinked" << std::endl;
+
+    size_t position = 0;
+    auto streamed = blobs.uploadStream(
+        "media/streamed.mp4",
+        [&](char* buffer, size_t capacity) {
+            const size_t take = std::min<size_t>({capacity, 7000, data.size() - position});
+            std::copy(data.begin() + position, data.begin() + position + take, buffer);
+            position += take;
+            return take;
+        },
+        data.size());
+    assert(streamed.isOk());
+    assert(streamed.value().etag == uploaded.value().etag);
+    assert(storage.storedObjectCount() == 1);
+    std::cout << "  ✓ Same bytes, same ETag and one object on disk" << std::endl;
+
+    std::filesystem::remove_all(directory);
+}
+
+void test_filesystem_reopen() {
+    std::cout << "Testing filesystem references and reopening..." << std::endl;
+
+    const auto directory = freshDirectory("blob_reopen");
+    const auto data = pattern(10000, 6);
+    {
+        FilesystemStorage storage(directory.string());
+        dbal::BlobStorage& blobs = storage;
+        dbal::UploadOptions options;
+        options.content_type = "text/plain";
+        options.metadata["lang"] = "en";
+        assert(blobs.upload("docs/a.txt", data, options).isOk());
+        assert(blobs.copy("docs/a.txt", "docs/b.txt").isOk());
+        assert(blobs.upload("docs/c.txt", pattern(10, 7)).isOk());
+        assert(blobs.upload("other", pattern(10, 8)).isOk());
+        assert(storage.storedObjectCount() == 3);
+
+        dbal::UploadOptions keep;
+        keep.overwrite = false;
+        auto refused = blobs.upload("docs/c.txt", pattern(5, 9), keep);
+        assert(refused.isError() && refused.error().code() == dbal::ErrorCode::Conflict);
+        assert(blobs.deleteBlob("docs/a.txt").value());
+        assert(blobs.deleteBlob("docs/a.txt").isError());
+        assert(storage.storedObjectCount() == 3);
+        assert(blobs.upload("other", pattern(10, 7)).isOk());
+        assert(storage.storedObjectCount() == 2);
+    }
+    std::cout << "  ✓ Objects live while any key names them" << std::endl;
+
+    std::ofstream(directory / "tmp" / "interrupted.tmp") << "partial upload";
+    const auto orphan = directory / "objects" / "00" / "00" / std::string(64, '0');
+    std::filesystem::create_directories(orphan.parent_path());
+    std::ofstream(orphan) << "orphan";
+
+    FilesystemStorage reopened(directory.string());
+    dbal::BlobStorage& blobs = reopened;
+    assert(blobs.getObjectCount().value() == 3);
+    assert(blobs.getTotalSize().value() == data.size() + 20);
+    assert(reopened.storedObjectCount() == 2);
+    auto metadata = blobs.getMetadata("docs/b.txt");
+    assert(metadata.isOk());
+    assert(metadata.value().content_type == "text/plain");
+    assert(metadata.value().custom_metadata.at("lang") == "en");
+    assert(blobs.download("docs/b.txt").value() == data);
+    assert(blobs.download("other").value() == pattern(10, 7));
+    assert(!std::filesystem::exists(orphan));
+    assert(std::filesystem::is_empty(directory / "tmp"));
+    std::cout << "  ✓ Reopened store keeps blobs and drops stray files" << std::endl;
+
+    dbal::ListOptions options;
+    options.prefix = "docs/";
+    options.max_keys = 1;
+    auto first = blobs.list(options).value();
+    assert(first.items.size() == 1 && first.items[0].key == "docs/b.txt");
+    assert(first.is_truncated && first.next_token.has_value());
+    options.continuation_token = first.next_token;
+    auto second = blobs.list(options).value();
+    assert(second.items.size() == 1 && second.items[0].key == "docs/c.txt");
+    assert(!second.is_truncated);
+    std::cout << "  ✓ Listing pages through a prefix in key order" << std::endl;
+
+    std::filesystem::remove_all(directory);
+}
+
+int main() {
+    std::cout << "==================================================" << std::endl;
+    std::cout << "Running Blob Storage Tests" << std::endl;
+    std::cout << "==================================================" << std::endl;
+
+    try {
+        test_chunked_upload_and_ranges();
+        test_streaming();
+        test_copy_and_overwrite();
+        test_content_defined_dedup();
+        test_listing();
+        test_filesystem_transfers();
+        test_filesystem_reopen();
+
+        std::cout << std::endl;
+        std::cout << "✅ All blob storage tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -718,7 +718,7 @@ void test_component_crud() {
 
     auto treeResult = client.getComponentTree(pageId);
     assert(treeResult.isOk());
-    assert(treeResult.value().size() == 3);
+    assert(treeResult.value()->nodes.size() == 3);
     std::cout << "  ✓ Retrieved component tree" << std::endl;
 
     dbal::ListOptions parentFilter;
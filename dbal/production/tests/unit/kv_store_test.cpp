@@ -0,0 +1,236 @@
+#include "kv/in_memory_kv_store.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dbal::kv::InMemoryKVStore;
+using dbal::kv::StorableValue;
+using dbal::tenant::TenantContext;
+
+namespace {
+
+TenantContext tenantContext(const std::string& ns, const dbal::tenant::TenantQuota& quota = {}) {
+    dbal::tenant::TenantIdentity identity;
+    identity.tenantId = ns;
+    identity.userId = "owner_" + ns;
+    identity.role = "owner";
+    return TenantContext(identity, quota, ns + ":");
+}
+
+std::string keyName(int i) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "item:%04d", i);
+    return buffer;
+}
+
+} // namespace
+
+void test_namespaced_values() {
+    std::cout << "Testing values kept per tenant namespace..." << std::endl;
+
+    InMemoryKVStore store(std::chrono::milliseconds(0));
+    const auto acme = tenantContext("acme");
+    const auto globex = tenantContext("globex");
+
+    assert(store.set("greeting", StorableValue(std::string("hello")), acme).isOk());
+    assert(store.set("greeting", StorableValue(int64_t{42}), globex).isOk());
+    assert(std::get<std::string>(*store.get("greeting", acme).value()) == "hello");
+    assert(std::get<int64_t>(*store.get("greeting", globex).value()) == 42);
+    assert(!store.get("missing", acme).value().has_value());
+    std::cout << "  ✓ Same key holds separate values per namespace" << std::endl;
+
+    assert(store.remove("greeting", acme).value());
+    assert(!store.remove("greeting", acme).value());
+    assert(!store.exists("greeting", acme).value());
+    assert(store.exists("greeting", globex).value());
+    std::cout << "  ✓ Remove only touches the caller's namespace" << std::endl;
+
+    dbal::tenant::TenantIdentity viewer;
+    viewer.tenantId = "acme";
+    viewer.role = "viewer";
+    viewer.permissions = {"read:kv"};
+    const TenantContext reader(viewer, {}, "acme:");
+    assert(store.get("greeting", reader).isOk());
+    auto refused = store.set("greeting", StorableValue(std::string("nope")), reader);
+    assert(refused.isError() && refused.error().code() == dbal::ErrorCode::Forbidden);
+    std::cout << "  ✓ Writes need write permission" << std::endl;
+}
+
+void test_prefix_listing() {
+    std::cout << "Testing prefix listing with cursors..." << std::endl;
+
+    InMemoryKVStore store(std::chrono::milliseconds(0));
+    const auto context = tenantContext("acme");
+    for (int i = 0; i < 250; ++i) {
+        assert(store.set(keyName(i), StorableValue(int64_t{i}), context).isOk());
+    }
+    assert(store.set("other", StorableValue(true), context).isOk());
+
+    dbal::kv::ListOptions options;
+    options.prefix = "item:";
+    options.limit = 100;
+    std::vector<std::string> seen;
+    for (int page = 0;; ++page) {
+        auto result = store.list(options, context);
+        assert(result.isOk());
+        for (const auto& entry : result.value().entries) {
+            seen.push_back(entry.key);
+        }
+        if (page == 0) {
+            // Removing a key already listed must not shift the next page
+            assert(store.remove(keyName(5), context).value());
+        }
+        if (!result.value().hasMore) {
+            assert(!result.value().nextCursor.has_value());
+            break;
+        }
+        options.cursor = result.value().nextCursor;
+    }
+    assert(seen.size() == 250);
+    for (int i = 0; i < 250; ++i) {
+        assert(seen[i] == keyName(i));
+    }
+    std::cout << "  ✓ Pages cover every key once, in key order" << std::endl;
+
+    assert(store.count("item:", context).value() == 249);
+    assert(store.count("item:01", context).value() == 100);
+    assert(store.count("", context).value() == 250);
+    options.cursor = std::string("not a cursor!");
+    assert(store.list(options, context).isError());
+    std::cout << "  ✓ Counts by prefix; bad cursors refused" << std::endl;
+
+    assert(store.clear(context).value() == 250);
+    assert(store.count("", context).value() == 0);
+    assert(store.list(dbal::kv::ListOptions(), context).value().entries.empty());
+    std::cout << "  ✓ Clear empties the namespace" << std::endl;
+}
+
+void test_ttl_expiry() {
+    std::cout << "Testing TTL expiry on the timing wheel..." << std::endl;
+
+    InMemoryKVStore store(std::chrono::milliseconds(0));
+    const auto context = tenantContext("acme");
+    const auto now = std::chrono::system_clock::now();
+    const auto day = std::chrono::hours(24);
+
+    assert(store.set("short", StorableValue(std::string("a")), context, 1).isOk());
+    assert(store.set("long", StorableValue(std::string("b")), context, 3 * 24 * 3600).isOk());
+    assert(store.set("distant", StorableValue(std::string("c")), context, 40 * 24 * 3600).isOk());
+    assert(store.set("kept", StorableValue(std::string("d")), context, 1).isOk());
+    assert(store.set("kept", StorableValue(std::string("d")), context).isOk());
+
+    assert(store.expire(now) == 0);
+    assert(store.expire(now + std::chrono::seconds(2)) == 1);
+    assert(!store.exists("short", context).value());
+    assert(store.exists("kept", context).value());
+    std::cout << "  ✓ Expired keys reaped, keys set again without TTL kept" << std::endl;
+
+    assert(store.expire(now + 3 * day - std::chrono::seconds(1)) == 0);
+    assert(store.expire(now + 3 * day + std::chrono::seconds(1)) == 1);
+    assert(store.expire(now + 40 * day - std::chrono::seconds(1)) == 0);
+    assert(store.expire(now + 40 * day + std::chrono::seconds(1)) == 1);
+    assert(store.count("", context).value() == 1);
+    std::cout << "  ✓ Deadlines days ahead fire on time" << std::endl;
+
+    InMemoryKVStore reaped(std::chrono::milliseconds(20));
+    assert(reaped.set("session", StorableValue(std::string("x")), context, 1).isOk());
+    for (int i = 0; i < 200 && reaped.count("", context).value() != 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    assert(reaped.count("", context).value() == 0);
+    std::cout << "  ✓ Reaper thread removes expired keys" << std::endl;
+}
+
+void test_quota_and_lists() {
+    std::cout << "Testing quotas and list values..." << std::endl;
+
+    InMemoryKVStore store(std::chrono::milliseconds(0));
+    dbal::tenant::TenantQuota quota{};
+    quota.maxRecords = 2;
+    quota.maxDataSizeBytes = 16;
+    quota.maxListLength = 3;
+    const auto context = tenantContext("acme", quota);
+
+    assert(store.listAdd("queue", {"a", "b"}, context).value() == 2);
+    assert(store.listAdd("queue", {"c"}, context).value() == 3);
+    auto too_long = store.listAdd("queue", {"d"}, context);
+    assert(too_long.isError() && too_long.error().code() == dbal::ErrorCode::Forbidden);
+    assert((store.listGet("queue", context).value() == std::vector<std::string>{"a", "b", "c"}));
+    assert((store.listGet("queue", context, 1).value() == std::vector<std::string>{"b", "c"}));
+    assert((store.listGet("queue", context, -2, -1).value() == std::vector<std::string>{"b"}));
+    assert(store.listRemove("queue", "b", context).value() == 1);
+    assert(store.listLength("queue", context).value() == 2);
+    std::cout << "  ✓ List append, slice, remove and length limit" << std::endl;
+
+    assert(store.set("name", StorableValue(std::string("0123456789")), context).isOk());
+    auto too_big = store.set("name", StorableValue(std::string("0123456789abcdef")), context);
+    assert(too_big.isError());
+    assert(std::get<std::string>(*store.get("name", context).value()) == "0123456789");
+    auto too_many = store.set("third", StorableValue(true), context);
+    assert(too_many.isError());
+    auto not_list = store.listAdd("name", {"x"}, context);
+    assert(not_list.isError() && not_list.error().code() == dbal::ErrorCode::Conflict);
+    std::cout << "  ✓ Record and byte quotas refuse writes past the limit" << std::endl;
+
+    assert(store.listClear("queue", context).isOk());
+    assert(store.remove("name", context).value());
+    assert(store.set("third", StorableValue(std::string("0123456789abcdef")), context).isOk());
+    std::cout << "  ✓ Freed records and bytes can be used again" << std::endl;
+}
+
+void test_concurrent_writers() {
+    std::cout << "Testing concurrent writers within one quota..." << std::endl;
+
+    InMemoryKVStore store;
+    dbal::tenant::TenantQuota quota{};
+    quota.maxRecords = 500;
+    const auto context = tenantContext("acme", quota);
+
+    std::atomic<int> accepted{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 8; ++t) {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < 100; ++i) {
+                const std::string key = "w" + std::to_string(t) + ":" + std::to_string(i);
+                if (store.set(key, StorableValue(int64_t{i}), context, 60).isOk()) {
+                    ++accepted;
+                }
+                (void)store.get(key, context);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    assert(accepted.load() == 500);
+    assert(store.count("", context).value() == 500);
+    assert(store.count("w", context).value() == 500);
+    std::cout << "  ✓ Exactly maxRecords writes accepted" << std::endl;
+}
+
+int main() {
+    std::cout << "==================================================" << std::endl;
+    std::cout << "Running In-Memory KV Store Tests" << std::endl;
+    std::cout << "==================================================" << std::endl;
+
+    try {
+        test_namespaced_values();
+        test_prefix_listing();
+        test_ttl_expiry();
+        test_quota_and_lists();
+        test_concurrent_writers();
+
+        std::cout << std::endl;
+        std::cout << "✅ All KV store tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
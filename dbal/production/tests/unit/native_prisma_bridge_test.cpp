@@ -0,0 +1,288 @@
+#include "adapters/sql/native_prisma_bridge.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dbal::adapters::sql::BridgeResult;
+using dbal::adapters::sql::BridgeStatement;
+using dbal::adapters::sql::NativePrismaBridge;
+
+namespace {
+
+/**
+ * In-process stand-in for the /api/native-prisma route. Understands
+ * "SELECT <key>" and "SET <key> <value>" against a map, and fails any
+ * statement containing "FAIL" with a unique violation. Unless
+ * acceptsBatches, batch payloads are rejected the way today's route
+ * rejects a body without "sql".
+ */
+class StubBridge {
+public:
+    explicit StubBridge(std::chrono::milliseconds latency = std::chrono::milliseconds(0), bool acceptsBatches = true)
+        : latency_(latency), acceptsBatches_(acceptsBatches) {}
+
+    ::Json::Value handle(const ::Json::Value& payload) {
+        std::this_thread::sleep_for(latency_);
+        std::lock_guard<std::mutex> lock(mu_);
+        payloads.push_back(payload);
+        if (!payload.isMember("batch")) {
+            return run(payload);
+        }
+        if (!acceptsBatches_) {
+            ::Json::Value rejected(::Json::objectValue);
+            rejected["error"] = "sql is required";
+            return rejected;
+        }
+
+        ::Json::Value response(::Json::objectValue);
+        ::Json::Value results(::Json::arrayValue);
+        const auto snapshot = values_;
+        for (const auto& statement : payload["batch"]) {
+            auto result = run(statement);
+            if (result.isMember("error") && payload["transaction"].asBool()) {
+                values_ = snapshot;
+                ::Json::Value rolledBack(::Json::arrayValue);
+                for (::Json::ArrayIndex i = 0; i < payload["batch"].size(); ++i) {
+                    rolledBack.append(result);
+                }
+                response["results"] = rolledBack;
+                return response;
+            }
+            results.append(result);
+        }
+        response["results"] = results;
+        return response;
+    }
+
+    std::string value(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mu_);
+        return values_[key];
+    }
+
+    std::vector<::Json::Value> payloads;
+
+private:
+    ::Json::Value run(const ::Json::Value& statement) {
+        const std::string sql = statement["sql"].asString();
+        ::Json::Value result(::Json::objectValue);
+        if (sql.find("FAIL") != std::string::npos) {
+            result["error"] = "duplicate key";
+            result["code"] = "unique";
+            return result;
+        }
+        if (statement["type"].asString() == "query") {
+            ::Json::Value row(::Json::objectValue);
+            row["value"] = values_[statement["params"][0].asString()];
+            result["rows"].append(row);
+            return result;
+        }
+        values_[statement["params"][0].asString()] = statement["params"][1].asString();
+        result["affected"] = 1;
+        return result;
+    }
+
+    std::chrono::milliseconds latency_;
+    bool acceptsBatches_;
+    std::mutex mu_;
+    std::map<std::string, std::string> values_;
+};
+
+BridgeStatement setStatement(const std::string& key, const std::string& value) {
+    BridgeStatement statement;
+    statement.sql = "SET";
+    statement.params = {key, value};
+    statement.query = false;
+    return statement;
+}
+
+BridgeStatement getStatement(const std::string& key) {
+    BridgeStatement statement;
+    statement.sql = "SELECT";
+    statement.params = {key};
+    return statement;
+}
+
+} // namespace
+
+void test_single_statement_format() {
+    std::cout << "Testing single statement payload..." << std::endl;
+
+    StubBridge stub;
+    NativePrismaBridge bridge([&stub](const ::Json::Value& payload) { return stub.handle(payload); });
+
+    auto set = bridge.execute(setStatement("a", "1"));
+    assert(set.ok());
+    assert(set.affected == 1);
+    auto get = bridge.execute(getStatement("a"));
+    assert(get.ok());
+    assert(get.rows.size() == 1);
+    assert(get.rows[0]["value"].asString() == "1");
+
+    // A lone statement keeps the original single-statement wire format
+    assert(!stub.payloads[0].isMember("batch"));
+    assert(stub.payloads[0]["type"].asString() == "nonquery");
+    assert(bridge.roundTrips() == 2);
+
+    std::cout << "✓ Single statement payload test passed" << std::endl;
+}
+
+void test_concurrent_statements_coalesce() {
+    std::cout << "Testing concurrent statement coalescing..." << std::endl;
+
+    StubBridge stub(std::chrono::milliseconds(20));
+    NativePrismaBridge bridge([&stub](const ::Json::Value& payload) { return stub.handle(payload); }, true, 64, 1);
+
+    constexpr int kThreads = 16;
+    std::atomic<int> ok{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            if (bridge.execute(setStatement("k" + std::to_string(i), std::to_string(i))).ok()) {
+                ok.fetch_add(1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    assert(ok.load() == kThreads);
+    assert(bridge.statementsSent() == kThreads);
+    // With one request in flight, everything queued behind it shares the next one
+    assert(bridge.roundTrips() < kThreads);
+    for (int i = 0; i < kThreads; ++i) {
+        assert(stub.value("k" + std::to_string(i)) == std::to_string(i));
+    }
+
+    std::cout << "✓ Concurrent statement coalescing test passed" << std::endl;
+}
+
+void test_batching_off_by_default() {
+    std::cout << "Testing default unbatched payloads..." << std::endl;
+
+    StubBridge stub(std::chrono::milliseconds(5), false);
+    NativePrismaBridge bridge([&stub](const ::Json::Value& payload) { return stub.handle(payload); });
+    assert(!bridge.batching());
+
+    constexpr int kThreads = 8;
+    std::atomic<int> ok{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&, i]() {
+            if (bridge.execute(setStatement("k" + std::to_string(i), std::to_string(i))).ok()) {
+                ok.fetch_add(1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(ok.load() == kThreads);
+
+    auto failing = setStatement("z", "3");
+    failing.sql = "SET FAIL";
+    auto results = bridge.executeBatch({setStatement("x", "1"), failing, setStatement("y", "2")}, true);
+    assert(results[0].ok());
+    assert(results[1].errorCode == "unique");
+    assert(results[2].errorCode == "skipped");
+    assert(stub.value("y").empty());
+
+    for (const auto& payload : stub.payloads) {
+        assert(!payload.isMember("batch"));
+    }
+    assert(bridge.roundTrips() == kThreads + 2);
+
+    std::cout << "✓ Default unbatched payload test passed" << std::endl;
+}
+
+void test_rejected_batch_format() {
+    std::cout << "Testing a bridge that rejects batches..." << std::endl;
+
+    StubBridge stub(std::chrono::milliseconds(0), false);
+    NativePrismaBridge bridge([&stub](const ::Json::Value& payload) { return stub.handle(payload); }, true);
+    assert(bridge.batching());
+
+    auto results = bridge.executeBatch({setStatement("x", "1"), setStatement("y", "2")}, true);
+    assert(results.size() == 2);
+    assert(results[0].ok() && results[1].ok());
+    assert(stub.value("x") == "1" && stub.value("y") == "2");
+    assert(!bridge.batching());
+    assert(stub.payloads.size() == 3 && stub.payloads[0].isMember("batch"));
+
+    // Once rejected, batches are never offered again
+    results = bridge.executeBatch({setStatement("x", "3"), setStatement("y", "4")}, true);
+    assert(results[0].ok() && results[1].ok());
+    assert(stub.payloads.size() == 5);
+    for (size_t i = 1; i < stub.payloads.size(); ++i) {
+        assert(!stub.payloads[i].isMember("batch"));
+    }
+
+    std::cout << "✓ Rejected batch format test passed" << std::endl;
+}
+
+void test_transactional_batch() {
+    std::cout << "Testing transactional batch..." << std::endl;
+
+    StubBridge stub;
+    NativePrismaBridge bridge([&stub](const ::Json::Value& payload) { return stub.handle(payload); }, true);
+
+    auto results = bridge.executeBatch({setStatement("x", "1"), setStatement("y", "2")}, true);
+    assert(results.size() == 2);
+    assert(results[0].ok() && results[1].ok());
+    assert(bridge.roundTrips() == 1);
+    assert(stub.payloads[0]["transaction"].asBool());
+    assert(stub.payloads[0]["batch"].size() == 2);
+
+    auto failing = setStatement("z", "3");
+    failing.sql = "SET FAIL";
+    results = bridge.executeBatch({setStatement("x", "10"), failing}, true);
+    assert(results.size() == 2);
+    assert(!results[0].ok() && !results[1].ok());
+    assert(results[1].errorCode == "unique");
+    assert(stub.value("x") == "1");
+
+    std::cout << "✓ Transactional batch test passed" << std::endl;
+}
+
+void test_transport_failure() {
+    std::cout << "Testing transport failure..." << std::endl;
+
+    NativePrismaBridge bridge([](const ::Json::Value&) -> ::Json::Value {
+        throw std::runtime_error("connection refused");
+    });
+
+    BridgeResult result = bridge.execute(getStatement("a"));
+    assert(!result.ok());
+    assert(result.errorCode == "transport");
+    assert(result.error == "connection refused");
+
+    std::cout << "✓ Transport failure test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running DBAL Native Prisma Bridge Tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        test_single_statement_format();
+        test_concurrent_statements_coalesce();
+        test_batching_off_by_default();
+        test_rejected_batch_format();
+        test_transactional_batch();
+        test_transport_failure();
+
+        std::cout << std::endl;
+        std::cout << "All Native Prisma bridge tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,215 @@
+#include "adapters/sql/sql_connection.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using dbal::adapters::sql::SqlConnection;
+using dbal::adapters::sql::SqlConnectionConfig;
+using dbal::adapters::sql::SqlPool;
+using dbal::adapters::sql::SqlPoolConfig;
+
+namespace {
+
+SqlPoolConfig poolConfig(size_t min_size, size_t max_size) {
+    SqlPoolConfig config;
+    config.min_size = min_size;
+    config.max_size = max_size;
+    config.acquire_timeout = std::chrono::milliseconds(50);
+    return config;
+}
+
+} // namespace
+
+void test_exclusive_checkout() {
+    std::cout << "Testing exclusive checkout..." << std::endl;
+
+    SqlPool pool(SqlConnectionConfig(), poolConfig(1, 3));
+    assert(pool.size() == 1);
+
+    std::set<SqlConnection*> held;
+    for (int i = 0; i < 3; ++i) {
+        SqlConnection* conn = pool.acquire();
+        assert(conn != nullptr);
+        assert(held.insert(conn).second);
+    }
+    assert(pool.size() == 3);
+
+    SqlPool::AcquireStatus status;
+    assert(pool.acquire(status) == nullptr);
+    assert(status == SqlPool::AcquireStatus::Timeout);
+
+    for (auto* conn : held) {
+        pool.release(conn);
+    }
+    // Releasing twice is ignored
+    pool.release(*held.begin());
+
+    const auto metrics = pool.metrics();
+    assert(metrics.acquired == 3);
+    assert(metrics.timeouts == 1);
+    assert(metrics.waits == 1);
+    assert(metrics.in_use == 0);
+    assert(metrics.idle == 3);
+
+    std::cout << "✓ Exclusive checkout test passed" << std::endl;
+}
+
+void test_waiter_handoff() {
+    std::cout << "Testing waiter hand-off..." << std::endl;
+
+    auto config = poolConfig(1, 1);
+    config.acquire_timeout = std::chrono::seconds(5);
+    SqlPool pool(SqlConnectionConfig(), config);
+
+    SqlConnection* first = pool.acquire();
+    assert(first != nullptr);
+
+    std::atomic<SqlConnection*> received{nullptr};
+    std::thread waiter([&]() { received = pool.acquire(); });
+    while (pool.metrics().waiting == 0) {
+        std::this_thread::yield();
+    }
+    pool.release(first);
+    waiter.join();
+
+    assert(received.load() == first);
+    assert(pool.metrics().in_use == 1);
+    pool.release(first);
+
+    std::cout << "✓ Waiter hand-off test passed" << std::endl;
+}
+
+void test_wait_queue_bound() {
+    std::cout << "Testing bounded wait queue..." << std::endl;
+
+    auto config = poolConfig(1, 1);
+    config.max_waiters = 0;
+    SqlPool pool(SqlConnectionConfig(), config);
+
+    SqlConnection* conn = pool.acquire();
+    SqlPool::AcquireStatus status;
+    assert(pool.acquire(status) == nullptr);
+    assert(status == SqlPool::AcquireStatus::QueueFull);
+    assert(pool.metrics().rejected == 1);
+    pool.release(conn);
+
+    std::cout << "✓ Bounded wait queue test passed" << std::endl;
+}
+
+void test_idle_eviction_and_health() {
+    std::cout << "Testing idle eviction and health checks..." << std::endl;
+
+    auto config = poolConfig(1, 4);
+    config.idle_timeout = std::chrono::milliseconds(0);
+    config.health_check_interval = std::chrono::milliseconds(0);
+    SqlPool pool(SqlConnectionConfig(), config);
+
+    std::vector<SqlConnection*> held;
+    for (int i = 0; i < 4; ++i) {
+        held.push_back(pool.acquire());
+    }
+    for (auto* conn : held) {
+        pool.release(conn);
+    }
+    // Eviction keeps min_size connections open
+    assert(pool.size() == 1);
+    assert(pool.metrics().evicted == 3);
+
+    // A connection that drops while idle fails its health check and is replaced
+    SqlConnection* idle = pool.acquire();
+    pool.release(idle);
+    idle->disconnect();
+    SqlConnection* fresh = pool.acquire();
+    assert(fresh != nullptr && fresh->isConnected());
+    assert(pool.metrics().health_check_failures == 1);
+
+    // A connection released broken is dropped rather than reused
+    fresh->disconnect();
+    pool.release(fresh);
+    assert(pool.size() == 0);
+
+    std::cout << "✓ Idle eviction and health check test passed" << std::endl;
+}
+
+void test_concurrent_checkout() {
+    std::cout << "Testing concurrent checkout..." << std::endl;
+
+    auto config = poolConfig(0, 4);
+    config.acquire_timeout = std::chrono::seconds(5);
+    SqlPool pool(SqlConnectionConfig(), config);
+
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    std::atomic<bool> overlap{false};
+    std::vector<std::atomic<int>> owners(4);
+    std::vector<std::thread> workers;
+    std::vector<SqlConnection*> seen;
+    std::mutex seen_mutex;
+
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < 200; ++i) {
+                SqlConnection* conn = pool.acquire();
+                assert(conn != nullptr);
+                size_t slot;
+                {
+                    std::lock_guard<std::mutex> lock(seen_mutex);
+                    auto it = std::find(seen.begin(), seen.end(), conn);
+                    if (it == seen.end()) {
+                        seen.push_back(conn);
+                        it = seen.end() - 1;
+                    }
+                    slot = static_cast<size_t>(it - seen.begin());
+                }
+                if (owners[slot].fetch_add(1) != 0) {
+                    overlap = true;
+                }
+                const int now = active.fetch_add(1) + 1;
+                int expected = peak.load();
+                while (now > expected && !peak.compare_exchange_weak(expected, now)) {
+                }
+                std::this_thread::yield();
+                active.fetch_sub(1);
+                owners[slot].fetch_sub(1);
+                pool.release(conn);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    assert(!overlap.load());
+    assert(peak.load() <= 4);
+    assert(pool.size() <= 4);
+    assert(pool.metrics().acquired == 1600);
+    assert(pool.metrics().timeouts == 0);
+
+    std::cout << "✓ Concurrent checkout test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running DBAL SQL Pool Tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        test_exclusive_checkout();
+        test_waiter_handoff();
+        test_wait_queue_bound();
+        test_idle_eviction_and_health();
+        test_concurrent_checkout();
+
+        std::cout << std::endl;
+        std::cout << "All SQL pool tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
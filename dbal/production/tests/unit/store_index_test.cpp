@@ -0,0 +1,622 @@
+#include "dbal/client.hpp"
+#include "dbal/errors.hpp"
+#include "query/cursor/list_cursor.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+dbal::Client makeClient() {
+    dbal::ClientConfig config;
+    config.adapter = "sqlite";
+    config.database_url = ":memory:";
+    return dbal::Client(config);
+}
+
+dbal::CreateUserInput userInput(const std::string& name, const std::string& tenant, const std::string& role) {
+    dbal::CreateUserInput input;
+    input.username = name;
+    input.email = name + "@example.com";
+    input.tenantId = tenant;
+    input.role = role;
+    return input;
+}
+
+} // namespace
+
+void test_user_indexes_follow_writes() {
+    std::cout << "Testing user tenant/role indexes..." << std::endl;
+
+    auto client = makeClient();
+    auto a = client.createUser(userInput("idx_a", "acme", "user"));
+    auto b = client.createUser(userInput("idx_b", "acme", "admin"));
+    auto c = client.createUser(userInput("idx_c", "globex", "user"));
+    assert(a.isOk() && b.isOk() && c.isOk());
+
+    dbal::ListOptions by_tenant;
+    by_tenant.filter["tenantId"] = "acme";
+    assert(client.listUsers(by_tenant).value().size() == 2);
+    assert(client.countUsers(std::string("user")).value() == 2);
+    std::cout << "  ✓ Filters served from indexes" << std::endl;
+
+    dbal::UpdateUserInput move;
+    move.tenantId = "globex";
+    move.role = "admin";
+    assert(client.updateUser(a.value().id, move).isOk());
+    assert(client.listUsers(by_tenant).value().size() == 1);
+    assert(client.countUsers(std::string("admin")).value() == 2);
+    assert(client.countUsers(std::string("user")).value() == 1);
+    std::cout << "  ✓ Updates re-file index entries" << std::endl;
+
+    assert(client.deleteUser(b.value().id).isOk());
+    assert(client.listUsers(by_tenant).value().empty());
+    assert(client.countUsers(std::string("admin")).value() == 1);
+    std::cout << "  ✓ Deletes drop index entries" << std::endl;
+
+    std::map<std::string, std::string> filter{{"tenantId", "globex"}, {"role", "user"}};
+    assert(client.deleteManyUsers(filter).value() == 1);
+    assert(client.countUsers().value() == 1);
+    std::cout << "  ✓ Bulk filters intersect indexes" << std::endl;
+
+    // Same username is allowed in another tenant, but not twice in one
+    assert(client.createUser(userInput("idx_a", "initech", "user")).isOk());
+    assert(client.createUser(userInput("idx_a", "initech", "user")).isError());
+    auto same_email = userInput("idx_d", "initech", "user");
+    same_email.email = "idx_a@example.com";
+    assert(client.createUser(same_email).error().code() == dbal::ErrorCode::Conflict);
+    std::cout << "  ✓ Uniqueness checked within tenant bucket" << std::endl;
+
+    auto d = client.createUser(userInput("idx_d", "initech", "user"));
+    assert(d.isOk());
+    dbal::UpdateUserInput rename;
+    rename.username = "idx_a";
+    assert(client.updateUser(d.value().id, rename).error().code() == dbal::ErrorCode::Conflict);
+    rename.username = "idx_e";
+    rename.email = "idx_e@example.com";
+    assert(client.updateUser(d.value().id, rename).isOk());
+    assert(client.createUser(userInput("idx_d", "initech", "user")).isOk());
+    std::cout << "  ✓ Renames take the new name and free the old one" << std::endl;
+
+    // A (tenant, name) pair stays unique when a user moves tenant
+    dbal::UpdateUserInput clash;
+    clash.tenantId = "initech";
+    clash.role = "admin";
+    const std::string moved = client.createUser(userInput("idx_a", "hooli", "user")).value().id;
+    assert(client.updateUser(moved, clash).error().code() == dbal::ErrorCode::Conflict);
+    assert(client.getUser(moved).value().role == "user");
+    assert(client.deleteUser(moved).isOk());
+    assert(client.createUser(userInput("idx_a", "hooli", "user")).isOk());
+    std::cout << "  ✓ Tenant moves are checked against the new tenant" << std::endl;
+}
+
+void test_list_window() {
+    std::cout << "Testing list pagination window..." << std::endl;
+
+    auto client = makeClient();
+    for (int i = 0; i < 25; ++i) {
+        assert(client.createUser(userInput("win_" + std::to_string(i), "acme", "user")).isOk());
+    }
+
+    dbal::ListOptions options;
+    options.page = 2;
+    options.limit = 10;
+    auto page = client.listUsers(options);
+    assert(page.isOk() && page.value().size() == 10);
+    assert(page.value().front().id == "user_00000011");
+
+    options.page = 3;
+    assert(client.listUsers(options).value().size() == 5);
+
+    options.sort["username"] = "asc";
+    options.page = 1;
+    options.limit = 3;
+    auto sorted = client.listUsers(options).value();
+    assert(sorted.size() == 3 && sorted[0].username == "win_0" && sorted[1].username == "win_1" &&
+           sorted[2].username == "win_10");
+    std::cout << "  ✓ Pages and sorting match full-scan results" << std::endl;
+}
+
+void test_keyset_cursor() {
+    std::cout << "Testing keyset cursor pagination..." << std::endl;
+
+    dbal::query::ListCursor cursor{"username", std::string("a\0b", 3), "user_1"};
+    auto decoded = dbal::query::decodeCursor(dbal::query::encodeCursor(cursor));
+    assert(decoded.has_value() && decoded->field == "username" && decoded->key == cursor.key &&
+           decoded->id == "user_1");
+    assert(!dbal::query::decodeCursor("not a cursor!").has_value());
+    assert(!dbal::query::decodeCursor("").has_value());
+    std::cout << "  ✓ Cursor tokens round-trip and reject garbage" << std::endl;
+
+    auto client = makeClient();
+    for (int i = 0; i < 30; ++i) {
+        // Reverse insertion order so username order differs from id order
+        const std::string tenant = i % 3 == 0 ? "globex" : "acme";
+        assert(client.createUser(userInput("key_" + std::to_string(100 - i), tenant, "user")).isOk());
+    }
+
+    for (const bool by_tenant : {false, true}) {
+        dbal::ListOptions options;
+        options.sort["username"] = "asc";
+        options.limit = 7;
+        if (by_tenant) {
+            options.filter["tenantId"] = "acme";
+        }
+        std::vector<std::string> seen;
+        std::string inserted;
+        while (true) {
+            auto page = client.listUsers(options);
+            assert(page.isOk());
+            for (const auto& user : page.value()) {
+                assert(seen.empty() || seen.back() < user.username);
+                seen.push_back(user.username);
+            }
+            if (inserted.empty()) {
+                // A row landing before the cursor must not shift later pages
+                auto early = client.createUser(userInput("key_000", "acme", "user"));
+                assert(early.isOk());
+                inserted = early.value().id;
+            }
+            options.cursor = dbal::query::nextCursor(page.value(), options);
+            if (options.cursor.empty()) {
+                break;
+            }
+        }
+        assert(seen.size() == (by_tenant ? 20u : 30u));
+        assert(client.deleteUser(inserted).isOk());
+    }
+    std::cout << "  ✓ Sorted pages resume from the index without skips or repeats" << std::endl;
+
+    dbal::ListOptions by_id;
+    by_id.limit = 10;
+    auto first = client.listUsers(by_id).value();
+    by_id.cursor = dbal::query::nextCursor(first, by_id);
+    auto second = client.listUsers(by_id).value();
+    assert(second.size() == 10 && first.back().id < second.front().id);
+
+    by_id.sort["username"] = "asc";
+    auto mismatched = client.listUsers(by_id);
+    assert(mismatched.isError() && mismatched.error().code() == dbal::ErrorCode::ValidationError);
+    by_id.cursor = "%%%";
+    assert(client.listUsers(by_id).isError());
+    std::cout << "  ✓ Cursors are tied to their sort order" << std::endl;
+
+    const auto now = std::chrono::system_clock::now();
+    const std::string owner = first.front().id;
+    for (int i = 0; i < 6; ++i) {
+        dbal::CreateSessionInput session;
+        session.userId = owner;
+        session.token = "tok_" + std::to_string(i);
+        session.expiresAt = now + std::chrono::hours(6 - i);
+        assert(client.createSession(session).isOk());
+    }
+    dbal::ListOptions sessions;
+    sessions.sort["expiresAt"] = "asc";
+    sessions.limit = 4;
+    auto soonest = client.listSessions(sessions).value();
+    assert(soonest.size() == 4 && soonest.front().token == "tok_5");
+    sessions.cursor = dbal::query::nextCursor(soonest, sessions);
+    auto latest = client.listSessions(sessions).value();
+    assert(latest.size() == 2 && latest.back().token == "tok_0");
+    std::cout << "  ✓ Timestamp sort keys page in time order" << std::endl;
+}
+
+void test_tenant_sorted_pages() {
+    std::cout << "Testing tenant-filtered sorted pages..." << std::endl;
+
+    auto client = makeClient();
+    std::map<std::string, std::vector<std::string>> by_tenant;
+    std::vector<std::string> admins;
+    std::map<std::string, std::string> ids;
+    for (int i = 0; i < 900; ++i) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "t_%04d", 900 - i);
+        const std::string tenant = "tenant_" + std::to_string(i % 3);
+        const std::string role = i % 10 == 0 ? "admin" : "user";
+        ids[name] = client.createUser(userInput(name, tenant, role)).value().id;
+        by_tenant[tenant].push_back(name);
+        if (tenant == "tenant_1" && role == "admin") {
+            admins.push_back(name);
+        }
+    }
+    for (auto& [tenant, names] : by_tenant) {
+        (void)tenant;
+        std::sort(names.begin(), names.end());
+    }
+    std::sort(admins.begin(), admins.end());
+
+    auto collect = [&](dbal::ListOptions options) {
+        std::vector<std::string> seen;
+        while (true) {
+            auto page = client.listUsers(options).value();
+            for (const auto& user : page) {
+                seen.push_back(user.username);
+            }
+            options.cursor = dbal::query::nextCursor(page, options);
+            if (options.cursor.empty()) {
+                return seen;
+            }
+        }
+    };
+    dbal::ListOptions options;
+    options.sort["username"] = "asc";
+    options.limit = 25;
+    options.filter["tenantId"] = "tenant_0";
+    assert(collect(options) == by_tenant["tenant_0"]);
+    options.filter["tenantId"] = "tenant_1";
+    options.filter["role"] = "admin";
+    assert(collect(options) == admins);
+    options.filter["role"] = "nobody";
+    assert(client.listUsers(options).value().empty());
+    options.filter["tenantId"] = "tenant_none";
+    options.filter["role"] = "admin";
+    assert(client.listUsers(options).value().empty());
+    options.filter["tenantId"] = "tenant_1";
+    std::cout << "  ✓ Tenant and role filters page in username order" << std::endl;
+
+    // A cursor near the end of one tenant reads only what follows it
+    options.filter.erase("role");
+    const auto& names = by_tenant["tenant_1"];
+    dbal::User last_seen;
+    last_seen.id = ids[names[names.size() - 11]];
+    last_seen.username = names[names.size() - 11];
+    options.cursor = dbal::query::nextCursor(std::vector<dbal::User>(25, last_seen), options);
+    auto tail = client.listUsers(options).value();
+    assert(tail.size() == 10 && tail.front().username == names[names.size() - 10] &&
+           tail.back().username == names.back());
+    std::cout << "  ✓ Deep cursors seek within the tenant" << std::endl;
+
+    options.cursor.clear();
+    options.limit = 1000;
+    const std::string moved_id = tail.front().id;
+    dbal::UpdateUserInput rename;
+    rename.username = "a_first";
+    assert(client.updateUser(moved_id, rename).isOk());
+    assert(client.listUsers(options).value().front().id == moved_id);
+    dbal::UpdateUserInput move;
+    move.tenantId = "tenant_2";
+    assert(client.updateUser(moved_id, move).isOk());
+    assert(client.listUsers(options).value().size() == names.size() - 1);
+    options.filter["tenantId"] = "tenant_2";
+    assert(client.listUsers(options).value().front().id == moved_id);
+    assert(client.deleteUser(moved_id).isOk());
+    assert(client.listUsers(options).value().front().username == by_tenant["tenant_2"].front());
+    std::cout << "  ✓ Renames, tenant moves and deletes keep the tenant order" << std::endl;
+}
+
+void test_page_indexes() {
+    std::cout << "Testing page tenant/package indexes..." << std::endl;
+
+    auto client = makeClient();
+    for (int i = 0; i < 4; ++i) {
+        dbal::CreatePageInput input;
+        input.path = "/idx/" + std::to_string(i);
+        input.title = "Page " + std::to_string(i);
+        input.level = 1;
+        input.requiresAuth = false;
+        input.componentTree = "{}";
+        input.tenantId = (i % 2 == 0) ? "acme" : "globex";
+        input.packageId = "pkg_" + std::to_string(i % 2);
+        assert(client.createPage(input).isOk());
+    }
+
+    dbal::ListOptions options;
+    options.filter["tenantId"] = "acme";
+    options.filter["packageId"] = "pkg_0";
+    assert(client.listPages(options).value().size() == 2);
+
+    options.filter["packageId"] = "pkg_1";
+    assert(client.listPages(options).value().empty());
+
+    options.filter.erase("tenantId");
+    options.filter["packageId"] = "missing";
+    assert(client.listPages(options).value().empty());
+    std::cout << "  ✓ Page filters narrowed by index" << std::endl;
+}
+
+void test_text_search_index() {
+    std::cout << "Testing n-gram search index..." << std::endl;
+
+    auto client = makeClient();
+    auto anna = client.createUser(userInput("anna_smith", "acme", "user"));
+    auto hannah = client.createUser(userInput("hannah", "acme", "user"));
+    auto bob = client.createUser(userInput("bob", "acme", "user"));
+    assert(anna.isOk() && hannah.isOk() && bob.isOk());
+
+    for (const char* query : {"a", "An", "ann", "ANNA", "nna_s"}) {
+        auto found = client.searchUsers(query, 10);
+        assert(found.isOk());
+        for (const auto& user : found.value()) {
+            assert(user.username.find("ann") != std::string::npos || std::string(query).size() < 3);
+        }
+    }
+    auto ranked = client.searchUsers("an", 10);
+    assert(ranked.value().size() == 2);
+    assert(ranked.value()[0].username == "anna_smith");
+    assert(client.searchUsers("hannah@example", 10).value().size() == 1);
+    assert(client.searchUsers("annx", 10).value().empty());
+    assert(client.searchUsers("a", 1).value().size() == 1);
+    std::cout << "  ✓ Short and long queries match substrings, ranked by prefix" << std::endl;
+
+    dbal::UpdateUserInput rename;
+    rename.username = "zed";
+    assert(client.updateUser(hannah.value().id, rename).isOk());
+    assert(client.searchUsers("hannah", 10).value().size() == 1);  // still in the email
+    assert(client.searchUsers("zed", 10).value().size() == 1);
+    rename.username = std::nullopt;
+    rename.email = "zed@example.com";
+    assert(client.updateUser(hannah.value().id, rename).isOk());
+    assert(client.searchUsers("hannah", 10).value().empty());
+    assert(client.deleteUser(anna.value().id).isOk());
+    assert(client.searchUsers("anna", 10).value().empty());
+    std::cout << "  ✓ Index follows updates and deletes" << std::endl;
+
+    dbal::CreatePageInput input;
+    input.path = "/docs/search";
+    input.title = "Finding Things";
+    input.level = 1;
+    input.requiresAuth = false;
+    input.componentTree = "{}";
+    auto page = client.createPage(input);
+    assert(page.isOk());
+    assert(client.searchPages("SEARCH", 10).value().size() == 1);
+    assert(client.searchPages("finding", 10).value().size() == 1);
+    dbal::UpdatePageInput retitle;
+    retitle.title = "Lookup";
+    assert(client.updatePage(page.value().id, retitle).isOk());
+    assert(client.searchPages("finding", 10).value().empty());
+    assert(client.deletePage(page.value().id).isOk());
+    assert(client.searchPages("search", 10).value().empty());
+    std::cout << "  ✓ Page search follows title and path writes" << std::endl;
+}
+
+void test_component_tree_cache() {
+    std::cout << "Testing cached component trees..." << std::endl;
+
+    auto client = makeClient();
+    dbal::CreatePageInput pageInput;
+    pageInput.path = "/tree";
+    pageInput.title = "Tree";
+    pageInput.level = 1;
+    pageInput.requiresAuth = false;
+    pageInput.componentTree = "{}";
+    auto page = client.createPage(pageInput);
+    assert(page.isOk());
+    const std::string pageId = page.value().id;
+
+    auto add = [&](const std::optional<std::string>& parentId, int order) {
+        dbal::CreateComponentNodeInput input;
+        input.pageId = pageId;
+        input.parentId = parentId;
+        input.type = "Box";
+        input.childIds = "[]";
+        input.order = order;
+        auto created = client.createComponent(input);
+        assert(created.isOk());
+        return created.value().id;
+    };
+    const std::string root_b = add(std::nullopt, 2);
+    const std::string root_a = add(std::nullopt, 1);
+    const std::string child_2 = add(root_a, 2);
+    const std::string child_1 = add(root_a, 1);
+    const std::string leaf = add(child_1, 0);
+
+    auto tree = client.getComponentTree(pageId).value();
+    assert(tree->nodes.size() == 5);
+    assert(tree->nodes[0].id == root_a && tree->nodes[1].id == child_1 && tree->nodes[2].id == leaf);
+    assert(tree->nodes[3].id == child_2 && tree->nodes[4].id == root_b);
+    assert(tree->depth[0] == 0 && tree->depth[2] == 2 && tree->depth[4] == 0);
+    assert(tree->subtreeEnd[0] == 4 && tree->subtreeEnd[1] == 3 && tree->subtreeEnd[4] == 5);
+    assert(client.getComponentTree(pageId).value() == tree);
+    std::cout << "  ✓ Pre-order snapshot with depths and subtree ranges, reused across reads" << std::endl;
+
+    std::vector<dbal::ComponentOrderUpdate> swap{{root_a, 3}};
+    assert(client.reorderComponents(swap).isOk());
+    auto reordered = client.getComponentTree(pageId).value();
+    assert(reordered != tree);
+    assert(reordered->nodes[0].id == root_b && reordered->nodes[1].id == root_a);
+    assert(tree->nodes[0].id == root_a);  // old snapshot is untouched
+
+    dbal::MoveComponentInput move;
+    move.id = child_1;
+    move.newParentId = root_b;
+    move.order = 0;
+    assert(client.moveComponent(move).isOk());
+    auto moved = client.getComponentTree(pageId).value();
+    assert(moved->nodes[1].id == child_1 && moved->nodes[2].id == leaf && moved->subtreeEnd[0] == 3);
+
+    assert(client.deleteComponent(child_1).isOk());
+    auto pruned = client.getComponentTree(pageId).value();
+    assert(pruned->nodes.size() == 3);
+    assert(pruned->nodes[0].id == root_b && pruned->subtreeEnd[0] == 1);
+    std::cout << "  ✓ Reorder, move and delete replace the snapshot" << std::endl;
+}
+
+void test_batch_rollback() {
+    std::cout << "Testing batched operations..." << std::endl;
+
+    auto client = makeClient();
+    auto keep = client.createUser(userInput("batch_keep", "acme", "user"));
+    auto doomed = client.createUser(userInput("batch_doomed", "acme", "user"));
+    assert(keep.isOk() && doomed.isOk());
+    dbal::CreatePageInput pageInput;
+    pageInput.path = "/batch";
+    pageInput.title = "Batch";
+    pageInput.level = 1;
+    pageInput.requiresAuth = false;
+    pageInput.componentTree = "{}";
+    auto page = client.createPage(pageInput);
+    assert(page.isOk());
+
+    const std::vector<dbal::BatchAccess> access{
+        {dbal::BatchEntity::User, true},
+        {dbal::BatchEntity::Page, true},
+        {dbal::BatchEntity::Component, true},
+    };
+    std::string new_user_id;
+    auto failed = client.batch(access, true, [&]() -> dbal::Result<bool> {
+        auto created = client.createUser(userInput("batch_new", "acme", "admin"));
+        assert(created.isOk());
+        new_user_id = created.value().id;
+
+        dbal::UpdateUserInput rename;
+        rename.username = "batch_renamed";
+        rename.role = "admin";
+        assert(client.updateUser(keep.value().id, rename).isOk());
+        assert(client.deleteUser(doomed.value().id).isOk());
+
+        // The deleted user's name is free inside the batch
+        assert(client.createUser(userInput("batch_doomed", "acme", "user")).isOk());
+
+        dbal::UpdatePageInput move;
+        move.path = "/batch/moved";
+        assert(client.updatePage(page.value().id, move).isOk());
+
+        dbal::CreateComponentNodeInput component;
+        component.pageId = page.value().id;
+        component.type = "Box";
+        component.childIds = "[]";
+        assert(client.createComponent(component).isOk());
+        assert(client.getComponentTree(page.value().id).value()->nodes.size() == 1);
+
+        return client.getUser("user_missing").error();
+    });
+    assert(failed.isError());
+    assert(failed.error().code() == dbal::ErrorCode::NotFound);
+
+    assert(client.getUser(new_user_id).isError());
+    assert(client.getUser(keep.value().id).value().username == "batch_keep");
+    assert(client.getUser(doomed.value().id).value().username == "batch_doomed");
+    assert(client.countUsers(std::string("admin")).value() == 0);
+    assert(client.countUsers().value() == 2);
+    assert(client.searchUsers("batch_renamed", 10).value().empty());
+    assert(client.getPageByPath("/batch").isOk());
+    assert(client.getPageByPath("/batch/moved").isError());
+    assert(client.getComponentTree(page.value().id).value()->nodes.empty());
+    std::cout << "  ✓ Failed atomic batch restores records and indexes" << std::endl;
+
+    auto partial = client.batch(access, false, [&]() -> dbal::Result<bool> {
+        assert(client.createUser(userInput("batch_kept", "acme", "user")).isOk());
+        return dbal::Error::conflict("later op failed");
+    });
+    assert(partial.isError());
+    assert(client.countUsers().value() == 3);
+    std::cout << "  ✓ Non-atomic batch keeps earlier writes" << std::endl;
+
+    bool rejected = false;
+    auto read_only = client.batch({{dbal::BatchEntity::User, false}}, false, [&]() -> dbal::Result<bool> {
+        assert(client.getUser(keep.value().id).isOk());
+        try {
+            client.deleteUser(keep.value().id);
+        } catch (const std::logic_error&) {
+            rejected = true;
+        }
+        return true;
+    });
+    assert(read_only.isOk() && rejected);
+    assert(client.getUser(keep.value().id).isOk());
+    std::cout << "  ✓ Calls outside the batch's access are refused" << std::endl;
+}
+
+void test_session_expiry() {
+    std::cout << "Testing session expiry and reaping..." << std::endl;
+
+    dbal::ClientConfig config;
+    config.adapter = "sqlite";
+    config.database_url = ":memory:";
+    config.sessions.reap_interval_ms = 0;
+    config.sessions.reap_batch = 2;
+    config.sessions.touch_granularity_ms = 60000;
+    dbal::Client client(config);
+    const std::string owner = client.createUser(userInput("session_owner", "acme", "user")).value().id;
+
+    const auto now = std::chrono::system_clock::now();
+    std::vector<std::string> ids;
+    for (int i = 0; i < 8; ++i) {
+        dbal::CreateSessionInput session;
+        session.userId = owner;
+        session.token = "exp_" + std::to_string(i);
+        session.expiresAt = i < 5 ? now - std::chrono::minutes(i + 1) : now + std::chrono::hours(1);
+        ids.push_back(client.createSession(session).value().id);
+    }
+
+    auto expired = client.getSession(ids[0]);
+    assert(expired.isError() && expired.error().code() == dbal::ErrorCode::NotFound);
+    dbal::ListOptions all;
+    all.limit = 100;
+    assert(client.listSessions(all).value().size() == 3);
+    dbal::CreateSessionInput reused;
+    reused.userId = owner;
+    reused.token = "exp_0";
+    reused.expiresAt = now + std::chrono::hours(1);
+    assert(client.createSession(reused).error().code() == dbal::ErrorCode::Conflict);
+    std::cout << "  ✓ Reads skip expired sessions without removing them" << std::endl;
+
+    assert(client.reapExpiredSessions().value() == 5);
+    assert(client.reapExpiredSessions().value() == 0);
+    assert(client.listSessions(all).value().size() == 3);
+    assert(client.createSession(reused).isOk());
+    std::cout << "  ✓ Reaping removes expired sessions across batches" << std::endl;
+
+    const auto before = client.getSession(ids[5]).value();
+    auto unchanged = client.touchSession(ids[5], std::chrono::seconds(3600));
+    assert(unchanged.isOk() && unchanged.value().expiresAt == before.expiresAt);
+    auto extended = client.touchSession(ids[5], std::chrono::hours(3));
+    assert(extended.isOk() && extended.value().expiresAt > before.expiresAt + std::chrono::hours(1));
+    assert(client.getSession(ids[5]).value().expiresAt == extended.value().expiresAt);
+    dbal::ListOptions by_expiry;
+    by_expiry.sort["expiresAt"] = "asc";
+    assert(client.listSessions(by_expiry).value().back().id == ids[5]);
+    assert(client.touchSession(ids[0], std::chrono::hours(1)).error().code() == dbal::ErrorCode::NotFound);
+    std::cout << "  ✓ Touch slides expiry past the granularity and keeps the index in order" << std::endl;
+
+    config.sessions.reap_interval_ms = 10;
+    dbal::Client background(config);
+    const std::string other = background.createUser(userInput("session_other", "acme", "user")).value().id;
+    dbal::CreateSessionInput stale;
+    stale.userId = other;
+    stale.token = "stale";
+    stale.expiresAt = std::chrono::system_clock::now() - std::chrono::seconds(1);
+    assert(background.createSession(stale).isOk());
+    stale.expiresAt = std::chrono::system_clock::now() + std::chrono::hours(1);
+    bool reaped = false;
+    for (int i = 0; i < 200 && !reaped; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        reaped = background.createSession(stale).isOk();
+    }
+    assert(reaped);
+    std::cout << "  ✓ Background reaper frees expired sessions" << std::endl;
+}
+
+int main() {
+    std::cout << "==================================================" << std::endl;
+    std::cout << "Running In-Memory Store Index Tests" << std::endl;
+    std::cout << "==================================================" << std::endl;
+
+    try {
+        test_user_indexes_follow_writes();
+        test_list_window();
+        test_keyset_cursor();
+        test_tenant_sorted_pages();
+        test_page_indexes();
+        test_text_search_index();
+        test_component_tree_cache();
+        test_batch_rollback();
+        test_session_expiry();
+
+        std::cout << std::endl;
+        std::cout << "✅ All store index tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
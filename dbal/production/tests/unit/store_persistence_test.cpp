@@ -0,0 +1,372 @@
+#include "dbal/client.hpp"
+#include "dbal/errors.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path freshDirectory(const std::string& name) {
+    const fs::path directory = fs::temp_directory_path() / ("dbal_persistence_test_" + name);
+    fs::remove_all(directory);
+    return directory;
+}
+
+dbal::ClientConfig persistentConfig(const fs::path& directory) {
+    dbal::ClientConfig config;
+    config.adapter = "sqlite";
+    config.database_url = ":memory:";
+    config.persistence.directory = directory.string();
+    config.persistence.group_commit_ms = 1;
+    return config;
+}
+
+dbal::CreateUserInput userInput(const std::string& name, const std::string& tenant, const std::string& role) {
+    dbal::CreateUserInput input;
+    input.username = name;
+    input.email = name + "@example.com";
+    input.tenantId = tenant;
+    input.role = role;
+    return input;
+}
+
+dbal::CreatePageInput pageInput(const std::string& path) {
+    dbal::CreatePageInput input;
+    input.path = path;
+    input.title = "Page " + path;
+    input.level = 1;
+    input.requiresAuth = false;
+    input.componentTree = "{}";
+    input.tenantId = "acme";
+    return input;
+}
+
+std::vector<fs::path> segments(const fs::path& directory) {
+    std::vector<fs::path> found;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        if (entry.path().extension() == ".log") {
+            found.push_back(entry.path());
+        }
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+size_t countTenant(dbal::Client& client, const std::string& tenant) {
+    dbal::ListOptions options;
+    options.filter["tenantId"] = tenant;
+    options.limit = 100;
+    return client.listUsers(options).value().size();
+}
+
+} // namespace
+
+void test_restart_restores_store() {
+    std::cout << "Testing restart from the write-ahead log..." << std::endl;
+
+    const fs::path directory = freshDirectory("restart");
+    std::string kept_id;
+    std::string removed_id;
+    std::string page_id;
+    std::string workflow_id;
+    {
+        dbal::Client client(persistentConfig(directory));
+        auto kept = client.createUser(userInput("wal_kept", "acme", "user"));
+        auto removed = client.createUser(userInput("wal_removed", "acme", "user"));
+        assert(client.createUser(userInput("wal_other", "globex", "user")).isOk());
+        assert(kept.isOk() && removed.isOk());
+        kept_id = kept.value().id;
+        removed_id = removed.value().id;
+
+        dbal::UpdateUserInput promote;
+        promote.role = "admin";
+        assert(client.updateUser(kept_id, promote).isOk());
+        assert(client.deleteUser(removed_id).isOk());
+
+        dbal::CreateCredentialInput credential;
+        credential.username = "wal_kept";
+        credential.passwordHash = "wal-password-123";
+        assert(client.setCredential(credential).isOk());
+
+        auto page = client.createPage(pageInput("/wal"));
+        assert(page.isOk());
+        page_id = page.value().id;
+        dbal::CreateComponentNodeInput component;
+        component.pageId = page_id;
+        component.type = "Box";
+        component.childIds = "[]";
+        component.order = 0;
+        assert(client.createComponent(component).isOk());
+
+        dbal::CreateSessionInput session;
+        session.userId = kept_id;
+        session.token = "wal_token";
+        session.expiresAt = std::chrono::system_clock::now() + std::chrono::hours(1);
+        assert(client.createSession(session).isOk());
+
+        dbal::CreateWorkflowInput workflow;
+        workflow.name = "wal_flow";
+        workflow.nodes = "[]";
+        workflow.edges = "[]";
+        workflow.enabled = true;
+        auto created_workflow = client.createWorkflow(workflow);
+        assert(created_workflow.isOk());
+        workflow_id = created_workflow.value().id;
+
+        dbal::CreatePackageInput package;
+        package.packageId = "wal_pkg";
+        package.version = "1.0.0";
+        package.enabled = true;
+        assert(client.createPackage(package).isOk());
+
+        // A rolled-back batch leaves nothing in the log
+        const std::vector<dbal::BatchAccess> access{{dbal::BatchEntity::User, true}};
+        auto failed = client.batch(access, true, [&]() -> dbal::Result<bool> {
+            assert(client.createUser(userInput("wal_rolled_back", "acme", "user")).isOk());
+            return dbal::Error::conflict("abort");
+        });
+        assert(failed.isError());
+    }
+
+    dbal::Client client(persistentConfig(directory));
+    auto kept = client.getUser(kept_id);
+    assert(kept.isOk() && kept.value().role == "admin" && kept.value().username == "wal_kept");
+    assert(client.getUser(removed_id).isError());
+    assert(countTenant(client, "acme") == 1);
+    assert(countTenant(client, "globex") == 1);
+    std::cout << "  ✓ Users and their indexes restored" << std::endl;
+
+    assert(client.verifyCredential("wal_kept", "wal-password-123").isOk());
+    assert(client.getPageByPath("/wal").isOk());
+    assert(client.getComponentTree(page_id).isOk());
+    assert(client.getWorkflow(workflow_id).isOk());
+    assert(client.getPackage("wal_pkg").isOk());
+    dbal::ListOptions all;
+    assert(client.listSessions(all).value().size() == 1);
+    std::cout << "  ✓ Credentials, pages, components, sessions, workflows and packages restored" << std::endl;
+
+    auto next = client.createUser(userInput("wal_next", "acme", "user"));
+    assert(next.isOk() && next.value().id != kept_id && next.value().id != removed_id);
+    std::cout << "  ✓ Id counters resume past logged ids" << std::endl;
+}
+
+void test_torn_tail_is_cut() {
+    std::cout << "Testing recovery from a torn log tail..." << std::endl;
+
+    const fs::path directory = freshDirectory("torn");
+    {
+        dbal::Client client(persistentConfig(directory));
+        assert(client.createUser(userInput("torn_a", "acme", "user")).isOk());
+        assert(client.createUser(userInput("torn_b", "acme", "user")).isOk());
+    }
+    {
+        // A frame header promising more bytes than were written
+        std::ofstream tail(segments(directory).back(), std::ios::binary | std::ios::app);
+        tail.write("\x40\x00\x00\x00\x12\x34", 6);
+    }
+    {
+        dbal::Client client(persistentConfig(directory));
+        assert(countTenant(client, "acme") == 2);
+        assert(client.createUser(userInput("torn_c", "acme", "user")).isOk());
+    }
+    {
+        dbal::Client client(persistentConfig(directory));
+        assert(countTenant(client, "acme") == 3);
+    }
+    std::cout << "  ✓ Torn frame dropped, earlier and later commits kept" << std::endl;
+
+    {
+        // Damage inside a segment that is not the last one is not a crash artefact
+        const fs::path first = segments(directory).front();
+        std::fstream file(first, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+    bool rejected = false;
+    try {
+        dbal::Client client(persistentConfig(directory));
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    std::cout << "  ✓ Corruption before the tail is refused" << std::endl;
+}
+
+void test_checkpoint_then_tail() {
+    std::cout << "Testing snapshot plus log tail..." << std::endl;
+
+    const fs::path directory = freshDirectory("snapshot");
+    std::vector<std::string> ids;
+    {
+        dbal::Client client(persistentConfig(directory));
+        for (int i = 0; i < 50; ++i) {
+            auto created = client.createUser(userInput("snap_" + std::to_string(i), "acme", "user"));
+            assert(created.isOk());
+            ids.push_back(created.value().id);
+        }
+        assert(client.checkpoint().isOk());
+        assert(fs::exists(directory / "snapshot"));
+        assert(segments(directory).size() == 1);
+
+        dbal::UpdateUserInput move;
+        move.tenantId = "globex";
+        assert(client.updateUser(ids[0], move).isOk());
+        assert(client.deleteUser(ids[1]).isOk());
+    }
+
+    dbal::Client client(persistentConfig(directory));
+    assert(countTenant(client, "acme") == 48);
+    assert(countTenant(client, "globex") == 1);
+    assert(client.getUser(ids[1]).isError());
+    assert(client.getUser(ids[49]).isOk());
+    std::cout << "  ✓ Snapshot loaded and later writes replayed" << std::endl;
+
+    dbal::ClientConfig volatile_config = persistentConfig(directory);
+    volatile_config.persistence.directory.clear();
+    dbal::Client in_memory(volatile_config);
+    assert(in_memory.checkpoint().isError());
+    std::cout << "  ✓ Checkpoint without persistence is refused" << std::endl;
+}
+
+void test_snapshot_loads_lazily() {
+    std::cout << "Testing partitions loaded from the snapshot on first use..." << std::endl;
+
+    const fs::path directory = freshDirectory("lazy");
+    std::string page_id;
+    {
+        dbal::Client client(persistentConfig(directory));
+        for (int i = 0; i < 20; ++i) {
+            assert(client.createUser(userInput("lazy_" + std::to_string(i), i % 2 ? "acme" : "globex", "user")).isOk());
+        }
+        auto page = client.createPage(pageInput("/lazy"));
+        assert(page.isOk());
+        page_id = page.value().id;
+        dbal::CreateComponentNodeInput component;
+        component.pageId = page_id;
+        component.type = "Box";
+        component.childIds = "[]";
+        component.order = 0;
+        assert(client.createComponent(component).isOk());
+        assert(client.checkpoint().isOk());
+
+        // Logged after the snapshot
+        assert(client.createUser(userInput("lazy_tail", "acme", "user")).isOk());
+    }
+
+    {
+        dbal::Client client(persistentConfig(directory));
+        // A write before the first search must not be lost from the text index
+        assert(client.createUser(userInput("lazy_fresh", "acme", "user")).isOk());
+        assert(client.searchUsers("lazy_1", 50).value().size() == 11);
+        assert(client.searchUsers("lazy_tail", 10).value().size() == 1);
+        assert(client.searchUsers("lazy_fresh", 10).value().size() == 1);
+        assert(countTenant(client, "acme") == 12);
+        assert(countTenant(client, "globex") == 10);
+        assert(client.getComponentTree(page_id).isOk());
+        assert(client.getPageByPath("/lazy").isOk());
+    }
+    std::cout << "  ✓ Records, indexes and later writes served after reopening" << std::endl;
+
+    {
+        dbal::Client client(persistentConfig(directory));
+        assert(client.checkpoint().isOk());
+    }
+    {
+        // The first section after the header holds user rows
+        std::fstream file(directory / "snapshot", std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(112);
+        const char byte = static_cast<char>(file.get());
+        file.seekp(112);
+        file.put(static_cast<char>(byte ^ 0x5a));
+    }
+    dbal::Client client(persistentConfig(directory));
+    assert(client.getPageByPath("/lazy").isOk());
+    bool rejected = false;
+    try {
+        client.countUsers();
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    std::cout << "  ✓ Damaged section refused when its partition is first used" << std::endl;
+}
+
+void test_point_reads_before_load() {
+    std::cout << "Testing reads by id before a partition loads..." << std::endl;
+
+    const fs::path directory = freshDirectory("peek");
+    std::vector<std::string> ids;
+    std::string page_id;
+    std::string tail_page_id;
+    {
+        dbal::Client client(persistentConfig(directory));
+        for (int i = 0; i < 30; ++i) {
+            auto created = client.createUser(userInput("peek_" + std::to_string(i), "acme", "user"));
+            assert(created.isOk());
+            ids.push_back(created.value().id);
+        }
+        page_id = client.createPage(pageInput("/peek")).value().id;
+        assert(client.checkpoint().isOk());
+
+        dbal::UpdateUserInput rename;
+        rename.username = "peek_renamed";
+        assert(client.updateUser(ids[3], rename).isOk());
+        rename.username = "peek_renamed_again";
+        assert(client.updateUser(ids[3], rename).isOk());
+        assert(client.deleteUser(ids[4]).isOk());
+        ids.push_back(client.createUser(userInput("peek_tail", "acme", "user")).value().id);
+        tail_page_id = client.createPage(pageInput("/peek_tail")).value().id;
+    }
+
+    dbal::Client client(persistentConfig(directory));
+    for (size_t i = 0; i < ids.size(); ++i) {
+        auto found = client.getUser(ids[i]);
+        if (i == 4) {
+            assert(found.isError() && found.error().code() == dbal::ErrorCode::NotFound);
+            continue;
+        }
+        assert(found.isOk() && found.value().id == ids[i] && found.value().tenantId == "acme");
+    }
+    assert(client.getUser(ids[0]).value().username == "peek_0");
+    assert(client.getUser(ids[3]).value().username == "peek_renamed_again");
+    assert(client.getUser(ids.back()).value().username == "peek_tail");
+    assert(client.getUser("no-such-user").isError());
+    assert(client.getUser("").error().code() == dbal::ErrorCode::ValidationError);
+    assert(client.getPage(page_id).value().path == "/peek");
+    assert(client.getPage(tail_page_id).value().path == "/peek_tail");
+    std::cout << "  ✓ Snapshot rows and later logged writes answer reads by id" << std::endl;
+
+    assert(countTenant(client, "acme") == 30);
+    assert(client.getUser(ids[3]).value().username == "peek_renamed_again");
+    assert(client.getUser(ids[4]).isError());
+    std::cout << "  ✓ Loading the partition afterwards agrees with them" << std::endl;
+}
+
+int main() {
+    std::cout << "==================================================" << std::endl;
+    std::cout << "Running In-Memory Store Persistence Tests" << std::endl;
+    std::cout << "==================================================" << std::endl;
+
+    try {
+        test_restart_restores_store();
+        test_torn_tail_is_cut();
+        test_checkpoint_then_tail();
+        test_snapshot_loads_lazily();
+        test_point_reads_before_load();
+
+        std::cout << std::endl;
+        std::cout << "✅ All store persistence tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}